@@ -0,0 +1,50 @@
+#===============================================================================
+# MAX22200 Driver - Footprint report (cmake -P script)
+# Reads the symbol table of max22200_footprint_bench with nm and prints the
+# size of every max22200_fp_<Api> thunk plus every out-of-line driver symbol
+# (NullBus methods are listed too; they stand in for the platform bus).
+#
+# Inputs: -DNM=<path to nm> -DBINARY=<path to max22200_footprint_bench>
+#===============================================================================
+
+if(NOT NM OR NOT BINARY)
+    message(FATAL_ERROR "usage: cmake -DNM=<nm> -DBINARY=<elf> -P max22200_footprint_report.cmake")
+endif()
+
+execute_process(
+    COMMAND ${NM} --print-size --size-sort --demangle ${BINARY}
+    OUTPUT_VARIABLE nm_output
+    RESULT_VARIABLE nm_result
+)
+if(NOT nm_result EQUAL 0)
+    message(FATAL_ERROR "nm failed on ${BINARY}")
+endif()
+
+string(REPLACE "\n" ";" nm_lines "${nm_output}")
+
+set(api_total 0)
+set(helper_total 0)
+set(api_report "")
+set(helper_report "")
+foreach(line IN LISTS nm_lines)
+    # <address> <size> <type> <name>
+    if(NOT line MATCHES "^[0-9a-fA-F]+ ([0-9a-fA-F]+) [tTwW] (.+)$")
+        continue()
+    endif()
+    set(size_hex "${CMAKE_MATCH_1}")
+    set(name "${CMAKE_MATCH_2}")
+    math(EXPR size "0x${size_hex}" OUTPUT_FORMAT DECIMAL)
+    if(name MATCHES "^max22200_fp_(.+)$")
+        string(APPEND api_report "  ${size}\t${CMAKE_MATCH_1}\n")
+        math(EXPR api_total "${api_total} + ${size}")
+    elseif(name MATCHES "max22200::" OR name MATCHES "^NullBus::")
+        string(APPEND helper_report "  ${size}\t${name}\n")
+        math(EXPR helper_total "${helper_total} + ${size}")
+    endif()
+endforeach()
+
+message("MAX22200 per-API code size (bytes, API inlined into its thunk):")
+message("${api_report}")
+message("Out-of-line driver symbols shared by the APIs above (bytes):")
+message("${helper_report}")
+message("Thunks total: ${api_total} bytes; shared driver symbols: ${helper_total} bytes")
@@ -0,0 +1,472 @@
+/**
+ * @file max22200_emulated_bus.hpp
+ * @brief Register-level MAX22200 emulator implementing SpiInterface (header-only)
+ *
+ * Host-side stand-in for the ESP32 bus used by the benchmarks. It models the
+ * device rather than the wire, so every byte the driver clocks out is decoded
+ * the way the MAX22200 would decode it:
+ *
+ *   - Two-phase protocol: a 1-byte transfer with CMD ACTIVE writes the Command
+ *     Register and returns STATUS[7:0]; transfers with CMD INACTIVE are data
+ *     frames for the last latched command (the command is sticky, as on the IC).
+ *   - 32-bit writes arrive LSB first, 32-bit reads leave MSB first, 8-bit
+ *     accesses touch only bits 31:24.
+ *   - STATUS[7:0] fault flags are derived from the FAULT register plus the
+ *     OVT/UVM/COMER latches; nFAULT follows the unmasked flags.
+ *   - FAULT reads clear on read; in MAX22200A mode only the bits whose SDI bit
+ *     is HIGH are cleared (selective clear).
+ *
+ * Time is a virtual bus clock in nanoseconds. Each frame advances it by the
+ * wire time at the configured SCLK plus a fixed per-frame overhead (CS setup,
+ * CMD toggling, driver-to-peripheral latency), DelayUs() advances it by the
+ * requested amount, and benchmarks advance it explicitly for idle time. This
+ * keeps results independent of host speed and reproducible from a seed.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+
+#include "max22200_registers.hpp"
+#include "max22200_spi_interface.hpp"
+#include "max22200_types.hpp"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Frame and byte counters kept by EmulatedMax22200Bus
+ */
+struct EmulatedBusCounters {
+  uint64_t frames;          ///< All SPI frames (CS low → CS high)
+  uint64_t command_frames;  ///< Frames with CMD ACTIVE (Command Register writes)
+  uint64_t data_frames;     ///< Frames with CMD INACTIVE (register data)
+  uint64_t bytes;           ///< Bytes clocked in both directions (one count per byte)
+  uint64_t wire_time_ns;    ///< Virtual time spent on the bus (frames + overhead)
+  uint64_t onch_latches;    ///< Data frames that wrote STATUS (new ONCH latched)
+  uint64_t comer_events;    ///< Frames the device flagged as communication errors
+
+  EmulatedBusCounters()
+      : frames(0), command_frames(0), data_frames(0), bytes(0), wire_time_ns(0),
+        onch_latches(0), comer_events(0) {}
+};
+
+/**
+ * @brief Writable device register image (what a differential test compares)
+ */
+struct EmulatedRegisterImage {
+  uint32_t status;                                 ///< STATUS bits 31:8 and ACTIVE
+  uint32_t cfg_ch[max22200::NUM_CHANNELS_];        ///< CFG_CH0..CFG_CH7
+  uint32_t cfg_dpm;                                ///< CFG_DPM
+
+  EmulatedRegisterImage() : status(0), cfg_ch{}, cfg_dpm(0) {}
+
+  bool operator==(const EmulatedRegisterImage &o) const {
+    if (status != o.status || cfg_dpm != o.cfg_dpm) return false;
+    for (uint8_t ch = 0; ch < max22200::NUM_CHANNELS_; ++ch) {
+      if (cfg_ch[ch] != o.cfg_ch[ch]) return false;
+    }
+    return true;
+  }
+  bool operator!=(const EmulatedRegisterImage &o) const { return !(*this == o); }
+};
+
+/**
+ * @brief Per-frame trace record handed to an optional frame observer
+ */
+struct EmulatedFrame {
+  uint64_t start_ns;   ///< Virtual time at CS falling edge
+  uint64_t end_ns;     ///< Virtual time at CS rising edge (data is latched here)
+  uint8_t  bank;       ///< Register bank addressed (last command for data frames)
+  uint8_t  length;     ///< Frame length in bytes
+  bool     command;    ///< true = Command Register frame (CMD ACTIVE)
+  bool     write;      ///< Latched command was a write
+  bool     mode8;      ///< Latched command was an 8-bit access
+  bool     onch_latch; ///< This frame latched a new ONCH value
+  uint8_t  onch;       ///< ONCH after the frame
+};
+
+/**
+ * @class EmulatedMax22200Bus
+ * @brief SpiInterface implementation backed by an in-memory MAX22200 model
+ */
+class EmulatedMax22200Bus : public max22200::SpiInterface<EmulatedMax22200Bus> {
+public:
+  using FrameObserver = void (*)(const EmulatedFrame &frame, void *user_data);
+
+  /**
+   * @param selective_clear true = MAX22200A (SDI selects FAULT bits to clear),
+   *                        false = MAX22200 (any FAULT read clears everything)
+   */
+  explicit EmulatedMax22200Bus(bool selective_clear = true)
+      : selective_clear_(selective_clear), sclk_hz_(max22200::MAX_SPI_FREQ_STANDALONE_),
+        frame_overhead_ns_(2000), now_ns_(0), clock_owner_(nullptr), enable_(false), cmd_(false),
+        command_valid_(false), command_bank_(0), command_write_(false), command_mode8_(false),
+        status_(0), cfg_ch_{}, cfg_dpm_(0), fault_(0), ovt_(false), uvm_(false),
+        comer_(false), injected_(0), coalesced_(0), counters_(), observer_(nullptr),
+        observer_user_data_(nullptr) {
+    powerOnReset();
+  }
+
+  // ── SpiInterface ────────────────────────────────────────────────────────
+
+  bool Initialize() { return true; }
+
+  bool Configure(uint32_t speed_hz, uint8_t mode, bool msb_first = true) {
+    if (speed_hz == 0 || mode != 0 || !msb_first) {
+      return false;
+    }
+    sclk_hz_ = speed_hz;
+    return true;
+  }
+
+  bool IsReady() const { return true; }
+
+  void SetChipSelect(bool) {}
+
+  void DelayUs(uint32_t us) { clockNs() += static_cast<uint64_t>(us) * 1000u; }
+
+  uint32_t GetTimeUs() { return static_cast<uint32_t>(clockNs() / 1000u); }
+
+  void GpioSet(max22200::CtrlPin pin, max22200::GpioSignal signal) {
+    const bool active = (signal == max22200::GpioSignal::ACTIVE);
+    if (pin == max22200::CtrlPin::ENABLE) {
+      if (enable_ && !active) {
+        powerOnReset();  // ENABLE low puts the IC in sleep; registers return to reset values
+      }
+      enable_ = active;
+    } else if (pin == max22200::CtrlPin::CMD) {
+      cmd_ = active;
+    }
+  }
+
+  bool GpioRead(max22200::CtrlPin pin, max22200::GpioSignal &signal) {
+    if (pin == max22200::CtrlPin::FAULT) {
+      signal = faultPinAsserted() ? max22200::GpioSignal::ACTIVE : max22200::GpioSignal::INACTIVE;
+    } else if (pin == max22200::CtrlPin::ENABLE) {
+      signal = enable_ ? max22200::GpioSignal::ACTIVE : max22200::GpioSignal::INACTIVE;
+    } else {
+      signal = cmd_ ? max22200::GpioSignal::ACTIVE : max22200::GpioSignal::INACTIVE;
+    }
+    return true;
+  }
+
+  bool Transfer(const uint8_t *tx_data, uint8_t *rx_data, size_t length) {
+    if (tx_data == nullptr || rx_data == nullptr || length == 0) {
+      return false;
+    }
+    EmulatedFrame frame{};
+    frame.start_ns = clockNs();
+    frame.length = static_cast<uint8_t>(length);
+    frame.command = cmd_;
+
+    if (!enable_) {
+      for (size_t i = 0; i < length; ++i) rx_data[i] = 0xFF;  // SDO pulled up, device asleep
+    } else if (cmd_) {
+      commandFrame(tx_data, rx_data, length);
+    } else {
+      frame.onch_latch = dataFrame(tx_data, rx_data, length);
+    }
+
+    clockNs() += frameTimeNs(length);
+    counters_.frames++;
+    counters_.bytes += length;
+    counters_.wire_time_ns += frameTimeNs(length);
+    if (cmd_) {
+      counters_.command_frames++;
+    } else {
+      counters_.data_frames++;
+    }
+    if (frame.onch_latch) {
+      counters_.onch_latches++;
+    }
+
+    if (observer_ != nullptr) {
+      frame.end_ns = clockNs();
+      frame.bank = command_bank_;
+      frame.write = command_write_;
+      frame.mode8 = command_mode8_;
+      frame.onch = onch();
+      observer_(frame, observer_user_data_);
+    }
+    return true;
+  }
+
+  // ── Fault injection ─────────────────────────────────────────────────────
+
+  /**
+   * @brief Raise a fault as the device would
+   *
+   * OCP/HHF/OLF/DPM set the channel's FAULT bit; OVT/UVM/COMER set the
+   * corresponding STATUS latch. A fault raised on a bit that is already set is
+   * merged by the hardware and counted as coalesced (the event is lost to
+   * software).
+   *
+   * @return true if the event produced a new flag, false if it was coalesced
+   */
+  bool InjectFault(max22200::FaultType type, uint8_t channel) {
+    injected_++;
+    bool fresh = true;
+    switch (type) {
+      case max22200::FaultType::OCP:
+      case max22200::FaultType::HHF:
+      case max22200::FaultType::OLF:
+      case max22200::FaultType::DPM: {
+        const uint32_t bit = faultBit(type, channel);
+        fresh = (fault_ & bit) == 0;
+        fault_ |= bit;
+        break;
+      }
+      case max22200::FaultType::OVT:
+        fresh = !ovt_;
+        ovt_ = true;
+        break;
+      case max22200::FaultType::UVM:
+        fresh = !uvm_;
+        uvm_ = true;
+        break;
+      case max22200::FaultType::COMER:
+        fresh = !comer_;
+        comer_ = true;
+        break;
+      default:
+        break;
+    }
+    if (!fresh) {
+      coalesced_++;
+    }
+    return fresh;
+  }
+
+  /** @brief FAULT register bit for a per-channel fault type */
+  static uint32_t faultBit(max22200::FaultType type, uint8_t channel) {
+    static constexpr uint32_t kShift[4] = {max22200::FaultReg::OCP_SHIFT, max22200::FaultReg::HHF_SHIFT,
+                                           max22200::FaultReg::OLF_SHIFT, max22200::FaultReg::DPM_SHIFT};
+    return 1u << (kShift[static_cast<uint8_t>(type) & 0x03u] + (channel & 0x07u));
+  }
+
+  // ── Time ────────────────────────────────────────────────────────────────
+
+  /** @brief Virtual bus clock in nanoseconds */
+  uint64_t NowNs() const { return clock_owner_ != nullptr ? clock_owner_->now_ns_ : now_ns_; }
+
+  /** @brief Advance the virtual clock (idle time between driver calls) */
+  void AdvanceNs(uint64_t ns) { clockNs() += ns; }
+
+  /**
+   * @brief Run on @p owner's clock (devices on one SPI host, one CS each)
+   *
+   * Frames to either device then advance the same time, so sequences across
+   * devices are timed as one host would issue them. @p owner must not itself
+   * share another clock and must outlive this bus; nullptr restores the own
+   * clock.
+   */
+  void ShareClock(EmulatedMax22200Bus *owner) { clock_owner_ = owner; }
+
+  /** @brief Per-frame overhead added to the wire time (default 2 µs) */
+  void SetFrameOverheadNs(uint32_t ns) { frame_overhead_ns_ = ns; }
+
+  uint32_t GetSclkHz() const { return sclk_hz_; }
+
+  // ── Inspection ──────────────────────────────────────────────────────────
+
+  /** @brief Full STATUS word as a 32-bit read would return it (no side effects) */
+  uint32_t PeekStatus() const { return status_ | flagsByte(); }
+  uint32_t PeekFault() const { return fault_; }
+  uint32_t PeekChannelConfig(uint8_t ch) const { return cfg_ch_[ch & 0x07u]; }
+  uint32_t PeekDpmConfig() const { return cfg_dpm_; }
+  uint8_t onch() const { return static_cast<uint8_t>(status_ >> max22200::StatusReg::ONCH_SHIFT); }
+  bool faultPinAsserted() const;
+
+  EmulatedRegisterImage GetRegisterImage() const {
+    EmulatedRegisterImage img;
+    img.status = status_;
+    for (uint8_t ch = 0; ch < max22200::NUM_CHANNELS_; ++ch) img.cfg_ch[ch] = cfg_ch_[ch];
+    img.cfg_dpm = cfg_dpm_;
+    return img;
+  }
+
+  const EmulatedBusCounters &GetCounters() const { return counters_; }
+  void ResetCounters() { counters_ = EmulatedBusCounters(); }
+
+  uint64_t GetInjectedFaults() const { return injected_; }
+  uint64_t GetCoalescedFaults() const { return coalesced_; }
+
+  void SetFrameObserver(FrameObserver observer, void *user_data) {
+    observer_ = observer;
+    observer_user_data_ = user_data;
+  }
+
+private:
+  static constexpr uint32_t kStatusWritableMask = 0xFFFFFF00u | max22200::StatusReg::ACTIVE_BIT;
+  static constexpr uint32_t kDpmWritableMask = 0x00007FFFu;
+
+  uint64_t &clockNs() { return clock_owner_ != nullptr ? clock_owner_->now_ns_ : now_ns_; }
+
+  void powerOnReset() {
+    status_ = max22200::StatusReg::M_COMF_BIT;  // M_COMF = 1, everything else 0 at POR
+    for (uint8_t ch = 0; ch < max22200::NUM_CHANNELS_; ++ch) cfg_ch_[ch] = 0;
+    cfg_dpm_ = 0;
+    fault_ = 0;
+    ovt_ = false;
+    uvm_ = true;  // UVM is set at power-up and cleared by the first STATUS read
+    comer_ = false;
+    command_valid_ = false;
+  }
+
+  uint8_t flagsByte() const {
+    uint8_t b = 0;
+    if (ovt_) b |= max22200::StatusReg::OVT_BIT;
+    if (fault_ & max22200::FaultReg::OCP_MASK) b |= max22200::StatusReg::OCP_BIT;
+    if (fault_ & max22200::FaultReg::OLF_MASK) b |= max22200::StatusReg::OLF_BIT;
+    if (fault_ & max22200::FaultReg::HHF_MASK) b |= max22200::StatusReg::HHF_BIT;
+    if (fault_ & max22200::FaultReg::DPM_MASK) b |= max22200::StatusReg::DPM_BIT;
+    if (comer_) b |= max22200::StatusReg::COMER_BIT;
+    if (uvm_) b |= max22200::StatusReg::UVM_BIT;
+    if (status_ & max22200::StatusReg::ACTIVE_BIT) b |= max22200::StatusReg::ACTIVE_BIT;
+    return b;
+  }
+
+  uint64_t frameTimeNs(size_t length) const {
+    return frame_overhead_ns_ + (static_cast<uint64_t>(length) * 8u * 1000000000u) / sclk_hz_;
+  }
+
+  void commandFrame(const uint8_t *tx, uint8_t *rx, size_t length) {
+    rx[0] = flagsByte();
+    for (size_t i = 1; i < length; ++i) rx[i] = 0;
+    const uint8_t bank = (tx[0] & max22200::CommandReg::A_BNK_MASK) >> max22200::CommandReg::A_BNK_POS;
+    if (length != 1 || bank > max22200::RegBank::CFG_DPM || (tx[0] & 0x60u) != 0) {
+      comer_ = true;
+      command_valid_ = false;
+      counters_.comer_events++;
+      return;
+    }
+    command_valid_ = true;
+    command_bank_ = bank;
+    command_write_ = (tx[0] & max22200::CommandReg::RBW_WRITE) != 0;
+    command_mode8_ = (tx[0] & max22200::CommandReg::MODE_8BIT) != 0;
+  }
+
+  /** @return true when the frame latched a new STATUS (ONCH) value */
+  bool dataFrame(const uint8_t *tx, uint8_t *rx, size_t length) {
+    const size_t expected = command_mode8_ ? 1u : 4u;
+    if (!command_valid_ || length != expected) {
+      for (size_t i = 0; i < length; ++i) rx[i] = 0;
+      comer_ = true;
+      counters_.comer_events++;
+      return false;
+    }
+
+    if (command_write_) {
+      if (command_mode8_) {
+        rx[0] = flagsByte();
+        writeRegister(command_bank_, static_cast<uint32_t>(tx[0]) << 24, 0xFF000000u);
+      } else {
+        rx[0] = flagsByte();
+        rx[1] = latchedCommand();
+        rx[2] = 0;
+        rx[3] = 0;
+        const uint32_t value = static_cast<uint32_t>(tx[0]) | (static_cast<uint32_t>(tx[1]) << 8) |
+                               (static_cast<uint32_t>(tx[2]) << 16) |
+                               (static_cast<uint32_t>(tx[3]) << 24);
+        writeRegister(command_bank_, value, 0xFFFFFFFFu);
+      }
+      return command_bank_ == max22200::RegBank::STATUS;
+    }
+
+    const uint32_t value = readRegister(command_bank_, tx, length);
+    if (command_mode8_) {
+      rx[0] = static_cast<uint8_t>(value >> 24);
+    } else {
+      rx[0] = static_cast<uint8_t>(value >> 24);
+      rx[1] = static_cast<uint8_t>(value >> 16);
+      rx[2] = static_cast<uint8_t>(value >> 8);
+      rx[3] = static_cast<uint8_t>(value);
+    }
+    return false;
+  }
+
+  uint8_t latchedCommand() const {
+    return max22200::CommandReg::build(command_bank_, command_write_, command_mode8_);
+  }
+
+  void writeRegister(uint8_t bank, uint32_t value, uint32_t byte_mask) {
+    if (bank == max22200::RegBank::STATUS) {
+      const uint32_t mask = byte_mask & kStatusWritableMask;
+      status_ = (status_ & ~mask) | (value & mask);
+    } else if (bank >= max22200::RegBank::CFG_CH0 && bank <= max22200::RegBank::CFG_CH7) {
+      uint32_t &reg = cfg_ch_[bank - max22200::RegBank::CFG_CH0];
+      reg = (reg & ~byte_mask) | (value & byte_mask);
+    } else if (bank == max22200::RegBank::CFG_DPM) {
+      const uint32_t mask = byte_mask & kDpmWritableMask;
+      cfg_dpm_ = (cfg_dpm_ & ~mask) | (value & mask);
+    }
+    // FAULT is read-only; writes are ignored
+  }
+
+  uint32_t readRegister(uint8_t bank, const uint8_t *tx, size_t length) {
+    if (bank == max22200::RegBank::STATUS) {
+      const uint32_t value = status_ | flagsByte();
+      uvm_ = false;  // Reading STATUS clears UVM and COMER
+      comer_ = false;
+      ovt_ = false;
+      return value;
+    }
+    if (bank >= max22200::RegBank::CFG_CH0 && bank <= max22200::RegBank::CFG_CH7) {
+      return cfg_ch_[bank - max22200::RegBank::CFG_CH0];
+    }
+    if (bank == max22200::RegBank::CFG_DPM) {
+      return cfg_dpm_;
+    }
+    // FAULT: clear-on-read. SDI carries OCP, HHF, OLF, DPM clear masks in that order.
+    const uint32_t value = fault_;
+    if (!selective_clear_) {
+      fault_ = 0;
+    } else if (length == 4) {
+      const uint32_t clear = (static_cast<uint32_t>(tx[0]) << max22200::FaultReg::OCP_SHIFT) |
+                             (static_cast<uint32_t>(tx[1]) << max22200::FaultReg::HHF_SHIFT) |
+                             (static_cast<uint32_t>(tx[2]) << max22200::FaultReg::OLF_SHIFT) |
+                             (static_cast<uint32_t>(tx[3]) << max22200::FaultReg::DPM_SHIFT);
+      fault_ &= ~clear;
+    } else {
+      fault_ &= ~(static_cast<uint32_t>(tx[0]) << max22200::FaultReg::OCP_SHIFT);
+    }
+    return value;
+  }
+
+  bool selective_clear_;
+  uint32_t sclk_hz_;
+  uint32_t frame_overhead_ns_;
+  uint64_t now_ns_;
+  EmulatedMax22200Bus *clock_owner_;  ///< Shared clock (nullptr = now_ns_)
+
+  bool enable_;
+  bool cmd_;
+  bool command_valid_;
+  uint8_t command_bank_;
+  bool command_write_;
+  bool command_mode8_;
+
+  uint32_t status_;  ///< STATUS bits 31:8 + ACTIVE (flags are derived)
+  uint32_t cfg_ch_[max22200::NUM_CHANNELS_];
+  uint32_t cfg_dpm_;
+  uint32_t fault_;
+  bool ovt_;
+  bool uvm_;
+  bool comer_;
+
+  uint64_t injected_;
+  uint64_t coalesced_;
+  EmulatedBusCounters counters_;
+  FrameObserver observer_;
+  void *observer_user_data_;
+};
+
+inline bool EmulatedMax22200Bus::faultPinAsserted() const {
+  using namespace max22200;
+  const uint32_t s = status_;
+  return (ovt_ && !(s & StatusReg::M_OVT_BIT)) ||
+         ((fault_ & FaultReg::OCP_MASK) && !(s & StatusReg::M_OCP_BIT)) ||
+         ((fault_ & FaultReg::OLF_MASK) && !(s & StatusReg::M_OLF_BIT)) ||
+         ((fault_ & FaultReg::HHF_MASK) && !(s & StatusReg::M_HHF_BIT)) ||
+         ((fault_ & FaultReg::DPM_MASK) && !(s & StatusReg::M_DPM_BIT)) ||
+         (comer_ && !(s & StatusReg::M_COMF_BIT)) || (uvm_ && !(s & StatusReg::M_UVM_BIT));
+}
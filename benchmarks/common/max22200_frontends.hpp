@@ -0,0 +1,278 @@
+/**
+ * @file max22200_frontends.hpp
+ * @brief Driver front-ends that replay a Workload (header-only)
+ *
+ * A front-end maps each WorkloadStep onto driver calls. Two front-ends given
+ * the same workload must leave the device in the same register state; the
+ * differential benchmark checks exactly that while counting what each one
+ * cost on the bus and on the host. A front-end provides:
+ *
+ *   static const char *Name();
+ *   template <typename Driver> DriverStatus Begin(Driver &);
+ *   template <typename Driver> DriverStatus Apply(Driver &, const WorkloadStep &);
+ *
+ * New driver features (caches, batched writes, integer paths) get their own
+ * front-end here and are then compared against DirectFrontEnd. CachedFrontEnd
+ * covers the driver-internal ones: Initialize(DeviceImage), the max_age_us
+ * STATUS / FAULT caches and the CFG_CHx shadow (GetCachedChannelRegister).
+ * ReadSnapshot() is not used: the workload issues STATUS and FAULT polls as
+ * separate steps.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+
+#include "max22200.hpp"
+#include "common/max22200_workload.hpp"
+
+/**
+ * @brief Operations every front-end issues the same way (polls, DPM)
+ *
+ * @return true if the step was handled, with the driver result in @p status
+ */
+template <typename Driver>
+inline bool ApplyCommonStep(Driver &driver, const WorkloadStep &s, max22200::DriverStatus &status) {
+  using namespace max22200;
+  switch (s.op) {
+    case WorkloadOp::READ_STATUS: {
+      StatusConfig st;
+      status = driver.ReadStatus(st);
+      return true;
+    }
+    case WorkloadOp::READ_FAULT: {
+      FaultStatus f;
+      status = driver.ReadFaultRegister(f);
+      return true;
+    }
+    case WorkloadOp::READ_ALL_CONFIGS: {
+      ChannelConfigArray cfgs;
+      status = driver.GetAllChannelConfigs(cfgs);
+      return true;
+    }
+    case WorkloadOp::CONFIGURE_DPM:
+      status = driver.ConfigureDpm(static_cast<float>(s.value), static_cast<float>(s.value2),
+                                   static_cast<float>(s.aux) / 1000.0f);
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ * @brief Baseline: one convenience API per step, exactly as the examples use it
+ *
+ * Toggles go through SetChannelEnabled (full ONCH write each time) and
+ * setpoint changes through SetHitCurrentMa / SetHoldCurrentMa / SetHitTimeMs
+ * (read-modify-write of CFG_CHx).
+ */
+struct DirectFrontEnd {
+  static const char *Name() { return "direct"; }
+
+  template <typename Driver>
+  max22200::DriverStatus Begin(Driver &) { return max22200::DriverStatus::OK; }
+
+  template <typename Driver>
+  max22200::DriverStatus Apply(Driver &driver, const WorkloadStep &s) {
+    using namespace max22200;
+    DriverStatus status = DriverStatus::OK;
+    if (ApplyCommonStep(driver, s, status)) {
+      return status;
+    }
+    switch (s.op) {
+      case WorkloadOp::SET_CHANNELS_ON:
+        return driver.SetChannelsOn(s.mask);
+      case WorkloadOp::SET_CHANNEL:
+        return driver.SetChannelEnabled(s.channel, s.value != 0);
+      case WorkloadOp::SET_HIT_CURRENT:
+        return driver.SetHitCurrentMa(s.channel, s.value);
+      case WorkloadOp::SET_HOLD_CURRENT:
+        return driver.SetHoldCurrentMa(s.channel, s.value);
+      case WorkloadOp::SET_HIT_TIME:
+        return driver.SetHitTimeMs(s.channel, static_cast<float>(s.value) / 1000.0f);
+      case WorkloadOp::CONFIGURE_CDR:
+        return driver.ConfigureChannelCdr(s.channel, s.value, s.value2, static_cast<float>(s.aux));
+      default:
+        return DriverStatus::INVALID_PARAMETER;
+    }
+  }
+};
+
+/**
+ * @brief Application-side shadow: keep ONCH and CFG_CHx in RAM, write only
+ *
+ * Reads every channel config once in Begin(), then serves setpoint changes
+ * from the shadow with a single ConfigureChannel (no read-back) and skips
+ * ONCH writes that would not change the mask. This is the application
+ * keeping its own copy; CachedFrontEnd uses the driver's caches instead.
+ */
+struct ShadowFrontEnd {
+  static const char *Name() { return "shadow"; }
+
+  template <typename Driver>
+  max22200::DriverStatus Begin(Driver &driver) {
+    using namespace max22200;
+    StatusConfig st;
+    DriverStatus status = driver.ReadStatus(st);
+    if (status != DriverStatus::OK) {
+      return status;
+    }
+    onch_ = st.channels_on_mask;
+    ChannelConfigArray cfgs;
+    status = driver.GetAllChannelConfigs(cfgs);
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+      cfg_[ch] = cfgs[ch];
+    }
+    return status;
+  }
+
+  template <typename Driver>
+  max22200::DriverStatus Apply(Driver &driver, const WorkloadStep &s) {
+    using namespace max22200;
+    DriverStatus status = DriverStatus::OK;
+    if (ApplyCommonStep(driver, s, status)) {
+      return status;
+    }
+    if (s.op != WorkloadOp::SET_CHANNELS_ON && !Driver::IsValidChannel(s.channel)) {
+      return DriverStatus::INVALID_PARAMETER;
+    }
+    const uint32_t max_ma = driver.GetBoardConfig().max_current_ma;
+    auto clamp_ma = [max_ma](uint32_t ma) { return (max_ma > 0 && ma > max_ma) ? max_ma : ma; };
+
+    switch (s.op) {
+      case WorkloadOp::SET_CHANNELS_ON:
+        return setOnch(driver, s.mask);
+      case WorkloadOp::SET_CHANNEL: {
+        const uint8_t bit = static_cast<uint8_t>(1u << s.channel);
+        return setOnch(driver, s.value != 0 ? static_cast<uint8_t>(onch_ | bit)
+                                            : static_cast<uint8_t>(onch_ & ~bit));
+      }
+      case WorkloadOp::SET_HIT_CURRENT: {
+        ChannelConfig c = cfg_[s.channel];
+        c.drive_mode = DriveMode::CDR;
+        c.hit_setpoint = static_cast<float>(clamp_ma(s.value));
+        return configure(driver, s.channel, c);
+      }
+      case WorkloadOp::SET_HOLD_CURRENT: {
+        ChannelConfig c = cfg_[s.channel];
+        c.drive_mode = DriveMode::CDR;
+        c.hold_setpoint = static_cast<float>(clamp_ma(s.value));
+        return configure(driver, s.channel, c);
+      }
+      case WorkloadOp::SET_HIT_TIME: {
+        ChannelConfig c = cfg_[s.channel];
+        c.hit_time_ms = static_cast<float>(s.value) / 1000.0f;
+        return configure(driver, s.channel, c);
+      }
+      case WorkloadOp::CONFIGURE_CDR: {
+        ChannelConfig c;
+        c.drive_mode = DriveMode::CDR;
+        c.hit_setpoint = static_cast<float>(clamp_ma(s.value));
+        c.hold_setpoint = static_cast<float>(clamp_ma(s.value2));
+        c.hit_time_ms = static_cast<float>(s.aux);
+        return configure(driver, s.channel, c);
+      }
+      default:
+        return DriverStatus::INVALID_PARAMETER;
+    }
+  }
+
+private:
+  template <typename Driver>
+  max22200::DriverStatus setOnch(Driver &driver, uint8_t mask) {
+    if (mask == onch_) {
+      return max22200::DriverStatus::OK;
+    }
+    const max22200::DriverStatus status = driver.SetChannelsOn(mask);
+    if (status == max22200::DriverStatus::OK) {
+      onch_ = mask;
+    }
+    return status;
+  }
+
+  template <typename Driver>
+  max22200::DriverStatus configure(Driver &driver, uint8_t channel, const max22200::ChannelConfig &c) {
+    const max22200::DriverStatus status = driver.ConfigureChannel(channel, c);
+    if (status == max22200::DriverStatus::OK) {
+      cfg_[channel] = c;
+    }
+    return status;
+  }
+
+  uint8_t onch_ = 0;
+  max22200::ChannelConfig cfg_[max22200::NUM_CHANNELS_];
+};
+
+/**
+ * @brief Driver-side caches: image boot, max_age_us polls, CFG_CHx shadow
+ *
+ * Begin() reads the device state back into a DeviceImage and reloads it with
+ * Initialize(DeviceImage). STATUS and FAULT polls accept an observation up to
+ * kMaxAgeUs old. Current setpoint changes decode the CFG_CHx shadow instead
+ * of reading the register back, and fall back to the convenience API when
+ * the shadow is empty. Everything else is issued as DirectFrontEnd does.
+ */
+struct CachedFrontEnd {
+  static constexpr uint32_t kMaxAgeUs = 1000;  ///< Poll results reused for 1 ms
+
+  static const char *Name() { return "cached"; }
+
+  template <typename Driver>
+  max22200::DriverStatus Begin(Driver &driver) {
+    using namespace max22200;
+    DeviceImage image;
+    DriverStatus status = driver.ReadStatus(image.status);
+    if (status == DriverStatus::OK) status = driver.GetAllChannelConfigs(image.channels);
+    if (status == DriverStatus::OK) status = driver.ReadDpmConfig(image.dpm);
+    if (status != DriverStatus::OK) {
+      return status;
+    }
+    return driver.Initialize(image);
+  }
+
+  template <typename Driver>
+  max22200::DriverStatus Apply(Driver &driver, const WorkloadStep &s) {
+    using namespace max22200;
+    switch (s.op) {
+      case WorkloadOp::READ_STATUS: {
+        StatusConfig st;
+        return driver.ReadStatus(st, kMaxAgeUs);
+      }
+      case WorkloadOp::READ_FAULT: {
+        FaultStatus f;
+        return driver.ReadFaultRegister(f, kMaxAgeUs);
+      }
+      case WorkloadOp::SET_HIT_CURRENT:
+      case WorkloadOp::SET_HOLD_CURRENT: {
+        ChannelConfig c;
+        if (!fromShadow(driver, s.channel, c)) break;
+        const uint32_t max_ma = driver.GetBoardConfig().max_current_ma;
+        const uint32_t ma = (max_ma > 0 && s.value > max_ma) ? max_ma : s.value;
+        c.drive_mode = DriveMode::CDR;
+        (s.op == WorkloadOp::SET_HIT_CURRENT ? c.hit_setpoint : c.hold_setpoint) =
+            static_cast<float>(ma);
+        return driver.ConfigureChannel(s.channel, c);
+      }
+      default:
+        break;
+    }
+    return direct_.Apply(driver, s);
+  }
+
+private:
+  /** @brief Decode channel @p channel from the driver's CFG_CHx shadow */
+  template <typename Driver>
+  static bool fromShadow(Driver &driver, uint8_t channel, max22200::ChannelConfig &c) {
+    using namespace max22200;
+    uint32_t raw = 0;
+    StatusConfig st;
+    if (driver.GetBoardConfig().full_scale_current_ma == 0 ||
+        driver.GetCachedChannelRegister(channel, raw) != DriverStatus::OK ||
+        driver.ReadStatus(st, UINT32_MAX) != DriverStatus::OK) {
+      return false;
+    }
+    c.fromRegister(raw, driver.GetBoardConfig().full_scale_current_ma, st.master_clock_80khz);
+    return true;
+  }
+
+  DirectFrontEnd direct_;
+};
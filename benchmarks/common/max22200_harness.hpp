@@ -0,0 +1,152 @@
+/**
+ * @file max22200_harness.hpp
+ * @brief Front-end runner: driver + emulated device + timed workload replay
+ *
+ * FrontEndRunner owns one EmulatedMax22200Bus and one driver and feeds
+ * WorkloadSteps to a front-end, advancing the emulator's virtual clock to
+ * each step's scheduled time first. Steps that are due while the bus is still
+ * busy run late; the lag is recorded. Host CPU spent inside the front-end and
+ * per-op counts are tallied. MakeFrontEndRunner() is the front-end registry
+ * shared by the benchmarks.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+
+#include "common/max22200_emulated_bus.hpp"
+#include "common/max22200_frontends.hpp"
+#include "common/max22200_workload.hpp"
+#include "max22200.hpp"
+#include <chrono>
+#include <cstring>
+#include <memory>
+
+/**
+ * @brief Bus / board settings for a FrontEndRunner
+ */
+struct HarnessConfig {
+  uint32_t ifs_ma;            ///< Board full-scale current
+  uint32_t sclk_hz;           ///< SPI clock
+  uint32_t frame_overhead_ns; ///< CS / CMD handling per frame
+
+  HarnessConfig() : ifs_ma(500), sclk_hz(max22200::MAX_SPI_FREQ_STANDALONE_), frame_overhead_ns(2000) {}
+};
+
+/**
+ * @brief Type-erased runner for one front-end
+ */
+class FrontEndRunner {
+public:
+  using Driver = max22200::MAX22200<EmulatedMax22200Bus>;
+
+  virtual ~FrontEndRunner() = default;
+  virtual const char *Name() const = 0;
+
+  /**
+   * @brief Initialize the driver on a fresh device, then the front-end
+   *
+   * Bus counters and the schedule origin are reset after driver bring-up so
+   * only front-end traffic is counted.
+   */
+  bool Initialize(const HarnessConfig &cfg) {
+    bus_.SetFrameOverheadNs(cfg.frame_overhead_ns);
+    max22200::BoardConfig board;
+    board.full_scale_current_ma = cfg.ifs_ma;
+    driver_.SetBoardConfig(board);
+    if (driver_.Initialize() != max22200::DriverStatus::OK ||
+        !bus_.Configure(cfg.sclk_hz, 0, true)) {
+      return false;
+    }
+    bus_.ResetCounters();
+    origin_ns_ = bus_.NowNs();
+    return timed([&] { return begin(); }) == max22200::DriverStatus::OK;
+  }
+
+  /**
+   * @brief Run one step at its scheduled time (or as soon as the bus is free)
+   */
+  max22200::DriverStatus Apply(const WorkloadStep &step) {
+    const uint64_t due_ns = origin_ns_ + step.t_us * 1000u;
+    if (bus_.NowNs() < due_ns) {
+      bus_.AdvanceNs(due_ns - bus_.NowNs());
+    } else if (bus_.NowNs() - due_ns > max_lag_ns_) {
+      max_lag_ns_ = bus_.NowNs() - due_ns;
+    }
+    const max22200::DriverStatus status = timed([&] { return apply(step); });
+    op_counts_[static_cast<uint8_t>(step.op)]++;
+    if (status != max22200::DriverStatus::OK) failed_steps_++;
+    return status;
+  }
+
+  /** @brief Apply every step of @p w in order; returns the number rejected */
+  uint64_t Replay(const Workload &w) {
+    const uint64_t before = failed_steps_;
+    for (const WorkloadStep &s : w) Apply(s);
+    return failed_steps_ - before;
+  }
+
+  const EmulatedMax22200Bus &Bus() const { return bus_; }
+  const Driver &GetDriver() const { return driver_; }
+  uint64_t HostNs() const { return static_cast<uint64_t>(host_.count()); }
+  uint64_t ElapsedNs() const { return bus_.NowNs() - origin_ns_; }
+  uint64_t MaxLagNs() const { return max_lag_ns_; }
+  uint64_t FailedSteps() const { return failed_steps_; }
+  uint64_t OpCount(WorkloadOp op) const { return op_counts_[static_cast<uint8_t>(op)]; }
+
+protected:
+  FrontEndRunner()
+      : bus_(), driver_(bus_), host_(0), origin_ns_(0), max_lag_ns_(0), failed_steps_(0),
+        op_counts_{} {}
+
+  virtual max22200::DriverStatus begin() = 0;
+  virtual max22200::DriverStatus apply(const WorkloadStep &step) = 0;
+
+  EmulatedMax22200Bus bus_;
+  Driver driver_;
+
+private:
+  template <typename Fn>
+  max22200::DriverStatus timed(Fn &&fn) {
+    const auto t0 = std::chrono::steady_clock::now();
+    const max22200::DriverStatus status = fn();
+    host_ += std::chrono::steady_clock::now() - t0;
+    return status;
+  }
+
+  std::chrono::nanoseconds host_;
+  uint64_t origin_ns_;
+  uint64_t max_lag_ns_;
+  uint64_t failed_steps_;
+  uint64_t op_counts_[WORKLOAD_OP_COUNT];
+};
+
+template <typename FrontEnd>
+class FrontEndRunnerImpl : public FrontEndRunner {
+public:
+  const char *Name() const override { return FrontEnd::Name(); }
+
+protected:
+  max22200::DriverStatus begin() override { return fe_.Begin(driver_); }
+  max22200::DriverStatus apply(const WorkloadStep &step) override { return fe_.Apply(driver_, step); }
+
+private:
+  FrontEnd fe_;
+};
+
+/// Names accepted by MakeFrontEndRunner(); add new front-ends here and below.
+inline const char *const FRONT_END_NAMES[] = {DirectFrontEnd::Name(), ShadowFrontEnd::Name(),
+                                              CachedFrontEnd::Name()};
+
+/** @brief Runner for front-end @p name, or nullptr if unknown */
+inline std::unique_ptr<FrontEndRunner> MakeFrontEndRunner(const char *name) {
+  if (std::strcmp(name, DirectFrontEnd::Name()) == 0) {
+    return std::make_unique<FrontEndRunnerImpl<DirectFrontEnd>>();
+  }
+  if (std::strcmp(name, ShadowFrontEnd::Name()) == 0) {
+    return std::make_unique<FrontEndRunnerImpl<ShadowFrontEnd>>();
+  }
+  if (std::strcmp(name, CachedFrontEnd::Name()) == 0) {
+    return std::make_unique<FrontEndRunnerImpl<CachedFrontEnd>>();
+  }
+  return nullptr;
+}
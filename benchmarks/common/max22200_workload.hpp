@@ -0,0 +1,443 @@
+/**
+ * @file max22200_workload.hpp
+ * @brief Deterministic API workloads for the host benchmarks (header-only)
+ *
+ * A workload is a flat list of WorkloadStep records, each naming one
+ * application-level operation (toggle, setpoint change, poll, DPM
+ * reconfiguration) and when it is issued. Benchmarks replay the same list
+ * through different driver front-ends (see max22200_frontends.hpp) so their
+ * bus traffic and final register state can be compared like for like.
+ *
+ * GenerateWorkload() builds workloads from profiles modelled on the example
+ * programs (c21_cycle_test, c21_dpm_tuning_test, max22200_solenoid_valve_test)
+ * or from configurable per-class rates; LoadWorkloadCsv() replays a recorded
+ * trace. Everything is seeded, so a (profile, seed) pair is reproducible.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+
+#include "max22200_registers.hpp"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Application-level operation carried by a WorkloadStep
+ */
+enum class WorkloadOp : uint8_t {
+  SET_CHANNELS_ON = 0, ///< mask = new ONCH byte
+  SET_CHANNEL,         ///< channel, value = 1 (on) / 0 (off)
+  SET_HIT_CURRENT,     ///< channel, value = HIT current in mA
+  SET_HOLD_CURRENT,    ///< channel, value = HOLD current in mA
+  SET_HIT_TIME,        ///< channel, value = HIT time in µs
+  CONFIGURE_CDR,       ///< channel, value = HIT mA, value2 = HOLD mA, aux = HIT time in ms
+  READ_STATUS,         ///< STATUS poll
+  READ_FAULT,          ///< FAULT poll (clears flags)
+  READ_ALL_CONFIGS,    ///< Read all CFG_CHx (diagnostics page)
+  CONFIGURE_DPM        ///< value = ISTART mA, value2 = IPTH mA, aux = debounce in µs
+};
+
+/** @brief Short name for reports */
+inline const char *WorkloadOpToStr(WorkloadOp op) {
+  switch (op) {
+    case WorkloadOp::SET_CHANNELS_ON:  return "set_channels_on";
+    case WorkloadOp::SET_CHANNEL:      return "set_channel";
+    case WorkloadOp::SET_HIT_CURRENT:  return "set_hit_current";
+    case WorkloadOp::SET_HOLD_CURRENT: return "set_hold_current";
+    case WorkloadOp::SET_HIT_TIME:     return "set_hit_time";
+    case WorkloadOp::CONFIGURE_CDR:    return "configure_cdr";
+    case WorkloadOp::READ_STATUS:      return "read_status";
+    case WorkloadOp::READ_FAULT:       return "read_fault";
+    case WorkloadOp::READ_ALL_CONFIGS: return "read_all_configs";
+    case WorkloadOp::CONFIGURE_DPM:    return "configure_dpm";
+    default:                           return "unknown";
+  }
+}
+
+/** @brief Parse a WorkloadOpToStr() name; false if unknown */
+inline bool WorkloadOpFromStr(const char *name, WorkloadOp &op) {
+  for (uint8_t i = 0; i <= static_cast<uint8_t>(WorkloadOp::CONFIGURE_DPM); ++i) {
+    if (std::strcmp(name, WorkloadOpToStr(static_cast<WorkloadOp>(i))) == 0) {
+      op = static_cast<WorkloadOp>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+/** @brief Number of WorkloadOp values (for per-op tallies) */
+inline constexpr uint8_t WORKLOAD_OP_COUNT = static_cast<uint8_t>(WorkloadOp::CONFIGURE_DPM) + 1u;
+
+/**
+ * @brief One operation of a workload
+ */
+struct WorkloadStep {
+  uint64_t   t_us;    ///< Scheduled time from workload start (0 = back-to-back)
+  WorkloadOp op;      ///< Operation
+  uint8_t    channel; ///< Channel for per-channel operations
+  uint8_t    mask;    ///< Channel mask for SET_CHANNELS_ON
+  uint16_t   aux;     ///< Operation-specific (see WorkloadOp)
+  uint32_t   value;   ///< Operation-specific (see WorkloadOp)
+  uint32_t   value2;  ///< Operation-specific (see WorkloadOp)
+
+  WorkloadStep()
+      : t_us(0), op(WorkloadOp::READ_STATUS), channel(0), mask(0), aux(0), value(0), value2(0) {}
+  WorkloadStep(WorkloadOp o, uint8_t ch = 0, uint32_t v = 0, uint32_t v2 = 0, uint16_t a = 0)
+      : t_us(0), op(o), channel(ch), mask(0), aux(a), value(v), value2(v2) {}
+
+  static WorkloadStep channelsOn(uint8_t mask) {
+    WorkloadStep s(WorkloadOp::SET_CHANNELS_ON);
+    s.mask = mask;
+    return s;
+  }
+
+  /** @brief Same step scheduled at @p t */
+  WorkloadStep at(uint64_t t) const {
+    WorkloadStep s = *this;
+    s.t_us = t;
+    return s;
+  }
+};
+
+using Workload = std::vector<WorkloadStep>;
+
+/**
+ * @brief Seeded mixed workload: bring-up, then toggles, setpoints and polls
+ *
+ * Starts by configuring every channel in CDR (as the example programs do),
+ * then draws `steps` operations with a fixed mix: ~45 % channel toggles,
+ * ~20 % STATUS/FAULT polls, ~30 % setpoint/HIT-time changes and the rest
+ * diagnostics reads and DPM reconfiguration. Currents stay below `ifs_ma`.
+ */
+inline Workload MakeScriptedWorkload(uint32_t seed, uint32_t steps, uint32_t ifs_ma = 500) {
+  Workload w;
+  w.reserve(steps + max22200::NUM_CHANNELS_ + 1u);
+  for (uint8_t ch = 0; ch < max22200::NUM_CHANNELS_; ++ch) {
+    w.emplace_back(WorkloadOp::CONFIGURE_CDR, ch, ifs_ma / 5u, ifs_ma / 10u, 100);
+  }
+  w.emplace_back(WorkloadOp::CONFIGURE_DPM, 0, ifs_ma / 10u, ifs_ma / 50u, 1000);
+
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<uint32_t> pct(0, 99);
+  std::uniform_int_distribution<uint32_t> chan(0, max22200::NUM_CHANNELS_ - 1u);
+  std::uniform_int_distribution<uint32_t> byte(0, 255);
+  std::uniform_int_distribution<uint32_t> ma(0, ifs_ma - 1u);
+  std::uniform_int_distribution<uint32_t> hit_us(1000, 100000);
+
+  for (uint32_t i = 0; i < steps; ++i) {
+    const uint32_t p = pct(rng);
+    const uint8_t ch = static_cast<uint8_t>(chan(rng));
+    if (p < 25) {
+      w.emplace_back(WorkloadOp::SET_CHANNEL, ch, byte(rng) & 1u);
+    } else if (p < 45) {
+      w.push_back(WorkloadStep::channelsOn(static_cast<uint8_t>(byte(rng))));
+    } else if (p < 55) {
+      w.emplace_back(WorkloadOp::READ_STATUS);
+    } else if (p < 65) {
+      w.emplace_back(WorkloadOp::READ_FAULT);
+    } else if (p < 77) {
+      w.emplace_back(WorkloadOp::SET_HOLD_CURRENT, ch, ma(rng));
+    } else if (p < 87) {
+      w.emplace_back(WorkloadOp::SET_HIT_CURRENT, ch, ma(rng));
+    } else if (p < 92) {
+      w.emplace_back(WorkloadOp::SET_HIT_TIME, ch, hit_us(rng));
+    } else if (p < 95) {
+      w.emplace_back(WorkloadOp::CONFIGURE_CDR, ch, ma(rng), ma(rng) / 2u,
+                     static_cast<uint16_t>(1u + pct(rng)));
+    } else if (p < 98) {
+      w.emplace_back(WorkloadOp::READ_ALL_CONFIGS);
+    } else {
+      w.emplace_back(WorkloadOp::CONFIGURE_DPM, 0, ma(rng) / 2u, ifs_ma / 50u,
+                     static_cast<uint16_t>(500u + 10u * pct(rng)));
+    }
+  }
+  return w;
+}
+
+// ============================================================================
+// Generator
+// ============================================================================
+
+/**
+ * @brief Traffic profile for GenerateWorkload()
+ */
+enum class WorkloadProfile : uint8_t {
+  MIXED = 0,      ///< MakeScriptedWorkload(): back-to-back, `steps` operations
+  C21_CYCLE,      ///< c21_cycle_test: CH0 2 s ON / 2 s OFF, STATUS + FAULT at 10 Hz
+  C21_DPM_TUNING, ///< c21_dpm_tuning_test: 500/500 ms cycle, 1 kHz FAULT + STATUS in windows
+  SOLENOID_VALVE, ///< max22200_solenoid_valve_test: sequential + parallel patterns, diagnostics
+  RATES           ///< Independent Poisson streams at WorkloadRates
+};
+
+/** @brief Short name for reports and command lines */
+inline const char *WorkloadProfileToStr(WorkloadProfile p) {
+  switch (p) {
+    case WorkloadProfile::MIXED:          return "mixed";
+    case WorkloadProfile::C21_CYCLE:      return "c21_cycle";
+    case WorkloadProfile::C21_DPM_TUNING: return "c21_dpm_tuning";
+    case WorkloadProfile::SOLENOID_VALVE: return "solenoid_valve";
+    case WorkloadProfile::RATES:          return "rates";
+    default:                              return "unknown";
+  }
+}
+
+/** @brief Parse a WorkloadProfileToStr() name; false if unknown */
+inline bool WorkloadProfileFromStr(const char *name, WorkloadProfile &p) {
+  for (uint8_t i = 0; i <= static_cast<uint8_t>(WorkloadProfile::RATES); ++i) {
+    if (std::strcmp(name, WorkloadProfileToStr(static_cast<WorkloadProfile>(i))) == 0) {
+      p = static_cast<WorkloadProfile>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Mean event rates for WorkloadProfile::RATES (events/s, 0 = off)
+ */
+struct WorkloadRates {
+  uint32_t toggle_hz;      ///< SET_CHANNEL / SET_CHANNELS_ON (1 in 4 is a full mask)
+  uint32_t setpoint_hz;    ///< SET_HIT_CURRENT / SET_HOLD_CURRENT / SET_HIT_TIME
+  uint32_t status_poll_hz; ///< READ_STATUS
+  uint32_t fault_poll_hz;  ///< READ_FAULT
+  uint32_t dpm_hz;         ///< CONFIGURE_DPM
+  uint8_t  channel_mask;   ///< Channels the toggles and setpoints touch
+
+  WorkloadRates()
+      : toggle_hz(200), setpoint_hz(20), status_poll_hz(100), fault_poll_hz(100), dpm_hz(1),
+        channel_mask(0xFF) {}
+};
+
+/**
+ * @brief GenerateWorkload() parameters
+ */
+struct WorkloadConfig {
+  WorkloadProfile profile; ///< Traffic profile
+  uint32_t duration_ms;    ///< Scheduled length (timed profiles)
+  uint32_t steps;          ///< Operation count (MIXED only)
+  uint32_t seed;           ///< RNG seed (MIXED and RATES)
+  uint32_t ifs_ma;         ///< Board full-scale current; setpoints stay below it
+  WorkloadRates rates;     ///< RATES only
+
+  WorkloadConfig()
+      : profile(WorkloadProfile::MIXED), duration_ms(60000), steps(20000), seed(0x22200u),
+        ifs_ma(500), rates() {}
+};
+
+/**
+ * @brief Build a workload for @p cfg, sorted by t_us
+ *
+ * Channel bring-up is always emitted first at t = 0. Timed profiles end at
+ * `duration_ms`; MIXED ignores it and issues `steps` operations back-to-back.
+ */
+inline Workload GenerateWorkload(const WorkloadConfig &cfg) {
+  if (cfg.profile == WorkloadProfile::MIXED) {
+    return MakeScriptedWorkload(cfg.seed, cfg.steps, cfg.ifs_ma);
+  }
+
+  Workload w;
+  const uint64_t end_us = static_cast<uint64_t>(cfg.duration_ms) * 1000u;
+  const uint32_t ifs = cfg.ifs_ma;
+
+  switch (cfg.profile) {
+    case WorkloadProfile::C21_CYCLE: {
+      // 102 mA hit / 51 mA hold / 100 ms on CH0; telemetry task at 10 Hz
+      w.emplace_back(WorkloadOp::CONFIGURE_CDR, 0, std::min<uint32_t>(102, ifs),
+                     std::min<uint32_t>(51, ifs), 100);
+      for (uint64_t t = 0; t < end_us; t += 100000u) {
+        w.push_back(WorkloadStep(WorkloadOp::READ_STATUS).at(t));
+        w.push_back(WorkloadStep(WorkloadOp::READ_FAULT).at(t));
+      }
+      for (uint64_t t = 100000u; t < end_us; t += 4000000u) {
+        w.push_back(WorkloadStep::channelsOn(0x01).at(t));
+        if (t + 2000000u < end_us) w.push_back(WorkloadStep::channelsOn(0x00).at(t + 2000000u));
+      }
+      break;
+    }
+    case WorkloadProfile::C21_DPM_TUNING: {
+      // DPM-enabled CH0; per cycle: drain FAULT, ON, 200 ms of 1 kHz polls,
+      // OFF at 500 ms, 50 ms of 1 kHz polls
+      w.emplace_back(WorkloadOp::CONFIGURE_CDR, 0, std::min<uint32_t>(102, ifs),
+                     std::min<uint32_t>(51, ifs), 100);
+      w.emplace_back(WorkloadOp::CONFIGURE_DPM, 0, std::min<uint32_t>(20, ifs),
+                     std::min<uint32_t>(4, ifs), 50);
+      for (uint64_t c = 0; c + 1000000u <= end_us; c += 1000000u) {
+        w.push_back(WorkloadStep(WorkloadOp::READ_FAULT).at(c));
+        w.push_back(WorkloadStep::channelsOn(0x01).at(c));
+        for (uint64_t t = c; t < c + 200000u; t += 1000u) {
+          w.push_back(WorkloadStep(WorkloadOp::READ_FAULT).at(t));
+          w.push_back(WorkloadStep(WorkloadOp::READ_STATUS).at(t));
+        }
+        w.push_back(WorkloadStep::channelsOn(0x00).at(c + 500000u));
+        for (uint64_t t = c + 500000u; t < c + 550000u; t += 1000u) {
+          w.push_back(WorkloadStep(WorkloadOp::READ_FAULT).at(t));
+          w.push_back(WorkloadStep(WorkloadOp::READ_STATUS).at(t));
+        }
+      }
+      break;
+    }
+    case WorkloadProfile::SOLENOID_VALVE: {
+      // All channels at C21 valve currents (500 / 250 mA, clamped to IFS);
+      // sequential 200 ms on / 80 ms gap, 400 ms pause, parallel 500 ms,
+      // 400 ms pause, diagnostics (STATUS, FAULT, all CFG) after each pattern
+      for (uint8_t ch = 0; ch < max22200::NUM_CHANNELS_; ++ch) {
+        w.emplace_back(WorkloadOp::CONFIGURE_CDR, ch, std::min<uint32_t>(500, ifs),
+                       std::min<uint32_t>(250, ifs / 2u), 100);
+      }
+      auto diagnostics = [&w](uint64_t t) {
+        w.push_back(WorkloadStep(WorkloadOp::READ_STATUS).at(t));
+        w.push_back(WorkloadStep(WorkloadOp::READ_FAULT).at(t));
+        w.push_back(WorkloadStep(WorkloadOp::READ_ALL_CONFIGS).at(t));
+      };
+      const uint64_t loop_us = max22200::NUM_CHANNELS_ * 280000u + 400000u + 500000u + 400000u;
+      for (uint64_t l = 0; l + loop_us <= end_us; l += loop_us) {
+        uint64_t t = l;
+        for (uint8_t ch = 0; ch < max22200::NUM_CHANNELS_; ++ch) {
+          w.push_back(WorkloadStep(WorkloadOp::SET_CHANNEL, ch, 1).at(t));
+          w.push_back(WorkloadStep(WorkloadOp::SET_CHANNEL, ch, 0).at(t + 200000u));
+          t += 280000u;
+        }
+        t += 400000u;
+        diagnostics(t);
+        w.push_back(WorkloadStep::channelsOn(0xFF).at(t));
+        w.push_back(WorkloadStep::channelsOn(0x00).at(t + 500000u));
+        diagnostics(t + 900000u);
+      }
+      break;
+    }
+    case WorkloadProfile::RATES: {
+      const WorkloadRates &r = cfg.rates;
+      for (uint8_t ch = 0; ch < max22200::NUM_CHANNELS_; ++ch) {
+        if (r.channel_mask & (1u << ch)) {
+          w.emplace_back(WorkloadOp::CONFIGURE_CDR, ch, ifs / 5u, ifs / 10u, 100);
+        }
+      }
+      uint8_t chans[max22200::NUM_CHANNELS_];
+      uint8_t nchans = 0;
+      for (uint8_t ch = 0; ch < max22200::NUM_CHANNELS_; ++ch) {
+        if (r.channel_mask & (1u << ch)) chans[nchans++] = ch;
+      }
+      if (nchans == 0) break;
+
+      std::mt19937 rng(cfg.seed);
+      std::uniform_int_distribution<uint32_t> pick(0, nchans - 1u);
+      std::uniform_int_distribution<uint32_t> pct(0, 99);
+      std::uniform_int_distribution<uint32_t> ma(0, ifs - 1u);
+      std::uniform_int_distribution<uint32_t> hit_us(1000, 100000);
+      // One independent stream per class; the merged list is sorted below
+      auto stream = [&](uint32_t hz, auto &&emit) {
+        if (hz == 0) return;
+        std::exponential_distribution<double> gap_us(static_cast<double>(hz) / 1e6);
+        for (double t = gap_us(rng); t < static_cast<double>(end_us); t += gap_us(rng)) {
+          emit(static_cast<uint64_t>(t));
+        }
+      };
+      stream(r.toggle_hz, [&](uint64_t t) {
+        if (pct(rng) < 25) {
+          uint8_t m = 0;
+          for (uint8_t i = 0; i < nchans; ++i) m |= (pct(rng) & 1u) ? (1u << chans[i]) : 0u;
+          w.push_back(WorkloadStep::channelsOn(m).at(t));
+        } else {
+          w.push_back(WorkloadStep(WorkloadOp::SET_CHANNEL, chans[pick(rng)], pct(rng) & 1u).at(t));
+        }
+      });
+      stream(r.setpoint_hz, [&](uint64_t t) {
+        const uint32_t p = pct(rng);
+        const uint8_t ch = chans[pick(rng)];
+        if (p < 40) {
+          w.push_back(WorkloadStep(WorkloadOp::SET_HOLD_CURRENT, ch, ma(rng)).at(t));
+        } else if (p < 80) {
+          w.push_back(WorkloadStep(WorkloadOp::SET_HIT_CURRENT, ch, ma(rng)).at(t));
+        } else {
+          w.push_back(WorkloadStep(WorkloadOp::SET_HIT_TIME, ch, hit_us(rng)).at(t));
+        }
+      });
+      stream(r.status_poll_hz, [&](uint64_t t) { w.push_back(WorkloadStep(WorkloadOp::READ_STATUS).at(t)); });
+      stream(r.fault_poll_hz, [&](uint64_t t) { w.push_back(WorkloadStep(WorkloadOp::READ_FAULT).at(t)); });
+      stream(r.dpm_hz, [&](uint64_t t) {
+        w.push_back(WorkloadStep(WorkloadOp::CONFIGURE_DPM, 0, ma(rng) / 2u, ifs / 50u,
+                                 static_cast<uint16_t>(500u + 10u * pct(rng))).at(t));
+      });
+      break;
+    }
+    default:
+      break;
+  }
+
+  std::stable_sort(w.begin(), w.end(),
+                   [](const WorkloadStep &a, const WorkloadStep &b) { return a.t_us < b.t_us; });
+  return w;
+}
+
+// ============================================================================
+// Trace files (CSV)
+// ============================================================================
+
+/**
+ * @brief Write @p w as CSV: `t_us,op,channel,mask,value,value2,aux`
+ *
+ * `op` is the WorkloadOpToStr() name; `mask` is hex. A header line is written
+ * first. Returns false on I/O error.
+ */
+inline bool SaveWorkloadCsv(const char *path, const Workload &w) {
+  std::FILE *f = std::fopen(path, "w");
+  if (f == nullptr) return false;
+  std::fprintf(f, "t_us,op,channel,mask,value,value2,aux\n");
+  for (const WorkloadStep &s : w) {
+    std::fprintf(f, "%" PRIu64 ",%s,%u,0x%02X,%" PRIu32 ",%" PRIu32 ",%u\n", s.t_us,
+                 WorkloadOpToStr(s.op), s.channel, s.mask, s.value, s.value2, s.aux);
+  }
+  return std::fclose(f) == 0;
+}
+
+/**
+ * @brief Load a trace written by SaveWorkloadCsv() (or recorded on target)
+ *
+ * Blank lines, lines starting with '#' and the header are skipped. Trailing
+ * columns may be omitted (they default to 0). Steps are sorted by t_us.
+ *
+ * @return false if the file cannot be opened or a line does not parse
+ *         (@p bad_line then holds its 1-based number)
+ */
+inline bool LoadWorkloadCsv(const char *path, Workload &w, uint32_t *bad_line = nullptr) {
+  std::FILE *f = std::fopen(path, "r");
+  if (f == nullptr) return false;
+  w.clear();
+  char line[256];
+  uint32_t n = 0;
+  bool ok = true;
+  while (std::fgets(line, sizeof(line), f) != nullptr) {
+    ++n;
+    if (line[0] == '#' || line[0] == '\n' || line[0] == '\r' || std::strncmp(line, "t_us", 4) == 0) {
+      continue;
+    }
+    unsigned long long t = 0;
+    char op_name[32] = {};
+    unsigned ch = 0, mask = 0, aux = 0;
+    unsigned long v = 0, v2 = 0;
+    const int fields = std::sscanf(line, "%llu,%31[a-z_],%u,%x,%lu,%lu,%u", &t, op_name, &ch,
+                                   &mask, &v, &v2, &aux);
+    WorkloadStep s;
+    if (fields < 2 || !WorkloadOpFromStr(op_name, s.op) || ch > 0xFF || mask > 0xFF || aux > 0xFFFF) {
+      if (bad_line != nullptr) *bad_line = n;
+      ok = false;
+      break;
+    }
+    s.t_us = t;
+    s.channel = static_cast<uint8_t>(ch);
+    s.mask = static_cast<uint8_t>(mask);
+    s.value = static_cast<uint32_t>(v);
+    s.value2 = static_cast<uint32_t>(v2);
+    s.aux = static_cast<uint16_t>(aux);
+    w.push_back(s);
+  }
+  std::fclose(f);
+  std::stable_sort(w.begin(), w.end(),
+                   [](const WorkloadStep &a, const WorkloadStep &b) { return a.t_us < b.t_us; });
+  return ok;
+}
@@ -0,0 +1,297 @@
+/**
+ * @file max22200_actuation_latency_bench.cpp
+ * @brief End-to-end actuation latency: API call → ONCH latched at the device.
+ *
+ * @details
+ *   Valve timing budgets are defined at the output pin, so this benchmark
+ *   measures from the moment the application calls SetChannelsOn,
+ *   SetChannelEnabled or SetFullBridgeState to the CS rising edge of the
+ *   STATUS data frame in which the emulated device latches the new ONCH value
+ *   (EmulatedFrame::onch_latch, observed through the bus frame observer).
+ *
+ *   Each call is broken down into:
+ *
+ *     encode        host CPU from the call until its first frame reaches the
+ *                   bus (argument checks, mask update, command-byte build)
+ *     lock wait     time the request waits for the bus because a telemetry
+ *                   transaction (STATUS + FAULT read, as in c21_cycle_test)
+ *                   is in progress
+ *     command phase CS low → CS high of the Command Register frame
+ *     data phase    end of the command frame → CS high of the ONCH data frame
+ *
+ *   The driver itself takes no lock; applications serialise the control
+ *   path and the telemetry task on one bus. That arbitration is modelled on
+ *   the emulator's virtual clock: requests arrive with exponential gaps and
+ *   the poller runs at a fixed period, a request that lands inside a poll
+ *   waits for it to finish. Bus phases and lock wait are virtual time (depend
+ *   on SCLK and the per-frame overhead), encode is measured on the host.
+ *
+ * @par Usage
+ *   max22200_actuation_latency_bench [--requests N] [--rate-hz N] [--poll-hz N]
+ *                                    [--sclk HZ] [--frame-overhead-ns N]
+ *                                    [--seed N]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "common/max22200_emulated_bus.hpp"
+#include "max22200.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// BENCHMARK CONFIGURATION
+//==============================================================================
+
+namespace cfg {
+
+static constexpr uint32_t kRequests        = 20000;     ///< Actuations per API
+static constexpr uint32_t kRateHz          = 1000;      ///< Mean actuation rate
+static constexpr uint32_t kPollHz          = 1000;      ///< Telemetry poll rate (0 = none)
+static constexpr uint32_t kSclkHz          = 10000000;  ///< 10 MHz standalone max
+static constexpr uint32_t kFrameOverheadNs = 2000;      ///< CS/CMD handling per frame
+static constexpr uint32_t kSeed            = 0x22200u;
+
+} // namespace cfg
+
+struct Options {
+  uint32_t requests = cfg::kRequests;
+  uint32_t rate_hz = cfg::kRateHz;
+  uint32_t poll_hz = cfg::kPollHz;
+  uint32_t sclk_hz = cfg::kSclkHz;
+  uint32_t frame_overhead_ns = cfg::kFrameOverheadNs;
+  uint32_t seed = cfg::kSeed;
+};
+
+enum class ActuationApi : uint8_t { SET_CHANNELS_ON = 0, SET_CHANNEL_ENABLED, SET_FULL_BRIDGE };
+
+static const char *ApiName(ActuationApi api) {
+  switch (api) {
+    case ActuationApi::SET_CHANNELS_ON:     return "SetChannelsOn";
+    case ActuationApi::SET_CHANNEL_ENABLED: return "SetChannelEnabled";
+    case ActuationApi::SET_FULL_BRIDGE:     return "SetFullBridgeState";
+    default:                                return "?";
+  }
+}
+
+//==============================================================================
+// FRAME TRACE (one actuation call)
+//==============================================================================
+
+struct CallTrace {
+  bool armed;
+  bool first_seen;
+  bool latched;
+  std::chrono::steady_clock::time_point host_first;
+  uint64_t cmd_start_ns;
+  uint64_t cmd_end_ns;
+  uint64_t latch_ns;
+  uint8_t onch;
+};
+
+static void on_frame(const EmulatedFrame &frame, void *user_data) {
+  auto *t = static_cast<CallTrace *>(user_data);
+  if (!t->armed) return;
+  if (!t->first_seen) {
+    t->host_first = std::chrono::steady_clock::now();
+    t->first_seen = true;
+  }
+  if (frame.command) {
+    t->cmd_start_ns = frame.start_ns;
+    t->cmd_end_ns = frame.end_ns;
+  } else if (frame.onch_latch && !t->latched) {
+    t->latch_ns = frame.end_ns;
+    t->onch = frame.onch;
+    t->latched = true;
+  }
+}
+
+//==============================================================================
+// STATISTICS
+//==============================================================================
+
+struct Series {
+  std::vector<uint64_t> v;
+
+  void add(uint64_t x) { v.push_back(x); }
+  void print(const char *name) {
+    if (v.empty()) return;
+    std::sort(v.begin(), v.end());
+    double sum = 0.0;
+    for (uint64_t x : v) sum += static_cast<double>(x);
+    auto pct = [this](double p) { return v[static_cast<size_t>(p * (v.size() - 1))]; };
+    std::printf("  %-14s %10.0f %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n", name,
+                sum / v.size(), pct(0.50), pct(0.99), pct(0.999), v.back());
+  }
+};
+
+struct LatencyResult {
+  Series encode, lock_wait, command, data, pin, total;
+  uint64_t polls = 0;
+};
+
+//==============================================================================
+// ONE API
+//==============================================================================
+
+static bool run_api(const Options &opt, ActuationApi api, LatencyResult &out) {
+  EmulatedMax22200Bus bus;
+  bus.SetFrameOverheadNs(opt.frame_overhead_ns);
+  MAX22200<EmulatedMax22200Bus> driver(bus, BoardConfig(30.0f, false));
+  if (driver.Initialize() != DriverStatus::OK || !bus.Configure(opt.sclk_hz, 0, true)) {
+    std::fprintf(stderr, "init failed\n");
+    return false;
+  }
+
+  CallTrace trace{};
+  bus.SetFrameObserver(on_frame, &trace);
+
+  std::mt19937 rng(opt.seed ^ static_cast<uint32_t>(api));
+  std::exponential_distribution<double> gap_s(static_cast<double>(opt.rate_hz));
+  std::uniform_int_distribution<int> pick_byte(0, 255);
+  std::uniform_int_distribution<int> pick_channel(0, NUM_CHANNELS_ - 1);
+  std::uniform_int_distribution<int> pick_pair(0, 3);
+
+  const uint64_t poll_period_ns = opt.poll_hz ? 1000000000ull / opt.poll_hz : 0;
+  uint64_t next_poll_ns = poll_period_ns ? bus.NowNs() + poll_period_ns : UINT64_MAX;
+  uint64_t arrival_ns = bus.NowNs() + static_cast<uint64_t>(gap_s(rng) * 1e9) + 1u;
+  uint8_t expected = 0;
+
+  for (uint32_t n = 0; n < opt.requests; ++n) {
+    // Telemetry transactions that start before this request arrives
+    while (next_poll_ns <= arrival_ns) {
+      if (bus.NowNs() < next_poll_ns) bus.AdvanceNs(next_poll_ns - bus.NowNs());
+      StatusConfig st;
+      FaultStatus faults;
+      driver.ReadStatus(st);
+      driver.ReadFaultRegister(faults);
+      out.polls++;
+      next_poll_ns += poll_period_ns;
+    }
+    // Request arrives; the bus is either idle (advance to arrival) or still busy
+    if (bus.NowNs() < arrival_ns) bus.AdvanceNs(arrival_ns - bus.NowNs());
+    const uint64_t lock_wait_ns = bus.NowNs() - arrival_ns;
+
+    // Draw the request before the clock starts so encode covers the driver only
+    uint8_t arg = 0;
+    bool on = false;
+    FullBridgeState bridge = FullBridgeState::HiZ;
+    switch (api) {
+      case ActuationApi::SET_CHANNELS_ON:
+        expected = static_cast<uint8_t>(pick_byte(rng));
+        break;
+      case ActuationApi::SET_CHANNEL_ENABLED:
+        arg = static_cast<uint8_t>(pick_channel(rng));
+        on = (expected & (1u << arg)) == 0;
+        expected = on ? static_cast<uint8_t>(expected | (1u << arg))
+                      : static_cast<uint8_t>(expected & ~(1u << arg));
+        break;
+      case ActuationApi::SET_FULL_BRIDGE: {
+        arg = static_cast<uint8_t>(pick_pair(rng));
+        const uint8_t bits = static_cast<uint8_t>(pick_byte(rng) & 3);
+        bridge = static_cast<FullBridgeState>(bits);
+        expected = static_cast<uint8_t>((expected & ~(3u << (2 * arg))) | (bits << (2 * arg)));
+        break;
+      }
+    }
+
+    trace = CallTrace{};
+    trace.armed = true;
+    DriverStatus status = DriverStatus::OK;
+    const auto host_call = std::chrono::steady_clock::now();
+    switch (api) {
+      case ActuationApi::SET_CHANNELS_ON:     status = driver.SetChannelsOn(expected); break;
+      case ActuationApi::SET_CHANNEL_ENABLED: status = driver.SetChannelEnabled(arg, on); break;
+      case ActuationApi::SET_FULL_BRIDGE:     status = driver.SetFullBridgeState(arg, bridge); break;
+    }
+    trace.armed = false;
+
+    if (status != DriverStatus::OK || !trace.latched || trace.onch != expected) {
+      std::fprintf(stderr, "%s: request %" PRIu32 " did not latch ONCH 0x%02X (%s)\n",
+                   ApiName(api), n, expected, DriverStatusToStr(status));
+      return false;
+    }
+
+    const uint64_t encode_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(trace.host_first - host_call).count());
+    const uint64_t pin_ns = trace.latch_ns - arrival_ns;
+    out.encode.add(encode_ns);
+    out.lock_wait.add(lock_wait_ns);
+    out.command.add(trace.cmd_end_ns - trace.cmd_start_ns);
+    out.data.add(trace.latch_ns - trace.cmd_end_ns);
+    out.pin.add(pin_ns);
+    out.total.add(encode_ns + pin_ns);
+
+    arrival_ns += static_cast<uint64_t>(gap_s(rng) * 1e9) + 1u;
+  }
+  return true;
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+static bool parse_args(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    if (std::strcmp(a, "--requests") == 0 && has_value) {
+      opt.requests = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(a, "--rate-hz") == 0 && has_value) {
+      opt.rate_hz = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(a, "--poll-hz") == 0 && has_value) {
+      opt.poll_hz = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(a, "--sclk") == 0 && has_value) {
+      opt.sclk_hz = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(a, "--frame-overhead-ns") == 0 && has_value) {
+      opt.frame_overhead_ns = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(a, "--seed") == 0 && has_value) {
+      opt.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+    } else {
+      std::fprintf(stderr, "unknown or incomplete argument: %s\n", a);
+      return false;
+    }
+  }
+  return opt.requests > 0 && opt.rate_hz > 0 && opt.sclk_hz > 0;
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    return 2;
+  }
+
+  std::printf("MAX22200 actuation latency (call → ONCH latch), %" PRIu32 " requests/API at %" PRIu32
+              " Hz, telemetry %" PRIu32 " Hz, SCLK %.1f MHz, frame overhead %" PRIu32 " ns\n",
+              opt.requests, opt.rate_hz, opt.poll_hz, opt.sclk_hz / 1e6, opt.frame_overhead_ns);
+
+  const ActuationApi apis[] = {ActuationApi::SET_CHANNELS_ON, ActuationApi::SET_CHANNEL_ENABLED,
+                               ActuationApi::SET_FULL_BRIDGE};
+  bool ok = true;
+  for (ActuationApi api : apis) {
+    LatencyResult r;
+    if (!run_api(opt, api, r)) {
+      ok = false;
+      continue;
+    }
+    std::printf("\n%s (%" PRIu64 " telemetry polls interleaved), ns:\n", ApiName(api), r.polls);
+    std::printf("  %-14s %10s %10s %10s %10s %10s\n", "component", "mean", "p50", "p99", "p99.9",
+                "max");
+    r.encode.print("encode (host)");
+    r.lock_wait.print("lock wait");
+    r.command.print("command phase");
+    r.data.print("data phase");
+    r.pin.print("arrival->latch");
+    r.total.print("total at pin");
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+/**
+ * @file max22200_boot_bench.cpp
+ * @brief Machine-start bring-up: ENABLE → ready-to-fire, Initialize(DeviceImage) vs the API sequence.
+ *
+ * @details
+ *   Brings the emulated device from power-off to a fully configured state with
+ *   the requested channels on, three ways:
+ *
+ *     sequence  Initialize(), WriteStatus() for fault masks / pair modes,
+ *               ConfigureAllChannels(), WriteDpmConfig(), SetChannelsOn()
+ *     verified  the same, reading STATUS, CFG_CHx and CFG_DPM back before
+ *               SetChannelsOn() (what the image path guarantees)
+ *     image     Initialize(const DeviceImage&): write burst, verify burst,
+ *               then ACTIVE + ONCH
+ *
+ *   For each it reports SPI frames, bytes, and virtual time from the call to
+ *   the CS rising edge of the last frame (SCLK as configured by the driver,
+ *   plus --frame-overhead-ns per frame). All three must leave the same register
+ *   image in the device, and repeated image boots must take exactly the same
+ *   time.
+ *
+ * @par Usage
+ *   max22200_boot_bench [--frame-overhead-ns N] [--onch MASK] [--repeats N]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/max22200_emulated_bus.hpp"
+#include "max22200.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// BENCHMARK CONFIGURATION
+//==============================================================================
+
+namespace cfg {
+
+static constexpr uint32_t kFrameOverheadNs = 2000;  ///< CS/CMD handling per frame
+static constexpr uint32_t kOnch            = 0x0F;  ///< Channels on once ready
+static constexpr uint32_t kRepeats         = 8;     ///< Image boots checked for jitter
+static constexpr uint32_t kIfsMa           = 1000;
+
+} // namespace cfg
+
+struct Options {
+  uint32_t frame_overhead_ns = cfg::kFrameOverheadNs;
+  uint32_t onch = cfg::kOnch;
+  uint32_t repeats = cfg::kRepeats;
+};
+
+using Driver = MAX22200<EmulatedMax22200Bus>;
+
+/// Representative machine configuration: CDR valves, one parallel pair
+static DeviceImage make_image(uint8_t onch) {
+  DeviceImage image;
+  image.status.channels_on_mask = onch;
+  image.status.channel_pair_mode_54 = ChannelMode::PARALLEL;
+  image.status.undervoltage_masked = true;
+  for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+    ChannelConfig &c = image.channels[ch];
+    c.drive_mode = DriveMode::CDR;
+    c.hit_setpoint = 600.0f + 20.0f * ch;
+    c.hold_setpoint = 200.0f;
+    c.hit_time_ms = 20.0f;
+    c.hit_current_check_enabled = true;
+    c.plunger_movement_detection_enabled = (ch < 4);
+  }
+  image.dpm.plunger_movement_start_current = 40;
+  image.dpm.plunger_movement_debounce_time = 3;
+  image.dpm.plunger_movement_current_threshold = 2;
+  return image;
+}
+
+//==============================================================================
+// BOOT PATHS
+//==============================================================================
+
+struct BootResult {
+  bool ok = false;
+  uint64_t frames = 0;
+  uint64_t bytes = 0;
+  uint64_t time_ns = 0;
+  EmulatedRegisterImage regs;
+};
+
+enum class BootPath : uint8_t { SEQUENCE = 0, VERIFIED, IMAGE };
+
+static DriverStatus boot_sequence(Driver &driver, const DeviceImage &image, bool verify) {
+  DriverStatus result = driver.Initialize();
+  if (result != DriverStatus::OK) return result;
+  StatusConfig status = image.status;
+  status.channels_on_mask = 0x00;
+  result = driver.WriteStatus(status);
+  if (result != DriverStatus::OK) return result;
+  result = driver.ConfigureAllChannels(image.channels);
+  if (result != DriverStatus::OK) return result;
+  result = driver.WriteDpmConfig(image.dpm);
+  if (result != DriverStatus::OK) return result;
+  if (verify) {
+    ChannelConfigArray channels;
+    DpmConfig dpm;
+    result = driver.ReadStatus(status);
+    if (result == DriverStatus::OK) result = driver.GetAllChannelConfigs(channels);
+    if (result == DriverStatus::OK) result = driver.ReadDpmConfig(dpm);
+    if (result != DriverStatus::OK) return result;
+  }
+  return driver.SetChannelsOn(image.status.channels_on_mask);
+}
+
+static BootResult boot(const Options &opt, const DeviceImage &image, BootPath path) {
+  EmulatedMax22200Bus bus(false);
+  bus.SetFrameOverheadNs(opt.frame_overhead_ns);
+  BoardConfig board;
+  board.full_scale_current_ma = cfg::kIfsMa;
+  Driver driver(bus, board);
+
+  BootResult r;
+  const uint64_t t0 = bus.NowNs();
+  const DriverStatus result = (path == BootPath::IMAGE)
+                                  ? driver.Initialize(image)
+                                  : boot_sequence(driver, image, path == BootPath::VERIFIED);
+  r.time_ns = bus.NowNs() - t0;
+  r.ok = (result == DriverStatus::OK);
+  r.frames = bus.GetCounters().frames;
+  r.bytes = bus.GetCounters().bytes;
+  r.regs = bus.GetRegisterImage();
+  return r;
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+static bool parse_args(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    auto u32 = [&] { return static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0)); };
+    if (std::strcmp(a, "--frame-overhead-ns") == 0 && has_value) {
+      opt.frame_overhead_ns = u32();
+    } else if (std::strcmp(a, "--onch") == 0 && has_value) {
+      opt.onch = u32();
+    } else if (std::strcmp(a, "--repeats") == 0 && has_value) {
+      opt.repeats = u32();
+    } else {
+      std::fprintf(stderr, "unknown or incomplete argument: %s\n", a);
+      return false;
+    }
+  }
+  return opt.onch <= 0xFF && opt.repeats > 0;
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    return 2;
+  }
+
+  const DeviceImage image = make_image(static_cast<uint8_t>(opt.onch));
+  const BootResult seq = boot(opt, image, BootPath::SEQUENCE);
+  const BootResult ver = boot(opt, image, BootPath::VERIFIED);
+  const BootResult img = boot(opt, image, BootPath::IMAGE);
+
+  bool deterministic = true;
+  for (uint32_t i = 1; i < opt.repeats; ++i) {
+    const BootResult again = boot(opt, image, BootPath::IMAGE);
+    deterministic = deterministic && again.ok && again.time_ns == img.time_ns &&
+                    again.frames == img.frames;
+  }
+  const bool same_regs = seq.ok && ver.ok && img.ok && seq.regs == img.regs && ver.regs == img.regs;
+
+  std::printf("MAX22200 boot: ENABLE -> ready-to-fire (ONCH 0x%02" PRIX32 ", frame overhead %" PRIu32
+              " ns, tEN included)\n\n",
+              opt.onch, opt.frame_overhead_ns);
+  std::printf("  %-28s %8s %8s %12s\n", "path", "frames", "bytes", "time (us)");
+  std::printf("  %-28s %8" PRIu64 " %8" PRIu64 " %12.1f%s\n", "API sequence", seq.frames, seq.bytes,
+              seq.time_ns / 1e3, seq.ok ? "" : "  FAILED");
+  std::printf("  %-28s %8" PRIu64 " %8" PRIu64 " %12.1f%s\n", "API sequence + readback", ver.frames,
+              ver.bytes, ver.time_ns / 1e3, ver.ok ? "" : "  FAILED");
+  std::printf("  %-28s %8" PRIu64 " %8" PRIu64 " %12.1f%s\n", "Initialize(DeviceImage)", img.frames,
+              img.bytes, img.time_ns / 1e3, img.ok ? "" : "  FAILED");
+  std::printf("\n  %-28s %s\n", "same register image", same_regs ? "yes" : "NO");
+  std::printf("  %-28s %s (%" PRIu32 " boots)\n", "image boot time constant",
+              deterministic ? "yes" : "NO", opt.repeats);
+  return (same_regs && deterministic) ? 0 : 1;
+}
@@ -0,0 +1,276 @@
+/**
+ * @file max22200_bulk_decode_bench.cpp
+ * @brief Bulk STATUS / FAULT decoding (max22200_bulk_decode.hpp) vs per-word fromRegister().
+ *
+ * @details
+ *   Check: every byte value in every byte position, plus --words random
+ *   words at several array lengths (to cover the non-multiple-of-16 tail),
+ *   are decoded with DecodeStatusWords() / DecodeFaultWords() and compared
+ *   column by column with StatusConfig::fromRegister() and
+ *   FaultStatus::fromRegister(). Any mismatch fails the run.
+ *
+ *   Speed: --words random words decoded --reps times into all columns,
+ *   once through the scalar codecs (fromRegister, then each field packed
+ *   back into its column) and once through the bulk decoders.
+ *
+ * @par Usage
+ *   max22200_bulk_decode_bench [--words N] [--reps N] [--seed N]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <random>
+#include <vector>
+
+#include "max22200_bulk_decode.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// BENCHMARK CONFIGURATION
+//==============================================================================
+
+namespace cfg {
+
+static constexpr uint32_t kWords = 1u << 20;
+static constexpr uint32_t kReps  = 20;
+static constexpr uint32_t kSeed  = 0x22200u;
+
+} // namespace cfg
+
+struct Options {
+  uint32_t words = cfg::kWords;
+  uint32_t reps = cfg::kReps;
+  uint32_t seed = cfg::kSeed;
+};
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t elapsed_ns(Clock::time_point t0) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count());
+}
+
+//==============================================================================
+// COLUMN STORAGE
+//==============================================================================
+
+struct Columns {
+  std::vector<uint8_t> onch, fault_masks, pair_modes, flags, fault_types;
+  std::vector<uint8_t> ocp, hhf, olf, dpm, any;
+  std::vector<uint32_t> channel_types;
+
+  explicit Columns(size_t n)
+      : onch(n), fault_masks(n), pair_modes(n), flags(n), fault_types(n), ocp(n), hhf(n),
+        olf(n), dpm(n), any(n), channel_types(n) {}
+
+  StatusColumns status() {
+    StatusColumns c;
+    c.onch = onch.data();
+    c.fault_masks = fault_masks.data();
+    c.pair_modes = pair_modes.data();
+    c.flags = flags.data();
+    c.fault_types = fault_types.data();
+    return c;
+  }
+  FaultColumns fault() {
+    FaultColumns c;
+    c.ocp = ocp.data();
+    c.hhf = hhf.data();
+    c.olf = olf.data();
+    c.dpm = dpm.data();
+    c.any = any.data();
+    c.channel_types = channel_types.data();
+    return c;
+  }
+};
+
+//==============================================================================
+// SCALAR REFERENCE
+//==============================================================================
+
+static uint8_t bits(std::initializer_list<bool> msb_first) {
+  uint8_t v = 0;
+  for (bool b : msb_first) v = static_cast<uint8_t>((v << 1) | (b ? 1u : 0u));
+  return v;
+}
+
+/// Row i of every column from the scalar codecs
+static void scalar_row(uint32_t status_word, uint32_t fault_word, Columns &c, size_t i) {
+  StatusConfig s;
+  s.fromRegister(status_word);
+  c.onch[i] = s.channels_on_mask;
+  c.fault_masks[i] = bits({s.overtemperature_masked, s.overcurrent_masked,
+                           s.open_load_fault_masked, s.hit_not_reached_masked,
+                           s.plunger_movement_fault_masked, s.communication_error_masked,
+                           s.undervoltage_masked, s.master_clock_80khz});
+  c.pair_modes[i] = static_cast<uint8_t>((static_cast<uint8_t>(s.channel_pair_mode_76) << 6) |
+                                         (static_cast<uint8_t>(s.channel_pair_mode_54) << 4) |
+                                         (static_cast<uint8_t>(s.channel_pair_mode_32) << 2) |
+                                         static_cast<uint8_t>(s.channel_pair_mode_10));
+  c.flags[i] = bits({s.overtemperature, s.overcurrent, s.open_load_fault, s.hit_not_reached,
+                     s.plunger_movement_fault, s.communication_error, s.undervoltage, s.active});
+  c.fault_types[i] = bits({s.communication_error, s.undervoltage, s.overtemperature,
+                           s.plunger_movement_fault, s.open_load_fault, s.hit_not_reached,
+                           s.overcurrent});  // FaultType COMER(6) .. OCP(0)
+
+  FaultStatus f;
+  f.fromRegister(fault_word);
+  c.ocp[i] = f.overcurrent_channel_mask;
+  c.hhf[i] = f.hit_not_reached_channel_mask;
+  c.olf[i] = f.open_load_fault_channel_mask;
+  c.dpm[i] = f.plunger_movement_fault_channel_mask;
+  c.any[i] = static_cast<uint8_t>(f.overcurrent_channel_mask | f.hit_not_reached_channel_mask |
+                                  f.open_load_fault_channel_mask |
+                                  f.plunger_movement_fault_channel_mask);
+  uint32_t types = 0;
+  for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+    const uint8_t t = bits({f.hasPlungerMovementFaultOnChannel(ch),
+                            f.hasOpenLoadFaultOnChannel(ch), f.hasHitNotReachedOnChannel(ch),
+                            f.hasOvercurrentOnChannel(ch)});  // FaultType DPM(3) .. OCP(0)
+    types |= static_cast<uint32_t>(t) << (4u * ch);
+  }
+  c.channel_types[i] = types;
+}
+
+static void scalar_decode(const std::vector<uint32_t> &status, const std::vector<uint32_t> &fault,
+                          size_t n, Columns &c) {
+  for (size_t i = 0; i < n; ++i) scalar_row(status[i], fault[i], c, i);
+}
+
+static void bulk_decode(const std::vector<uint32_t> &status, const std::vector<uint32_t> &fault,
+                        size_t n, Columns &c) {
+  DecodeStatusWords(status.data(), n, c.status());
+  DecodeFaultWords(fault.data(), n, c.fault());
+}
+
+//==============================================================================
+// CHECK
+//==============================================================================
+
+static bool same_prefix(const Columns &a, const Columns &b, size_t n) {
+  if (n == 0) return true;
+  auto eq8 = [n](const std::vector<uint8_t> &x, const std::vector<uint8_t> &y) {
+    return std::memcmp(x.data(), y.data(), n) == 0;
+  };
+  return eq8(a.onch, b.onch) && eq8(a.fault_masks, b.fault_masks) &&
+         eq8(a.pair_modes, b.pair_modes) && eq8(a.flags, b.flags) &&
+         eq8(a.fault_types, b.fault_types) && eq8(a.ocp, b.ocp) && eq8(a.hhf, b.hhf) &&
+         eq8(a.olf, b.olf) && eq8(a.dpm, b.dpm) && eq8(a.any, b.any) &&
+         std::memcmp(a.channel_types.data(), b.channel_types.data(), n * sizeof(uint32_t)) == 0;
+}
+
+/// Returns the number of failing cases
+static uint32_t check(const Options &opt) {
+  uint32_t failures = 0;
+  std::mt19937 rng(opt.seed);
+
+  // Every byte value in every byte position
+  std::vector<uint32_t> status(256 * 4), fault(256 * 4);
+  for (uint32_t pos = 0; pos < 4; ++pos) {
+    for (uint32_t b = 0; b < 256; ++b) {
+      status[pos * 256 + b] = b << (8 * pos);
+      fault[pos * 256 + b] = b << (8 * pos);
+    }
+  }
+  {
+    Columns ref(status.size()), got(status.size());
+    scalar_decode(status, fault, status.size(), ref);
+    bulk_decode(status, fault, status.size(), got);
+    if (!same_prefix(ref, got, status.size())) {
+      std::printf("  MISMATCH: per-byte sweep\n");
+      failures++;
+    }
+  }
+
+  // Random words at assorted lengths
+  const size_t lengths[] = {0, 1, 7, 15, 16, 17, 31, 33, 255, opt.words};
+  for (size_t n : lengths) {
+    status.resize(n);
+    fault.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      status[i] = rng();
+      fault[i] = rng();
+    }
+    Columns ref(n), got(n);
+    scalar_decode(status, fault, n, ref);
+    bulk_decode(status, fault, n, got);
+    if (!same_prefix(ref, got, n)) {
+      std::printf("  MISMATCH: %zu random words\n", n);
+      failures++;
+    }
+  }
+  return failures;
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+static bool parse_args(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    auto u32 = [&](uint32_t &dst) { dst = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0)); };
+    if (std::strcmp(a, "--words") == 0 && has_value) {
+      u32(opt.words);
+    } else if (std::strcmp(a, "--reps") == 0 && has_value) {
+      u32(opt.reps);
+    } else if (std::strcmp(a, "--seed") == 0 && has_value) {
+      u32(opt.seed);
+    } else {
+      return false;
+    }
+  }
+  return opt.words > 0 && opt.reps > 0;
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    std::fprintf(stderr, "usage: %s [--words N] [--reps N] [--seed N]\n", argv[0]);
+    return 2;
+  }
+
+  std::printf("MAX22200 bulk STATUS/FAULT decode (%u words x %u reps)\n", opt.words, opt.reps);
+  const uint32_t failures = check(opt);
+  std::printf("  bit-exact vs fromRegister(): %s\n", failures == 0 ? "yes" : "NO");
+
+  std::mt19937 rng(opt.seed ^ 0x5A5Au);
+  std::vector<uint32_t> status(opt.words), fault(opt.words);
+  for (uint32_t i = 0; i < opt.words; ++i) {
+    status[i] = rng();
+    fault[i] = rng();
+  }
+  Columns cols(opt.words);
+
+  auto time_ns = [&](void (*decode)(const std::vector<uint32_t> &, const std::vector<uint32_t> &,
+                                    size_t, Columns &)) {
+    uint64_t best = UINT64_MAX;
+    for (uint32_t r = 0; r < opt.reps; ++r) {
+      const auto t0 = Clock::now();
+      decode(status, fault, opt.words, cols);
+      best = std::min(best, elapsed_ns(t0));
+    }
+    return best;
+  };
+  const uint64_t scalar_ns = time_ns(scalar_decode);
+  const uint64_t bulk_ns = time_ns(bulk_decode);
+  uint64_t sink = 0;
+  for (uint32_t i = 0; i < opt.words; i += 4099) sink += cols.channel_types[i] + cols.flags[i];
+
+  std::printf("\n  %-34s %12s %14s\n", "decoder (STATUS + FAULT word pair)", "ns/pair", "M pairs/s");
+  std::printf("  %-34s %12.2f %14.1f\n", "fromRegister() per word", double(scalar_ns) / opt.words,
+              opt.words * 1e3 / scalar_ns);
+  std::printf("  %-34s %12.2f %14.1f\n", "DecodeStatusWords/DecodeFaultWords",
+              double(bulk_ns) / opt.words, opt.words * 1e3 / bulk_ns);
+  std::printf("  speedup %.1fx  (checksum %" PRIu64 ")\n", double(scalar_ns) / bulk_ns, sink);
+  return failures == 0 ? 0 : 1;
+}
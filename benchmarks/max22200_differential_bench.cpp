@@ -0,0 +1,226 @@
+/**
+ * @file max22200_differential_bench.cpp
+ * @brief Differential tester: two driver front-ends, one workload, same device state.
+ *
+ * @details
+ *   Replays one Workload (common/max22200_workload.hpp: a generated profile
+ *   or a recorded trace) through two front-ends (common/max22200_frontends.hpp),
+ *   each owning its own driver instance on its own EmulatedMax22200Bus
+ *   (common/max22200_harness.hpp). The two sides run in lock step;
+ *   after every step the emulated register images (STATUS, CFG_CH0..7,
+ *   CFG_DPM) are compared and any divergence fails the run with the step that
+ *   caused it. The per-step DriverStatus must agree as well.
+ *
+ *   On success it reports what each side cost: frames, command/data frames,
+ *   bytes, virtual wire time and host CPU time spent inside the front-end,
+ *   plus the relative difference B vs A. A performance feature is therefore
+ *   only credited once it leaves the device in exactly the baseline state.
+ *
+ * @par Usage
+ *   max22200_differential_bench [--a NAME] [--b NAME] [--profile P] [--trace FILE]
+ *                               [--steps N] [--duration-ms N] [--seed N]
+ *                               [--ifs-ma N] [--sclk HZ]
+ *                               [--frame-overhead-ns N] [--verbose]
+ *
+ *   NAME is one of the front-ends listed by --list (default: direct vs shadow);
+ *   P is a WorkloadProfile name (default: mixed).
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include "common/max22200_harness.hpp"
+#include "max22200.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// BENCHMARK CONFIGURATION
+//==============================================================================
+
+namespace cfg {
+
+static constexpr uint32_t kSteps           = 20000;     ///< MIXED profile length
+static constexpr uint32_t kDurationMs      = 60000;     ///< Timed profiles
+static constexpr uint32_t kSeed            = 0x22200u;
+static constexpr uint32_t kIfsMa           = 500;       ///< Board full-scale current
+static constexpr uint32_t kSclkHz          = 10000000;  ///< 10 MHz standalone max
+static constexpr uint32_t kFrameOverheadNs = 2000;      ///< CS/CMD handling per frame
+
+} // namespace cfg
+
+struct Options {
+  const char *a = DirectFrontEnd::Name();
+  const char *b = ShadowFrontEnd::Name();
+  const char *trace = nullptr;
+  WorkloadConfig workload;
+  HarnessConfig harness;
+  bool verbose = false;
+
+  Options() {
+    workload.steps = cfg::kSteps;
+    workload.duration_ms = cfg::kDurationMs;
+    workload.seed = cfg::kSeed;
+    workload.ifs_ma = cfg::kIfsMa;
+    harness.ifs_ma = cfg::kIfsMa;
+    harness.sclk_hz = cfg::kSclkHz;
+    harness.frame_overhead_ns = cfg::kFrameOverheadNs;
+  }
+};
+
+//==============================================================================
+// REPORTING
+//==============================================================================
+
+static void print_image_diff(const EmulatedRegisterImage &a, const EmulatedRegisterImage &b) {
+  if (a.status != b.status) {
+    std::fprintf(stderr, "  STATUS   A=0x%08" PRIX32 " B=0x%08" PRIX32 "\n", a.status, b.status);
+  }
+  for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+    if (a.cfg_ch[ch] != b.cfg_ch[ch]) {
+      std::fprintf(stderr, "  CFG_CH%u  A=0x%08" PRIX32 " B=0x%08" PRIX32 "\n", ch, a.cfg_ch[ch],
+                   b.cfg_ch[ch]);
+    }
+  }
+  if (a.cfg_dpm != b.cfg_dpm) {
+    std::fprintf(stderr, "  CFG_DPM  A=0x%08" PRIX32 " B=0x%08" PRIX32 "\n", a.cfg_dpm, b.cfg_dpm);
+  }
+}
+
+static void print_step(const WorkloadStep &s) {
+  std::fprintf(stderr, "  op=%s ch=%u mask=0x%02X value=%" PRIu32 " value2=%" PRIu32 " aux=%u\n",
+               WorkloadOpToStr(s.op), s.channel, s.mask, s.value, s.value2, s.aux);
+}
+
+static double delta_pct(double a, double b) { return a != 0.0 ? 100.0 * (b - a) / a : 0.0; }
+
+static void print_row(const char *what, double a, double b, const char *fmt) {
+  std::printf("%-16s ", what);
+  std::printf(fmt, a);
+  std::printf(" ");
+  std::printf(fmt, b);
+  std::printf(" %+9.1f%%\n", delta_pct(a, b));
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+static bool parse_args(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    if (std::strcmp(a, "--a") == 0 && has_value) {
+      opt.a = argv[++i];
+    } else if (std::strcmp(a, "--b") == 0 && has_value) {
+      opt.b = argv[++i];
+    } else if (std::strcmp(a, "--profile") == 0 && has_value) {
+      if (!WorkloadProfileFromStr(argv[++i], opt.workload.profile)) {
+        std::fprintf(stderr, "unknown profile: %s\n", argv[i]);
+        return false;
+      }
+    } else if (std::strcmp(a, "--trace") == 0 && has_value) {
+      opt.trace = argv[++i];
+    } else if (std::strcmp(a, "--steps") == 0 && has_value) {
+      opt.workload.steps = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(a, "--duration-ms") == 0 && has_value) {
+      opt.workload.duration_ms = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(a, "--seed") == 0 && has_value) {
+      opt.workload.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+    } else if (std::strcmp(a, "--ifs-ma") == 0 && has_value) {
+      opt.workload.ifs_ma = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+      opt.harness.ifs_ma = opt.workload.ifs_ma;
+    } else if (std::strcmp(a, "--sclk") == 0 && has_value) {
+      opt.harness.sclk_hz = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(a, "--frame-overhead-ns") == 0 && has_value) {
+      opt.harness.frame_overhead_ns = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(a, "--verbose") == 0) {
+      opt.verbose = true;
+    } else if (std::strcmp(a, "--list") == 0) {
+      for (const char *name : FRONT_END_NAMES) std::printf("%s\n", name);
+      std::exit(0);
+    } else {
+      std::fprintf(stderr, "unknown or incomplete argument: %s\n", a);
+      return false;
+    }
+  }
+  return opt.harness.sclk_hz > 0 && opt.harness.ifs_ma > 0;
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    return 2;
+  }
+
+  Workload work;
+  if (opt.trace != nullptr) {
+    uint32_t bad_line = 0;
+    if (!LoadWorkloadCsv(opt.trace, work, &bad_line)) {
+      std::fprintf(stderr, "cannot load trace %s (line %" PRIu32 ")\n", opt.trace, bad_line);
+      return 2;
+    }
+  } else {
+    work = GenerateWorkload(opt.workload);
+  }
+
+  std::unique_ptr<FrontEndRunner> a = MakeFrontEndRunner(opt.a);
+  std::unique_ptr<FrontEndRunner> b = MakeFrontEndRunner(opt.b);
+  if (!a || !b) {
+    std::fprintf(stderr, "unknown front-end (see --list)\n");
+    return 2;
+  }
+  if (!a->Initialize(opt.harness) || !b->Initialize(opt.harness)) {
+    std::fprintf(stderr, "init failed\n");
+    return 1;
+  }
+
+  std::printf("MAX22200 differential test: A=%s B=%s, %zu steps (%s%s, seed 0x%" PRIX32
+              ", IFS %" PRIu32 " mA, SCLK %.1f MHz)\n",
+              a->Name(), b->Name(), work.size(), opt.trace ? "trace " : "profile ",
+              opt.trace ? opt.trace : WorkloadProfileToStr(opt.workload.profile),
+              opt.workload.seed, opt.harness.ifs_ma, opt.harness.sclk_hz / 1e6);
+
+  uint64_t failed_steps = 0;
+  for (size_t i = 0; i < work.size(); ++i) {
+    const DriverStatus sa = a->Apply(work[i]);
+    const DriverStatus sb = b->Apply(work[i]);
+    if (sa != DriverStatus::OK) failed_steps++;
+    const EmulatedRegisterImage ia = a->Bus().GetRegisterImage();
+    const EmulatedRegisterImage ib = b->Bus().GetRegisterImage();
+    if (sa != sb || ia != ib) {
+      std::fprintf(stderr, "DIVERGENCE at step %zu (A: %s, B: %s)\n", i, DriverStatusToStr(sa),
+                   DriverStatusToStr(sb));
+      print_step(work[i]);
+      print_image_diff(ia, ib);
+      return 1;
+    }
+    if (opt.verbose) {
+      std::printf("%6zu %-16s ok\n", i, WorkloadOpToStr(work[i].op));
+    }
+  }
+
+  const EmulatedBusCounters &ca = a->Bus().GetCounters();
+  const EmulatedBusCounters &cb = b->Bus().GetCounters();
+  std::printf("Final register state identical (%" PRIu64 " steps rejected by both sides)\n\n",
+              failed_steps);
+  std::printf("%-16s %12s %12s %10s\n", "", a->Name(), b->Name(), "B vs A");
+  print_row("frames", static_cast<double>(ca.frames), static_cast<double>(cb.frames), "%12.0f");
+  print_row("command frames", static_cast<double>(ca.command_frames),
+            static_cast<double>(cb.command_frames), "%12.0f");
+  print_row("data frames", static_cast<double>(ca.data_frames),
+            static_cast<double>(cb.data_frames), "%12.0f");
+  print_row("bytes", static_cast<double>(ca.bytes), static_cast<double>(cb.bytes), "%12.0f");
+  print_row("wire time ms", ca.wire_time_ns / 1e6, cb.wire_time_ns / 1e6, "%12.3f");
+  print_row("max lag us", a->MaxLagNs() / 1e3, b->MaxLagNs() / 1e3, "%12.1f");
+  print_row("host CPU ms", a->HostNs() / 1e6, b->HostNs() / 1e6, "%12.3f");
+  print_row("host ns/step", static_cast<double>(a->HostNs()) / work.size(),
+            static_cast<double>(b->HostNs()) / work.size(), "%12.1f");
+  return 0;
+}
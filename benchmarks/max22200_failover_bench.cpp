@@ -0,0 +1,280 @@
+/**
+ * @file max22200_failover_bench.cpp
+ * @brief Redundant-channel failover: ValveFailover switchover vs an application round trip.
+ *
+ * @details
+ *   Two emulated devices share one SPI host (one virtual clock). Four valves
+ *   are routed:
+ *
+ *     valve 0  A CH2 → backup B CH2   (cross-device)
+ *     valve 1  A CH5 → backup A CH6   (same device)
+ *     valve 2  B CH0 → backup A CH0
+ *     valve 3  B CH4 → backup B CH5
+ *
+ *   With all valves on, the run raises OCP on A CH2, OLF on A CH5, then HHF on
+ *   A CH6 (the backup valve 1 now runs on). Each fault is read with
+ *   ReadFaultRegister() on the device that raised it, then ValveFailover::
+ *   Service() writes the switchover. The run checks:
+ *     - the read itself writes no ONCH;
+ *     - the cross-device failover costs one ONCH write per device (2), the
+ *       same-device failover one, and the backup fault loses valve 1 in one;
+ *     - both devices' ONCH match the valves after every step;
+ *     - Restore() brings the valves back to their primaries.
+ *
+ *   Latency is virtual bus time from the start of the FAULT read to the last
+ *   switchover frame. The application path routes the FaultCallback through a
+ *   task --app-latency-us later that rewrites both devices.
+ *
+ * @par Usage
+ *   max22200_failover_bench [--app-latency-us N] [--frame-overhead-ns N]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/max22200_emulated_bus.hpp"
+#include "max22200.hpp"
+#include "max22200_failover.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// BENCHMARK CONFIGURATION
+//==============================================================================
+
+namespace cfg {
+
+static constexpr uint32_t kAppLatencyUs    = 1000;  ///< Callback → application task running
+static constexpr uint32_t kFrameOverheadNs = 2000;  ///< CS/CMD handling per frame
+static constexpr uint32_t kIfsMa           = 1000;
+
+} // namespace cfg
+
+struct Options {
+  uint32_t app_latency_us = cfg::kAppLatencyUs;
+  uint32_t frame_overhead_ns = cfg::kFrameOverheadNs;
+};
+
+using Driver = MAX22200<EmulatedMax22200Bus>;
+using Failover = ValveFailover<Driver, 2, 8>;
+
+static constexpr uint8_t bit(uint8_t ch) { return static_cast<uint8_t>(1u << ch); }
+
+//==============================================================================
+// FIXTURE
+//==============================================================================
+
+struct Rig {
+  EmulatedMax22200Bus bus_a{false};
+  EmulatedMax22200Bus bus_b{false};
+  Driver dev_a{bus_a, board()};
+  Driver dev_b{bus_b, board()};
+  Failover valves;
+
+  static BoardConfig board() {
+    BoardConfig b;
+    b.full_scale_current_ma = cfg::kIfsMa;
+    return b;
+  }
+
+  bool bring_up(const Options &opt) {
+    bus_b.ShareClock(&bus_a);
+    bus_a.SetFrameOverheadNs(opt.frame_overhead_ns);
+    bus_b.SetFrameOverheadNs(opt.frame_overhead_ns);
+    if (dev_a.Initialize() != DriverStatus::OK || dev_b.Initialize() != DriverStatus::OK) {
+      return false;
+    }
+    ChannelConfig c;
+    c.drive_mode = DriveMode::CDR;
+    c.hit_setpoint = 600.0f;
+    c.hold_setpoint = 200.0f;
+    c.hit_time_ms = 10.0f;
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+      if (dev_a.ConfigureChannel(ch, c) != DriverStatus::OK ||
+          dev_b.ConfigureChannel(ch, c) != DriverStatus::OK) {
+        return false;
+      }
+    }
+    return valves.AttachDevice(0, dev_a) && valves.AttachDevice(1, dev_b) &&
+           valves.AddValve(ValveRoute(0, 2, 1, 2)) && valves.AddValve(ValveRoute(0, 5, 0, 6)) &&
+           valves.AddValve(ValveRoute(1, 0, 0, 0)) && valves.AddValve(ValveRoute(1, 4, 1, 5)) &&
+           valves.SetValves(0x0F) == DriverStatus::OK;
+  }
+
+  bool onch_is(uint8_t a, uint8_t b) const { return bus_a.onch() == a && bus_b.onch() == b; }
+  uint64_t latches() const {
+    return bus_a.GetCounters().onch_latches + bus_b.GetCounters().onch_latches;
+  }
+};
+
+/// Last frame latching ONCH on either device
+struct LatchProbe {
+  uint64_t last_ns = 0;
+};
+
+static void probe_frame(const EmulatedFrame &frame, void *user_data) {
+  if (frame.onch_latch) static_cast<LatchProbe *>(user_data)->last_ns = frame.end_ns;
+}
+
+//==============================================================================
+// SEQUENCES
+//==============================================================================
+
+struct Step {
+  const char *name;
+  bool ok = false;
+  uint64_t writes = 0;  ///< ONCH writes beyond the FAULT read
+  bool read_quiet = true;  ///< The FAULT read itself wrote no ONCH
+  uint64_t ns = 0;
+};
+
+/// Raise @p type on (@p dev, @p ch), read it, and check the resulting ONCH of both devices
+static Step fault_step(Rig &rig, const char *name, uint8_t dev, uint8_t ch, FaultType type,
+                       uint8_t onch_a, uint8_t onch_b) {
+  Step s;
+  s.name = name;
+  EmulatedMax22200Bus &bus = dev == 0 ? rig.bus_a : rig.bus_b;
+  Driver &driver = dev == 0 ? rig.dev_a : rig.dev_b;
+  LatchProbe probe;
+  rig.bus_a.SetFrameObserver(probe_frame, &probe);
+  rig.bus_b.SetFrameObserver(probe_frame, &probe);
+  const uint64_t writes0 = rig.latches();
+  bus.InjectFault(type, ch);
+  const uint64_t t0 = rig.bus_a.NowNs();
+  FaultStatus faults;
+  if (driver.ReadFaultRegister(faults) != DriverStatus::OK) return s;
+  s.read_quiet = rig.latches() == writes0;
+  if (rig.valves.Service() != DriverStatus::OK) return s;
+  s.writes = rig.latches() - writes0;
+  s.ns = probe.last_ns > t0 ? probe.last_ns - t0 : 0;
+  s.ok = rig.onch_is(onch_a, onch_b);
+  rig.bus_a.SetFrameObserver(nullptr, nullptr);
+  rig.bus_b.SetFrameObserver(nullptr, nullptr);
+  rig.bus_a.AdvanceNs(1000000u);
+  return s;
+}
+
+/// Application path for the cross-device failover: callback → task → both devices
+struct AppPending {
+  uint8_t device = 0xFF;
+};
+
+static void on_app_fault(uint8_t channel, FaultType, void *user_data) {
+  if (channel < NUM_CHANNELS_) static_cast<AppPending *>(user_data)->device = 0;
+}
+
+static Step app_step(const Options &opt) {
+  Step s;
+  s.name = "application: A CH2 -> B CH2";
+  EmulatedMax22200Bus bus_a(false);
+  EmulatedMax22200Bus bus_b(false);
+  bus_b.ShareClock(&bus_a);
+  bus_a.SetFrameOverheadNs(opt.frame_overhead_ns);
+  bus_b.SetFrameOverheadNs(opt.frame_overhead_ns);
+  Driver dev_a(bus_a, Rig::board());
+  Driver dev_b(bus_b, Rig::board());
+  if (dev_a.Initialize() != DriverStatus::OK || dev_b.Initialize() != DriverStatus::OK) return s;
+  dev_a.SetChannelsOn(bit(2));
+  AppPending pending;
+  dev_a.SetFaultCallback(on_app_fault, &pending);
+  LatchProbe probe;
+  bus_a.SetFrameObserver(probe_frame, &probe);
+  bus_b.SetFrameObserver(probe_frame, &probe);
+  const uint64_t writes0 = bus_a.GetCounters().onch_latches + bus_b.GetCounters().onch_latches;
+  bus_a.InjectFault(FaultType::OCP, 2);
+  const uint64_t t0 = bus_a.NowNs();
+  FaultStatus faults;
+  dev_a.ReadFaultRegister(faults);
+  if (pending.device == 0) {
+    bus_a.AdvanceNs(static_cast<uint64_t>(opt.app_latency_us) * 1000u);
+    dev_a.SetChannelsOn(0);
+    dev_b.SetChannelsOn(bit(2));
+  }
+  s.writes = bus_a.GetCounters().onch_latches + bus_b.GetCounters().onch_latches - writes0;
+  s.ns = probe.last_ns - t0;
+  s.ok = bus_a.onch() == 0 && bus_b.onch() == bit(2);
+  return s;
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+static bool parse_args(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    auto u32 = [&] { return static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0)); };
+    if (std::strcmp(a, "--app-latency-us") == 0 && has_value) {
+      opt.app_latency_us = u32();
+    } else if (std::strcmp(a, "--frame-overhead-ns") == 0 && has_value) {
+      opt.frame_overhead_ns = u32();
+    } else {
+      std::fprintf(stderr, "unknown or incomplete argument: %s\n", a);
+      return false;
+    }
+  }
+  return true;
+}
+
+static void print_step(const Step &s) {
+  std::printf("  %-36s %7" PRIu64 " %14.1f%s\n", s.name, s.writes, s.ns / 1e3,
+              s.ok ? "" : "  FAILED");
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    return 2;
+  }
+
+  Rig rig;
+  if (!rig.bring_up(opt) || !rig.onch_is(bit(2) | bit(5), bit(0) | bit(4))) {
+    std::fprintf(stderr, "bring-up failed\n");
+    return 1;
+  }
+  const Step app = app_step(opt);
+  // All valves on their primaries: A CH2, CH5 / B CH0, CH4
+  const Step cross = fault_step(rig, "OCP A CH2 -> B CH2", 0, 2, FaultType::OCP,
+                                bit(5), bit(0) | bit(2) | bit(4));
+  const Step same = fault_step(rig, "OLF A CH5 -> A CH6", 0, 5, FaultType::OLF,
+                               bit(6), bit(0) | bit(2) | bit(4));
+  const Step lost = fault_step(rig, "HHF A CH6 (backup) -> lost", 0, 6, FaultType::HHF,
+                               0, bit(0) | bit(2) | bit(4));
+  const FailoverStats stats = rig.valves.GetStats();
+
+  const bool sides = rig.valves.GetSide(0) == ValveSide::BACKUP &&
+                     rig.valves.GetSide(1) == ValveSide::LOST &&
+                     rig.valves.GetSide(2) == ValveSide::PRIMARY;
+  rig.valves.Restore(0);
+  rig.valves.Restore(1);
+  const bool restored = rig.onch_is(bit(2) | bit(5), bit(0) | bit(4)) &&
+                        rig.valves.GetFailedOver() == 0 && rig.valves.GetLost() == 0;
+
+  std::printf("MAX22200 failover: 2 devices, 4 valves, app latency %" PRIu32 " us\n\n",
+              opt.app_latency_us);
+  std::printf("  %-36s %7s %14s\n", "step", "writes", "latency (us)");
+  print_step(app);
+  print_step(cross);
+  print_step(same);
+  print_step(lost);
+
+  const bool writes_ok = cross.writes == 2 && same.writes == 1 && lost.writes == 1 &&
+                         cross.read_quiet && same.read_quiet && lost.read_quiet;
+  const bool stats_ok = stats.failovers == 2 && stats.lost == 1 && stats.switch_writes == 4 &&
+                        stats.write_errors == 0;
+  std::printf("\n  FailoverStats: failovers %" PRIu32 ", lost %" PRIu32 ", writes %" PRIu32
+              ", last %" PRIu32 " us, max %" PRIu32 " us\n",
+              stats.failovers, stats.lost, stats.switch_writes, stats.last_latency_us,
+              stats.max_latency_us);
+  std::printf("\n  %-44s %s\n", "reads quiet, one ONCH write per device", writes_ok ? "yes" : "NO");
+  std::printf("  %-44s %s\n", "sides and counters as expected", (sides && stats_ok) ? "yes" : "NO");
+  std::printf("  %-44s %s\n", "Restore() back to the primaries", restored ? "yes" : "NO");
+  return (app.ok && cross.ok && same.ok && lost.ok && writes_ok && sides && stats_ok && restored)
+             ? 0
+             : 1;
+}
@@ -0,0 +1,237 @@
+/**
+ * @file max22200_fault_filter_bench.cpp
+ * @brief Fault event de-duplication: chattering OLF / DPM polled through the driver.
+ *
+ * @details
+ *   The emulated device raises OLF on CH2 and DPM on CH5 every --chatter-ms
+ *   during bursts of --burst-ms, separated by --quiet-ms without faults. The
+ *   application polls ReadFaultRegister() every --poll-ms. Each read that
+ *   returns a set bit is one observation. With the driver's fault filter:
+ *
+ *     - every burst must produce exactly one FaultCallback per (channel, type),
+ *       and DriverStatistics::fault_events must count the same;
+ *     - every burst must close as one FaultEventCallback whose count is the
+ *       burst's observations and whose first/last times bracket it;
+ *     - with a 0 µs window every observation is its own event (the unfiltered
+ *       baseline).
+ *
+ *   It also times FaultEventFilter::Observe() + Expire() on the host for the
+ *   no-fault steady state and for two chattering keys.
+ *
+ * @par Usage
+ *   max22200_fault_filter_bench [--seconds N] [--poll-ms N] [--chatter-ms N]
+ *                               [--burst-ms N] [--quiet-ms N] [--window-ms N]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <bit>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/max22200_emulated_bus.hpp"
+#include "max22200.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// BENCHMARK CONFIGURATION
+//==============================================================================
+
+namespace cfg {
+
+static constexpr uint32_t kSeconds   = 60;    ///< Virtual run time
+static constexpr uint32_t kPollMs    = 10;    ///< ReadFaultRegister() period
+static constexpr uint32_t kChatterMs = 25;    ///< Fault re-raised this often within a burst
+static constexpr uint32_t kBurstMs   = 2000;  ///< Chattering burst length
+static constexpr uint32_t kQuietMs   = 3000;  ///< Fault-free gap between bursts
+static constexpr uint32_t kWindowMs  = 100;   ///< Filter merge window
+
+static constexpr uint8_t kOlfChannel = 2;
+static constexpr uint8_t kDpmChannel = 5;
+static constexpr uint32_t kTimingIterations = 2000000;
+
+} // namespace cfg
+
+struct Options {
+  uint32_t seconds = cfg::kSeconds;
+  uint32_t poll_ms = cfg::kPollMs;
+  uint32_t chatter_ms = cfg::kChatterMs;
+  uint32_t burst_ms = cfg::kBurstMs;
+  uint32_t quiet_ms = cfg::kQuietMs;
+  uint32_t window_ms = cfg::kWindowMs;
+};
+
+//==============================================================================
+// CALLBACK SINK
+//==============================================================================
+
+struct Sink {
+  uint64_t opened = 0;            ///< FaultCallback calls
+  uint64_t closed = 0;            ///< FaultEventCallback calls
+  uint64_t closed_count = 0;      ///< Sum of FaultEvent::count over closed events
+  uint64_t bad_events = 0;        ///< Closed events with the wrong key or times
+};
+
+static void on_fault(uint8_t, FaultType, void *user_data) {
+  static_cast<Sink *>(user_data)->opened++;
+}
+
+static void on_event(const FaultEvent &event, void *user_data) {
+  auto *s = static_cast<Sink *>(user_data);
+  s->closed++;
+  s->closed_count += event.count;
+  const bool key_ok = (event.channel == cfg::kOlfChannel && event.type == FaultType::OLF) ||
+                      (event.channel == cfg::kDpmChannel && event.type == FaultType::DPM);
+  if (!key_ok || event.count == 0 || event.last_us < event.first_us) {
+    s->bad_events++;
+  }
+}
+
+//==============================================================================
+// SCENARIO
+//==============================================================================
+
+struct RunResult {
+  uint64_t reads = 0;
+  uint64_t observations = 0;  ///< (channel, type) bits set across all reads
+  uint64_t bursts = 0;
+  uint32_t fault_events = 0;
+  Sink sink;
+};
+
+static RunResult run(const Options &opt, uint32_t window_us) {
+  EmulatedMax22200Bus bus(false);
+  MAX22200<EmulatedMax22200Bus> driver(bus);
+  RunResult r;
+  if (driver.Initialize() != DriverStatus::OK) {
+    std::fprintf(stderr, "init failed\n");
+    return r;
+  }
+  driver.SetFaultCallback(on_fault, &r.sink);
+  driver.SetFaultEventCallback(on_event, &r.sink);
+  driver.SetFaultFilterWindowUs(window_us);
+
+  const uint64_t period_ms = static_cast<uint64_t>(opt.burst_ms) + opt.quiet_ms;
+  const uint64_t start_ns = bus.NowNs();
+  uint64_t last_tick = UINT64_MAX;
+  for (uint64_t t_ms = 0; t_ms < static_cast<uint64_t>(opt.seconds) * 1000u; t_ms += opt.poll_ms) {
+    bus.AdvanceNs(start_ns + t_ms * 1000000u - bus.NowNs());
+    const uint64_t phase = t_ms % period_ms;
+    if (phase == 0) r.bursts++;
+    // Re-raise on every chatter tick inside the burst (the hardware latches until read)
+    const uint64_t tick = t_ms / opt.chatter_ms;
+    if (phase < opt.burst_ms && tick != last_tick) {
+      bus.InjectFault(FaultType::OLF, cfg::kOlfChannel);
+      bus.InjectFault(FaultType::DPM, cfg::kDpmChannel);
+      last_tick = tick;
+    }
+    FaultStatus faults;
+    if (driver.ReadFaultRegister(faults) != DriverStatus::OK) {
+      std::fprintf(stderr, "FAULT read failed\n");
+      return r;
+    }
+    r.reads++;
+    r.observations += static_cast<uint64_t>(std::popcount(FaultEventFilter::KeyBits(faults)));
+  }
+  // One more read after the window to close the last events
+  bus.AdvanceNs((static_cast<uint64_t>(window_us) + 1000u) * 1000u);
+  FaultStatus faults;
+  driver.ReadFaultRegister(faults);
+  r.fault_events = driver.GetStatistics().fault_events;
+  return r;
+}
+
+//==============================================================================
+// HOST COST
+//==============================================================================
+
+static double time_filter(uint64_t keys, uint32_t window_us) {
+  FaultEventFilter filter(window_us);
+  volatile uint64_t sink = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < cfg::kTimingIterations; ++i) {
+    const uint32_t now = i * 10000u;
+    filter.Expire(now, [&](const FaultEvent &e) { sink = sink + e.count; });
+    sink = sink + filter.Observe(now, keys);
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / cfg::kTimingIterations;
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+static bool parse_args(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    auto u32 = [&] { return static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0)); };
+    if (std::strcmp(a, "--seconds") == 0 && has_value) {
+      opt.seconds = u32();
+    } else if (std::strcmp(a, "--poll-ms") == 0 && has_value) {
+      opt.poll_ms = u32();
+    } else if (std::strcmp(a, "--chatter-ms") == 0 && has_value) {
+      opt.chatter_ms = u32();
+    } else if (std::strcmp(a, "--burst-ms") == 0 && has_value) {
+      opt.burst_ms = u32();
+    } else if (std::strcmp(a, "--quiet-ms") == 0 && has_value) {
+      opt.quiet_ms = u32();
+    } else if (std::strcmp(a, "--window-ms") == 0 && has_value) {
+      opt.window_ms = u32();
+    } else {
+      std::fprintf(stderr, "unknown or incomplete argument: %s\n", a);
+      return false;
+    }
+  }
+  // The window must bridge the chatter gap but not the quiet gap
+  return opt.seconds > 0 && opt.poll_ms > 0 && opt.chatter_ms >= opt.poll_ms &&
+         opt.burst_ms > 0 && opt.window_ms > opt.chatter_ms && opt.quiet_ms > opt.window_ms;
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    return 2;
+  }
+
+  const RunResult raw = run(opt, 0);
+  const RunResult filt = run(opt, opt.window_ms * 1000u);
+
+  std::printf("MAX22200 fault filter: OLF CH%u + DPM CH%u chattering every %" PRIu32
+              " ms, %" PRIu32 " ms bursts / %" PRIu32 " ms quiet, poll %" PRIu32 " ms\n\n",
+              cfg::kOlfChannel, cfg::kDpmChannel, opt.chatter_ms, opt.burst_ms, opt.quiet_ms,
+              opt.poll_ms);
+  std::printf("  %-22s %8s %12s %10s %10s %14s\n", "window", "reads", "observations", "callbacks",
+              "closed", "fault_events");
+  std::printf("  %-22s %8" PRIu64 " %12" PRIu64 " %10" PRIu64 " %10" PRIu64 " %14" PRIu32 "\n",
+              "0 us (unfiltered)", raw.reads, raw.observations, raw.sink.opened, raw.sink.closed,
+              raw.fault_events);
+  char label[32];
+  std::snprintf(label, sizeof(label), "%" PRIu32 " ms", opt.window_ms);
+  std::printf("  %-22s %8" PRIu64 " %12" PRIu64 " %10" PRIu64 " %10" PRIu64 " %14" PRIu32 "\n",
+              label, filt.reads, filt.observations, filt.sink.opened, filt.sink.closed,
+              filt.fault_events);
+
+  const bool raw_ok = raw.sink.opened == raw.observations && raw.fault_events == raw.observations;
+  const bool filt_ok = filt.sink.opened == 2 * filt.bursts && filt.fault_events == 2 * filt.bursts &&
+                       filt.sink.closed == filt.sink.opened &&
+                       filt.sink.closed_count == filt.observations && filt.sink.bad_events == 0;
+
+  const uint64_t two_keys = (1ull << FaultEventFilter::KeyOf(cfg::kOlfChannel, FaultType::OLF)) |
+                            (1ull << FaultEventFilter::KeyOf(cfg::kDpmChannel, FaultType::DPM));
+  const double idle_ns = time_filter(0, opt.window_ms * 1000u);
+  const double chatter_ns = time_filter(two_keys, opt.window_ms * 1000u);
+
+  std::printf("\n  %-40s %s\n", "unfiltered: one event per observation", raw_ok ? "yes" : "NO");
+  std::printf("  %-40s %s (%" PRIu64 " bursts)\n", "filtered: one event per key per burst",
+              filt_ok ? "yes" : "NO", filt.bursts);
+  std::printf("\n  host cost per read (Expire + Observe):\n");
+  std::printf("    %-24s %8.1f ns\n", "no fault", idle_ns);
+  std::printf("    %-24s %8.1f ns\n", "two chattering keys", chatter_ns);
+  return (raw_ok && filt_ok) ? 0 : 1;
+}
@@ -0,0 +1,272 @@
+/**
+ * @file max22200_fault_reaction_bench.cpp
+ * @brief Fault → ONCH latency: driver fault reactions vs an application round trip.
+ *
+ * @details
+ *   Eight CDR channels are on when the emulated device raises OCP on CH3. The
+ *   fault is read with ReadFaultRegister() and CH3 must be switched off:
+ *
+ *     application  FaultCallback records the channel, the application task
+ *                  runs --app-latency-us later (queue / task hand-off) and
+ *                  calls SetChannelsOn() without it
+ *     reaction     SetFaultReaction(OCP, QUARANTINE): the FAULT read queues
+ *                  the reaction and ServiceReactions(), called right after
+ *                  it, clears the ONCH bit
+ *
+ *   Latency is virtual bus time from the start of the FAULT read to the CS
+ *   rising edge of the frame that latches ONCH without CH3. The run also
+ *   checks each reaction's effect on the emulated registers:
+ *
+ *     - the read itself writes nothing; QUARANTINE keeps CH3 off through
+ *       SetChannelsOn() until the cooldown;
+ *     - HIT_STEP_RETRY raises CFG_CH1 HIT one step, then a second HHF switches
+ *       CH1 off;
+ *     - SHED on OVT clears the shed mask in one ONCH write after ReadStatus();
+ *     - every reaction is a single extra write (2 frames).
+ *
+ * @par Usage
+ *   max22200_fault_reaction_bench [--app-latency-us N] [--frame-overhead-ns N]
+ *                                 [--cooldown-ms N]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/max22200_emulated_bus.hpp"
+#include "max22200.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// BENCHMARK CONFIGURATION
+//==============================================================================
+
+namespace cfg {
+
+static constexpr uint32_t kAppLatencyUs    = 1000;  ///< Callback → application task running
+static constexpr uint32_t kFrameOverheadNs = 2000;  ///< CS/CMD handling per frame
+static constexpr uint32_t kCooldownMs      = 500;   ///< OCP quarantine
+static constexpr uint32_t kIfsMa           = 1000;
+
+static constexpr uint8_t kOcpChannel = 3;
+static constexpr uint8_t kHhfChannel = 1;
+static constexpr uint8_t kShedMask   = 0xC0;  ///< Lowest-priority channels, shed on OVT
+
+} // namespace cfg
+
+struct Options {
+  uint32_t app_latency_us = cfg::kAppLatencyUs;
+  uint32_t frame_overhead_ns = cfg::kFrameOverheadNs;
+  uint32_t cooldown_ms = cfg::kCooldownMs;
+};
+
+using Driver = MAX22200<EmulatedMax22200Bus>;
+
+//==============================================================================
+// FIXTURE
+//==============================================================================
+
+/// First frame latching ONCH with @p channel cleared
+struct OffProbe {
+  uint8_t channel = 0;
+  uint64_t off_ns = 0;
+};
+
+static void probe_frame(const EmulatedFrame &frame, void *user_data) {
+  auto *p = static_cast<OffProbe *>(user_data);
+  if (frame.onch_latch && p->off_ns == 0 && (frame.onch & (1u << p->channel)) == 0) {
+    p->off_ns = frame.end_ns;
+  }
+}
+
+static bool bring_up(Driver &driver, EmulatedMax22200Bus &bus, const Options &opt) {
+  bus.SetFrameOverheadNs(opt.frame_overhead_ns);
+  if (driver.Initialize() != DriverStatus::OK) return false;
+  ChannelConfig c;
+  c.drive_mode = DriveMode::CDR;
+  c.hit_setpoint = 600.0f;
+  c.hold_setpoint = 200.0f;
+  c.hit_time_ms = 10.0f;
+  for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+    if (driver.ConfigureChannel(ch, c) != DriverStatus::OK) return false;
+  }
+  return driver.SetChannelsOn(0xFF) == DriverStatus::OK;
+}
+
+static void on_fault_record(uint8_t channel, FaultType, void *user_data) {
+  if (channel < NUM_CHANNELS_) *static_cast<uint8_t *>(user_data) |= static_cast<uint8_t>(1u << channel);
+}
+
+//==============================================================================
+// LATENCY
+//==============================================================================
+
+struct Latency {
+  bool ok = false;
+  uint64_t ns = 0;
+  uint64_t frames = 0;
+};
+
+static Latency ocp_latency(const Options &opt, bool reaction) {
+  EmulatedMax22200Bus bus(false);
+  BoardConfig board;
+  board.full_scale_current_ma = cfg::kIfsMa;
+  Driver driver(bus, board);
+  Latency r;
+  if (!bring_up(driver, bus, opt)) return r;
+
+  uint8_t pending = 0;
+  driver.SetFaultCallback(on_fault_record, &pending);
+  if (reaction) {
+    driver.SetFaultReaction(FaultType::OCP,
+                            FaultReactionPolicy(FaultReaction::QUARANTINE, opt.cooldown_ms));
+  }
+  OffProbe probe;
+  probe.channel = cfg::kOcpChannel;
+  bus.SetFrameObserver(probe_frame, &probe);
+
+  bus.InjectFault(FaultType::OCP, cfg::kOcpChannel);
+  const uint64_t frames0 = bus.GetCounters().frames;
+  const uint64_t t0 = bus.NowNs();
+  FaultStatus faults;
+  if (driver.ReadFaultRegister(faults) != DriverStatus::OK) return r;
+  if (reaction) {
+    driver.ServiceReactions();
+  } else if (pending != 0) {
+    bus.AdvanceNs(static_cast<uint64_t>(opt.app_latency_us) * 1000u);
+    driver.SetChannelsOn(static_cast<uint8_t>(0xFF & ~pending));
+  }
+  r.frames = bus.GetCounters().frames - frames0;
+  r.ok = probe.off_ns != 0 && bus.onch() == static_cast<uint8_t>(0xFF & ~(1u << cfg::kOcpChannel));
+  r.ns = probe.off_ns - t0;
+  return r;
+}
+
+//==============================================================================
+// REACTION CHECKS
+//==============================================================================
+
+static bool check_quarantine(const Options &opt) {
+  EmulatedMax22200Bus bus(false);
+  BoardConfig board;
+  board.full_scale_current_ma = cfg::kIfsMa;
+  Driver driver(bus, board);
+  if (!bring_up(driver, bus, opt)) return false;
+  driver.SetFaultReaction(FaultType::OCP,
+                          FaultReactionPolicy(FaultReaction::QUARANTINE, opt.cooldown_ms));
+  const uint8_t bit = static_cast<uint8_t>(1u << cfg::kOcpChannel);
+  bus.InjectFault(FaultType::OCP, cfg::kOcpChannel);
+  FaultStatus faults;
+  driver.ReadFaultRegister(faults);
+  const bool queued = driver.HasPendingReactions() && bus.onch() == 0xFF;
+  driver.ServiceReactions();
+  const bool tripped = (bus.onch() & bit) == 0 && driver.GetQuarantinedChannels() == bit &&
+                       !driver.HasPendingReactions();
+
+  bus.AdvanceNs(static_cast<uint64_t>(opt.cooldown_ms) * 500000u);  // Half the cooldown
+  driver.SetChannelsOn(0xFF);
+  const bool held = (bus.onch() & bit) == 0;
+
+  bus.AdvanceNs(static_cast<uint64_t>(opt.cooldown_ms) * 500000u + 1000u);
+  driver.SetChannelsOn(0xFF);
+  const bool released = bus.onch() == 0xFF && driver.GetQuarantinedChannels() == 0;
+  return queued && tripped && held && released;
+}
+
+static bool check_hit_retry(const Options &opt) {
+  EmulatedMax22200Bus bus(false);
+  BoardConfig board;
+  board.full_scale_current_ma = cfg::kIfsMa;
+  Driver driver(bus, board);
+  if (!bring_up(driver, bus, opt)) return false;
+  driver.SetFaultReaction(FaultType::HHF, FaultReactionPolicy(FaultReaction::HIT_STEP_RETRY));
+  const uint8_t bit = static_cast<uint8_t>(1u << cfg::kHhfChannel);
+  const uint32_t hit0 = bus.GetRegisterImage().cfg_ch[cfg::kHhfChannel] & CfgChReg::HIT_MASK;
+
+  bus.InjectFault(FaultType::HHF, cfg::kHhfChannel);
+  const uint64_t frames0 = bus.GetCounters().frames;
+  FaultStatus faults;
+  driver.ReadFaultRegister(faults);
+  driver.ServiceReactions();
+  const uint64_t frames = bus.GetCounters().frames - frames0;
+  const uint32_t hit1 = bus.GetRegisterImage().cfg_ch[cfg::kHhfChannel] & CfgChReg::HIT_MASK;
+  const bool stepped = hit1 == hit0 + (1u << CfgChReg::HIT_SHIFT) && bus.onch() == 0xFF &&
+                       frames == 4;
+
+  bus.InjectFault(FaultType::HHF, cfg::kHhfChannel);
+  driver.ReadFaultRegister(faults);
+  driver.ServiceReactions();
+  const bool gave_up = (bus.onch() & bit) == 0;
+  return stepped && gave_up;
+}
+
+static bool check_shed(const Options &opt) {
+  EmulatedMax22200Bus bus(false);
+  BoardConfig board;
+  board.full_scale_current_ma = cfg::kIfsMa;
+  Driver driver(bus, board);
+  if (!bring_up(driver, bus, opt)) return false;
+  driver.SetFaultReaction(FaultType::OVT,
+                          FaultReactionPolicy(FaultReaction::SHED, 0, cfg::kShedMask));
+  bus.InjectFault(FaultType::OVT, 0);
+  const uint64_t frames0 = bus.GetCounters().frames;
+  StatusConfig status;
+  driver.ReadStatus(status);
+  driver.ServiceReactions();
+  const uint64_t frames = bus.GetCounters().frames - frames0;
+  return bus.onch() == static_cast<uint8_t>(0xFF & ~cfg::kShedMask) && frames == 4;
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+static bool parse_args(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    auto u32 = [&] { return static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0)); };
+    if (std::strcmp(a, "--app-latency-us") == 0 && has_value) {
+      opt.app_latency_us = u32();
+    } else if (std::strcmp(a, "--frame-overhead-ns") == 0 && has_value) {
+      opt.frame_overhead_ns = u32();
+    } else if (std::strcmp(a, "--cooldown-ms") == 0 && has_value) {
+      opt.cooldown_ms = u32();
+    } else {
+      std::fprintf(stderr, "unknown or incomplete argument: %s\n", a);
+      return false;
+    }
+  }
+  return opt.cooldown_ms > 0;
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    return 2;
+  }
+
+  const Latency app = ocp_latency(opt, false);
+  const Latency drv = ocp_latency(opt, true);
+
+  std::printf("MAX22200 fault reaction: OCP on CH%u, FAULT read -> ONCH without CH%u"
+              " (app latency %" PRIu32 " us, frame overhead %" PRIu32 " ns)\n\n",
+              cfg::kOcpChannel, cfg::kOcpChannel, opt.app_latency_us, opt.frame_overhead_ns);
+  std::printf("  %-34s %8s %14s\n", "path", "frames", "latency (us)");
+  std::printf("  %-34s %8" PRIu64 " %14.1f%s\n", "application (callback + task)", app.frames,
+              app.ns / 1e3, app.ok ? "" : "  FAILED");
+  std::printf("  %-34s %8" PRIu64 " %14.1f%s\n", "driver reaction (QUARANTINE)", drv.frames,
+              drv.ns / 1e3, drv.ok ? "" : "  FAILED");
+
+  const bool quarantine = check_quarantine(opt);
+  const bool retry = check_hit_retry(opt);
+  const bool shed = check_shed(opt);
+  std::printf("\n  %-50s %s\n", "OCP QUARANTINE holds CH off until cooldown", quarantine ? "yes" : "NO");
+  std::printf("  %-50s %s\n", "HHF HIT_STEP_RETRY: +1 HIT step, then off", retry ? "yes" : "NO");
+  std::printf("  %-50s %s\n", "OVT SHED: one ONCH write after ReadStatus()", shed ? "yes" : "NO");
+  return (app.ok && drv.ok && quarantine && retry && shed) ? 0 : 1;
+}
@@ -0,0 +1,277 @@
+/**
+ * @file max22200_fault_storm_bench.cpp
+ * @brief Fault-storm throughput benchmark on the emulated MAX22200.
+ *
+ * @details
+ *   Models a shorted / chattering harness: the emulated device raises OCP,
+ *   HHF, OLF and DPM on random channels with exponentially distributed
+ *   inter-arrival times at a configurable mean rate. The consumer is the
+ *   interrupt-driven pipeline an application would run:
+ *
+ *     nFAULT asserted → (IRQ-to-task latency) →
+ *     ReadFaultRegisterSelectiveClear(all) → driver fault filter (window 0)
+ *     → one FaultCallback per set (type, channel) bit
+ *
+ *   For each offered rate the benchmark reports how many events per second
+ *   were delivered, how many the hardware merged because a flag was raised
+ *   again before software cleared it (the only legitimate loss), the FAULT
+ *   reads and bus bandwidth it took, and host CPU time per delivered event.
+ *   Any event the device latched but the pipeline did not deliver is a bug
+ *   and fails the run.
+ *
+ *   Time is the emulator's virtual bus clock, so results depend on SCLK and
+ *   the per-frame overhead, not on the host.
+ *
+ * @par Usage
+ *   max22200_fault_storm_bench [--rates 1000,10000,...] [--seconds N]
+ *                              [--sclk HZ] [--irq-latency-us N]
+ *                              [--frame-overhead-ns N] [--seed N] [--plain]
+ *
+ *   --plain emulates the original MAX22200 (any FAULT read clears all bits)
+ *   instead of the MAX22200A selective clear.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "common/max22200_emulated_bus.hpp"
+#include "max22200.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// BENCHMARK CONFIGURATION
+//==============================================================================
+
+namespace cfg {
+
+/// Offered fault rates (events/s) swept by default.
+static const uint32_t kDefaultRates[] = {1000, 5000, 10000, 25000, 50000,
+                                         100000, 200000, 400000};
+
+static constexpr double   kSeconds          = 1.0;       ///< Virtual run time per rate
+static constexpr uint32_t kSclkHz           = 10000000;  ///< 10 MHz standalone max
+static constexpr uint32_t kIrqLatencyUs     = 5;         ///< nFAULT edge → task running
+static constexpr uint32_t kFrameOverheadNs  = 2000;      ///< CS/CMD handling per frame
+static constexpr uint32_t kSeed             = 0x22200u;
+
+/// A rate counts as saturated once this share of events is merged by hardware.
+static constexpr double kSaturationCoalescedPct = 1.0;
+
+} // namespace cfg
+
+//==============================================================================
+// DELIVERY SINK
+//==============================================================================
+
+struct DeliveryCounters {
+  uint64_t delivered;
+  uint64_t by_type[4];
+  uint64_t by_channel[NUM_CHANNELS_];
+};
+
+static void on_fault(uint8_t channel, FaultType type, void *user_data) {
+  auto *c = static_cast<DeliveryCounters *>(user_data);
+  c->delivered++;
+  c->by_type[static_cast<uint8_t>(type) & 3u]++;
+  if (channel < NUM_CHANNELS_) c->by_channel[channel]++;
+}
+
+
+//==============================================================================
+// ONE RATE
+//==============================================================================
+
+struct Options {
+  std::vector<uint32_t> rates;
+  double seconds = cfg::kSeconds;
+  uint32_t sclk_hz = cfg::kSclkHz;
+  uint32_t irq_latency_us = cfg::kIrqLatencyUs;
+  uint32_t frame_overhead_ns = cfg::kFrameOverheadNs;
+  uint32_t seed = cfg::kSeed;
+  bool selective_clear = true;
+};
+
+struct RateResult {
+  uint32_t offered_hz;
+  uint64_t injected;
+  uint64_t coalesced;
+  uint64_t delivered;
+  uint64_t reads;
+  EmulatedBusCounters bus;
+  double elapsed_s;
+  double host_ns;
+};
+
+static bool run_rate(const Options &opt, uint32_t rate_hz, RateResult &out) {
+  EmulatedMax22200Bus bus(opt.selective_clear);
+  bus.SetFrameOverheadNs(opt.frame_overhead_ns);
+  MAX22200<EmulatedMax22200Bus> driver(bus, BoardConfig(30.0f, false));
+  if (driver.Initialize() != DriverStatus::OK || !bus.Configure(opt.sclk_hz, 0, true)) {
+    std::fprintf(stderr, "init failed\n");
+    return false;
+  }
+  bus.ResetCounters();
+
+  DeliveryCounters sink{};
+  driver.SetFaultCallback(on_fault, &sink);
+  driver.SetFaultFilterWindowUs(0);  // Every latched (type, channel) bit is its own event
+
+  std::mt19937 rng(opt.seed ^ rate_hz);
+  std::exponential_distribution<double> gap_s(static_cast<double>(rate_hz));
+  std::uniform_int_distribution<int> pick_type(0, 3);
+  std::uniform_int_distribution<int> pick_channel(0, NUM_CHANNELS_ - 1);
+
+  const uint64_t start_ns = bus.NowNs();
+  const uint64_t end_ns = start_ns + static_cast<uint64_t>(opt.seconds * 1e9);
+  uint64_t next_fault_ns = start_ns + static_cast<uint64_t>(gap_s(rng) * 1e9);
+  const uint64_t injected_before = bus.GetInjectedFaults();
+  const uint64_t coalesced_before = bus.GetCoalescedFaults();
+  uint64_t reads = 0;
+  std::chrono::nanoseconds host{0};
+
+  auto inject_due = [&]() {
+    while (next_fault_ns <= bus.NowNs() && next_fault_ns < end_ns) {
+      bus.InjectFault(static_cast<FaultType>(pick_type(rng)),
+                      static_cast<uint8_t>(pick_channel(rng)));
+      next_fault_ns += static_cast<uint64_t>(gap_s(rng) * 1e9) + 1u;
+    }
+  };
+
+  while (bus.NowNs() < end_ns) {
+    inject_due();
+    bool fault_active = false;
+    driver.GetFaultPinState(fault_active);
+    if (!fault_active) {
+      if (next_fault_ns >= end_ns) break;
+      bus.AdvanceNs(next_fault_ns - bus.NowNs());  // Sleep until the next nFAULT edge
+      continue;
+    }
+    bus.AdvanceNs(static_cast<uint64_t>(opt.irq_latency_us) * 1000u);
+    inject_due();  // Faults keep arriving while the task wakes up
+
+    const auto t0 = std::chrono::steady_clock::now();
+    FaultStatus faults;
+    if (driver.ReadFaultRegisterSelectiveClear(0xFF, 0xFF, 0xFF, 0xFF, faults) != DriverStatus::OK) {
+      std::fprintf(stderr, "FAULT read failed\n");
+      return false;
+    }
+    host += std::chrono::steady_clock::now() - t0;
+    reads++;
+  }
+
+  // Drain whatever is still latched so every fresh event is accounted for
+  FaultStatus tail;
+  driver.ReadFaultRegisterSelectiveClear(0xFF, 0xFF, 0xFF, 0xFF, tail);
+
+  out.offered_hz = rate_hz;
+  out.injected = bus.GetInjectedFaults() - injected_before;
+  out.coalesced = bus.GetCoalescedFaults() - coalesced_before;
+  out.delivered = sink.delivered;
+  out.reads = reads;
+  out.bus = bus.GetCounters();
+  out.elapsed_s = static_cast<double>(end_ns - start_ns) / 1e9;
+  out.host_ns = static_cast<double>(host.count());
+
+  if (out.delivered != out.injected - out.coalesced) {
+    std::fprintf(stderr,
+                 "LOST EVENTS at %" PRIu32 " Hz: latched %" PRIu64 ", delivered %" PRIu64 "\n",
+                 rate_hz, out.injected - out.coalesced, out.delivered);
+    return false;
+  }
+  return true;
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+static std::vector<uint32_t> parse_rates(const char *s) {
+  std::vector<uint32_t> rates;
+  while (*s != '\0') {
+    char *end = nullptr;
+    const unsigned long v = std::strtoul(s, &end, 10);
+    if (end == s) break;
+    if (v > 0) rates.push_back(static_cast<uint32_t>(v));
+    s = (*end == ',') ? end + 1 : end;
+  }
+  return rates;
+}
+
+static bool parse_args(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    if (std::strcmp(a, "--rates") == 0 && has_value) {
+      opt.rates = parse_rates(argv[++i]);
+    } else if (std::strcmp(a, "--seconds") == 0 && has_value) {
+      opt.seconds = std::strtod(argv[++i], nullptr);
+    } else if (std::strcmp(a, "--sclk") == 0 && has_value) {
+      opt.sclk_hz = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(a, "--irq-latency-us") == 0 && has_value) {
+      opt.irq_latency_us = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(a, "--frame-overhead-ns") == 0 && has_value) {
+      opt.frame_overhead_ns = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(a, "--seed") == 0 && has_value) {
+      opt.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+    } else if (std::strcmp(a, "--plain") == 0) {
+      opt.selective_clear = false;
+    } else {
+      std::fprintf(stderr, "unknown or incomplete argument: %s\n", a);
+      return false;
+    }
+  }
+  if (opt.rates.empty()) {
+    opt.rates.assign(std::begin(cfg::kDefaultRates), std::end(cfg::kDefaultRates));
+  }
+  return opt.seconds > 0.0 && opt.sclk_hz > 0;
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    return 2;
+  }
+
+  std::printf("MAX22200 fault-storm benchmark (%s, SCLK %.1f MHz, IRQ latency %" PRIu32
+              " us, frame overhead %" PRIu32 " ns, %.2f s/rate)\n",
+              opt.selective_clear ? "MAX22200A selective clear" : "MAX22200 clear-all",
+              opt.sclk_hz / 1e6, opt.irq_latency_us, opt.frame_overhead_ns, opt.seconds);
+  std::printf("%10s %12s %10s %10s %8s %10s %10s %8s %10s\n", "offered/s", "delivered/s",
+              "merged%", "reads/s", "ev/read", "frames/s", "bytes/s", "bus%", "host ns/ev");
+
+  bool ok = true;
+  uint32_t saturation_hz = 0;
+  for (uint32_t rate : opt.rates) {
+    RateResult r{};
+    if (!run_rate(opt, rate, r)) {
+      ok = false;
+      continue;
+    }
+    const double merged_pct = r.injected ? 100.0 * r.coalesced / r.injected : 0.0;
+    const double bus_pct = 100.0 * (r.bus.wire_time_ns / 1e9) / r.elapsed_s;
+    std::printf("%10" PRIu32 " %12.0f %10.2f %10.0f %8.2f %10.0f %10.0f %8.1f %10.1f\n",
+                r.offered_hz, r.delivered / r.elapsed_s, merged_pct, r.reads / r.elapsed_s,
+                r.reads ? static_cast<double>(r.delivered) / r.reads : 0.0,
+                r.bus.frames / r.elapsed_s, r.bus.bytes / r.elapsed_s, bus_pct,
+                r.delivered ? r.host_ns / r.delivered : 0.0);
+    if (saturation_hz == 0 && merged_pct > cfg::kSaturationCoalescedPct) {
+      saturation_hz = rate;
+    }
+  }
+
+  if (saturation_hz != 0) {
+    std::printf("Pipeline saturates at ~%" PRIu32 " events/s (>%.1f%% merged by hardware)\n",
+                saturation_hz, cfg::kSaturationCoalescedPct);
+  } else {
+    std::printf("No saturation within the swept rates\n");
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,413 @@
+/**
+ * @file max22200_footprint_bench.cpp
+ * @brief Per-API code footprint and instruction-count benchmark.
+ *
+ * @details
+ *   Instantiates MAX22200 with a null bus (every transfer succeeds and reads
+ *   an opaque fill byte, GPIO is a no-op) so the measured cost is the driver
+ *   alone.
+ *
+ *   Footprint: each public API and each register codec is wrapped in its own
+ *   non-inlined `extern "C"` thunk named `max22200_fp_<Api>`. The compiler
+ *   inlines the template into the thunk, so the thunk's symbol size is the
+ *   code that API pulls in; helpers the compiler kept out of line (a thunk that
+ *   is only a few bytes is a tail call) show up as
+ *   `max22200::MAX22200<NullBus>::...` symbols. The `max22200_footprint_report`
+ *   target reads both from the symbol table with `nm`. Build MinSizeRel with
+ *   the target toolchain to get flash numbers for the MCU.
+ *
+ *   Instruction counts: running the binary times the encode/decode hot paths
+ *   and the SetChannelsOn path. On Linux it counts retired instructions and
+ *   CPU cycles with perf_event_open; where counters are unavailable (VMs,
+ *   containers, non-Linux) it falls back to wall time and prints a cycle
+ *   estimate from --cpu-ghz.
+ *
+ *   Calibration input check: non-finite and out-of-range offsets must be
+ *   rejected by CurrentCalibration::isValid() and SetChannelCalibration(), and
+ *   an accepted offset beyond IFS must be clamped before the Q8 conversion;
+ *   the run exits 1 otherwise.
+ *
+ * @par Usage
+ *   max22200_footprint_bench [--iterations N] [--cpu-ghz F]
+ *   cmake --build build --target max22200_footprint_report
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "max22200.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// NULL BUS
+//==============================================================================
+
+/**
+ * @brief SpiInterface that does nothing: transfers succeed and read back a
+ *        volatile fill byte
+ *
+ * The bus methods are kept out of line and the read data is opaque, as with
+ * a real platform bus; otherwise the compiler would constant-fold whole APIs
+ * around known-zero reads and under-report their size.
+ */
+static volatile uint8_t g_null_bus_fill = 0;
+
+class NullBus : public SpiInterface<NullBus> {
+public:
+  bool Initialize() { return true; }
+  __attribute__((noinline)) bool Transfer(const uint8_t *, uint8_t *rx_data, size_t length) {
+    for (size_t i = 0; i < length; ++i) rx_data[i] = g_null_bus_fill;
+    return true;
+  }
+  void SetChipSelect(bool) {}
+  bool Configure(uint32_t, uint8_t, bool) { return true; }
+  bool IsReady() const { return true; }
+  __attribute__((noinline)) void DelayUs(uint32_t) { asm volatile("" ::: "memory"); }
+  __attribute__((noinline)) uint32_t GetTimeUs() { return g_null_bus_fill; }
+  __attribute__((noinline)) void GpioSet(CtrlPin, GpioSignal) { asm volatile("" ::: "memory"); }
+  __attribute__((noinline)) bool GpioRead(CtrlPin, GpioSignal &signal) {
+    signal = (g_null_bus_fill & 1u) ? GpioSignal::ACTIVE : GpioSignal::INACTIVE;
+    return true;
+  }
+};
+
+using Driver = MAX22200<NullBus>;
+
+//==============================================================================
+// FOOTPRINT THUNKS (one symbol per API; sizes read by the report target)
+//==============================================================================
+
+// Inputs come from volatiles so the compiler cannot fold the calls away.
+static volatile uint8_t g_u8 = 0x5A;
+static volatile uint32_t g_u32 = 0x12345678u;
+static volatile float g_f32 = 250.0f;
+
+#define HF_FP_THUNK extern "C" __attribute__((noinline, used))
+
+HF_FP_THUNK DriverStatus max22200_fp_Initialize(Driver *d) { return d->Initialize(); }
+HF_FP_THUNK DriverStatus max22200_fp_Deinitialize(Driver *d) { return d->Deinitialize(); }
+HF_FP_THUNK DriverStatus max22200_fp_ReadStatus(Driver *d, StatusConfig *s) { return d->ReadStatus(*s); }
+HF_FP_THUNK DriverStatus max22200_fp_WriteStatus(Driver *d, const StatusConfig *s) {
+  return d->WriteStatus(*s);
+}
+HF_FP_THUNK DriverStatus max22200_fp_ConfigureChannel(Driver *d, const ChannelConfig *c) {
+  return d->ConfigureChannel(g_u8 & 7u, *c);
+}
+HF_FP_THUNK DriverStatus max22200_fp_GetChannelConfig(Driver *d, ChannelConfig *c) {
+  return d->GetChannelConfig(g_u8 & 7u, *c);
+}
+HF_FP_THUNK DriverStatus max22200_fp_GetAllChannelConfigs(Driver *d, ChannelConfigArray *c) {
+  return d->GetAllChannelConfigs(*c);
+}
+HF_FP_THUNK DriverStatus max22200_fp_SetChannelsOn(Driver *d) { return d->SetChannelsOn(g_u8); }
+HF_FP_THUNK DriverStatus max22200_fp_SetChannelEnabled(Driver *d) {
+  return d->SetChannelEnabled(g_u8 & 7u, (g_u8 & 0x80u) != 0);
+}
+HF_FP_THUNK DriverStatus max22200_fp_SetFullBridgeState(Driver *d) {
+  return d->SetFullBridgeState(g_u8 & 3u, static_cast<FullBridgeState>(g_u8 & 3u));
+}
+HF_FP_THUNK DriverStatus max22200_fp_ReadFaultRegister(Driver *d, FaultStatus *f) {
+  return d->ReadFaultRegister(*f);
+}
+HF_FP_THUNK DriverStatus max22200_fp_ReadFaultRegisterSelectiveClear(Driver *d, FaultStatus *f) {
+  return d->ReadFaultRegisterSelectiveClear(g_u8, g_u8, g_u8, g_u8, *f);
+}
+HF_FP_THUNK DriverStatus max22200_fp_ReadSnapshot(Driver *d, Snapshot *s) {
+  return d->ReadSnapshot(*s, g_u8);
+}
+HF_FP_THUNK DriverStatus max22200_fp_ConfigureDpm(Driver *d) {
+  return d->ConfigureDpm(g_f32, g_f32 / 10.0f, 1.0f);
+}
+HF_FP_THUNK DriverStatus max22200_fp_SetHitCurrentMa(Driver *d) {
+  return d->SetHitCurrentMa(g_u8 & 7u, g_u32 & 0x3FFu);
+}
+HF_FP_THUNK DriverStatus max22200_fp_SetHoldCurrentMa(Driver *d) {
+  return d->SetHoldCurrentMa(g_u8 & 7u, g_u32 & 0x3FFu);
+}
+HF_FP_THUNK DriverStatus max22200_fp_SetHitDutyPercent(Driver *d) {
+  return d->SetHitDutyPercent(g_u8 & 7u, g_f32 / 10.0f);
+}
+HF_FP_THUNK DriverStatus max22200_fp_SetHitTimeMs(Driver *d) {
+  return d->SetHitTimeMs(g_u8 & 7u, g_f32 / 100.0f);
+}
+HF_FP_THUNK DriverStatus max22200_fp_ConfigureChannelCdr(Driver *d) {
+  return d->ConfigureChannelCdr(g_u8 & 7u, g_u32 & 0x3FFu, (g_u32 >> 10) & 0x3FFu, 10.0f);
+}
+HF_FP_THUNK DriverStatus max22200_fp_ConfigureChannelVdr(Driver *d) {
+  return d->ConfigureChannelVdr(g_u8 & 7u, g_f32 / 5.0f, g_f32 / 10.0f, 10.0f);
+}
+
+HF_FP_THUNK uint32_t max22200_fp_ChannelConfig_toRegister(const ChannelConfig *c) {
+  return c->toRegister(g_u32 & 0x3FFu, (g_u8 & 1u) != 0);
+}
+HF_FP_THUNK void max22200_fp_ChannelConfig_fromRegister(ChannelConfig *c) {
+  c->fromRegister(g_u32, 1000u, (g_u8 & 1u) != 0);
+}
+HF_FP_THUNK uint32_t max22200_fp_StatusConfig_toRegister(const StatusConfig *s) {
+  return s->toRegister();
+}
+HF_FP_THUNK void max22200_fp_StatusConfig_fromRegister(StatusConfig *s) { s->fromRegister(g_u32); }
+HF_FP_THUNK void max22200_fp_FaultStatus_fromRegister(FaultStatus *f) { f->fromRegister(g_u32); }
+
+//==============================================================================
+// COUNTING HARNESS
+//==============================================================================
+
+template <typename T>
+static inline void do_not_optimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Retired-instruction and cycle counters for the calling thread
+ */
+class HwCounters {
+public:
+  HwCounters() : fd_instr_(-1), fd_cycles_(-1) {
+#if defined(__linux__)
+    fd_instr_ = open(PERF_COUNT_HW_INSTRUCTIONS);
+    fd_cycles_ = open(PERF_COUNT_HW_CPU_CYCLES);
+#endif
+  }
+  ~HwCounters() {
+#if defined(__linux__)
+    if (fd_instr_ >= 0) close(fd_instr_);
+    if (fd_cycles_ >= 0) close(fd_cycles_);
+#endif
+  }
+
+  bool available() const { return fd_instr_ >= 0; }
+  bool cyclesAvailable() const { return fd_cycles_ >= 0; }
+
+  void start() {
+#if defined(__linux__)
+    for (int fd : {fd_instr_, fd_cycles_}) {
+      if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+#endif
+  }
+
+  void stop(uint64_t &instructions, uint64_t &cycles) {
+    instructions = 0;
+    cycles = 0;
+#if defined(__linux__)
+    if (fd_instr_ >= 0) {
+      ioctl(fd_instr_, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(fd_instr_, &instructions, sizeof(instructions)) != sizeof(instructions)) instructions = 0;
+    }
+    if (fd_cycles_ >= 0) {
+      ioctl(fd_cycles_, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(fd_cycles_, &cycles, sizeof(cycles)) != sizeof(cycles)) cycles = 0;
+    }
+#endif
+  }
+
+private:
+#if defined(__linux__)
+  static int open(uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+#endif
+  int fd_instr_;
+  int fd_cycles_;
+};
+
+struct Options {
+  uint32_t iterations = 1000000;
+  double cpu_ghz = 3.0;
+};
+
+template <typename Fn>
+static void measure(const char *name, const Options &opt, HwCounters &hw, Fn &&fn) {
+  for (uint32_t i = 0; i < opt.iterations / 10u; ++i) fn(i);  // Warm caches and predictors
+
+  uint64_t instructions = 0;
+  uint64_t cycles = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  hw.start();
+  for (uint32_t i = 0; i < opt.iterations; ++i) fn(i);
+  hw.stop(instructions, cycles);
+  const auto t1 = std::chrono::steady_clock::now();
+
+  const double n = static_cast<double>(opt.iterations);
+  const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+  if (hw.available()) {
+    const double cyc = hw.cyclesAvailable() ? cycles / n : ns * opt.cpu_ghz;
+    std::printf("%-36s %10.1f %10.1f %10.2f\n", name, instructions / n, cyc, ns);
+  } else {
+    std::printf("%-36s %10s %9.1f~ %10.2f\n", name, "n/a", ns * opt.cpu_ghz, ns);
+  }
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+int main(int argc, char **argv) {
+  Options opt;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      opt.iterations = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(argv[i], "--cpu-ghz") == 0 && i + 1 < argc) {
+      opt.cpu_ghz = std::strtod(argv[++i], nullptr);
+    } else {
+      std::fprintf(stderr, "usage: %s [--iterations N] [--cpu-ghz F]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (opt.iterations == 0) opt.iterations = 1;
+
+  NullBus bus;
+  Driver driver(bus, BoardConfig(30.0f, false));
+  driver.Initialize();
+
+  HwCounters hw;
+  std::printf("MAX22200 hot-path cost (%" PRIu32 " iterations, %s)\n", opt.iterations,
+              hw.available() ? "perf_event counters" : "no HW counters; cycles ~ ns x --cpu-ghz");
+  std::printf("%-36s %10s %10s %10s\n", "path", "instr/op", "cycles/op", "ns/op");
+
+  ChannelConfig cfg_cdr = ChannelConfig::makeSolenoidCdr(400.0f, 200.0f, 10.0f);
+  measure("ChannelConfig::toRegister (CDR)", opt, hw, [&](uint32_t i) {
+    cfg_cdr.hold_setpoint = static_cast<float>(i & 0x1FFu);
+    do_not_optimize(cfg_cdr.toRegister(500u, false));
+  });
+  const ChannelScale cal_scale(ChannelCalibration(CurrentCalibration(1.04f, -6.0f)), 500u);
+  measure("ChannelConfig::toRegister (CDR, cal)", opt, hw, [&](uint32_t i) {
+    cfg_cdr.hold_setpoint = static_cast<float>(i & 0x1FFu);
+    do_not_optimize(cfg_cdr.toRegister(500u, false, &cal_scale));
+  });
+  ChannelConfig cfg_vdr = ChannelConfig::makeSolenoidVdr(80.0f, 30.0f, 10.0f);
+  measure("ChannelConfig::toRegister (VDR)", opt, hw, [&](uint32_t i) {
+    cfg_vdr.hold_setpoint = static_cast<float>(i & 0x3Fu);
+    do_not_optimize(cfg_vdr.toRegister(500u, false));
+  });
+  ChannelConfig decoded;
+  measure("ChannelConfig::fromRegister", opt, hw, [&](uint32_t i) {
+    decoded.fromRegister(0x3C64320Fu ^ (i & 0x7F7F0000u), 500u, false);
+    do_not_optimize(decoded);
+  });
+  StatusConfig status;
+  measure("StatusConfig::toRegister", opt, hw, [&](uint32_t i) {
+    status.channels_on_mask = static_cast<uint8_t>(i);
+    do_not_optimize(status.toRegister());
+  });
+  measure("StatusConfig::fromRegister", opt, hw, [&](uint32_t i) {
+    status.fromRegister(0x01040001u ^ (i << 24));
+    do_not_optimize(status);
+  });
+  FaultStatus faults;
+  measure("FaultStatus::fromRegister", opt, hw, [&](uint32_t i) {
+    faults.fromRegister(i * 0x01010101u);
+    do_not_optimize(faults);
+  });
+  measure("SetChannelsOn (null bus)", opt, hw, [&](uint32_t i) {
+    do_not_optimize(driver.SetChannelsOn(static_cast<uint8_t>(i)));
+  });
+  static uint32_t audit_mem[AuditLog::RequiredBytes(64) / sizeof(uint32_t)];
+  AuditLog audit;
+  audit.Attach(audit_mem, sizeof(audit_mem));
+  driver.SetAuditLog(&audit);
+  measure("SetChannelsOn (null bus, audit log)", opt, hw, [&](uint32_t i) {
+    do_not_optimize(driver.SetChannelsOn(static_cast<uint8_t>(i)));
+  });
+  driver.SetAuditLog(nullptr);
+  measure("SetChannelEnabled (null bus)", opt, hw, [&](uint32_t i) {
+    do_not_optimize(driver.SetChannelEnabled(static_cast<uint8_t>(i & 7u), (i & 8u) != 0));
+  });
+  measure("ReadStatus (null bus)", opt, hw, [&](uint32_t) {
+    do_not_optimize(driver.ReadStatus(status));
+  });
+  measure("ReadStatus max_age cache hit", opt, hw, [&](uint32_t) {
+    do_not_optimize(driver.ReadStatus(status, 1000));
+  });
+  measure("ReadStatus+ReadFault (null bus)", opt, hw, [&](uint32_t) {
+    do_not_optimize(driver.ReadStatus(status));
+    do_not_optimize(driver.ReadFaultRegister(faults));
+  });
+  Snapshot snap;
+  measure("ReadSnapshot (null bus)", opt, hw, [&](uint32_t) {
+    do_not_optimize(driver.ReadSnapshot(snap));
+  });
+  ChannelConfigArray all_cfg;
+  measure("GetAllChannelConfigs (null bus)", opt, hw, [&](uint32_t) {
+    do_not_optimize(driver.GetAllChannelConfigs(all_cfg));
+  });
+  measure("ConfigureChannel CDR (null bus)", opt, hw, [&](uint32_t i) {
+    do_not_optimize(driver.ConfigureChannel(static_cast<uint8_t>(i & 7u), cfg_cdr));
+  });
+
+  // Calibration inputs: a bad offset is rejected, never converted (float → int overflow)
+  const float inf = std::numeric_limits<float>::infinity();
+  const CurrentCalibration bad_cal[] = {
+      CurrentCalibration(1.0f, inf),     CurrentCalibration(1.0f, -inf),
+      CurrentCalibration(1.0f, 1.0e7f),  CurrentCalibration(1.0f, -1.0e7f),
+      CurrentCalibration(1.0f, std::numeric_limits<float>::quiet_NaN()),
+      CurrentCalibration(inf, 0.0f)};
+  bool cal_ok = true;
+  for (const CurrentCalibration &c : bad_cal) {
+    cal_ok = cal_ok && !c.isValid() &&
+             driver.SetChannelCalibration(0, ChannelCalibration(c)) ==
+                 DriverStatus::INVALID_PARAMETER &&
+             CurrentScale::fromCalibration(c, 500u).full_ma_q8 == 0;
+  }
+  const CurrentScale beyond =
+      CurrentScale::fromCalibration(CurrentCalibration(1.0f, 9000.0f), 500u);
+  cal_ok = cal_ok && beyond.offset_ma_q8 == 500 * 256 && beyond.maToRaw(400u, false) == 0;
+  std::printf("\n%-36s %s\n", "calibration rejects bad offsets", cal_ok ? "yes" : "NO");
+
+  // Reference the footprint thunks so they are linked even with --gc-sections
+  void *volatile keep[] = {
+      reinterpret_cast<void *>(&max22200_fp_Initialize),
+      reinterpret_cast<void *>(&max22200_fp_Deinitialize),
+      reinterpret_cast<void *>(&max22200_fp_ReadStatus),
+      reinterpret_cast<void *>(&max22200_fp_WriteStatus),
+      reinterpret_cast<void *>(&max22200_fp_ConfigureChannel),
+      reinterpret_cast<void *>(&max22200_fp_GetChannelConfig),
+      reinterpret_cast<void *>(&max22200_fp_GetAllChannelConfigs),
+      reinterpret_cast<void *>(&max22200_fp_SetChannelsOn),
+      reinterpret_cast<void *>(&max22200_fp_SetChannelEnabled),
+      reinterpret_cast<void *>(&max22200_fp_SetFullBridgeState),
+      reinterpret_cast<void *>(&max22200_fp_ReadFaultRegister),
+      reinterpret_cast<void *>(&max22200_fp_ReadFaultRegisterSelectiveClear),
+      reinterpret_cast<void *>(&max22200_fp_ReadSnapshot),
+      reinterpret_cast<void *>(&max22200_fp_ConfigureDpm),
+      reinterpret_cast<void *>(&max22200_fp_SetHitCurrentMa),
+      reinterpret_cast<void *>(&max22200_fp_SetHoldCurrentMa),
+      reinterpret_cast<void *>(&max22200_fp_SetHitDutyPercent),
+      reinterpret_cast<void *>(&max22200_fp_SetHitTimeMs),
+      reinterpret_cast<void *>(&max22200_fp_ConfigureChannelCdr),
+      reinterpret_cast<void *>(&max22200_fp_ConfigureChannelVdr),
+      reinterpret_cast<void *>(&max22200_fp_ChannelConfig_toRegister),
+      reinterpret_cast<void *>(&max22200_fp_ChannelConfig_fromRegister),
+      reinterpret_cast<void *>(&max22200_fp_StatusConfig_toRegister),
+      reinterpret_cast<void *>(&max22200_fp_StatusConfig_fromRegister),
+      reinterpret_cast<void *>(&max22200_fp_FaultStatus_fromRegister),
+  };
+  do_not_optimize(keep);
+  return cal_ok ? 0 : 1;
+}
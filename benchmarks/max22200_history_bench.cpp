@@ -0,0 +1,251 @@
+/**
+ * @file max22200_history_bench.cpp
+ * @brief Compressed on-device history (max22200_history.hpp): RAM reach, cost, exactness.
+ *
+ * @details
+ *   Runs the C21 cycle (CH0 --on-ms / --off-ms) on the emulated device for
+ *   --minutes of virtual time with a ReadSnapshot() poll every --poll-ms,
+ *   faults injected at --fault-rate-hz and the CH0 HIT setpoint retuned every
+ *   --retune-s. Every snapshot goes into a default TelemetryHistory (16 x 256 B)
+ *   and, uncompressed, into a reference list.
+ *
+ *   Reports how much time the history covers at the end of the run, bytes per
+ *   sample and per record, host CPU per Record(), and for comparison the
+ *   bytes TelemetryEncoder would have streamed for the same samples. The
+ *   Dump() is decoded and must reproduce the newest runs of the reference
+ *   (same state, first / last timestamp and sample count) exactly.
+ *
+ * @par Usage
+ *   max22200_history_bench [--minutes N] [--on-ms N] [--off-ms N] [--poll-ms N]
+ *                          [--fault-rate-hz X] [--retune-s N] [--seed N]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "common/max22200_emulated_bus.hpp"
+#include "max22200.hpp"
+#include "max22200_history.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// BENCHMARK CONFIGURATION
+//==============================================================================
+
+namespace cfg {
+
+static constexpr uint32_t kMinutes     = 120;
+static constexpr uint32_t kOnMs        = 2000;   ///< c21_cycle_test on time
+static constexpr uint32_t kOffMs       = 2000;   ///< c21_cycle_test off time
+static constexpr uint32_t kPollMs      = 100;    ///< c21_cycle_test kTelemetryPeriod_ms
+static constexpr double   kFaultRateHz = 0.01;
+static constexpr uint32_t kRetuneS     = 600;
+static constexpr uint32_t kSeed        = 0x22200u;
+static constexpr uint32_t kIfsMa       = 500;
+
+} // namespace cfg
+
+struct Options {
+  uint32_t minutes = cfg::kMinutes;
+  uint32_t on_ms = cfg::kOnMs;
+  uint32_t off_ms = cfg::kOffMs;
+  uint32_t poll_ms = cfg::kPollMs;
+  double fault_rate_hz = cfg::kFaultRateHz;
+  uint32_t retune_s = cfg::kRetuneS;
+  uint32_t seed = cfg::kSeed;
+};
+
+using Clock = std::chrono::steady_clock;
+using History = TelemetryHistory<>;
+
+static uint64_t elapsed_ns(Clock::time_point t0) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count());
+}
+
+//==============================================================================
+// RUN
+//==============================================================================
+
+struct RunResult {
+  bool ok = false;
+  uint64_t samples = 0;
+  uint64_t record_ns = 0;     ///< Host time inside TelemetryHistory::Record()
+  uint64_t stream_bytes = 0;  ///< TelemetryEncoder output for the same samples
+  uint64_t injected = 0;
+  std::vector<HistoryRecord> reference;  ///< Uncompressed runs, oldest first
+};
+
+/// Append @p s to the reference run list (same run-length rule as the history)
+static void add_reference(std::vector<HistoryRecord> &runs, const HistorySample &s) {
+  if (!runs.empty() && runs.back().sample.sameState(s)) {
+    runs.back().last_us = s.timestamp_us;
+    runs.back().samples++;
+    return;
+  }
+  HistoryRecord r;
+  r.sample = s;
+  r.last_us = s.timestamp_us;
+  r.samples = 1;
+  runs.push_back(r);
+}
+
+static RunResult run(const Options &opt, History &history) {
+  using Driver = MAX22200<EmulatedMax22200Bus>;
+  EmulatedMax22200Bus bus(false);  // Plain clear-on-read FAULT
+  Driver driver(bus);
+  BoardConfig board;
+  board.full_scale_current_ma = cfg::kIfsMa;
+  driver.SetBoardConfig(board);
+  RunResult r;
+  if (driver.Initialize() != DriverStatus::OK ||
+      driver.ConfigureChannelCdr(0, 102, 51, 100.0f) != DriverStatus::OK) {
+    std::fprintf(stderr, "init failed\n");
+    return r;
+  }
+
+  std::mt19937 rng(opt.seed);
+  std::exponential_distribution<double> gap(opt.fault_rate_hz > 0 ? opt.fault_rate_hz / 1e3 : 1.0);
+  std::uniform_int_distribution<int> type(0, 3);
+  TelemetryEncoder stream;
+  uint8_t frame[TelemetryFrame::MAX_FRAME_BYTES];
+
+  const uint64_t origin_ns = bus.NowNs();
+  const uint64_t end_ms = static_cast<uint64_t>(opt.minutes) * 60000u;
+  const uint64_t cycle_ms = opt.on_ms + opt.off_ms;
+  const uint64_t retune_ms = static_cast<uint64_t>(opt.retune_s) * 1000u;
+  double next_fault_ms = opt.fault_rate_hz > 0 ? gap(rng) : 1e300;
+  uint64_t next_retune_ms = retune_ms;
+  uint16_t hit = 102;
+  bool on = false;
+
+  for (uint64_t t_ms = 0; t_ms < end_ms; t_ms += opt.poll_ms) {
+    const uint64_t target_ns = origin_ns + t_ms * 1000000u;
+    if (bus.NowNs() < target_ns) bus.AdvanceNs(target_ns - bus.NowNs());
+    const bool want_on = cycle_ms > 0 && (t_ms % cycle_ms) < opt.on_ms;
+    if (want_on != on) {
+      (void)driver.SetChannelsOn(want_on ? 0x01 : 0x00);
+      on = want_on;
+      if (!on && retune_ms > 0 && t_ms >= next_retune_ms) {
+        // Retune while off, as an application would between strokes
+        hit = (hit == 102) ? 110 : 102;
+        (void)driver.ConfigureChannelCdr(0, hit, 51, 100.0f);
+        next_retune_ms += retune_ms;
+      }
+    }
+    while (next_fault_ms <= static_cast<double>(t_ms)) {
+      if (bus.InjectFault(static_cast<FaultType>(type(rng)), 0)) r.injected++;
+      next_fault_ms += gap(rng);
+    }
+
+    Snapshot snap;
+    if (driver.ReadSnapshot(snap) != DriverStatus::OK) continue;
+    r.samples++;
+
+    const Clock::time_point h0 = Clock::now();
+    history.Record(snap, driver);
+    r.record_ns += elapsed_ns(h0);
+
+    HistorySample s = HistorySample::fromSnapshot(snap);
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+      uint32_t raw = 0;
+      if (driver.GetCachedChannelRegister(ch, raw) == DriverStatus::OK) s.setpoints[ch] = raw;
+    }
+    add_reference(r.reference, s);
+    r.stream_bytes += stream.Encode(TelemetrySample::fromRegisters(s.timestamp_us, s.status, s.fault,
+                                                                   s.fault_byte),
+                                    frame, sizeof(frame));
+  }
+  r.ok = true;
+  return r;
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+static bool parse_args(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    auto u32 = [&] { return static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0)); };
+    if (std::strcmp(a, "--minutes") == 0 && has_value) {
+      opt.minutes = u32();
+    } else if (std::strcmp(a, "--on-ms") == 0 && has_value) {
+      opt.on_ms = u32();
+    } else if (std::strcmp(a, "--off-ms") == 0 && has_value) {
+      opt.off_ms = u32();
+    } else if (std::strcmp(a, "--poll-ms") == 0 && has_value) {
+      opt.poll_ms = u32();
+    } else if (std::strcmp(a, "--fault-rate-hz") == 0 && has_value) {
+      opt.fault_rate_hz = std::strtod(argv[++i], nullptr);
+    } else if (std::strcmp(a, "--retune-s") == 0 && has_value) {
+      opt.retune_s = u32();
+    } else if (std::strcmp(a, "--seed") == 0 && has_value) {
+      opt.seed = u32();
+    } else {
+      std::fprintf(stderr, "unknown or incomplete argument: %s\n", a);
+      return false;
+    }
+  }
+  return opt.minutes > 0 && opt.poll_ms > 0 && opt.on_ms + opt.off_ms > 0;
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    return 2;
+  }
+
+  static History history;
+  const RunResult r = run(opt, history);
+  if (!r.ok || r.reference.empty()) return 1;
+
+  static uint8_t dump[History::MAX_DUMP_BYTES];
+  const size_t dump_len = history.Dump(dump, sizeof(dump));
+  std::vector<HistoryRecord> decoded;
+  HistoryDecoder::DecodeAll(dump, dump_len, [&](const HistoryRecord &rec) { decoded.push_back(rec); });
+
+  // The dump must be exactly the newest runs of the reference
+  bool exact = !decoded.empty() && decoded.size() <= r.reference.size();
+  const size_t offset = exact ? r.reference.size() - decoded.size() : 0;
+  uint64_t covered_samples = 0;
+  for (size_t i = 0; exact && i < decoded.size(); ++i) {
+    const HistoryRecord &a = decoded[i];
+    const HistoryRecord &b = r.reference[offset + i];
+    exact = a.sample.sameState(b.sample) && a.sample.timestamp_us == b.sample.timestamp_us &&
+            a.last_us == b.last_us && a.samples == b.samples;
+    covered_samples += a.samples;
+  }
+  size_t visited = history.ForEach([](const HistoryRecord &) {});
+  exact = exact && visited == decoded.size();
+
+  const double span_min = static_cast<double>(history.GetSpanUs()) / 6e7;
+  std::printf("MAX22200 history: %" PRIu32 " min, CH0 %" PRIu32 "/%" PRIu32 " ms on/off, poll %" PRIu32
+              " ms, faults %.2f Hz, retune every %" PRIu32 " s\n\n",
+              opt.minutes, opt.on_ms, opt.off_ms, opt.poll_ms, opt.fault_rate_hz, opt.retune_s);
+  std::printf("  %-28s %" PRIu64 " (%zu runs, %" PRIu64 " faults injected)\n", "samples", r.samples,
+              r.reference.size(), r.injected);
+  std::printf("  %-28s %zu B (%zu blocks in use)\n", "history RAM", sizeof(History),
+              history.GetBlockCount());
+  std::printf("  %-28s %.1f min, %zu runs, %" PRIu64 " samples\n", "covered at end", span_min,
+              decoded.size(), covered_samples);
+  std::printf("  %-28s %zu B (%.2f B/sample, %.1f B/run)\n", "dump", dump_len,
+              covered_samples ? static_cast<double>(dump_len) / covered_samples : 0.0,
+              decoded.empty() ? 0.0 : static_cast<double>(dump_len) / decoded.size());
+  std::printf("  %-28s %.2f B/sample (TelemetryEncoder, whole run)\n", "streaming instead",
+              r.samples ? static_cast<double>(r.stream_bytes) / r.samples : 0.0);
+  std::printf("  %-28s %.1f ns\n", "Record() host CPU",
+              r.samples ? static_cast<double>(r.record_ns) / r.samples : 0.0);
+  std::printf("  %-28s %s\n", "dump vs reference", exact ? "exact" : "MISMATCH");
+  return exact ? 0 : 1;
+}
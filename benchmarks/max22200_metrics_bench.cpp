@@ -0,0 +1,306 @@
+/**
+ * @file max22200_metrics_bench.cpp
+ * @brief Windowed metrics (max22200_metrics.hpp): device cost, window size, gateway merge rate.
+ *
+ * @details
+ *   Device side: runs the C21 cycle (CH0 --on-ms / --off-ms) on the emulated
+ *   device for --minutes of virtual time with a ReadSnapshot() poll every
+ *   --poll-ms, faults injected at --fault-rate-hz, and feeds DriverMetrics
+ *   (latency = virtual bus time of each snapshot). Reports host CPU per poll
+ *   spent in DriverMetrics and the serialized size of minute and hour windows,
+ *   and checks the recorded on-time and fault counts against the scenario.
+ *
+ *   Gateway side: builds --devices serialized minute windows (the device's
+ *   minutes with seeded per-device variation), then deserializes and merges
+ *   them all, timing the loop. The merge is repeated in reverse order and must
+ *   produce an identical window.
+ *
+ * @par Usage
+ *   max22200_metrics_bench [--minutes N] [--on-ms N] [--off-ms N] [--poll-ms N]
+ *                          [--fault-rate-hz X] [--devices N] [--seed N]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "common/max22200_emulated_bus.hpp"
+#include "max22200.hpp"
+#include "max22200_metrics.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// BENCHMARK CONFIGURATION
+//==============================================================================
+
+namespace cfg {
+
+static constexpr uint32_t kMinutes     = 120;
+static constexpr uint32_t kOnMs        = 2000;   ///< c21_cycle_test on time
+static constexpr uint32_t kOffMs       = 2000;   ///< c21_cycle_test off time
+static constexpr uint32_t kPollMs      = 100;    ///< c21_cycle_test kTelemetryPeriod_ms
+static constexpr double   kFaultRateHz = 0.05;
+static constexpr uint32_t kDevices     = 10000;
+static constexpr uint32_t kSeed        = 0x22200u;
+static constexpr uint32_t kIfsMa       = 500;
+
+} // namespace cfg
+
+struct Options {
+  uint32_t minutes = cfg::kMinutes;
+  uint32_t on_ms = cfg::kOnMs;
+  uint32_t off_ms = cfg::kOffMs;
+  uint32_t poll_ms = cfg::kPollMs;
+  double fault_rate_hz = cfg::kFaultRateHz;
+  uint32_t devices = cfg::kDevices;
+  uint32_t seed = cfg::kSeed;
+};
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t elapsed_ns(Clock::time_point t0) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count());
+}
+
+//==============================================================================
+// DEVICE SIDE
+//==============================================================================
+
+struct DeviceResult {
+  bool ok = false;
+  uint64_t polls = 0;
+  uint64_t metrics_ns = 0;   ///< Host time inside DriverMetrics
+  uint64_t injected = 0;     ///< Faults injected
+  uint64_t on_ms = 0;        ///< Scheduled CH0 on-time
+  std::vector<MetricsWindow> minutes;
+  std::vector<MetricsWindow> hours;
+  uint32_t uptime_ms = 0;
+};
+
+static DeviceResult run_device(const Options &opt) {
+  using Driver = MAX22200<EmulatedMax22200Bus>;
+  EmulatedMax22200Bus bus(false);  // Plain clear-on-read FAULT
+  Driver driver(bus);
+  BoardConfig board;
+  board.full_scale_current_ma = cfg::kIfsMa;
+  driver.SetBoardConfig(board);
+  DeviceResult r;
+  if (driver.Initialize() != DriverStatus::OK ||
+      driver.ConfigureChannelCdr(0, 102, 51, 100.0f) != DriverStatus::OK) {
+    std::fprintf(stderr, "init failed\n");
+    return r;
+  }
+
+  // Metrics with room for the whole run
+  auto *metrics = new DriverMetrics<600, 48>();
+  std::mt19937 rng(opt.seed);
+  std::exponential_distribution<double> gap(opt.fault_rate_hz > 0 ? opt.fault_rate_hz / 1e3 : 1.0);
+  std::uniform_int_distribution<int> type(0, 3);
+
+  const uint64_t origin_ns = bus.NowNs();
+  const uint64_t end_ms = static_cast<uint64_t>(opt.minutes) * 60000u;
+  const uint64_t cycle_ms = opt.on_ms + opt.off_ms;
+  double next_fault_ms = opt.fault_rate_hz > 0 ? gap(rng) : 1e300;
+  bool on = false;
+
+  for (uint64_t t_ms = 0; t_ms < end_ms; t_ms += opt.poll_ms) {
+    const uint64_t target_ns = origin_ns + t_ms * 1000000u;
+    if (bus.NowNs() < target_ns) bus.AdvanceNs(target_ns - bus.NowNs());
+    const bool want_on = cycle_ms > 0 && (t_ms % cycle_ms) < opt.on_ms;
+    if (want_on != on) {
+      (void)driver.SetChannelsOn(want_on ? 0x01 : 0x00);
+      on = want_on;
+    }
+    if (on) r.on_ms += opt.poll_ms;
+    while (next_fault_ms <= static_cast<double>(t_ms)) {
+      if (bus.InjectFault(static_cast<FaultType>(type(rng)), 0)) r.injected++;
+      next_fault_ms += gap(rng);
+    }
+
+    const uint64_t bus0 = bus.NowNs();
+    Snapshot snap;
+    (void)driver.ReadSnapshot(snap);
+    const uint32_t latency_us = static_cast<uint32_t>((bus.NowNs() - bus0) / 1000u);
+    r.polls++;
+
+    const Clock::time_point h0 = Clock::now();
+    metrics->RecordLatencyUs(latency_us);
+    metrics->RecordSnapshot(snap);
+    (void)metrics->Update(snap.timestamp_us, driver);
+    r.metrics_ns += elapsed_ns(h0);
+  }
+  // Close the last minute (metrics started a few µs after origin, at the first snapshot)
+  const uint64_t final_ns = origin_ns + (end_ms + 1u) * 1000000u;
+  if (bus.NowNs() < final_ns) bus.AdvanceNs(final_ns - bus.NowNs());
+  (void)metrics->Update(bus.GetTimeUs(), driver);
+
+  for (size_t age = metrics->GetMinuteCount(); age-- > 0;) r.minutes.push_back(*metrics->Minute(age));
+  for (size_t age = metrics->GetHourCount(); age-- > 0;) r.hours.push_back(*metrics->Hour(age));
+  r.uptime_ms = driver.GetStatistics().uptime_ms;
+  delete metrics;
+  r.ok = true;
+  return r;
+}
+
+//==============================================================================
+// GATEWAY SIDE
+//==============================================================================
+
+/// One device's copy of a minute: counts scaled by a seeded factor in [0.5, 1.5]
+static MetricsWindow vary(const MetricsWindow &w, std::mt19937 &rng) {
+  std::uniform_real_distribution<double> scale(0.5, 1.5);
+  const double k = scale(rng);
+  auto s = [&](uint32_t v) { return static_cast<uint32_t>(v * k); };
+  MetricsWindow o = w;
+  o.operations = s(w.operations);
+  o.errors = s(w.errors);
+  o.frames = s(w.frames);
+  for (uint8_t t = 0; t < METRICS_CHANNEL_FAULT_TYPES; ++t) {
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) o.channel_faults[t][ch] = s(w.channel_faults[t][ch]);
+  }
+  for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) o.on_time_ms[ch] = s(w.on_time_ms[ch]);
+  for (uint8_t b = 0; b < METRICS_LATENCY_BUCKETS; ++b) o.latency_hist[b] = s(w.latency_hist[b]);
+  return o;
+}
+
+struct MergeResult {
+  bool ok = false;
+  uint64_t bytes = 0;
+  uint64_t ns = 0;
+  MetricsWindow merged;
+};
+
+static MergeResult merge_all(const std::vector<uint8_t> &blob, const std::vector<size_t> &offsets,
+                             bool reverse) {
+  MergeResult r;
+  const Clock::time_point t0 = Clock::now();
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    const size_t idx = reverse ? offsets.size() - 1 - i : i;
+    const size_t off = offsets[idx];
+    MetricsWindow w;
+    const size_t used = w.Deserialize(blob.data() + off, blob.size() - off);
+    if (used == 0) return r;
+    r.bytes += used;
+    r.merged.Merge(w);
+  }
+  r.ns = elapsed_ns(t0);
+  r.ok = true;
+  return r;
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+static bool parse_args(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    auto u32 = [&] { return static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0)); };
+    if (std::strcmp(a, "--minutes") == 0 && has_value) {
+      opt.minutes = u32();
+    } else if (std::strcmp(a, "--on-ms") == 0 && has_value) {
+      opt.on_ms = u32();
+    } else if (std::strcmp(a, "--off-ms") == 0 && has_value) {
+      opt.off_ms = u32();
+    } else if (std::strcmp(a, "--poll-ms") == 0 && has_value) {
+      opt.poll_ms = u32();
+    } else if (std::strcmp(a, "--fault-rate-hz") == 0 && has_value) {
+      opt.fault_rate_hz = std::strtod(argv[++i], nullptr);
+    } else if (std::strcmp(a, "--devices") == 0 && has_value) {
+      opt.devices = u32();
+    } else if (std::strcmp(a, "--seed") == 0 && has_value) {
+      opt.seed = u32();
+    } else {
+      std::fprintf(stderr, "unknown or incomplete argument: %s\n", a);
+      return false;
+    }
+  }
+  return opt.minutes > 0 && opt.minutes <= 600 && opt.poll_ms > 0 && opt.devices > 0;
+}
+
+static void size_stats(const std::vector<MetricsWindow> &v, double &mean, size_t &max) {
+  uint8_t buf[MetricsWindow::MAX_SERIALIZED_BYTES];
+  size_t total = 0;
+  max = 0;
+  for (const MetricsWindow &w : v) {
+    const size_t n = w.Serialize(buf, sizeof(buf));
+    total += n;
+    max = std::max(max, n);
+  }
+  mean = v.empty() ? 0.0 : static_cast<double>(total) / v.size();
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    return 2;
+  }
+
+  const DeviceResult dev = run_device(opt);
+  if (!dev.ok || dev.minutes.empty()) return 1;
+
+  MetricsWindow total;
+  for (const MetricsWindow &w : dev.minutes) total.Merge(w);
+  uint64_t faults = 0;
+  for (uint8_t t = 0; t < METRICS_CHANNEL_FAULT_TYPES; ++t) faults += total.channel_faults[t][0];
+
+  double minute_mean = 0.0, hour_mean = 0.0;
+  size_t minute_max = 0, hour_max = 0;
+  size_stats(dev.minutes, minute_mean, minute_max);
+  size_stats(dev.hours, hour_mean, hour_max);
+
+  std::printf("MAX22200 metrics: %" PRIu32 " min, CH0 %" PRIu32 "/%" PRIu32 " ms on/off, poll %" PRIu32
+              " ms, faults %.2f Hz, %" PRIu32 " devices\n\n",
+              opt.minutes, opt.on_ms, opt.off_ms, opt.poll_ms, opt.fault_rate_hz, opt.devices);
+  std::printf("device\n");
+  std::printf("  %-26s %" PRIu64 " (%.1f ns/poll in DriverMetrics)\n", "polls", dev.polls,
+              dev.polls ? static_cast<double>(dev.metrics_ns) / dev.polls : 0.0);
+  std::printf("  %-26s %zu minutes, %zu hours (uptime %" PRIu32 " ms)\n", "windows",
+              dev.minutes.size(), dev.hours.size(), dev.uptime_ms);
+  std::printf("  %-26s %.1f B mean, %zu B max (in memory %zu B)\n", "serialized minute", minute_mean,
+              minute_max, sizeof(MetricsWindow));
+  std::printf("  %-26s %.1f B mean, %zu B max\n", "serialized hour", hour_mean, hour_max);
+  std::printf("  %-26s %" PRIu32 " ms recorded / %" PRIu64 " ms scheduled\n", "CH0 on-time",
+              total.on_time_ms[0], dev.on_ms);
+  std::printf("  %-26s %" PRIu64 " recorded / %" PRIu64 " injected (repeats before a poll merge)\n",
+              "CH0 faults", faults, dev.injected);
+  std::printf("  %-26s p50 %" PRIu32 " us, p99 %" PRIu32 " us\n", "snapshot latency",
+              total.latencyPercentileUs(50), total.latencyPercentileUs(99));
+
+  // Gateway: one serialized minute per device
+  std::mt19937 rng(opt.seed ^ 0x9E3779B9u);
+  std::vector<uint8_t> blob;
+  std::vector<size_t> offsets;
+  uint8_t buf[MetricsWindow::MAX_SERIALIZED_BYTES];
+  for (uint32_t d = 0; d < opt.devices; ++d) {
+    const MetricsWindow w = vary(dev.minutes[d % dev.minutes.size()], rng);
+    const size_t n = w.Serialize(buf, sizeof(buf));
+    offsets.push_back(blob.size());
+    blob.insert(blob.end(), buf, buf + n);
+  }
+  const MergeResult fwd = merge_all(blob, offsets, false);
+  const MergeResult rev = merge_all(blob, offsets, true);
+  uint8_t a[MetricsWindow::MAX_SERIALIZED_BYTES], b[MetricsWindow::MAX_SERIALIZED_BYTES];
+  const size_t na = fwd.merged.Serialize(a, sizeof(a));
+  const size_t nb = rev.merged.Serialize(b, sizeof(b));
+  const bool same = fwd.ok && rev.ok && na == nb && std::memcmp(a, b, na) == 0;
+
+  std::printf("\ngateway\n");
+  std::printf("  %-26s %zu B (%.1f B/window)\n", "input", blob.size(),
+              static_cast<double>(blob.size()) / opt.devices);
+  std::printf("  %-26s %.3f ms (%.1f ns/window, %.1f M windows/s)\n", "deserialize + merge",
+              fwd.ns / 1e6, static_cast<double>(fwd.ns) / opt.devices,
+              fwd.ns ? opt.devices * 1e3 / fwd.ns : 0.0);
+  std::printf("  %-26s %s\n", "reverse-order merge", same ? "identical" : "MISMATCH");
+  return same ? 0 : 1;
+}
@@ -0,0 +1,298 @@
+/**
+ * @file max22200_poll_scheduler_bench.cpp
+ * @brief Fixed-period vs adaptive (PollScheduler) telemetry polling.
+ *
+ * @details
+ *   Runs the same scenario twice on the emulated device, once with a
+ *   telemetry loop that reads STATUS + FAULT every `--fixed-ms` (as
+ *   c21_cycle_test does) and once with the loop driven by PollScheduler,
+ *   and reports SPI load and fault detection latency for both.
+ *
+ *   Scenario (identical for both runs, from --seed):
+ *
+ *     - CH0 cycles on for --on-ms / off for --off-ms (C21 cycle profile)
+ *     - optional application traffic at --app-hz (SetHoldCurrentMa on CH0,
+ *       a CFG read-modify-write whose command bytes return fault bytes)
+ *     - faults (OCP / HHF / OLF / DPM on CH0) injected at --fault-rate-hz
+ *
+ *   The adaptive loop wakes every --wake-ms (or sooner if a poll is due) and
+ *   asks the scheduler; wake-ups that do not poll cost one GPIO read (nFAULT)
+ *   and no SPI. Fault latency is measured from injection to the first poll
+ *   that reports it; everything runs on the emulator's virtual clock.
+ *
+ * @par Usage
+ *   max22200_poll_scheduler_bench [--duration-ms N] [--on-ms N] [--off-ms N]
+ *                                 [--fixed-ms N] [--wake-ms N] [--app-hz N]
+ *                                 [--fault-rate-hz X] [--seed N] [--sclk HZ]
+ *                                 [--frame-overhead-ns N]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "common/max22200_emulated_bus.hpp"
+#include "max22200.hpp"
+#include "max22200_poll_scheduler.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// BENCHMARK CONFIGURATION
+//==============================================================================
+
+namespace cfg {
+
+static constexpr uint32_t kDurationMs      = 120000;
+static constexpr uint32_t kOnMs            = 2000;      ///< c21_cycle_test on time
+static constexpr uint32_t kOffMs           = 2000;      ///< c21_cycle_test off time
+static constexpr uint32_t kFixedMs         = 100;       ///< c21_cycle_test kTelemetryPeriod_ms
+static constexpr uint32_t kWakeMs          = 10;        ///< Adaptive loop wake-up ceiling
+static constexpr uint32_t kAppHz           = 0;         ///< Application CFG traffic
+static constexpr double   kFaultRateHz     = 0.2;
+static constexpr uint32_t kSeed            = 0x22200u;
+static constexpr uint32_t kIfsMa           = 500;
+static constexpr uint32_t kSclkHz          = 10000000;  ///< 10 MHz standalone max
+static constexpr uint32_t kFrameOverheadNs = 2000;      ///< CS/CMD handling per frame
+
+} // namespace cfg
+
+struct Options {
+  uint32_t duration_ms = cfg::kDurationMs;
+  uint32_t on_ms = cfg::kOnMs;
+  uint32_t off_ms = cfg::kOffMs;
+  uint32_t fixed_ms = cfg::kFixedMs;
+  uint32_t wake_ms = cfg::kWakeMs;
+  uint32_t app_hz = cfg::kAppHz;
+  double fault_rate_hz = cfg::kFaultRateHz;
+  uint32_t seed = cfg::kSeed;
+  uint32_t sclk_hz = cfg::kSclkHz;
+  uint32_t frame_overhead_ns = cfg::kFrameOverheadNs;
+};
+
+//==============================================================================
+// SCENARIO
+//==============================================================================
+
+enum class EventKind : uint8_t { CHANNELS, APP, FAULT };
+
+struct Event {
+  uint64_t t_us;
+  EventKind kind;
+  uint8_t arg;  ///< ONCH mask, or FaultType for FAULT
+  uint16_t value;
+};
+
+static std::vector<Event> make_scenario(const Options &opt) {
+  std::vector<Event> ev;
+  const uint64_t end_us = static_cast<uint64_t>(opt.duration_ms) * 1000u;
+  const uint64_t period_us = static_cast<uint64_t>(opt.on_ms + opt.off_ms) * 1000u;
+  for (uint64_t t = 0; period_us > 0 && t < end_us; t += period_us) {
+    ev.push_back({t, EventKind::CHANNELS, 0x01, 0});
+    ev.push_back({t + opt.on_ms * 1000ull, EventKind::CHANNELS, 0x00, 0});
+  }
+  std::mt19937 rng(opt.seed);
+  if (opt.app_hz > 0) {
+    std::exponential_distribution<double> gap(opt.app_hz / 1e6);
+    std::uniform_int_distribution<uint16_t> hold(20, 60);
+    for (double t = gap(rng); t < end_us; t += gap(rng)) {
+      ev.push_back({static_cast<uint64_t>(t), EventKind::APP, 0, hold(rng)});
+    }
+  }
+  if (opt.fault_rate_hz > 0) {
+    std::exponential_distribution<double> gap(opt.fault_rate_hz / 1e6);
+    std::uniform_int_distribution<int> type(0, 3);  // OCP, HHF, OLF, DPM
+    for (double t = gap(rng); t < end_us; t += gap(rng)) {
+      ev.push_back({static_cast<uint64_t>(t), EventKind::FAULT, static_cast<uint8_t>(type(rng)), 0});
+    }
+  }
+  std::stable_sort(ev.begin(), ev.end(),
+                   [](const Event &a, const Event &b) { return a.t_us < b.t_us; });
+  return ev;
+}
+
+//==============================================================================
+// RUN
+//==============================================================================
+
+struct RunResult {
+  uint64_t wakes = 0;
+  uint64_t polls = 0;
+  uint64_t skips = 0;
+  uint64_t early = 0;
+  uint64_t poll_frames = 0;
+  uint64_t poll_wire_ns = 0;
+  uint64_t total_frames = 0;
+  uint64_t elapsed_ns = 0;
+  uint64_t undetected = 0;
+  std::vector<uint64_t> latency_us;
+};
+
+static RunResult run(const Options &opt, const std::vector<Event> &events, bool adaptive) {
+  using Driver = MAX22200<EmulatedMax22200Bus>;
+  EmulatedMax22200Bus bus(false);  // Plain clear-on-read FAULT, as the c21 loop assumes
+  Driver driver(bus);
+  bus.SetFrameOverheadNs(opt.frame_overhead_ns);
+  BoardConfig board;
+  board.full_scale_current_ma = cfg::kIfsMa;
+  driver.SetBoardConfig(board);
+  RunResult r;
+  if (driver.Initialize() != DriverStatus::OK || !bus.Configure(opt.sclk_hz, 0, true) ||
+      driver.ConfigureChannelCdr(0, 102, 51, 100.0f) != DriverStatus::OK) {
+    std::fprintf(stderr, "init failed\n");
+    return r;
+  }
+  bus.ResetCounters();
+  const uint64_t origin_ns = bus.NowNs();
+  const uint64_t end_ns = origin_ns + static_cast<uint64_t>(opt.duration_ms) * 1000000u;
+  auto now_us = [&] { return static_cast<uint32_t>((bus.NowNs() - origin_ns) / 1000u); };
+
+  PollScheduler sched;
+  std::vector<uint64_t> pending;  // injection times (ns) not yet reported by a poll
+  size_t next_event = 0;
+  uint64_t next_wake_ns = origin_ns;
+
+  auto do_poll = [&] {
+    const EmulatedBusCounters before = bus.GetCounters();
+    const uint64_t t0 = bus.NowNs();
+    StatusConfig status;
+    FaultStatus faults;
+    (void)driver.ReadStatus(status);
+    (void)driver.ReadFaultRegister(faults);
+    r.polls++;
+    r.poll_frames += bus.GetCounters().frames - before.frames;
+    r.poll_wire_ns += bus.GetCounters().wire_time_ns - before.wire_time_ns;
+    if (status.hasFault() || faults.hasFault()) {
+      for (uint64_t t : pending) r.latency_us.push_back((t0 - t) / 1000u);
+      pending.clear();
+    }
+    if (adaptive) sched.OnPolled(now_us(), driver, status, faults);
+  };
+
+  while (true) {
+    const uint64_t ev_ns = next_event < events.size()
+                               ? origin_ns + events[next_event].t_us * 1000u
+                               : UINT64_MAX;
+    const uint64_t t_ns = std::min(ev_ns, next_wake_ns);
+    if (t_ns >= end_ns) break;
+    if (bus.NowNs() < t_ns) bus.AdvanceNs(t_ns - bus.NowNs());
+
+    if (ev_ns <= next_wake_ns) {
+      const Event &e = events[next_event++];
+      switch (e.kind) {
+        case EventKind::CHANNELS: (void)driver.SetChannelsOn(e.arg); break;
+        case EventKind::APP: (void)driver.SetHoldCurrentMa(0, e.value); break;
+        case EventKind::FAULT:
+          bus.InjectFault(static_cast<FaultType>(e.arg), 0);
+          pending.push_back(bus.NowNs());
+          break;
+      }
+      continue;
+    }
+
+    r.wakes++;
+    if (!adaptive) {
+      do_poll();
+      next_wake_ns = t_ns + opt.fixed_ms * 1000000ull;
+      continue;
+    }
+    const PollAction a = sched.Check(now_us(), driver);
+    if (a == PollAction::POLL) do_poll();
+    const uint64_t delay_ns = std::min<uint64_t>(sched.GetDelayUs(now_us()) * 1000ull,
+                                                 opt.wake_ms * 1000000ull);
+    next_wake_ns = bus.NowNs() + std::max<uint64_t>(delay_ns, 1000u);
+  }
+  if (adaptive) {
+    r.skips = sched.GetStats().skips;
+    r.early = sched.GetStats().early_polls;
+  }
+  r.undetected = pending.size();
+  r.total_frames = bus.GetCounters().frames;
+  r.elapsed_ns = bus.NowNs() - origin_ns;
+  return r;
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+static bool parse_args(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    auto u32 = [&] { return static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0)); };
+    if (std::strcmp(a, "--duration-ms") == 0 && has_value) {
+      opt.duration_ms = u32();
+    } else if (std::strcmp(a, "--on-ms") == 0 && has_value) {
+      opt.on_ms = u32();
+    } else if (std::strcmp(a, "--off-ms") == 0 && has_value) {
+      opt.off_ms = u32();
+    } else if (std::strcmp(a, "--fixed-ms") == 0 && has_value) {
+      opt.fixed_ms = u32();
+    } else if (std::strcmp(a, "--wake-ms") == 0 && has_value) {
+      opt.wake_ms = u32();
+    } else if (std::strcmp(a, "--app-hz") == 0 && has_value) {
+      opt.app_hz = u32();
+    } else if (std::strcmp(a, "--fault-rate-hz") == 0 && has_value) {
+      opt.fault_rate_hz = std::strtod(argv[++i], nullptr);
+    } else if (std::strcmp(a, "--seed") == 0 && has_value) {
+      opt.seed = u32();
+    } else if (std::strcmp(a, "--sclk") == 0 && has_value) {
+      opt.sclk_hz = u32();
+    } else if (std::strcmp(a, "--frame-overhead-ns") == 0 && has_value) {
+      opt.frame_overhead_ns = u32();
+    } else {
+      std::fprintf(stderr, "unknown or incomplete argument: %s\n", a);
+      return false;
+    }
+  }
+  return opt.sclk_hz > 0 && opt.fixed_ms > 0 && opt.wake_ms > 0;
+}
+
+static void print_row(const char *name, const RunResult &r) {
+  std::vector<uint64_t> v = r.latency_us;
+  std::sort(v.begin(), v.end());
+  double mean = 0.0;
+  for (uint64_t x : v) mean += static_cast<double>(x);
+  mean = v.empty() ? 0.0 : mean / v.size();
+  const uint64_t p99 = v.empty() ? 0 : v[static_cast<size_t>(0.99 * (v.size() - 1))];
+  const uint64_t max = v.empty() ? 0 : v.back();
+  const double s = r.elapsed_ns / 1e9;
+  std::printf("%-9s %7" PRIu64 " %7.2f %6" PRIu64 " %6" PRIu64 " %9" PRIu64 " %8.4f%% %9.1f %9.1f "
+              "%9.1f %6" PRIu64 "\n",
+              name, r.polls, s > 0 ? r.polls / s : 0.0, r.skips, r.early, r.poll_frames,
+              s > 0 ? 100.0 * r.poll_wire_ns / r.elapsed_ns : 0.0, mean / 1e3, p99 / 1e3,
+              max / 1e3, r.undetected);
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    return 2;
+  }
+  const std::vector<Event> events = make_scenario(opt);
+  const RunResult fixed = run(opt, events, false);
+  const RunResult adaptive = run(opt, events, true);
+
+  std::printf("MAX22200 poll scheduler: %.1f s, CH0 %" PRIu32 "/%" PRIu32 " ms on/off, app %" PRIu32
+              " Hz, faults %.2f Hz, fixed %" PRIu32 " ms, wake %" PRIu32 " ms\n\n",
+              opt.duration_ms / 1e3, opt.on_ms, opt.off_ms, opt.app_hz, opt.fault_rate_hz,
+              opt.fixed_ms, opt.wake_ms);
+  std::printf("%-9s %7s %7s %6s %6s %9s %9s %9s %9s %9s %6s\n", "loop", "polls", "per s",
+              "skips", "early", "frames", "bus", "lat mean", "lat p99", "lat max", "missed");
+  std::printf("%-9s %7s %7s %6s %6s %9s %9s %9s %9s %9s %6s\n", "", "", "", "", "", "(poll)",
+              "(poll)", "(ms)", "(ms)", "(ms)", "");
+  print_row("fixed", fixed);
+  print_row("adaptive", adaptive);
+  if (adaptive.poll_frames > 0) {
+    std::printf("\npoll frames fixed / adaptive: %.2fx\n",
+                static_cast<double>(fixed.poll_frames) / adaptive.poll_frames);
+  }
+  return 0;
+}
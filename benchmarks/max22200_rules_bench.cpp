@@ -0,0 +1,276 @@
+/**
+ * @file max22200_rules_bench.cpp
+ * @brief Event → ONCH hand-off: driver RuleTable vs an application round trip.
+ *
+ * @details
+ *   Three sequences on eight CDR channels with a --hit-ms HIT phase:
+ *
+ *     fault hand-off  CH5 is on when the device raises OLF on CH5; the FAULT
+ *                     read must switch to CH6. The application path records
+ *                     the FaultCallback and calls SetChannelsOn()
+ *                     --app-latency-us later; the rule path is
+ *                     OnFault(5, OLF, on CH6, off CH5), queued by the read
+ *                     and applied by ServiceReactions() right after it.
+ *     hold hand-off   CH2 is switched on; 5 ms after its HIT phase ends CH3
+ *                     must follow. The rule OnHold(2, on CH3, delay 5 ms) is
+ *                     run by ServiceReactions(), called whenever
+ *                     GetReactionDelayUs() elapses.
+ *     chain           OLF on CH5 switches to CH6, "ON CH6" switches CH7 off
+ *                     and "OFF CH5" switches CH4 on: three rules, one write.
+ *
+ *   Latency is virtual bus time from the start of the FAULT read (for the hold
+ *   hand-off: from the driver's HIT → HOLD transition) to the CS rising edge
+ *   of the frame that latches the target ONCH. The run checks that every rule
+ *   path is one ONCH write (2 frames) beyond the triggering read and that the
+ *   chain ends in the expected ONCH.
+ *
+ * @par Usage
+ *   max22200_rules_bench [--app-latency-us N] [--frame-overhead-ns N] [--hit-ms N]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/max22200_emulated_bus.hpp"
+#include "max22200.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// BENCHMARK CONFIGURATION
+//==============================================================================
+
+namespace cfg {
+
+static constexpr uint32_t kAppLatencyUs    = 1000;  ///< Callback → application task running
+static constexpr uint32_t kFrameOverheadNs = 2000;  ///< CS/CMD handling per frame
+static constexpr uint32_t kHitMs           = 10;    ///< HIT phase of every channel
+static constexpr uint32_t kHandOffUs       = 5000;  ///< HOLD CH2 → CH3 on
+static constexpr uint32_t kIfsMa           = 1000;
+
+static constexpr uint8_t kOlfChannel   = 5;
+static constexpr uint8_t kSpareChannel = 6;
+static constexpr uint8_t kHoldChannel  = 2;
+static constexpr uint8_t kNextChannel  = 3;
+
+} // namespace cfg
+
+struct Options {
+  uint32_t app_latency_us = cfg::kAppLatencyUs;
+  uint32_t frame_overhead_ns = cfg::kFrameOverheadNs;
+  uint32_t hit_ms = cfg::kHitMs;
+};
+
+using Driver = MAX22200<EmulatedMax22200Bus>;
+
+static constexpr uint8_t bit(uint8_t ch) { return ReactionRule::Bit(ch); }
+
+//==============================================================================
+// FIXTURE
+//==============================================================================
+
+/// First frame latching exactly @p onch
+struct OnchProbe {
+  uint8_t onch = 0;
+  uint64_t latched_ns = 0;
+};
+
+static void probe_frame(const EmulatedFrame &frame, void *user_data) {
+  auto *p = static_cast<OnchProbe *>(user_data);
+  if (frame.onch_latch && p->latched_ns == 0 && frame.onch == p->onch) {
+    p->latched_ns = frame.end_ns;
+  }
+}
+
+static bool bring_up(Driver &driver, EmulatedMax22200Bus &bus, const Options &opt,
+                     uint8_t onch) {
+  bus.SetFrameOverheadNs(opt.frame_overhead_ns);
+  if (driver.Initialize() != DriverStatus::OK) return false;
+  ChannelConfig c;
+  c.drive_mode = DriveMode::CDR;
+  c.hit_setpoint = 600.0f;
+  c.hold_setpoint = 200.0f;
+  c.hit_time_ms = static_cast<float>(opt.hit_ms);
+  for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+    if (driver.ConfigureChannel(ch, c) != DriverStatus::OK) return false;
+  }
+  return driver.SetChannelsOn(onch) == DriverStatus::OK;
+}
+
+static void on_fault_record(uint8_t channel, FaultType, void *user_data) {
+  if (channel < NUM_CHANNELS_) *static_cast<uint8_t *>(user_data) |= bit(channel);
+}
+
+struct HoldProbe {
+  EmulatedMax22200Bus *bus = nullptr;
+  uint64_t hold_ns = 0;  ///< When the driver reported HIT → HOLD
+};
+
+static void on_state(uint8_t channel, ChannelState old_state, ChannelState new_state,
+                     void *user_data) {
+  auto *p = static_cast<HoldProbe *>(user_data);
+  if (channel == cfg::kHoldChannel && old_state == ChannelState::HIT_PHASE &&
+      new_state == ChannelState::HOLD_PHASE && p->hold_ns == 0) {
+    p->hold_ns = p->bus->NowNs();
+  }
+}
+
+static Driver make_driver(EmulatedMax22200Bus &bus) {
+  BoardConfig board;
+  board.full_scale_current_ma = cfg::kIfsMa;
+  return Driver(bus, board);
+}
+
+//==============================================================================
+// SEQUENCES
+//==============================================================================
+
+struct Result {
+  bool ok = false;
+  uint64_t ns = 0;
+  uint64_t frames = 0;  ///< Frames beyond the triggering read / service call
+};
+
+/// OLF on CH5 read by ReadFaultRegister(); @p rules = nullptr runs the application path
+static Result fault_hand_off(const Options &opt, const RuleTable *rules, uint8_t onch0,
+                             uint8_t expected) {
+  EmulatedMax22200Bus bus(false);
+  Driver driver = make_driver(bus);
+  Result r;
+  if (!bring_up(driver, bus, opt, onch0)) return r;
+  uint8_t pending = 0;
+  driver.SetFaultCallback(on_fault_record, &pending);
+  driver.SetRuleTable(rules);
+  OnchProbe probe;
+  probe.onch = expected;
+  bus.SetFrameObserver(probe_frame, &probe);
+
+  // Frames of a FAULT read without a rule write, for the "extra frames" column
+  FaultStatus faults;
+  uint64_t frames0 = bus.GetCounters().frames;
+  driver.ReadFaultRegister(faults);
+  const uint64_t read_frames = bus.GetCounters().frames - frames0;
+
+  bus.InjectFault(FaultType::OLF, cfg::kOlfChannel);
+  frames0 = bus.GetCounters().frames;
+  const uint64_t t0 = bus.NowNs();
+  if (driver.ReadFaultRegister(faults) != DriverStatus::OK) return r;
+  if (rules != nullptr) {
+    if (driver.ServiceReactions() != DriverStatus::OK) return r;
+  } else if (pending != 0) {
+    bus.AdvanceNs(static_cast<uint64_t>(opt.app_latency_us) * 1000u);
+    driver.SetChannelsOn(expected);
+  }
+  r.frames = bus.GetCounters().frames - frames0 - read_frames;
+  r.ok = probe.latched_ns != 0 && bus.onch() == expected;
+  r.ns = probe.latched_ns - t0;
+  return r;
+}
+
+/// CH2 on; CH3 must latch kHandOffUs after the driver sees CH2 enter HOLD
+static Result hold_hand_off(const Options &opt, uint64_t &late_ns) {
+  EmulatedMax22200Bus bus(false);
+  Driver driver = make_driver(bus);
+  Result r;
+  RuleTable rules;
+  rules.Add(ReactionRule::OnHold(cfg::kHoldChannel, bit(cfg::kNextChannel), 0, cfg::kHandOffUs));
+  driver.SetRuleTable(&rules);
+  if (!bring_up(driver, bus, opt, 0)) return r;
+  OnchProbe probe;
+  probe.onch = bit(cfg::kHoldChannel) | bit(cfg::kNextChannel);
+  bus.SetFrameObserver(probe_frame, &probe);
+  HoldProbe hold;
+  hold.bus = &bus;
+  driver.SetStateChangeCallback(on_state, &hold);
+
+  if (driver.SetChannelsOn(bit(cfg::kHoldChannel)) != DriverStatus::OK) return r;
+  uint64_t frames = 0;
+  for (int step = 0; step < 8 && probe.latched_ns == 0; ++step) {
+    const uint32_t delay = driver.GetReactionDelayUs();
+    if (delay == UINT32_MAX) break;
+    bus.AdvanceNs(static_cast<uint64_t>(delay) * 1000u);
+    const uint64_t frames0 = bus.GetCounters().frames;
+    if (driver.ServiceReactions() != DriverStatus::OK) return r;
+    frames += bus.GetCounters().frames - frames0;
+  }
+  r.frames = frames;
+  r.ok = probe.latched_ns != 0 && hold.hold_ns != 0 && driver.GetArmedRules() == 0;
+  const uint64_t due_ns = hold.hold_ns + static_cast<uint64_t>(cfg::kHandOffUs) * 1000u;
+  late_ns = probe.latched_ns > due_ns ? probe.latched_ns - due_ns : 0;
+  r.ns = probe.latched_ns - hold.hold_ns;
+  return r;
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+static bool parse_args(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    auto u32 = [&] { return static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0)); };
+    if (std::strcmp(a, "--app-latency-us") == 0 && has_value) {
+      opt.app_latency_us = u32();
+    } else if (std::strcmp(a, "--frame-overhead-ns") == 0 && has_value) {
+      opt.frame_overhead_ns = u32();
+    } else if (std::strcmp(a, "--hit-ms") == 0 && has_value) {
+      opt.hit_ms = u32();
+    } else {
+      std::fprintf(stderr, "unknown or incomplete argument: %s\n", a);
+      return false;
+    }
+  }
+  return opt.hit_ms > 0 && opt.hit_ms <= 100;
+}
+
+static void print_row(const char *name, const Result &r) {
+  std::printf("  %-34s %8" PRIu64 " %14.1f%s\n", name, r.frames, r.ns / 1e3,
+              r.ok ? "" : "  FAILED");
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    return 2;
+  }
+
+  const uint8_t onch0 = bit(cfg::kOlfChannel) | bit(7);
+  const uint8_t switched = static_cast<uint8_t>((onch0 & ~bit(cfg::kOlfChannel)) | bit(cfg::kSpareChannel));
+
+  RuleTable hand_off;
+  hand_off.Add(ReactionRule::OnFault(cfg::kOlfChannel, FaultType::OLF, bit(cfg::kSpareChannel),
+                                     bit(cfg::kOlfChannel)));
+  RuleTable chain = hand_off;
+  chain.Add(ReactionRule::OnOn(cfg::kSpareChannel, 0, bit(7)));
+  chain.Add(ReactionRule::OnOff(cfg::kOlfChannel, bit(4), 0));
+  const uint8_t chained = bit(cfg::kSpareChannel) | bit(4);
+
+  const Result app = fault_hand_off(opt, nullptr, onch0, switched);
+  const Result rule = fault_hand_off(opt, &hand_off, onch0, switched);
+  const Result chn = fault_hand_off(opt, &chain, onch0, chained);
+  uint64_t late_ns = 0;
+  const Result hold = hold_hand_off(opt, late_ns);
+
+  std::printf("MAX22200 rules: OLF CH%u -> CH%u, HOLD CH%u -> CH%u after %" PRIu32
+              " us (app latency %" PRIu32 " us, HIT %" PRIu32 " ms)\n\n",
+              cfg::kOlfChannel, cfg::kSpareChannel, cfg::kHoldChannel, cfg::kNextChannel,
+              cfg::kHandOffUs, opt.app_latency_us, opt.hit_ms);
+  std::printf("  %-34s %8s %14s\n", "path", "frames+", "latency (us)");
+  print_row("OLF: application (callback + task)", app);
+  print_row("OLF: rule", rule);
+  print_row("OLF: chain of 3 rules", chn);
+  print_row("HOLD: rule + ServiceReactions()", hold);
+
+  const bool one_write = rule.frames == 2 && chn.frames == 2 && hold.frames == 2;
+  const bool on_time = hold.ok && hold.ns >= static_cast<uint64_t>(cfg::kHandOffUs) * 1000u &&
+                       late_ns < 100000u;  // Within the service call's own frames
+  std::printf("\n  %-44s %s\n", "every rule path is one ONCH write", one_write ? "yes" : "NO");
+  std::printf("  %-44s %s (%.1f us after due)\n", "HOLD hand-off on time", on_time ? "yes" : "NO",
+              late_ns / 1e3);
+  return (app.ok && rule.ok && chn.ok && hold.ok && one_write && on_time) ? 0 : 1;
+}
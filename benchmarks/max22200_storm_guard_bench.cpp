@@ -0,0 +1,219 @@
+/**
+ * @file max22200_storm_guard_bench.cpp
+ * @brief nFAULT interrupt storm: FaultStormGuard masking vs servicing every edge.
+ *
+ * @details
+ *   A shorted load on CH4 raises OCP every --storm-period-us for --storm-ms.
+ *   The fault task services nFAULT the usual way: --irq-latency-us after the
+ *   edge it calls ReadSnapshot(clear all). With the guard, each interrupt is
+ *   fed to FaultStormGuard::OnInterrupt(); once OCP trips, it is masked from
+ *   nFAULT and polled every poll_period_us until it has been quiet for
+ *   quiet_us.
+ *
+ *   During the storm an unrelated OLF is raised on CH2, and after the storm an
+ *   isolated OCP on CH1. For each run the benchmark reports interrupts, polls
+ *   and the share of virtual time the bus spent in fault handling. The guarded
+ *   run must:
+ *     - take at most trip_count interrupts from the storm;
+ *     - still take the OLF by interrupt;
+ *     - unmask OCP after the storm, so the isolated OCP interrupts again.
+ *
+ * @par Usage
+ *   max22200_storm_guard_bench [--storm-period-us N] [--storm-ms N]
+ *                              [--irq-latency-us N] [--frame-overhead-ns N]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/max22200_emulated_bus.hpp"
+#include "max22200.hpp"
+#include "max22200_storm_guard.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// BENCHMARK CONFIGURATION
+//==============================================================================
+
+namespace cfg {
+
+static constexpr uint32_t kStormPeriodUs   = 200;   ///< OCP re-raised this often (5 kHz)
+static constexpr uint32_t kStormMs         = 500;   ///< Storm length
+static constexpr uint32_t kIrqLatencyUs    = 5;     ///< nFAULT edge → task running
+static constexpr uint32_t kFrameOverheadNs = 2000;  ///< CS/CMD handling per frame
+static constexpr uint32_t kIdleStepUs      = 10;    ///< Simulation step while nothing happens
+
+static constexpr uint8_t kStormChannel = 4;
+static constexpr uint8_t kOlfChannel   = 2;
+static constexpr uint8_t kLateChannel  = 1;
+
+} // namespace cfg
+
+struct Options {
+  uint32_t storm_period_us = cfg::kStormPeriodUs;
+  uint32_t storm_ms = cfg::kStormMs;
+  uint32_t irq_latency_us = cfg::kIrqLatencyUs;
+  uint32_t frame_overhead_ns = cfg::kFrameOverheadNs;
+};
+
+//==============================================================================
+// ONE RUN
+//==============================================================================
+
+struct RunResult {
+  bool ok = false;
+  uint64_t interrupts = 0;
+  uint64_t storm_interrupts = 0;  ///< Interrupts caused by the storm alone
+  uint64_t polls = 0;
+  uint64_t fault_bus_ns = 0;      ///< Virtual time spent servicing interrupts and polls
+  uint64_t total_ns = 0;
+  bool olf_by_irq = false;
+  bool late_ocp_by_irq = false;
+  uint64_t released_at_ms = 0;    ///< When the guard unmasked OCP (0 = never)
+};
+
+static RunResult run(const Options &opt, bool guarded) {
+  EmulatedMax22200Bus bus(true);
+  bus.SetFrameOverheadNs(opt.frame_overhead_ns);
+  MAX22200<EmulatedMax22200Bus> driver(bus, BoardConfig(30.0f, false));
+  RunResult r;
+  if (driver.Initialize() != DriverStatus::OK || driver.SetChannelsOn(0xFF) != DriverStatus::OK) {
+    std::fprintf(stderr, "init failed\n");
+    return r;
+  }
+  FaultStormGuard guard;
+  const StormGuardConfig &gc = guard.GetConfig();
+
+  const uint64_t start_ns = bus.NowNs();
+  const uint64_t storm_end_ns = start_ns + static_cast<uint64_t>(opt.storm_ms) * 1000000u;
+  const uint64_t olf_ns = start_ns + (storm_end_ns - start_ns) / 2;
+  // Isolated OCP once the guard must have released (quiet time + one poll period + margin)
+  const uint64_t late_ns = storm_end_ns + (static_cast<uint64_t>(gc.quiet_us) +
+                                           2u * gc.poll_period_us) * 1000u;
+  const uint64_t end_ns = late_ns + 50000000u;
+  uint64_t next_storm_ns = start_ns;
+  bool olf_done = false;
+  bool late_done = false;
+
+  while (bus.NowNs() < end_ns) {
+    const uint64_t now_ns = bus.NowNs();
+    while (next_storm_ns <= now_ns && next_storm_ns < storm_end_ns) {
+      bus.InjectFault(FaultType::OCP, cfg::kStormChannel);
+      next_storm_ns += static_cast<uint64_t>(opt.storm_period_us) * 1000u;
+    }
+    if (!olf_done && now_ns >= olf_ns) {
+      bus.InjectFault(FaultType::OLF, cfg::kOlfChannel);
+      olf_done = true;
+    }
+    if (!late_done && now_ns >= late_ns) {
+      bus.InjectFault(FaultType::OCP, cfg::kLateChannel);
+      late_done = true;
+    }
+
+    bool pin = false;
+    driver.GetFaultPinState(pin);
+    const uint32_t now_us = bus.GetTimeUs();
+    Snapshot snap;
+    if (pin) {
+      bus.AdvanceNs(static_cast<uint64_t>(opt.irq_latency_us) * 1000u);
+      const uint64_t t0 = bus.NowNs();
+      if (driver.ReadSnapshot(snap, 0xFF) != DriverStatus::OK) return r;
+      r.interrupts++;
+      if (snap.faults.channelsWithAnyFault() == (1u << cfg::kStormChannel)) {
+        r.storm_interrupts++;
+      }
+      if ((snap.faults.open_load_fault_channel_mask & (1u << cfg::kOlfChannel)) != 0) {
+        r.olf_by_irq = true;
+      }
+      if ((snap.faults.overcurrent_channel_mask & (1u << cfg::kLateChannel)) != 0) {
+        r.late_ocp_by_irq = true;
+      }
+      if (guarded && guard.OnInterrupt(bus.GetTimeUs(), driver, snap) != DriverStatus::OK) return r;
+      r.fault_bus_ns += bus.NowNs() - t0;
+    } else if (guarded && guard.IsPollDue(now_us)) {
+      const uint64_t t0 = bus.NowNs();
+      if (driver.ReadSnapshot(snap, 0xFF) != DriverStatus::OK) return r;
+      r.polls++;
+      const bool was_masked = guard.GetMaskedTypes() != 0;
+      if (guard.OnPolled(bus.GetTimeUs(), driver, snap) != DriverStatus::OK) return r;
+      if (was_masked && guard.GetMaskedTypes() == 0) {
+        r.released_at_ms = (bus.NowNs() - start_ns) / 1000000u;
+      }
+      r.fault_bus_ns += bus.NowNs() - t0;
+    } else {
+      bus.AdvanceNs(static_cast<uint64_t>(cfg::kIdleStepUs) * 1000u);
+    }
+  }
+  r.total_ns = bus.NowNs() - start_ns;
+  r.ok = true;
+  return r;
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+static bool parse_args(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    auto u32 = [&] { return static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0)); };
+    if (std::strcmp(a, "--storm-period-us") == 0 && has_value) {
+      opt.storm_period_us = u32();
+    } else if (std::strcmp(a, "--storm-ms") == 0 && has_value) {
+      opt.storm_ms = u32();
+    } else if (std::strcmp(a, "--irq-latency-us") == 0 && has_value) {
+      opt.irq_latency_us = u32();
+    } else if (std::strcmp(a, "--frame-overhead-ns") == 0 && has_value) {
+      opt.frame_overhead_ns = u32();
+    } else {
+      std::fprintf(stderr, "unknown or incomplete argument: %s\n", a);
+      return false;
+    }
+  }
+  return opt.storm_period_us > 0 && opt.storm_ms > 0;
+}
+
+static void print_row(const char *name, const RunResult &r) {
+  std::printf("  %-14s %11" PRIu64 " %11" PRIu64 " %7" PRIu64 " %10.2f %8s %10s\n", name,
+              r.interrupts, r.storm_interrupts, r.polls,
+              r.total_ns ? 100.0 * static_cast<double>(r.fault_bus_ns) / r.total_ns : 0.0,
+              r.olf_by_irq ? "yes" : "no", r.late_ocp_by_irq ? "yes" : "no");
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    return 2;
+  }
+
+  const RunResult plain = run(opt, false);
+  const RunResult guarded = run(opt, true);
+  const StormGuardConfig gc;
+
+  std::printf("MAX22200 storm guard: OCP CH%u every %" PRIu32 " us for %" PRIu32
+              " ms (trip %u in %" PRIu32 " us, poll %" PRIu32 " us, quiet %" PRIu32 " us)\n\n",
+              cfg::kStormChannel, opt.storm_period_us, opt.storm_ms, gc.trip_count, gc.window_us,
+              gc.poll_period_us, gc.quiet_us);
+  std::printf("  %-14s %11s %11s %7s %10s %8s %10s\n", "run", "interrupts", "from storm", "polls",
+              "fault bus%", "OLF irq", "late irq");
+  print_row("every edge", plain);
+  print_row("storm guard", guarded);
+
+  const bool bounded = guarded.storm_interrupts <= gc.trip_count;
+  const bool released = guarded.released_at_ms != 0;
+  std::printf("\n  %-44s %s (%" PRIu64 ")\n", "guarded storm interrupts <= trip_count",
+              bounded ? "yes" : "NO", guarded.storm_interrupts);
+  std::printf("  %-44s %s", "OCP unmasked after the storm", released ? "yes" : "NO");
+  if (released) std::printf(" (at %" PRIu64 " ms)", guarded.released_at_ms);
+  std::printf("\n");
+
+  const bool ok = plain.ok && guarded.ok && bounded && released && guarded.olf_by_irq &&
+                  guarded.late_ocp_by_irq && plain.olf_by_irq && plain.late_ocp_by_irq;
+  return ok ? 0 : 1;
+}
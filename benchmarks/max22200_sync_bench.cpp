@@ -0,0 +1,294 @@
+/**
+ * @file max22200_sync_bench.cpp
+ * @brief Inter-device ONCH skew: SyncOnchGroup vs back-to-back SetChannelsOn().
+ *
+ * @details
+ *   --devices emulated devices share one SPI host (one virtual clock, one CS
+ *   each). Every update switches a new ONCH pattern on all devices, --updates
+ *   times, three ways:
+ *
+ *     back to back  SetChannelsOn() on each device in turn
+ *     commit each   CommitChannelsOn() on each armed device in turn (data
+ *                   frames with the driver bookkeeping between them)
+ *     sync (cold)   SyncOnchGroup::Update() with devices disarmed by a STATUS
+ *                   read in between (arm frames inside the call)
+ *     sync (armed)  SyncOnchGroup::Update() in a steady stream (data frames only)
+ *
+ *   Skew is the virtual time between the first and the last ONCH latch of an
+ *   update, taken from the emulator's frames. The virtual clock only counts
+ *   bus time, so the host time between the same two latches is reported as
+ *   well: it holds the host work done between the frames. The benchmark also
+ *   reports the call's bus time and SyncStats::max_skew_us, the skew the group
+ *   measures itself with GetTimeUs(). The synchronised skew must be
+ *   (devices - 1) data frames, its host skew must be below that of commit
+ *   each, and every device must end up with the written pattern. Finally a
+ *   ValveMap group spanning all devices is switched through Update(masks).
+ *
+ * @par Usage
+ *   max22200_sync_bench [--devices N] [--updates N] [--frame-overhead-ns N]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include "common/max22200_emulated_bus.hpp"
+#include "max22200.hpp"
+#include "max22200_sync.hpp"
+#include "max22200_valve_map.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// BENCHMARK CONFIGURATION
+//==============================================================================
+
+namespace cfg {
+
+static constexpr uint32_t kDevices         = 4;
+static constexpr uint32_t kMaxDevices      = 8;
+static constexpr uint32_t kUpdates         = 100;
+static constexpr uint32_t kFrameOverheadNs = 2000;  ///< CS/CMD handling per frame
+
+} // namespace cfg
+
+struct Options {
+  uint32_t devices = cfg::kDevices;
+  uint32_t updates = cfg::kUpdates;
+  uint32_t frame_overhead_ns = cfg::kFrameOverheadNs;
+};
+
+using Driver = MAX22200<EmulatedMax22200Bus>;
+using Sync = SyncOnchGroup<Driver, cfg::kMaxDevices>;
+
+//==============================================================================
+// FIXTURE
+//==============================================================================
+
+/// ONCH latch times of the current update, across all devices
+struct LatchWindow {
+  uint64_t first_ns = 0;
+  uint64_t last_ns = 0;
+  std::chrono::steady_clock::time_point first_host;
+  std::chrono::steady_clock::time_point last_host;
+  uint32_t latches = 0;
+
+  uint64_t host_ns() const {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(last_host - first_host).count());
+  }
+};
+
+static void probe_frame(const EmulatedFrame &frame, void *user_data) {
+  if (!frame.onch_latch) return;
+  auto *w = static_cast<LatchWindow *>(user_data);
+  const auto host = std::chrono::steady_clock::now();
+  if (w->latches++ == 0) {
+    w->first_ns = frame.end_ns;
+    w->first_host = host;
+  }
+  w->last_ns = frame.end_ns;
+  w->last_host = host;
+}
+
+struct Rig {
+  EmulatedMax22200Bus bus[cfg::kMaxDevices];
+  std::unique_ptr<Driver> dev[cfg::kMaxDevices];
+  Sync sync;
+  LatchWindow window;
+  uint8_t devices = 0;
+
+  bool bring_up(const Options &opt) {
+    devices = static_cast<uint8_t>(opt.devices);
+    for (uint8_t d = 0; d < devices; ++d) {
+      bus[d] = EmulatedMax22200Bus(false);
+      if (d != 0) bus[d].ShareClock(&bus[0]);
+      bus[d].SetFrameOverheadNs(opt.frame_overhead_ns);
+      bus[d].SetFrameObserver(probe_frame, &window);
+      dev[d] = std::make_unique<Driver>(bus[d]);
+      if (dev[d]->Initialize() != DriverStatus::OK || !sync.AttachDevice(d, *dev[d])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  uint8_t all() const { return static_cast<uint8_t>((1u << devices) - 1u); }
+  uint64_t now() const { return bus[0].NowNs(); }
+  bool onch_is(const uint8_t *onch) const {
+    for (uint8_t d = 0; d < devices; ++d) {
+      if (bus[d].onch() != onch[d]) return false;
+    }
+    return true;
+  }
+};
+
+//==============================================================================
+// RUNS
+//==============================================================================
+
+enum class Mode { BACK_TO_BACK, COMMIT_EACH, SYNC_COLD, SYNC_ARMED };
+
+struct RunResult {
+  bool ok = true;
+  uint64_t max_skew_ns = 0;
+  double mean_skew_ns = 0;
+  double mean_call_ns = 0;
+  double mean_host_skew_ns = 0;  ///< Host time between the first and last latch
+  uint32_t self_max_skew_us = 0;  ///< SyncStats::max_skew_us
+};
+
+static RunResult run(const Options &opt, Mode mode) {
+  Rig rig;
+  RunResult r;
+  if (!rig.bring_up(opt)) {
+    r.ok = false;
+    return r;
+  }
+  uint64_t skew_sum = 0;
+  uint64_t call_sum = 0;
+  uint64_t host_sum = 0;
+  if (mode == Mode::COMMIT_EACH) rig.sync.Arm();
+  for (uint32_t u = 0; u < opt.updates; ++u) {
+    uint8_t onch[cfg::kMaxDevices];
+    for (uint8_t d = 0; d < rig.devices; ++d) {
+      onch[d] = static_cast<uint8_t>((u * 37u + d * 11u + 1u) & 0xFFu);
+    }
+    if (mode == Mode::SYNC_COLD) {
+      // Unrelated traffic between updates leaves every device disarmed
+      for (uint8_t d = 0; d < rig.devices; ++d) {
+        StatusConfig status;
+        rig.dev[d]->ReadStatus(status);
+      }
+    }
+    rig.bus[0].AdvanceNs(100000u);
+    rig.window = LatchWindow();
+    const uint64_t t0 = rig.now();
+    if (mode == Mode::BACK_TO_BACK) {
+      for (uint8_t d = 0; d < rig.devices; ++d) rig.dev[d]->SetChannelsOn(onch[d]);
+    } else if (mode == Mode::COMMIT_EACH) {
+      for (uint8_t d = 0; d < rig.devices; ++d) {
+        if (rig.dev[d]->CommitChannelsOn(onch[d]) != DriverStatus::OK) r.ok = false;
+      }
+    } else if (rig.sync.Update(onch, rig.all()) != DriverStatus::OK) {
+      r.ok = false;
+    }
+    call_sum += rig.now() - t0;
+    const uint64_t skew = rig.window.last_ns - rig.window.first_ns;
+    skew_sum += skew;
+    host_sum += rig.window.host_ns();
+    if (skew > r.max_skew_ns) r.max_skew_ns = skew;
+    r.ok = r.ok && rig.window.latches == rig.devices && rig.onch_is(onch);
+  }
+  r.mean_skew_ns = static_cast<double>(skew_sum) / opt.updates;
+  r.mean_call_ns = static_cast<double>(call_sum) / opt.updates;
+  r.mean_host_skew_ns = static_cast<double>(host_sum) / opt.updates;
+  r.self_max_skew_us = rig.sync.GetStats().max_skew_us;
+  return r;
+}
+
+/// A ValveMap group over all devices, committed with SyncOnchGroup::Update(masks)
+static bool run_valve_group(const Options &opt, uint64_t &skew_ns) {
+  Rig rig;
+  if (!rig.bring_up(opt)) return false;
+  ValveMap<Driver, cfg::kMaxDevices, 64> valves;
+  for (uint8_t d = 0; d < rig.devices; ++d) valves.AttachDevice(d, *rig.dev[d]);
+  for (uint8_t v = 0; v < rig.devices * NUM_CHANNELS_; ++v) {
+    if (!valves.Map(v, v % rig.devices, v / rig.devices)) return false;
+  }
+  // Channel 3 of every device
+  ValveSet group = 0;
+  for (uint8_t d = 0; d < rig.devices; ++d) {
+    group |= ValveBit(static_cast<uint8_t>(3 * rig.devices + d));
+  }
+  rig.sync.Arm();
+  rig.window = LatchWindow();
+  if (rig.sync.Update(valves.Compile(group, 0)) != DriverStatus::OK) return false;
+  skew_ns = rig.window.last_ns - rig.window.first_ns;
+  for (uint8_t v = 0; v < rig.devices * NUM_CHANNELS_; ++v) {
+    if (valves.IsOn(v) != ((group & ValveBit(v)) != 0)) return false;
+  }
+  return rig.window.latches == rig.devices;
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+static bool parse_args(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    auto u32 = [&] { return static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0)); };
+    if (std::strcmp(a, "--devices") == 0 && has_value) {
+      opt.devices = u32();
+    } else if (std::strcmp(a, "--updates") == 0 && has_value) {
+      opt.updates = u32();
+    } else if (std::strcmp(a, "--frame-overhead-ns") == 0 && has_value) {
+      opt.frame_overhead_ns = u32();
+    } else {
+      std::fprintf(stderr, "unknown or incomplete argument: %s\n", a);
+      return false;
+    }
+  }
+  return opt.devices >= 2 && opt.devices <= cfg::kMaxDevices && opt.updates > 0;
+}
+
+static void print_row(const char *name, const RunResult &r, bool self) {
+  std::printf("  %-16s %12.2f %12.2f %12.2f %12.0f", name, r.mean_skew_ns / 1e3,
+              r.max_skew_ns / 1e3, r.mean_call_ns / 1e3, r.mean_host_skew_ns);
+  if (self) {
+    std::printf(" %12" PRIu32, r.self_max_skew_us);
+  } else {
+    std::printf(" %12s", "-");
+  }
+  std::printf("%s\n", r.ok ? "" : "  FAILED");
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    return 2;
+  }
+
+  const RunResult b2b = run(opt, Mode::BACK_TO_BACK);
+  const RunResult each = run(opt, Mode::COMMIT_EACH);
+  const RunResult cold = run(opt, Mode::SYNC_COLD);
+  const RunResult armed = run(opt, Mode::SYNC_ARMED);
+  uint64_t group_skew_ns = 0;
+  const bool group_ok = run_valve_group(opt, group_skew_ns);
+
+  // One 8-bit data frame: wire time plus per-frame overhead
+  EmulatedMax22200Bus probe(false);
+  probe.SetFrameOverheadNs(opt.frame_overhead_ns);
+  const uint64_t frame_ns = 8ull * 1000000000ull / probe.GetSclkHz() + opt.frame_overhead_ns;
+  const uint64_t expected_ns = (opt.devices - 1u) * frame_ns;
+
+  std::printf("MAX22200 sync: %" PRIu32 " devices, %" PRIu32 " updates, frame overhead %" PRIu32
+              " ns\n\n",
+              opt.devices, opt.updates, opt.frame_overhead_ns);
+  std::printf("  %-16s %12s %12s %12s %12s %12s\n", "path", "skew us", "max skew us", "call us",
+              "host skew ns", "self max us");
+  print_row("back to back", b2b, false);
+  print_row("commit each", each, false);
+  print_row("sync (cold)", cold, true);
+  print_row("sync (armed)", armed, true);
+
+  const bool tight = cold.max_skew_ns == expected_ns && armed.max_skew_ns == expected_ns;
+  const bool better = armed.max_skew_ns < b2b.max_skew_ns;
+  const bool host_better = armed.mean_host_skew_ns < each.mean_host_skew_ns;
+  std::printf("\n  %-44s %s (%.2f us)\n", "sync skew = (devices - 1) data frames",
+              tight ? "yes" : "NO", expected_ns / 1e3);
+  std::printf("  %-44s %s\n", "sync skew below back to back", better ? "yes" : "NO");
+  std::printf("  %-44s %s\n", "sync host skew below commit each", host_better ? "yes" : "NO");
+  std::printf("  %-44s %s (%.2f us skew)\n", "ValveMap group via Update(masks)",
+              group_ok ? "yes" : "NO", group_skew_ns / 1e3);
+  return (b2b.ok && each.ok && cold.ok && armed.ok && tight && better && host_better && group_ok)
+             ? 0
+             : 1;
+}
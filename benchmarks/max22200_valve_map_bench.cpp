@@ -0,0 +1,238 @@
+/**
+ * @file max22200_valve_map_bench.cpp
+ * @brief Logical valve groups: ValveMap per-device masks vs SetChannelEnabled() per valve.
+ *
+ * @details
+ *   --devices emulated devices share one SPI host (one virtual clock). Logical
+ *   valve v is mapped to device v % devices, channel v / devices, so any group
+ *   spreads over the devices. For group sizes 1 .. all valves the run switches
+ *   the group on and back off twice:
+ *
+ *     per valve  SetChannelEnabled() on the valve's device, once per valve
+ *     ValveMap   Switch() with the whole group (Compile() + Apply())
+ *
+ *   and reports ONCH writes and bus time per switch. Both paths must leave
+ *   identical ONCH on every device, and ValveMap must issue at most one write
+ *   per device. A precompiled group (channel 0 of every device) must switch
+ *   on with SetGroup() in one write per device. It also times Compile() of
+ *   all valves on the host.
+ *
+ * @par Usage
+ *   max22200_valve_map_bench [--devices N] [--frame-overhead-ns N]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include "common/max22200_emulated_bus.hpp"
+#include "max22200.hpp"
+#include "max22200_valve_map.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// BENCHMARK CONFIGURATION
+//==============================================================================
+
+namespace cfg {
+
+static constexpr uint32_t kDevices         = 3;
+static constexpr uint32_t kMaxDevices      = 8;
+static constexpr uint32_t kFrameOverheadNs = 2000;  ///< CS/CMD handling per frame
+static constexpr uint32_t kRepeats         = 2;     ///< On / off cycles per group size
+static constexpr uint32_t kTimingIterations = 2000000;
+
+} // namespace cfg
+
+struct Options {
+  uint32_t devices = cfg::kDevices;
+  uint32_t frame_overhead_ns = cfg::kFrameOverheadNs;
+};
+
+using Driver = MAX22200<EmulatedMax22200Bus>;
+using Map = ValveMap<Driver, cfg::kMaxDevices, 64>;
+
+//==============================================================================
+// FIXTURE
+//==============================================================================
+
+struct Rig {
+  EmulatedMax22200Bus bus[cfg::kMaxDevices];
+  std::unique_ptr<Driver> dev[cfg::kMaxDevices];
+  Map map;
+  uint8_t devices = 0;
+
+  Rig() {
+    for (uint8_t d = 0; d < cfg::kMaxDevices; ++d) bus[d] = EmulatedMax22200Bus(false);
+  }
+
+  bool bring_up(const Options &opt) {
+    devices = static_cast<uint8_t>(opt.devices);
+    for (uint8_t d = 0; d < devices; ++d) {
+      if (d != 0) bus[d].ShareClock(&bus[0]);
+      bus[d].SetFrameOverheadNs(opt.frame_overhead_ns);
+      dev[d] = std::make_unique<Driver>(bus[d]);
+      if (dev[d]->Initialize() != DriverStatus::OK || !map.AttachDevice(d, *dev[d])) {
+        return false;
+      }
+    }
+    for (uint8_t v = 0; v < valves(); ++v) {
+      if (!map.Map(v, v % devices, v / devices)) return false;
+    }
+    return true;
+  }
+
+  uint8_t valves() const { return static_cast<uint8_t>(devices * NUM_CHANNELS_); }
+  uint64_t latches() const {
+    uint64_t n = 0;
+    for (uint8_t d = 0; d < devices; ++d) n += bus[d].GetCounters().onch_latches;
+    return n;
+  }
+  bool same_onch(const Rig &other) const {
+    for (uint8_t d = 0; d < devices; ++d) {
+      if (bus[d].onch() != other.bus[d].onch()) return false;
+    }
+    return true;
+  }
+};
+
+//==============================================================================
+// GROUP SWITCHING
+//==============================================================================
+
+struct Row {
+  uint8_t size = 0;
+  double writes_per_switch[2] = {};  ///< [per valve, ValveMap]
+  double us_per_switch[2] = {};
+  uint64_t max_map_writes = 0;       ///< Largest ValveMap switch
+  bool same = true;
+};
+
+static Row run_group(Rig &per_valve, Rig &mapped, uint8_t size) {
+  Row row;
+  row.size = size;
+  const ValveSet group = size >= 64 ? ~ValveSet{0} : (ValveBit(size) - 1u);
+  uint64_t writes[2] = {};
+  uint64_t ns[2] = {};
+  uint32_t switches = 0;
+  for (uint32_t rep = 0; rep < cfg::kRepeats; ++rep) {
+    for (int on = 1; on >= 0; --on) {
+      uint64_t w0 = per_valve.latches();
+      uint64_t t0 = per_valve.bus[0].NowNs();
+      for (uint8_t v = 0; v < size; ++v) {
+        per_valve.dev[v % per_valve.devices]->SetChannelEnabled(
+            static_cast<uint8_t>(v / per_valve.devices), on != 0);
+      }
+      writes[0] += per_valve.latches() - w0;
+      ns[0] += per_valve.bus[0].NowNs() - t0;
+
+      w0 = mapped.latches();
+      t0 = mapped.bus[0].NowNs();
+      mapped.map.Switch(on ? group : 0, on ? 0 : group);
+      const uint64_t w = mapped.latches() - w0;
+      writes[1] += w;
+      ns[1] += mapped.bus[0].NowNs() - t0;
+      if (w > row.max_map_writes) row.max_map_writes = w;
+
+      row.same = row.same && per_valve.same_onch(mapped);
+      switches++;
+    }
+  }
+  for (int p = 0; p < 2; ++p) {
+    row.writes_per_switch[p] = static_cast<double>(writes[p]) / switches;
+    row.us_per_switch[p] = static_cast<double>(ns[p]) / 1e3 / switches;
+  }
+  return row;
+}
+
+//==============================================================================
+// HOST COST
+//==============================================================================
+
+static double time_compile(const Rig &rig, ValveSet group) {
+  volatile uint8_t sink = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < cfg::kTimingIterations; ++i) {
+    const Map::Masks m = rig.map.Compile(group ^ (i & 1u), 0);
+    sink = sink + m.on[0] + m.devices;
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / cfg::kTimingIterations;
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+static bool parse_args(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    auto u32 = [&] { return static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0)); };
+    if (std::strcmp(a, "--devices") == 0 && has_value) {
+      opt.devices = u32();
+    } else if (std::strcmp(a, "--frame-overhead-ns") == 0 && has_value) {
+      opt.frame_overhead_ns = u32();
+    } else {
+      std::fprintf(stderr, "unknown or incomplete argument: %s\n", a);
+      return false;
+    }
+  }
+  return opt.devices >= 1 && opt.devices <= cfg::kMaxDevices;
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    return 2;
+  }
+
+  Rig per_valve;
+  Rig mapped;
+  if (!per_valve.bring_up(opt) || !mapped.bring_up(opt)) {
+    std::fprintf(stderr, "bring-up failed\n");
+    return 1;
+  }
+
+  std::printf("MAX22200 valve map: %" PRIu32 " devices x 8 channels, valve v -> (v %% %" PRIu32
+              ", v / %" PRIu32 ")\n\n",
+              opt.devices, opt.devices, opt.devices);
+  std::printf("  %6s  %22s  %22s\n", "", "writes / switch", "bus us / switch");
+  std::printf("  %6s  %10s %11s  %10s %11s\n", "group", "per valve", "ValveMap", "per valve",
+              "ValveMap");
+  bool ok = true;
+  const uint8_t all = mapped.valves();
+  const uint8_t sizes[] = {1, 2, 4, 8, 12, 16, 24, 32, 48, 64};
+  for (uint8_t size : sizes) {
+    if (size > all) break;
+    const Row row = run_group(per_valve, mapped, size);
+    const bool bounded = row.max_map_writes <= opt.devices;
+    ok = ok && row.same && bounded;
+    std::printf("  %6u  %10.1f %11.1f  %10.1f %11.1f%s\n", row.size, row.writes_per_switch[0],
+                row.writes_per_switch[1], row.us_per_switch[0], row.us_per_switch[1],
+                (row.same && bounded) ? "" : "  FAILED");
+  }
+
+  // Precompiled group: all valves of the first channel of every device
+  ValveSet column = 0;
+  for (uint8_t d = 0; d < opt.devices; ++d) column |= ValveBit(d);
+  mapped.map.DefineGroup(0, column);
+  const uint64_t w0 = mapped.latches();
+  mapped.map.SetGroup(0, true);
+  const uint64_t group_writes = mapped.latches() - w0;
+  bool group_on = true;
+  for (uint8_t d = 0; d < opt.devices; ++d) group_on = group_on && (mapped.bus[d].onch() & 1u) != 0;
+  ok = ok && group_on && group_writes == opt.devices;
+
+  const ValveSet everything = all >= 64 ? ~ValveSet{0} : ValveBit(all) - 1u;
+  const double compile_ns = time_compile(mapped, everything);
+  std::printf("\n  %-44s %s\n", "identical ONCH, <= 1 write per device", ok ? "yes" : "NO");
+  std::printf("  %-44s %.1f ns\n", "host Compile() of all valves", compile_ns);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file max22200_workload_bench.cpp
+ * @brief Replays a generated or recorded workload through one driver front-end.
+ *
+ * @details
+ *   Builds a workload with GenerateWorkload() (profiles modelled on
+ *   c21_cycle_test, c21_dpm_tuning_test and max22200_solenoid_valve_test, or
+ *   independent per-class rates) or loads a CSV trace, replays it on the
+ *   emulated device at its scheduled times and reports:
+ *
+ *     - operations issued per type and how many the driver rejected
+ *     - frames, bytes, wire time and bus utilisation over the schedule
+ *     - worst lag of a step behind its schedule (bus still busy)
+ *     - host CPU per operation
+ *
+ *   --save writes the workload as CSV so the exact load can be replayed by
+ *   other benchmarks (--trace) or edited by hand.
+ *
+ * @par Usage
+ *   max22200_workload_bench [--profile P] [--trace FILE] [--save FILE]
+ *                           [--frontend NAME] [--duration-ms N] [--steps N]
+ *                           [--seed N] [--rates t,s,st,f,d] [--channels MASK]
+ *                           [--ifs-ma N] [--sclk HZ] [--frame-overhead-ns N]
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include "common/max22200_harness.hpp"
+#include "max22200.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// BENCHMARK CONFIGURATION
+//==============================================================================
+
+namespace cfg {
+
+static constexpr uint32_t kDurationMs      = 60000;     ///< Timed profiles
+static constexpr uint32_t kSteps           = 20000;     ///< MIXED profile length
+static constexpr uint32_t kSeed            = 0x22200u;
+static constexpr uint32_t kIfsMa           = 500;       ///< Board full-scale current
+static constexpr uint32_t kSclkHz          = 10000000;  ///< 10 MHz standalone max
+static constexpr uint32_t kFrameOverheadNs = 2000;      ///< CS/CMD handling per frame
+
+} // namespace cfg
+
+struct Options {
+  const char *frontend = DirectFrontEnd::Name();
+  const char *trace = nullptr;
+  const char *save = nullptr;
+  WorkloadConfig workload;
+  HarnessConfig harness;
+
+  Options() {
+    workload.profile = WorkloadProfile::C21_CYCLE;
+    workload.duration_ms = cfg::kDurationMs;
+    workload.steps = cfg::kSteps;
+    workload.seed = cfg::kSeed;
+    workload.ifs_ma = cfg::kIfsMa;
+    harness.ifs_ma = cfg::kIfsMa;
+    harness.sclk_hz = cfg::kSclkHz;
+    harness.frame_overhead_ns = cfg::kFrameOverheadNs;
+  }
+};
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+/// "toggle,setpoint,status,fault,dpm" in events/s
+static bool parse_rates(const char *s, WorkloadRates &r) {
+  uint32_t *fields[] = {&r.toggle_hz, &r.setpoint_hz, &r.status_poll_hz, &r.fault_poll_hz,
+                        &r.dpm_hz};
+  for (uint32_t *f : fields) {
+    char *end = nullptr;
+    const unsigned long v = std::strtoul(s, &end, 10);
+    if (end == s) return false;
+    *f = static_cast<uint32_t>(v);
+    if (*end != ',') return *end == '\0';
+    s = end + 1;
+  }
+  return true;
+}
+
+static bool parse_args(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    if (std::strcmp(a, "--profile") == 0 && has_value) {
+      if (!WorkloadProfileFromStr(argv[++i], opt.workload.profile)) {
+        std::fprintf(stderr, "unknown profile: %s\n", argv[i]);
+        return false;
+      }
+    } else if (std::strcmp(a, "--trace") == 0 && has_value) {
+      opt.trace = argv[++i];
+    } else if (std::strcmp(a, "--save") == 0 && has_value) {
+      opt.save = argv[++i];
+    } else if (std::strcmp(a, "--frontend") == 0 && has_value) {
+      opt.frontend = argv[++i];
+    } else if (std::strcmp(a, "--duration-ms") == 0 && has_value) {
+      opt.workload.duration_ms = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(a, "--steps") == 0 && has_value) {
+      opt.workload.steps = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(a, "--seed") == 0 && has_value) {
+      opt.workload.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+    } else if (std::strcmp(a, "--rates") == 0 && has_value) {
+      if (!parse_rates(argv[++i], opt.workload.rates)) {
+        std::fprintf(stderr, "bad --rates (toggle,setpoint,status,fault,dpm)\n");
+        return false;
+      }
+    } else if (std::strcmp(a, "--channels") == 0 && has_value) {
+      opt.workload.rates.channel_mask = static_cast<uint8_t>(std::strtoul(argv[++i], nullptr, 0));
+    } else if (std::strcmp(a, "--ifs-ma") == 0 && has_value) {
+      opt.workload.ifs_ma = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+      opt.harness.ifs_ma = opt.workload.ifs_ma;
+    } else if (std::strcmp(a, "--sclk") == 0 && has_value) {
+      opt.harness.sclk_hz = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(a, "--frame-overhead-ns") == 0 && has_value) {
+      opt.harness.frame_overhead_ns = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else {
+      std::fprintf(stderr, "unknown or incomplete argument: %s\n", a);
+      return false;
+    }
+  }
+  return opt.harness.sclk_hz > 0 && opt.harness.ifs_ma > 0;
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_args(argc, argv, opt)) {
+    return 2;
+  }
+
+  Workload work;
+  if (opt.trace != nullptr) {
+    uint32_t bad_line = 0;
+    if (!LoadWorkloadCsv(opt.trace, work, &bad_line)) {
+      std::fprintf(stderr, "cannot load trace %s (line %" PRIu32 ")\n", opt.trace, bad_line);
+      return 2;
+    }
+  } else {
+    work = GenerateWorkload(opt.workload);
+  }
+  if (opt.save != nullptr && !SaveWorkloadCsv(opt.save, work)) {
+    std::fprintf(stderr, "cannot write %s\n", opt.save);
+    return 1;
+  }
+
+  std::unique_ptr<FrontEndRunner> runner = MakeFrontEndRunner(opt.frontend);
+  if (!runner) {
+    std::fprintf(stderr, "unknown front-end: %s\n", opt.frontend);
+    return 2;
+  }
+  if (!runner->Initialize(opt.harness)) {
+    std::fprintf(stderr, "init failed\n");
+    return 1;
+  }
+  const uint64_t rejected = runner->Replay(work);
+
+  const EmulatedBusCounters &c = runner->Bus().GetCounters();
+  const double elapsed_s = runner->ElapsedNs() / 1e9;
+  std::printf("MAX22200 workload: %s%s via %s, %zu steps over %.3f s (IFS %" PRIu32
+              " mA, SCLK %.1f MHz)\n",
+              opt.trace ? "trace " : "profile ",
+              opt.trace ? opt.trace : WorkloadProfileToStr(opt.workload.profile),
+              runner->Name(), work.size(), elapsed_s, opt.harness.ifs_ma,
+              opt.harness.sclk_hz / 1e6);
+
+  std::printf("\n%-18s %10s %10s\n", "operation", "count", "per s");
+  for (uint8_t i = 0; i < WORKLOAD_OP_COUNT; ++i) {
+    const uint64_t n = runner->OpCount(static_cast<WorkloadOp>(i));
+    if (n == 0) continue;
+    std::printf("%-18s %10" PRIu64 " %10.1f\n", WorkloadOpToStr(static_cast<WorkloadOp>(i)), n,
+                elapsed_s > 0 ? n / elapsed_s : 0.0);
+  }
+
+  std::printf("\n%-18s %" PRIu64 "\n", "rejected steps", rejected);
+  std::printf("%-18s %" PRIu64 " (%" PRIu64 " command, %" PRIu64 " data)\n", "frames", c.frames,
+              c.command_frames, c.data_frames);
+  std::printf("%-18s %" PRIu64 "\n", "bytes", c.bytes);
+  std::printf("%-18s %.3f ms (%.2f%% of schedule)\n", "wire time", c.wire_time_ns / 1e6,
+              elapsed_s > 0 ? 100.0 * (c.wire_time_ns / 1e9) / elapsed_s : 0.0);
+  std::printf("%-18s %.1f us\n", "max step lag", runner->MaxLagNs() / 1e3);
+  std::printf("%-18s %.3f ms (%.1f ns/step)\n", "host CPU", runner->HostNs() / 1e6,
+              work.empty() ? 0.0 : static_cast<double>(runner->HostNs()) / work.size());
+  return rejected == 0 ? 0 : 1;
+}
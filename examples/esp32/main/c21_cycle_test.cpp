@@ -54,6 +54,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 // Bus-level logging knobs (override at the build system if you need
 // raw SPI hex on the console for SPI-protocol debugging).
@@ -67,7 +68,9 @@
 #include "esp32_max22200_bus.hpp"
 #include "esp32_max22200_test_config.hpp"
 #include "max22200.hpp"
+#include "max22200_poll_scheduler.hpp"
 #include "max22200_registers.hpp"
+#include "max22200_telemetry.hpp"
 #include "max22200_types.hpp"
 
 using namespace max22200;
@@ -94,7 +97,11 @@ constexpr ChopFreq kChopFreq       = ChopFreq::FMAIN_DIV4;  ///< ≥ 1 kHz floor
 constexpr uint32_t kOnDuration_ms      = 2000;
 constexpr uint32_t kOffDuration_ms     = 2000;
 constexpr uint32_t kCycleCount         = 0;      ///< 0 = run forever
-constexpr uint32_t kTelemetryPeriod_ms = 100;    ///< 10 Hz
+constexpr uint32_t kTelemetryPeriod_ms = 100;    ///< 10 Hz (fixed-rate polling)
+constexpr bool     kAdaptivePolling    = false;  ///< Opt-in: PollScheduler, not fixed rate
+constexpr uint32_t kPollWake_ms        = 10;     ///< Adaptive: nFAULT check interval
+constexpr bool     kBinaryTelemetry    = false;  ///< Emit `TLM,<hex>` frames
+                                                 ///< (tools/max22200_telemetry_decode)
 
 // Per-channel diagnostic feature gates. All-OFF is the safest first-light
 // configuration; see `c21_dpm_tuning_test` for DPM-specific tuning, and
@@ -114,36 +121,68 @@ static std::unique_ptr<Esp32Max22200SpiBus>            g_bus;
 static std::unique_ptr<MAX22200<Esp32Max22200SpiBus>>  g_driver;
 
 //==============================================================================
-// TELEMETRY  (10 Hz scrape of STATUS, FAULT, last-fault byte, nFAULT pin)
+// TELEMETRY  (scrape of STATUS, FAULT, last-fault byte, nFAULT pin; fixed
+//             10 Hz, or adaptive: fast around switching / faults, 1 Hz idle)
 //==============================================================================
 
 static volatile bool g_telemetry_running = false;
 
 static void telemetry_task(void* /*arg*/) noexcept {
-    ESP_LOGI(TAG, "[telemetry] starting (period=%u ms)",
-             static_cast<unsigned>(cfg::kTelemetryPeriod_ms));
+    ESP_LOGI(TAG, "[telemetry] starting (%s, period=%u ms)",
+             cfg::kAdaptivePolling ? "adaptive" : "fixed",
+             static_cast<unsigned>(cfg::kAdaptivePolling ? cfg::kPollWake_ms
+                                                         : cfg::kTelemetryPeriod_ms));
 
     uint32_t tick_count   = 0;
     bool     prev_dpm     = false;
     bool     prev_active  = false;
     uint8_t  prev_chmask  = 0xFF;  // force first transition print
+    TelemetryEncoder encoder;
+    PollScheduler    scheduler;
 
     while (g_telemetry_running && g_driver) {
-        StatusConfig status{};
-        FaultStatus  faults{};
-        const DriverStatus s_rc = g_driver->ReadStatus(status);
-        const DriverStatus f_rc = g_driver->ReadFaultRegister(faults);
-        const uint8_t      last_byte = g_driver->GetLastFaultByte();
+        // Between polls only nFAULT (GPIO) and the driver's cached fault
+        // byte are looked at; no SPI traffic.
+        const uint32_t now_us = static_cast<uint32_t>(esp_timer_get_time());
+        if (cfg::kAdaptivePolling &&
+            scheduler.Check(now_us, *g_driver) != PollAction::POLL) {
+            vTaskDelay(pdMS_TO_TICKS(cfg::kPollWake_ms));
+            continue;
+        }
+
+        // STATUS + FAULT back-to-back in one driver call
+        Snapshot snap;
+        const DriverStatus rc = g_driver->ReadSnapshot(snap);
+        const StatusConfig &status    = snap.status;
+        const FaultStatus  &faults    = snap.faults;
+        const uint8_t       last_byte = snap.fault_byte;
         bool fault_active = false;
         (void)g_driver->GetFaultPinState(fault_active);
+        if (cfg::kAdaptivePolling) {
+            scheduler.OnPolled(now_us, *g_driver, status, faults);
+        }
 
-        if (s_rc == DriverStatus::OK && f_rc == DriverStatus::OK) {
+        if (rc == DriverStatus::OK && cfg::kBinaryTelemetry) {
+            // Only changed fields go out; a few bytes per tick instead of a
+            // full text line. Decode on the host with max22200_telemetry_decode.
+            uint8_t frame[TelemetryFrame::MAX_FRAME_BYTES];
+            const size_t n = encoder.Encode(
+                TelemetrySample::fromRegisters(snap.timestamp_us, snap.status_raw,
+                                               faults.toRegister(), last_byte),
+                frame, sizeof(frame));
+            char hex[2 * TelemetryFrame::MAX_FRAME_BYTES + 1];
+            for (size_t i = 0; i < n; ++i) {
+                snprintf(&hex[2 * i], 3, "%02X", frame[i]);
+            }
+            hex[2 * n] = '\0';
+            printf("TLM,%s\n", hex);
+        } else if (rc == DriverStatus::OK) {
             ESP_LOGI(TAG,
                      "[t=%4u s+%03u] active=%d chmask=0x%02X  "
                      "OCP=0x%02X HHF=0x%02X OLF=0x%02X DPM=0x%02X  "
                      "last=0x%02X  nFAULT=%s",
-                     static_cast<unsigned>(tick_count * cfg::kTelemetryPeriod_ms / 1000U),
-                     static_cast<unsigned>(tick_count * cfg::kTelemetryPeriod_ms % 1000U),
+                     static_cast<unsigned>(now_us / 1000000U),
+                     static_cast<unsigned>(now_us / 1000U % 1000U),
                      status.active, status.channels_on_mask,
                      faults.overcurrent_channel_mask,
                      faults.hit_not_reached_channel_mask,
@@ -152,8 +191,7 @@ static void telemetry_task(void* /*arg*/) noexcept {
                      last_byte,
                      fault_active ? "ASSERTED" : "released");
         } else {
-            ESP_LOGW(TAG, "[telemetry] read failed: status=%s faults=%s",
-                     DriverStatusToStr(s_rc), DriverStatusToStr(f_rc));
+            ESP_LOGW(TAG, "[telemetry] snapshot read failed: %s", DriverStatusToStr(rc));
         }
 
         // Edge-detected highlights so significant events stand out in
@@ -179,8 +217,8 @@ static void telemetry_task(void* /*arg*/) noexcept {
             prev_chmask = status.channels_on_mask;
         }
 
-        // Every 50 ticks (~5 s) print a one-line "device summary".
-        if ((tick_count % 50U) == 0U && (s_rc == DriverStatus::OK)) {
+        // Every 50 polls (~5 s at the fixed rate) print a one-line "device summary".
+        if ((tick_count % 50U) == 0U && (rc == DriverStatus::OK)) {
             ESP_LOGI(TAG,
                      "  device summary: active=%d  ovt=%d uvm=%d comer=%d  "
                      "global{ocp=%d olf=%d hhf=%d dpm=%d}  hasFault=%d",
@@ -196,10 +234,17 @@ static void telemetry_task(void* /*arg*/) noexcept {
         }
 
         ++tick_count;
-        vTaskDelay(pdMS_TO_TICKS(cfg::kTelemetryPeriod_ms));
+        vTaskDelay(pdMS_TO_TICKS(cfg::kAdaptivePolling ? cfg::kPollWake_ms
+                                                       : cfg::kTelemetryPeriod_ms));
     }
 
-    ESP_LOGI(TAG, "[telemetry] stopping after %u ticks", static_cast<unsigned>(tick_count));
+    if (cfg::kAdaptivePolling) {
+        const PollSchedulerStats& st = scheduler.GetStats();
+        ESP_LOGI(TAG, "[telemetry] adaptive: %u polls, %u skipped, %u early (fault)",
+                 static_cast<unsigned>(st.polls), static_cast<unsigned>(st.skips),
+                 static_cast<unsigned>(st.early_polls));
+    }
+    ESP_LOGI(TAG, "[telemetry] stopping after %u polls", static_cast<unsigned>(tick_count));
     vTaskDelete(nullptr);
 }
 
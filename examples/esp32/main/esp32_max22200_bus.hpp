@@ -21,6 +21,7 @@
 #include "driver/spi_master.h"
 #include "esp_log.h"
 #include "esp_rom_sys.h"
+#include "esp_timer.h"
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
@@ -200,6 +201,13 @@ public:
     esp_rom_delay_us(us);
   }
 
+  /**
+   * @brief Microsecond timestamp from the ESP high-resolution timer.
+   */
+  uint32_t GetTimeUs() {
+    return static_cast<uint32_t>(esp_timer_get_time());
+  }
+
   // ── GPIO Pin Control ─────────────────────────────────────────────────
 
   /**
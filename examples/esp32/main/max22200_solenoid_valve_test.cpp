@@ -113,6 +113,14 @@ static void log_fault_byte(uint8_t fault_byte) {
            fault_byte, active ? 1 : 0, uvm ? 1 : 0, comer ? 1 : 0, dpm ? 1 : 0, hhf ? 1 : 0, olf ? 1 : 0, ocp ? 1 : 0, ovt ? 1 : 0);
 }
 
+/** State callback: one line per channel transition (DISABLED / HIT / HOLD / FAULT) */
+static void on_channel_state(uint8_t channel, ChannelState old_state, ChannelState new_state,
+                             void * /*user_data*/) {
+  static const char *const kNames[] = {"DISABLED", "ENABLED", "HIT", "HOLD", "FAULT"};
+  ESP_LOGI(TAG, "  CH%u %s -> %s", channel, kNames[static_cast<uint8_t>(old_state)],
+           kNames[static_cast<uint8_t>(new_state)]);
+}
+
 /** Full diagnostics: STATUS, FAULT, last fault byte, nFAULT, channel configs, board config, statistics */
 static void log_diagnostics(const char *phase) {
   if (!g_driver || !g_driver->IsInitialized()) return;
@@ -298,6 +306,7 @@ static bool init_driver_and_valve_config() {
            SPIPins::MISO, SPIPins::MOSI, SPIPins::SCLK, SPIPins::CS,
            ControlPins::ENABLE, ControlPins::FAULT, ControlPins::CMD);
 
+  g_driver->SetStateChangeCallback(on_channel_state, nullptr);
   if (!require_ok(g_driver->Initialize(), "Initialize()")) return false;
   if (!g_driver->IsInitialized()) {
     ESP_LOGE(TAG, "Driver not initialized after Initialize()");
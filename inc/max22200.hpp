@@ -69,7 +69,10 @@
  * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
  */
 #pragma once
+#include "max22200_audit_log.hpp"
+#include "max22200_fault_filter.hpp"
 #include "max22200_registers.hpp"
+#include "max22200_rules.hpp"
 #include "max22200_types.hpp"
 #include "max22200_spi_interface.hpp"
 #include "max22200_version.h"
@@ -89,6 +92,9 @@ namespace max22200 {
  *                 - Transfer() for SPI data transfer
  *                 - GpioSet() for CMD/ENABLE/FAULT pin control
  *                 - GpioGet() for FAULT pin reading
+ *                 - DelayUs() for power-up and timing delays
+ *                 - GetTimeUs() as the free-running µs time base (fault
+ *                   events, channel state, statistics timing)
  *
  * @example Basic usage (CDR mode):
  * @code
@@ -200,6 +206,33 @@ public:
    */
   DriverStatus Initialize();
 
+  /**
+   * @brief Initialize and load a complete configuration in two bursts
+   *
+   * Fast, fixed-length bring-up for machine start:
+   *
+   * 1. Validate @p image (CDR needs board IFS, SRC needs fCHOP < 50 kHz)
+   *    before touching ENABLE
+   * 2. ENABLE HIGH, wait tEN
+   * 3. Write burst: STATUS (ACTIVE=0, ONCH=0), CFG_CH0..CFG_CH7, CFG_DPM
+   * 4. Verify burst: read the same ten registers back (this STATUS read also
+   *    clears UVM) and compare the writable bits
+   * 5. Write STATUS with image.status.active and image.status.channels_on_mask
+   * 6. Read STATUS back and compare it, checking COMER for the write
+   *
+   * Steps 3 to 6 are retried on COMER or a readback mismatch, as in
+   * Initialize(). No decoding or bookkeeping happens between the frames of a
+   * burst, so ENABLE to ready-to-fire is 22 register transfers plus tEN.
+   *
+   * @param image Configuration to load
+   * @return DriverStatus::OK on success
+   * @return DriverStatus::INVALID_PARAMETER if a channel config cannot be written
+   *         (ENABLE is not touched)
+   * @return DriverStatus::COMMUNICATION_ERROR if COMER or a readback mismatch
+   *         persisted after all retries (ENABLE is left LOW)
+   */
+  DriverStatus Initialize(const DeviceImage &image);
+
   /**
    * @brief Deinitialize — disable channels, ACTIVE=0, ENABLE low
    *
@@ -231,11 +264,49 @@ public:
    */
   DriverStatus ReadStatus(StatusConfig &status) const;
 
+  /**
+   * @brief STATUS as last observed, if younger than @p max_age_us; else ReadStatus()
+   *
+   * The driver keeps the STATUS word current from all its own traffic: full
+   * STATUS reads and writes, ONCH (8-bit) writes, and the STATUS[7:0] fault
+   * byte every Command Register write returns. When that word was confirmed
+   * less than @p max_age_us ago it is returned without SPI traffic, so
+   * several callers polling at the same rate share one read.
+   *
+   * @param status     Populated from the cache or from the device
+   * @param max_age_us Oldest acceptable observation; 0 always reads
+   * @return DriverStatus::OK on success
+   *
+   * @note A cached result does not clear UVM (only a real read does). A fault
+   *       byte showing UVM drops the cache, since the device may have reset.
+   * @note Cache hits do not touch statistics or channel state tracking.
+   */
+  DriverStatus ReadStatus(StatusConfig &status, uint32_t max_age_us) const;
+
   /**
    * @brief Write the STATUS register (writable bits only)
+   *
+   * ONCH bits of channels in quarantine (see SetFaultReaction()) are written as 0.
    */
   DriverStatus WriteStatus(const StatusConfig &status);
 
+  /**
+   * @brief Set which fault types do not assert nFAULT (STATUS M_xxx bits)
+   *
+   * Writes the cached STATUS with only the seven mask bits changed (one
+   * 32-bit write). Masked flags still latch in STATUS / FAULT and are seen
+   * by reads; they only stop asserting the pin. Used by FaultStormGuard
+   * (max22200_storm_guard.hpp) to silence an interrupt storm.
+   *
+   * @param type_bits FaultTypeBit() of every type to mask
+   */
+  DriverStatus SetFaultPinMask(uint8_t type_bits);
+
+  /**
+   * @brief FaultTypeBit()s masked from nFAULT in the cached STATUS (no SPI)
+   */
+  uint8_t GetFaultPinMask() const;
+
   // =========================================================================
   // Channel Configuration (CFG_CHx)
   // =========================================================================
@@ -276,10 +347,34 @@ public:
   DriverStatus ConfigureAllChannels(const ChannelConfigArray &configs);
 
   /**
-   * @brief Get all channel configurations
+   * @brief Read all eight channel configurations
+   *
+   * Issues the eight CFG_CHx reads with no driver work between them, then
+   * decodes them in one pass with the board IFS and FREQM fetched once,
+   * refreshes the CFG shadow and HIT times, and counts one operation in the
+   * statistics. On a transfer error no config is modified.
+   *
+   * @note The bus traffic is that of eight GetChannelConfig() calls: each
+   *       CFG_CHx is its own bank and needs its own command frame (16 frames).
+   *       Only host work is saved. Decoding is into the float ChannelConfig;
+   *       for the raw words use GetCachedChannelRegister() afterwards.
    */
   DriverStatus GetAllChannelConfigs(ChannelConfigArray &configs) const;
 
+  /**
+   * @brief Last CFG_CHx value written or read through this driver (no SPI)
+   *
+   * The shadow is kept by every CFG_CHx access (ConfigureChannel, the setters,
+   * GetChannelConfig, GetAllChannelConfigs, raw register access; 8-bit writes
+   * update bits 31:24) and cleared by Initialize().
+   *
+   * @param channel Channel number (0-7)
+   * @param raw     Receives the 32-bit register value
+   * @return DriverStatus::INVALID_PARAMETER if channel is invalid or the register
+   *         has not been accessed since Initialize()
+   */
+  DriverStatus GetCachedChannelRegister(uint8_t channel, uint32_t &raw) const;
+
   // =========================================================================
   // Channel Enable/Disable (ONCH bits in STATUS register)
   // =========================================================================
@@ -338,7 +433,8 @@ public:
    *
    * Updates all eight ONCH bits in one 8-bit write. Bit N = 1 means channel N
    * is on; 0 means off. Use this instead of multiple EnableChannel() calls when
-   * updating several channels at once.
+   * updating several channels at once. Channels in quarantine (see
+   * SetFaultReaction()) are left off.
    *
    * @param channel_mask Bitmask: bit 0 = channel 0, bit 1 = channel 1, ... bit 7 = channel 7
    * @return DriverStatus::OK on success
@@ -350,6 +446,61 @@ public:
    */
   DriverStatus SetChannelsOn(uint8_t channel_mask);
 
+  /**
+   * @brief Latch the 8-bit STATUS write command without data
+   *
+   * Phase 1 of SetChannelsOn() on its own. The Command Register is sticky, so
+   * the device then takes every data-only frame as a new ONCH byte until
+   * another command is sent; CommitChannelsOn() sends just that frame. Used
+   * to switch several devices with their data frames back to back (see
+   * SyncOnchGroup in max22200_sync.hpp). Any other register access disarms;
+   * SetChannelsOn() leaves the device armed.
+   */
+  DriverStatus ArmChannelsOn();
+
+  /**
+   * @brief Write ONCH as a single data frame to an armed device
+   *
+   * Same effect and bookkeeping as SetChannelsOn() (quarantine, state
+   * tracking, rules, audit log) without the command frame. The data frame
+   * returns no fault byte.
+   *
+   * @return INVALID_PARAMETER if not armed (nothing sent)
+   */
+  DriverStatus CommitChannelsOn(uint8_t channel_mask);
+
+  /**
+   * @brief @p channel_mask without the channels writes must keep off (no SPI)
+   *
+   * Quarantined channels and those a queued fault reaction switches off, as
+   * SetChannelsOn() / CommitChannelsOn() drop them.
+   */
+  uint8_t FilterChannelsOn(uint8_t channel_mask) const;
+
+  /**
+   * @brief Send only the ONCH data frame to an armed device, no bookkeeping
+   *
+   * The frame half of CommitChannelsOn(), for SyncOnchGroup: pass a
+   * FilterChannelsOn() result, send the frames of every device back to back,
+   * then call FinishChannelsOn() for each. Nothing is logged, cached or
+   * tracked in between. A failed frame disarms the device.
+   *
+   * @return INVALID_PARAMETER if not armed (nothing sent)
+   */
+  DriverStatus SendChannelsOnFrame(uint8_t channel_mask);
+
+  /**
+   * @brief Bookkeeping of a SendChannelsOnFrame() that returned @p frame_result
+   *
+   * As CommitChannelsOn() after its frame: audit entry (appended after the
+   * frame, marked FAILED if it failed), ONCH cache on success, state
+   * tracking, rule matching and statistics.
+   */
+  void FinishChannelsOn(uint8_t channel_mask, DriverStatus frame_result);
+
+  /** @brief The device holds the 8-bit STATUS write command (no SPI) */
+  bool IsChannelsOnArmed() const { return onch_armed_; }
+
   /**
    * @brief Set full-bridge state for a channel pair (datasheet Table 7)
    *
@@ -384,6 +535,24 @@ public:
    */
   DriverStatus ReadFaultRegister(FaultStatus &faults) const;
 
+  /**
+   * @brief FAULT as last observed, if younger than @p max_age_us; else ReadFaultRegister()
+   *
+   * Refreshed by every FAULT read, and by any fault byte with no OCP, HHF,
+   * OLF or DPM flag (FAULT is then known to be 0). A fault byte flagging a
+   * type the cached word does not contain drops the cache.
+   *
+   * @param faults     Populated from the cache or from the device
+   * @param max_age_us Oldest acceptable observation; 0 always reads
+   * @return DriverStatus::OK on success
+   *
+   * @note FAULT is clear-on-read: a cached result can repeat flags that a real
+   *       read already cleared, and several callers may see the same flags.
+   *       Let one owner (e.g. the safety monitor, reading with max_age_us 0)
+   *       act on and count faults; other callers only display them.
+   */
+  DriverStatus ReadFaultRegister(FaultStatus &faults, uint32_t max_age_us) const;
+
   /**
    * @brief Clear all fault flags (read FAULT register and discard)
    *
@@ -428,6 +597,28 @@ public:
                                               uint8_t dpm_mask,
                                               FaultStatus &faults) const;
 
+  /**
+   * @brief Read STATUS and FAULT back-to-back as one health snapshot
+   *
+   * Issues the four SPI frames (STATUS command + data, FAULT command + data)
+   * with no driver work in between, then decodes both registers, refreshes the
+   * STATUS cache and channel state once and counts one operation in the
+   * statistics. This is the cheapest way to get the full health picture and
+   * replaces a ReadStatus() + ReadFaultRegister() pair.
+   *
+   * The driver does not lock the bus; if other tasks share it, hold the bus
+   * lock around this call and the two reads stay adjacent on the wire.
+   *
+   * @param snap       Populated with STATUS, FAULT, timestamp and fault byte
+   * @param clear_mask MAX22200A: channels whose OCP/HHF/OLF/DPM flags the FAULT
+   *                   read clears (bit N = channel N; 0 = same SDI as
+   *                   ReadFaultRegister()). Ignored by MAX22200 (clears all).
+   * @return DriverStatus::OK on success
+   *
+   * @see Snapshot::isCoherent() to detect a flag raised between the two reads
+   */
+  DriverStatus ReadSnapshot(Snapshot &snap, uint8_t clear_mask = 0) const;
+
   /**
    * @brief Read fault flags from STATUS register
    */
@@ -438,6 +629,75 @@ public:
    */
   DriverStatus ClearFaultFlags();
 
+  // =========================================================================
+  // Fault Reactions
+  // =========================================================================
+
+  /**
+   * @brief Set the automatic reaction to @p type
+   *
+   * The read that observes the fault (ReadFaultRegister(),
+   * ReadFaultRegisterSelectiveClear(), ReadSnapshot(), ReadStatus()) queues
+   * the reaction, before the fault callback; reads never write. The next
+   * ServiceReactions() applies everything queued, with no application
+   * decision in between: all channels switched off go out in a single ONCH
+   * write. Until then SetChannelsOn(), WriteStatus() and CommitChannelsOn()
+   * keep those channels off.
+   *
+   * - CHANNEL_OFF: clear the faulted channel's ONCH bit.
+   * - QUARANTINE: as CHANNEL_OFF, and SetChannelsOn() / WriteStatus() keep the
+   *   channel off until cooldown_ms after the read (see GetQuarantinedChannels()).
+   * - HIT_STEP_RETRY (HHF): write the channel's CFG_CHx with HIT one step
+   *   higher; it applies from the channel's next HIT phase. A further HHF
+   *   before ConfigureChannel() rewrites the channel, or with HIT already at
+   *   full scale or no CFG_CHx shadow, switches the channel off instead.
+   * - SHED: clear the ONCH bits in shed_mask, e.g. the lowest-priority
+   *   channels on OVT.
+   *
+   * Reactions are active from Initialize() on. With no reaction set the
+   * fault path costs one extra mask test.
+   *
+   * @return DriverStatus::INVALID_PARAMETER if the action does not apply to
+   *         @p type (see FaultReactionPolicy::isValidFor())
+   */
+  DriverStatus SetFaultReaction(FaultType type, const FaultReactionPolicy &policy);
+  FaultReactionPolicy GetFaultReaction(FaultType type) const;
+
+  /**
+   * @brief Set every reaction to NONE and release all quarantined channels
+   */
+  void ClearFaultReactions();
+
+  /**
+   * @brief Channels currently held off by QUARANTINE (bit N = channel N)
+   */
+  uint8_t GetQuarantinedChannels() const;
+
+  /**
+   * @brief End the quarantine of @p channel_mask early (channels stay off until switched on)
+   */
+  void ReleaseQuarantine(uint8_t channel_mask);
+
+  /**
+   * @brief Apply queued fault reactions and rules (see SetRuleTable())
+   *
+   * Call right after each poll and ONCH write, and at least every
+   * GetReactionDelayUs(); with nothing queued it costs one test and no SPI.
+   * HIT step retries write CFG_CHx; the channels switched off by reactions,
+   * the queued, due and HOLD rules and their chains go out in one ONCH write.
+   *
+   * @return Result of the ONCH write, or OK if there was nothing to write
+   */
+  DriverStatus ServiceReactions();
+
+  /** @brief True if a reaction or rule is queued for ServiceReactions() */
+  bool HasPendingReactions() const { return (react_pending_keys_ | rule_pending_) != 0; }
+
+  /**
+   * @brief µs until ServiceReactions() has work (0 = queued, UINT32_MAX = nothing pending)
+   */
+  uint32_t GetReactionDelayUs() const;
+
   // =========================================================================
   // DPM Configuration (CFG_DPM, 0x0A)
   // =========================================================================
@@ -572,10 +832,36 @@ public:
    */
   uint8_t GetLastFaultByte() const;
 
+  /**
+   * @brief Count of fault bytes received (one per Command Register write)
+   *
+   * Increments every time GetLastFaultByte() is refreshed, so a poller can
+   * tell whether other traffic has produced a newer fault byte since it last
+   * looked (see PollScheduler in max22200_poll_scheduler.hpp). Wraps at 2^32.
+   */
+  uint32_t GetFaultByteSequence() const;
+
+  /**
+   * @brief Channels-on mask as last written or read by the driver (no SPI)
+   */
+  uint8_t GetChannelsOnMask() const;
+
+  /**
+   * @brief SpiInterface::GetTimeUs(): the time base of fault events and state tracking
+   */
+  uint32_t GetTimeUs() const { return spi_interface_.GetTimeUs(); }
+
   // =========================================================================
   // Statistics
   // =========================================================================
 
+  /**
+   * @brief Cumulative counters since Initialize() / ResetStatistics()
+   *
+   * uptime_ms is brought up to date from SpiInterface::GetTimeUs() on each
+   * call; call at least every 71 minutes (32-bit µs clock) to keep it exact.
+   * For per-minute / per-hour windows see DriverMetrics (max22200_metrics.hpp).
+   */
   DriverStatistics GetStatistics() const;
   void ResetStatistics();
 
@@ -583,9 +869,120 @@ public:
   // Callbacks
   // =========================================================================
 
+  /**
+   * @brief Called once per fault event as it opens
+   *
+   * Fault observations from ReadFaultRegister(), ReadFaultRegisterSelectiveClear(),
+   * ReadSnapshot() (OCP/HHF/OLF/DPM per channel) and ReadStatus() (OVT, UVM,
+   * COMER with channel FaultEventFilter::DEVICE_CHANNEL) pass through the
+   * fault filter first: repeats of the same (channel, type) less than the
+   * filter window apart are merged into the open event, so a chattering
+   * fault calls back once, not on every read. Each opened event also counts
+   * in DriverStatistics::fault_events. Observations before Initialize()
+   * completes (e.g. the power-on UVM) and max_age cache hits are not filtered.
+   */
   void SetFaultCallback(FaultCallback callback, void *user_data);
+
+  /**
+   * @brief Called with the merged summary (count, first/last time) as each event closes
+   *
+   * An event closes when its fault has not been observed for the filter
+   * window; closing is checked on the next fault or STATUS read.
+   */
+  void SetFaultEventCallback(FaultEventCallback callback, void *user_data);
+
+  /**
+   * @brief Merge window of the fault filter (default FaultEventFilter::DEFAULT_WINDOW_US)
+   *
+   * 0 reports every observation as its own event. Choose a window longer
+   * than the read interval so a fault still present on the next read is
+   * treated as the same event.
+   */
+  void SetFaultFilterWindowUs(uint32_t window_us) { fault_filter_.SetWindowUs(window_us); }
+
+  /**
+   * @brief Fault filter, e.g. to list open events with ForEachOpen()
+   */
+  const FaultEventFilter &GetFaultFilter() const { return fault_filter_; }
+
   void SetStateChangeCallback(StateChangeCallback callback, void *user_data);
 
+  // =========================================================================
+  // Reactive Rules (see max22200_rules.hpp)
+  // =========================================================================
+
+  /**
+   * @brief Evaluate @p table on fault and ONCH events (nullptr = off)
+   *
+   * Rules are matched where the driver detects the event: opened fault
+   * events in FAULT / STATUS reads, ONCH edges in every ONCH write or read,
+   * HIT → HOLD in the same calls and in ServiceReactions(). Matching only
+   * queues; ServiceReactions() applies the queued immediate actions, with
+   * the fault reactions and chains through the ON / OFF edges they cause, in
+   * one ONCH write; quarantined channels stay off. Delayed actions are armed
+   * from the observing call and run by ServiceReactions().
+   *
+   * The table is not copied; keep it alive and unchanged while set. Setting
+   * a table disarms all delayed actions. Active from Initialize() on.
+   */
+  void SetRuleTable(const RuleTable *table);
+
+  /** @brief Rules with an armed delayed action (bit N = rule N) */
+  uint16_t GetArmedRules() const { return rule_armed_; }
+
+  // =========================================================================
+  // Register Write Audit (see max22200_audit_log.hpp)
+  // =========================================================================
+
+  /**
+   * @brief Log every register write to @p log (nullptr = stop logging)
+   *
+   * Each write is appended before it goes on the bus, stamped with
+   * SpiInterface::GetTimeUs() and the current audit tag, and marked
+   * AuditEntry::FAILED if its transfer fails. Costs one AuditLog::Append()
+   * per write; nothing when no log is set.
+   */
+  void SetAuditLog(AuditLog *log);
+
+  /**
+   * @brief Caller tag stored with subsequent writes (e.g. task or code-path id)
+   */
+  void SetAuditTag(uint16_t tag);
+
+  // =========================================================================
+  // Channel State (tracked from driver traffic, no extra SPI reads)
+  // =========================================================================
+
+  /**
+   * @brief Get the tracked state of a channel
+   *
+   * State is derived from what the driver already writes and reads:
+   * - ONCH writes/reads (SetChannelsOn, Enable/DisableChannel, SetFullBridgeState,
+   *   WriteStatus, ReadStatus): OFF → DISABLED, ON → HIT_PHASE
+   * - HIT time from the last CFG_CHx write/read: HIT_PHASE → HOLD_PHASE once it
+   *   has elapsed (SpiInterface::GetTimeUs()); ENABLED if the HIT time is not
+   *   known yet (channel not configured or read through this driver)
+   * - FAULT reads: FAULT while the last FAULT read reported the channel
+   *
+   * Transitions are detected per bit (XOR of previous and new masks); each one
+   * increments DriverStatistics::state_changes and calls the StateChangeCallback.
+   * Channels driven from TRIG pins are not tracked.
+   *
+   * @param channel Channel number (0-7)
+   * @param state   Receives the state (HIT→HOLD brought up to date first)
+   * @return DriverStatus::INVALID_PARAMETER if channel is invalid
+   */
+  DriverStatus GetChannelState(uint8_t channel, ChannelState &state) const;
+
+  /**
+   * @brief Apply HIT → HOLD transitions whose HIT time has elapsed
+   *
+   * HIT expiry is evaluated lazily (on every driver call that touches ONCH or
+   * FAULT, and in GetChannelState). Call this periodically if HOLD_PHASE
+   * callbacks should arrive without other driver traffic. No SPI traffic.
+   */
+  void UpdateChannelStates() const;
+
   // =========================================================================
   // Board/Scale Configuration (for unit-based APIs)
   // =========================================================================
@@ -609,6 +1006,38 @@ public:
    */
   BoardConfig GetBoardConfig() const;
 
+  /**
+   * @brief Load a channel's measured current calibration (CDR)
+   *
+   * From now on the CDR current encoders (ConfigureChannel and everything
+   * built on it) pick the code whose *measured* current is nearest the
+   * requested mA, and the getters (GetChannelConfig, GetHitCurrentMa, …)
+   * report calibrated mA. Gain and offset are folded with the board IFS into
+   * integer factors here and again in SetBoardConfig(), so encoding a setpoint
+   * needs no float math beyond what the uncalibrated path does.
+   *
+   * Registers already written are not changed; reconfigure the channel to
+   * apply the calibration to it.
+   *
+   * @param channel Channel number (0-7)
+   * @param cal     HIT and HOLD gain / offset; identity clears the channel
+   * @return DriverStatus::OK on success
+   * @return DriverStatus::INVALID_PARAMETER if channel >= 8, a gain is
+   *         outside 0.5–2.0 or an offset is not finite or beyond
+   *         ±CurrentCalibration::MAX_OFFSET_MA
+   */
+  DriverStatus SetChannelCalibration(uint8_t channel, const ChannelCalibration &cal);
+
+  /**
+   * @brief Calibration loaded for a channel (identity if none)
+   */
+  DriverStatus GetChannelCalibration(uint8_t channel, ChannelCalibration &cal) const;
+
+  /**
+   * @brief Return all channels to the ideal KFS / RREF scale
+   */
+  void ClearChannelCalibration();
+
   // =========================================================================
   // Convenience APIs: Current in Real Units (CDR Mode)
   // =========================================================================
@@ -857,14 +1286,74 @@ private:
   bool initialized_;
   mutable DriverStatistics statistics_;
   mutable uint8_t last_fault_byte_;  ///< STATUS[7:0] from last Command Reg write
+  mutable uint32_t fault_byte_seq_;  ///< Incremented with each last_fault_byte_ update
+  mutable uint32_t fault_byte_us_;   ///< GetTimeUs() when last_fault_byte_ was received
+  mutable bool onch_armed_;          ///< Last command was the 8-bit STATUS write
   mutable StatusConfig cached_status_;  ///< Cached STATUS (updated by ReadStatus/WriteStatus/Init)
   BoardConfig board_config_;         ///< Board configuration (IFS, max limits)
 
   FaultCallback fault_callback_;
   void *fault_user_data_;
+  FaultEventCallback fault_event_callback_;
+  void *fault_event_user_data_;
+  mutable FaultEventFilter fault_filter_;  ///< De-duplicates fault observations
   StateChangeCallback state_callback_;
   void *state_user_data_;
 
+  // ── Channel state tracking (see GetChannelState) ───────────────────────
+  mutable ChannelState channel_state_[NUM_CHANNELS_];  ///< Last reported state
+  mutable uint32_t hit_start_us_[NUM_CHANNELS_];  ///< GetTimeUs() at ONCH rising edge
+  mutable uint32_t hit_time_us_[NUM_CHANNELS_];   ///< HIT time (0 = none, UINT32_MAX = continuous)
+  mutable uint8_t hit_known_mask_;     ///< Channels whose HIT time is known
+  mutable uint8_t hit_pending_mask_;   ///< Channels on and still in HIT
+  mutable uint8_t state_onch_;         ///< ONCH as last applied to the state machine
+  mutable uint8_t state_fault_mask_;   ///< Channels reported by the last FAULT read
+
+  // ── CFG_CHx shadow (see GetCachedChannelRegister) ──────────────────────
+  mutable uint32_t cfg_shadow_[NUM_CHANNELS_];  ///< Last CFG_CHx value written or read
+  mutable uint8_t cfg_shadow_valid_mask_;       ///< Channels whose shadow is valid
+
+  mutable uint32_t uptime_last_us_;  ///< GetTimeUs() when uptime_ms was last advanced
+  mutable uint32_t uptime_rem_us_;   ///< Sub-millisecond remainder of uptime
+
+  // ── Per-channel current calibration (see SetChannelCalibration) ──────
+  ChannelCalibration calibration_[NUM_CHANNELS_];  ///< As loaded
+  ChannelScale cal_scale_[NUM_CHANNELS_];          ///< calibration_ folded with board IFS
+  uint8_t cal_mask_;                               ///< Channels with non-identity calibration
+
+  AuditLog *audit_log_;  ///< Register write audit ring (nullptr = off)
+  uint16_t audit_tag_;   ///< Caller tag for audit entries
+
+  // ── Reactive rules (see SetRuleTable) ──────────────────────────────────
+  const RuleTable *rule_table_;
+  uint16_t rule_armed_;                        ///< Rules with a pending delayed action
+  uint32_t rule_due_us_[RuleTable::MAX_RULES];  ///< When each armed action runs
+  bool rules_busy_;                             ///< Writing a rule result (its edges not queued)
+  mutable uint16_t rule_pending_;               ///< Rules matched, queued for ServiceReactions()
+  mutable uint32_t rule_pending_us_;            ///< When the oldest queued rule matched
+
+  // ── Fault reactions (see SetFaultReaction) ────────────────────────────
+  FaultReactionPolicy reaction_[7];   ///< Per FaultType, as set
+  uint64_t react_keys_;               ///< FaultEventFilter keys with any reaction
+  uint32_t react_off_keys_;           ///< Channel keys whose reaction clears ONCH
+  uint32_t react_quarantine_keys_;    ///< Channel keys whose reaction quarantines
+  uint8_t react_retry_mask_;          ///< 0xFF if HHF reacts with HIT_STEP_RETRY
+  uint8_t react_shed_types_;          ///< FaultType bits with a SHED reaction
+  uint8_t hit_retried_mask_;          ///< Channels whose one HIT step retry is used
+  uint8_t quarantine_mask_;           ///< Channels in quarantine (expired lazily)
+  uint32_t quarantine_start_us_[NUM_CHANNELS_];
+  uint32_t quarantine_us_[NUM_CHANNELS_];
+  mutable uint64_t react_pending_keys_;  ///< Observed keys whose reaction is queued
+  mutable uint32_t react_pending_us_;    ///< When the oldest queued key was observed
+
+  // ── STATUS / FAULT read cache (see ReadStatus(status, max_age_us)) ─────
+  mutable uint32_t status_word_;     ///< Last observed STATUS (bits 7:0 from newest fault byte)
+  mutable uint32_t status_word_us_;  ///< When status_word_ was last confirmed
+  mutable uint32_t fault_word_;      ///< Last observed FAULT
+  mutable uint32_t fault_word_us_;   ///< When fault_word_ was last confirmed
+  mutable bool status_word_valid_;
+  mutable bool fault_word_valid_;
+
   // ── Core SPI protocol (two-phase) ──────────────────────────────────────
 
   /**
@@ -936,6 +1425,21 @@ private:
    */
   DriverStatus readReg32(uint8_t bank, uint32_t &value) const;
 
+  /**
+   * @brief Sequence of 32-bit register reads issued back-to-back
+   *
+   * One Command Register + data frame pair per bank (the same frames as one
+   * readReg32() per bank), with no decoding or bookkeeping between frames. @p tx (optional) supplies the SDI bytes of each
+   * data phase (MAX22200A FAULT selective clear); otherwise zeros are sent.
+   */
+  DriverStatus readRegs32(const uint8_t *banks, uint32_t *values, uint8_t count,
+                          const uint8_t (*tx)[4] = nullptr) const;
+
+  /**
+   * @brief Sequence of 32-bit register writes issued back-to-back (see readRegs32)
+   */
+  DriverStatus writeRegs32(const uint8_t *banks, const uint32_t *values, uint8_t count) const;
+
   /**
    * @brief Full 8-bit MSB register write (Command Register + data)
    */
@@ -947,6 +1451,91 @@ private:
   DriverStatus readReg8(uint8_t bank, uint8_t &value) const;
 
   void updateStatistics(bool success) const;
+
+  /** @brief Reset driver state, start the SPI interface, ENABLE HIGH and wait tEN */
+  bool powerUp();
+
+  /** @brief Calibration scale for CDR encoding of @p channel (nullptr = uncalibrated) */
+  const ChannelScale *channelScale(uint8_t channel) const {
+    return ((cal_mask_ >> channel) & 1u) != 0 ? &cal_scale_[channel] : nullptr;
+  }
+
+  /** @brief ConfigureChannel() preconditions: CDR needs board IFS, SRC needs fCHOP < 50 kHz */
+  bool isChannelConfigWritable(const ChannelConfig &config, bool master_clock_80khz) const;
+
+  /** @brief Record a completed access in the CFG_CHx shadow and the STATUS / FAULT cache */
+  void shadowRegister(uint8_t bank, uint32_t value, bool mode8, bool is_write) const;
+
+  /** @brief Fold a Command Register fault byte into the STATUS / FAULT cache */
+  void observeFaultByte(uint8_t fault_byte) const;
+
+  /** @brief After an ONCH data frame: cache, shadow and track on success; statistics */
+  void completeChannelsOn(uint8_t channel_mask, DriverStatus result);
+
+  /** @brief Forget the STATUS / FAULT cache and the armed command (device reset or disabled) */
+  void dropReadCache() const;
+
+  /** @brief Append a write to the audit log; returns the slot (AuditLog::NO_SLOT if off) */
+  uint32_t auditWrite(uint8_t bank, uint32_t value, uint8_t flags) const;
+
+  // ── Channel state tracking ─────────────────────────────────────────────
+
+  /** @brief New ONCH written or read: edge-detect on/off transitions */
+  void trackOnch(uint8_t onch) const;
+
+  /**
+   * @brief FAULT register read: edge-detect channels entering/leaving FAULT
+   *        and report fault events (with STATUS @p device_keys if read together)
+   */
+  void trackFaults(const FaultStatus &faults, uint64_t device_keys = 0) const;
+
+  /**
+   * @brief Pass fault observations (FaultEventFilter keys) through the filter and report
+   * @return Keys that opened a new event
+   */
+  uint64_t reportFaults(uint64_t keys) const;
+
+  /** @brief Match the rule table against events and queue the matches for ServiceReactions() */
+  void queueRules(uint64_t fault_keys, uint8_t rising, uint8_t falling, uint8_t hold) const;
+
+  /** @brief Arm the delayed actions of @p rules, counting from @p from_us */
+  void armRules(uint16_t rules, uint32_t from_us);
+
+  /**
+   * @brief ONCH after the immediate actions of @p matched and @p due, with chains
+   * @param due Armed rules whose delay has passed (applied as immediate)
+   */
+  uint8_t applyRules(uint8_t onch, uint16_t matched, uint16_t due, uint32_t now_us);
+
+  /** @brief Apply the reactions to @p keys seen at @p seen_us; returns ONCH bits to clear */
+  uint8_t react(uint64_t keys, uint32_t seen_us);
+
+  /** @brief ONCH bits the reactions to @p keys clear (HHF retries still possible excluded) */
+  uint8_t reactionOffMask(uint64_t keys) const;
+
+  /** @brief Quarantined channels whose cooldown has not passed */
+  uint8_t activeQuarantine() const;
+
+  /** @brief Channels writes must keep off: quarantine and queued reactions */
+  uint8_t blockedChannels() const;
+
+  /** @brief Remember the HIT time of a channel from its (applied) configuration */
+  void trackHitTime(uint8_t channel, const ChannelConfig &config) const;
+
+  /** @brief Mask of channels whose HIT phase has elapsed at @p now_us (clears them) */
+  uint8_t expireHitPhases(uint32_t now_us) const;
+
+  /**
+   * @brief Recompute state for @p candidates; notify channels that changed
+   * @return Channels that went from HIT_PHASE to HOLD_PHASE
+   */
+  uint8_t updateChannelStates(uint8_t candidates) const;
+
+  /** @brief State implied by the tracked masks for one channel */
+  ChannelState computeChannelState(uint8_t channel) const;
+
+  /** @brief Forget all tracked state (all DISABLED, no notifications) */
+  void resetChannelStates() const;
 };
 
 // Public API: Get driver version string
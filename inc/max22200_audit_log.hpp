@@ -0,0 +1,246 @@
+/**
+ * @file max22200_audit_log.hpp
+ * @brief Crash-surviving binary log of MAX22200 register writes
+ *
+ * When a valve misbehaves in the field, the question is usually "what did
+ * the driver last write?". AuditLog records every register write the driver
+ * makes (bank, value, timestamp, caller tag) into a ring in memory supplied by
+ * the application. Place that memory in RAM that survives a watchdog or
+ * software reset, e.g. `RTC_NOINIT_ATTR` on ESP32 or a `.noinit` section,
+ * and re-Attach() it after boot to read what happened before the reset.
+ *
+ * ## Layout
+ *
+ * ```
+ * AuditLogHeader (16 B)  magic, capacity, format, check
+ * AuditEntry[capacity]   20 B each:
+ *   seq           running sequence number (wraps at 2^32)
+ *   timestamp_us  SpiInterface::GetTimeUs() at the write
+ *   value         value written (8-bit writes: the byte in bits 7:0)
+ *   info          bank [7:0], flags [15:8], caller tag [31:16]
+ *   check         hash of the four words above
+ * ```
+ *
+ * Appending an entry is five word stores plus a short hash. The checksum
+ * rejects an entry torn by a reset mid-store, and it also rejects
+ * uninitialised RAM. Attach() finds the newest entry by following the
+ * sequence numbers, so no write pointer has to be kept in sync with the
+ * entries.
+ *
+ * The driver logs a write before it goes on the bus. A reset during a hung
+ * transfer therefore still shows the write. A write whose transfer fails is
+ * then marked AuditEntry::FAILED.
+ *
+ * @code
+ * RTC_NOINIT_ATTR static uint32_t audit_mem[AuditLog::RequiredBytes(64) / 4];
+ * AuditLog audit;
+ * if (audit.Attach(audit_mem, sizeof(audit_mem))) {
+ *   audit.ForEach([](const AuditEntry &e) { printf("%u bank %u = 0x%08X\n", ...); });
+ * }
+ * driver.SetAuditLog(&audit);
+ * driver.SetAuditTag(TAG_STARTUP);
+ * @endcode
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace max22200 {
+
+/**
+ * @brief One logged register write
+ */
+struct AuditEntry {
+  uint32_t seq;           ///< Sequence number
+  uint32_t timestamp_us;  ///< Time of the write (driver's GetTimeUs())
+  uint32_t value;         ///< Value written (8-bit writes: bits 7:0)
+  uint32_t info;          ///< bank [7:0], flags [15:8], tag [31:16]
+  uint32_t check;         ///< AuditEntry::hash() of the fields above
+
+  static constexpr uint8_t WRITE8  = 0x01;  ///< Flag: 8-bit (MSB) write
+  static constexpr uint8_t FAILED  = 0x02;  ///< Flag: the SPI transfer failed
+  static constexpr uint8_t COMMAND = 0x04;  ///< Flag: command frame only, no data (ArmChannelsOn)
+
+  uint8_t bank() const { return static_cast<uint8_t>(info); }
+  uint8_t flags() const { return static_cast<uint8_t>(info >> 8); }
+  uint16_t tag() const { return static_cast<uint16_t>(info >> 16); }
+
+  /**
+   * @brief Checksum over seq, timestamp, value and info
+   */
+  static uint32_t hash(uint32_t seq, uint32_t timestamp_us, uint32_t value, uint32_t info) {
+    uint32_t h = (seq ^ 0xA5D1722Bu) * 0x9E3779B1u;
+    h = (h ^ timestamp_us) * 0x85EBCA77u;
+    h = (h ^ value) * 0xC2B2AE3Du;
+    return (h ^ info ^ (h >> 15)) * 0x27D4EB2Fu;
+  }
+
+  bool isValid() const { return check == hash(seq, timestamp_us, value, info); }
+};
+
+/**
+ * @brief Ring header at the start of the retained memory
+ */
+struct AuditLogHeader {
+  uint32_t magic;     ///< AuditLog::MAGIC
+  uint32_t capacity;  ///< Entries in the ring
+  uint32_t format;    ///< AuditLog::FORMAT_VERSION
+  uint32_t check;     ///< ~(magic ^ capacity ^ format)
+};
+
+/**
+ * @brief Register-write audit ring over caller-provided (retained) memory
+ *
+ * Not thread-safe on its own; the driver appends under the same bus lock
+ * the caller already holds for driver calls.
+ */
+class AuditLog {
+public:
+  static constexpr uint32_t MAGIC = 0x4D415841u;  ///< "AXAM"
+  static constexpr uint32_t FORMAT_VERSION = 1;
+  static constexpr uint32_t NO_SLOT = 0xFFFFFFFFu;  ///< Append() result when detached
+
+  AuditLog() : header_(nullptr), entries_(nullptr), capacity_(0), slot_(0), seq_(0) {}
+
+  /**
+   * @brief Bytes of memory needed for @p entries entries
+   */
+  static constexpr size_t RequiredBytes(size_t entries) {
+    return sizeof(AuditLogHeader) + entries * sizeof(AuditEntry);
+  }
+
+  /**
+   * @brief Use @p mem as the ring, keeping a log already there
+   *
+   * @param mem   4-byte aligned memory, ideally retained across resets
+   * @param bytes Size of @p mem; at least RequiredBytes(2)
+   * @return true if a valid log with the same capacity was found and kept;
+   *         false if the memory was (re)formatted, or is unusable (then
+   *         the log stays detached, see IsAttached())
+   */
+  bool Attach(void *mem, size_t bytes) {
+    header_ = nullptr;
+    entries_ = nullptr;
+    capacity_ = 0;
+    if (mem == nullptr || (reinterpret_cast<uintptr_t>(mem) & 3u) != 0 ||
+        bytes < RequiredBytes(2)) {
+      return false;
+    }
+    header_ = static_cast<AuditLogHeader *>(mem);
+    entries_ = reinterpret_cast<AuditEntry *>(header_ + 1);
+    capacity_ = static_cast<uint32_t>((bytes - sizeof(AuditLogHeader)) / sizeof(AuditEntry));
+
+    const bool kept = header_->magic == MAGIC && header_->capacity == capacity_ &&
+                      header_->format == FORMAT_VERSION &&
+                      header_->check == ~(MAGIC ^ capacity_ ^ FORMAT_VERSION);
+    if (!kept) {
+      Clear();
+      return false;
+    }
+    recover();
+    return true;
+  }
+
+  /**
+   * @brief Erase all entries (keeps the memory attached)
+   */
+  void Clear() {
+    if (header_ == nullptr) return;
+    header_->magic = MAGIC;
+    header_->capacity = capacity_;
+    header_->format = FORMAT_VERSION;
+    header_->check = ~(MAGIC ^ capacity_ ^ FORMAT_VERSION);
+    const uint32_t invalid = ~AuditEntry::hash(0, 0, 0, 0);
+    for (uint32_t i = 0; i < capacity_; ++i) {
+      entries_[i] = AuditEntry{0, 0, 0, 0, invalid};
+    }
+    slot_ = 0;
+    seq_ = 0;
+  }
+
+  /**
+   * @brief Log one write
+   *
+   * @return Slot for MarkFailed(), or NO_SLOT if detached
+   */
+  uint32_t Append(uint8_t bank, uint32_t value, uint32_t timestamp_us, uint16_t tag,
+                  uint8_t flags) {
+    if (entries_ == nullptr) return NO_SLOT;
+    const uint32_t slot = slot_;
+    const uint32_t info = static_cast<uint32_t>(bank) | (static_cast<uint32_t>(flags) << 8) |
+                          (static_cast<uint32_t>(tag) << 16);
+    AuditEntry &e = entries_[slot];
+    e.seq = seq_;
+    e.timestamp_us = timestamp_us;
+    e.value = value;
+    e.info = info;
+    e.check = AuditEntry::hash(seq_, timestamp_us, value, info);
+    seq_++;
+    slot_ = (slot + 1 == capacity_) ? 0 : slot + 1;
+    return slot;
+  }
+
+  /**
+   * @brief Set AuditEntry::FAILED on the entry Append() returned @p slot for
+   */
+  void MarkFailed(uint32_t slot) {
+    if (slot >= capacity_) return;
+    AuditEntry &e = entries_[slot];
+    e.info |= static_cast<uint32_t>(AuditEntry::FAILED) << 8;
+    e.check = AuditEntry::hash(e.seq, e.timestamp_us, e.value, e.info);
+  }
+
+  /**
+   * @brief Call fn(const AuditEntry&) for every valid entry, oldest first
+   *
+   * @return Entries visited
+   */
+  template <typename F>
+  size_t ForEach(F &&fn) const {
+    size_t n = 0;
+    for (uint32_t i = 0; i < capacity_; ++i) {
+      const uint32_t slot = (slot_ + i) % capacity_;
+      if (entries_[slot].isValid()) {
+        fn(entries_[slot]);
+        n++;
+      }
+    }
+    return n;
+  }
+
+  bool IsAttached() const { return entries_ != nullptr; }
+  uint32_t GetCapacity() const { return capacity_; }
+
+  /**
+   * @brief Sequence number the next Append() will use (= writes logged since Clear(), mod 2^32)
+   */
+  uint32_t GetNextSequence() const { return seq_; }
+
+private:
+  /// Newest entry: valid, and the next slot does not continue its sequence
+  void recover() {
+    slot_ = 0;
+    seq_ = 0;
+    for (uint32_t i = 0; i < capacity_; ++i) {
+      const AuditEntry &e = entries_[i];
+      if (!e.isValid()) continue;
+      const uint32_t next = (i + 1 == capacity_) ? 0 : i + 1;
+      const AuditEntry &n = entries_[next];
+      if (!n.isValid() || n.seq != e.seq + 1u) {
+        slot_ = next;
+        seq_ = e.seq + 1u;
+        return;
+      }
+    }
+  }
+
+  AuditLogHeader *header_;
+  AuditEntry *entries_;
+  uint32_t capacity_;
+  uint32_t slot_;  ///< Next slot to write
+  uint32_t seq_;   ///< Next sequence number
+};
+
+} // namespace max22200
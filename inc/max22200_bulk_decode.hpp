@@ -0,0 +1,213 @@
+/**
+ * @file max22200_bulk_decode.hpp
+ * @brief Column-wise decoding of STATUS / FAULT register word arrays
+ *
+ * StatusConfig::fromRegister() and FaultStatus::fromRegister() unpack one
+ * word into a struct of bools and enums. Log processing and fleet aggregation
+ * instead want every sample's value of one field side by side (structure of
+ * arrays). DecodeStatusWords() and DecodeFaultWords() fill such columns for a
+ * whole array of raw words:
+ *
+ * | Column            | Content (per word)                                         |
+ * |-------------------|------------------------------------------------------------|
+ * | onch              | STATUS[31:24], bit N = channel N on                         |
+ * | fault_masks       | STATUS[23:16]: M_OVT M_OCP M_OLF M_HHF M_DPM M_COMF M_UVM FREQM |
+ * | pair_modes        | STATUS[15:8]: CM76 CM54 CM32 CM10 (2 bits each)             |
+ * | flags             | STATUS[7:0]: OVT OCP OLF HHF DPM COMER UVM ACTIVE          |
+ * | fault_types       | STATUS flags as a FaultType bitmap (bit = 1 << FaultType)  |
+ * | ocp/hhf/olf/dpm   | FAULT channel masks                                         |
+ * | any               | OR of the four FAULT masks (channels with any fault)       |
+ * | channel_types     | Nibble per channel (bits 4N+3:4N): FaultType bitmap OCP..DPM |
+ *
+ * Byte columns are extracted 16 words at a time with SSE2 where available
+ * (shift, mask, pack), otherwise with a plain loop the compiler can
+ * vectorise. The bit remaps (fault_types, channel_types) are table lookups.
+ * Every column equals the corresponding StatusConfig / FaultStatus field bit
+ * for bit (see benchmarks/max22200_bulk_decode_bench.cpp).
+ *
+ * Column pointers may be null to skip a column; non-null ones must hold
+ * `count` elements. Nothing is allocated.
+ *
+ * @code
+ * uint8_t onch[N], types[N];
+ * StatusColumns cols;
+ * cols.onch = onch;
+ * cols.fault_types = types;
+ * DecodeStatusWords(status_words, N, cols);
+ * if (types[i] & FaultTypeBit(FaultType::UVM)) { ... }
+ * @endcode
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include "max22200_registers.hpp"
+#include "max22200_types.hpp"
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace max22200 {
+
+/**
+ * @brief Output columns for DecodeStatusWords() (null = skip)
+ */
+struct StatusColumns {
+  uint8_t *onch;         ///< STATUS[31:24] (StatusConfig::channels_on_mask)
+  uint8_t *fault_masks;  ///< STATUS[23:16] (fault masks, FREQM in bit 0)
+  uint8_t *pair_modes;   ///< STATUS[15:8] (CM76 in bits 7:6 ... CM10 in bits 1:0)
+  uint8_t *flags;        ///< STATUS[7:0] (fault flags, ACTIVE in bit 0)
+  uint8_t *fault_types;  ///< STATUS fault flags as a FaultType bitmap
+
+  StatusColumns()
+      : onch(nullptr), fault_masks(nullptr), pair_modes(nullptr), flags(nullptr),
+        fault_types(nullptr) {}
+};
+
+/**
+ * @brief Output columns for DecodeFaultWords() (null = skip)
+ */
+struct FaultColumns {
+  uint8_t *ocp;             ///< FAULT[31:24] (FaultStatus::overcurrent_channel_mask)
+  uint8_t *hhf;             ///< FAULT[23:16] (hit_not_reached_channel_mask)
+  uint8_t *olf;             ///< FAULT[15:8] (open_load_fault_channel_mask)
+  uint8_t *dpm;             ///< FAULT[7:0] (plunger_movement_fault_channel_mask)
+  uint8_t *any;             ///< Channels with any fault (OR of the four masks)
+  uint32_t *channel_types;  ///< Nibble per channel; see ChannelFaultTypes()
+
+  FaultColumns()
+      : ocp(nullptr), hhf(nullptr), olf(nullptr), dpm(nullptr), any(nullptr),
+        channel_types(nullptr) {}
+};
+
+/**
+ * @brief FaultType bitmap (OCP..DPM) of one channel from a channel_types value
+ */
+constexpr uint8_t ChannelFaultTypes(uint32_t channel_types, uint8_t channel) {
+  return channel < NUM_CHANNELS_ ? static_cast<uint8_t>((channel_types >> (4u * channel)) & 0x0Fu)
+                                 : 0;
+}
+
+// ============================================================================
+// Lookup tables
+// ============================================================================
+
+namespace BulkDecodeTables {
+
+/// STATUS[7:0] -> FaultType bitmap (ACTIVE dropped)
+struct StatusFaultTypeTable {
+  uint8_t v[256];
+  constexpr StatusFaultTypeTable() : v() {
+    for (unsigned b = 0; b < 256; ++b) {
+      uint8_t t = 0;
+      if (b & StatusReg::OCP_BIT)   t |= FaultTypeBit(FaultType::OCP);
+      if (b & StatusReg::HHF_BIT)   t |= FaultTypeBit(FaultType::HHF);
+      if (b & StatusReg::OLF_BIT)   t |= FaultTypeBit(FaultType::OLF);
+      if (b & StatusReg::DPM_BIT)   t |= FaultTypeBit(FaultType::DPM);
+      if (b & StatusReg::OVT_BIT)   t |= FaultTypeBit(FaultType::OVT);
+      if (b & StatusReg::UVM_BIT)   t |= FaultTypeBit(FaultType::UVM);
+      if (b & StatusReg::COMER_BIT) t |= FaultTypeBit(FaultType::COMER);
+      v[b] = t;
+    }
+  }
+};
+
+/// Channel mask -> bit 4N set for each channel N (one FAULT type spread to nibbles)
+struct NibbleSpreadTable {
+  uint32_t v[256];
+  constexpr NibbleSpreadTable() : v() {
+    for (unsigned b = 0; b < 256; ++b) {
+      uint32_t s = 0;
+      for (unsigned ch = 0; ch < 8; ++ch) {
+        if (b & (1u << ch)) s |= 1u << (4u * ch);
+      }
+      v[b] = s;
+    }
+  }
+};
+
+inline constexpr StatusFaultTypeTable kStatusFaultTypes{};
+inline constexpr NibbleSpreadTable kNibbleSpread{};
+
+/**
+ * @brief out[i] = (words[i] >> shift) & 0xFF, or with fold the OR of all four bytes
+ */
+inline void extractBytes(const uint32_t *words, size_t count, unsigned shift, bool fold,
+                         uint8_t *out) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128i low = _mm_set1_epi32(0xFF);
+  const __m128i sh = _mm_cvtsi32_si128(static_cast<int>(shift));
+  auto lanes = [&](const uint32_t *p) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    if (fold) {
+      v = _mm_or_si128(v, _mm_srli_epi32(v, 16));
+      v = _mm_or_si128(v, _mm_srli_epi32(v, 8));
+    } else {
+      v = _mm_srl_epi32(v, sh);
+    }
+    return _mm_and_si128(v, low);
+  };
+  for (; i + 16 <= count; i += 16) {
+    const __m128i lo = _mm_packs_epi32(lanes(words + i), lanes(words + i + 4));
+    const __m128i hi = _mm_packs_epi32(lanes(words + i + 8), lanes(words + i + 12));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(lo, hi));
+  }
+#endif
+  if (fold) {
+    for (; i < count; ++i) {
+      const uint32_t w = words[i] | (words[i] >> 16);
+      out[i] = static_cast<uint8_t>(w | (w >> 8));
+    }
+  } else {
+    for (; i < count; ++i) out[i] = static_cast<uint8_t>(words[i] >> shift);
+  }
+}
+
+}  // namespace BulkDecodeTables
+
+// ============================================================================
+// Decoders
+// ============================================================================
+
+/**
+ * @brief Decode `count` STATUS words into the non-null columns of `out`
+ */
+inline void DecodeStatusWords(const uint32_t *words, size_t count, const StatusColumns &out) {
+  using namespace BulkDecodeTables;
+  if (out.onch) extractBytes(words, count, StatusReg::ONCH_SHIFT, false, out.onch);
+  if (out.fault_masks) extractBytes(words, count, 16, false, out.fault_masks);  // FREQM = bit 16
+  if (out.pair_modes) extractBytes(words, count, StatusReg::CM10_SHIFT, false, out.pair_modes);
+  if (out.flags) extractBytes(words, count, 0, false, out.flags);
+  if (out.fault_types) {
+    for (size_t i = 0; i < count; ++i) {
+      out.fault_types[i] = kStatusFaultTypes.v[words[i] & 0xFFu];
+    }
+  }
+}
+
+/**
+ * @brief Decode `count` FAULT words into the non-null columns of `out`
+ */
+inline void DecodeFaultWords(const uint32_t *words, size_t count, const FaultColumns &out) {
+  using namespace BulkDecodeTables;
+  if (out.ocp) extractBytes(words, count, FaultReg::OCP_SHIFT, false, out.ocp);
+  if (out.hhf) extractBytes(words, count, FaultReg::HHF_SHIFT, false, out.hhf);
+  if (out.olf) extractBytes(words, count, FaultReg::OLF_SHIFT, false, out.olf);
+  if (out.dpm) extractBytes(words, count, FaultReg::DPM_SHIFT, false, out.dpm);
+  if (out.any) extractBytes(words, count, 0, true, out.any);
+  if (out.channel_types) {
+    // FaultType OCP=0, HHF=1, OLF=2, DPM=3 -> bit offset within each nibble
+    for (size_t i = 0; i < count; ++i) {
+      const uint32_t w = words[i];
+      out.channel_types[i] = kNibbleSpread.v[(w >> FaultReg::OCP_SHIFT) & 0xFFu] |
+                             (kNibbleSpread.v[(w >> FaultReg::HHF_SHIFT) & 0xFFu] << 1) |
+                             (kNibbleSpread.v[(w >> FaultReg::OLF_SHIFT) & 0xFFu] << 2) |
+                             (kNibbleSpread.v[(w >> FaultReg::DPM_SHIFT) & 0xFFu] << 3);
+    }
+  }
+}
+
+}  // namespace max22200
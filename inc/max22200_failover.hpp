@@ -0,0 +1,368 @@
+/**
+ * @file max22200_failover.hpp
+ * @brief Redundant-channel valve failover across one or more MAX22200 devices
+ *
+ * A valve wired to two channels, on one device or on two, is one logical
+ * valve with a primary and a backup route. ValveFailover owns the ONCH bits of
+ * those channels: the application switches valves with SetValves(), and the
+ * map drives whichever side is active.
+ *
+ * When the primary channel reports one of the route's fault types (default
+ * OCP, OLF, HHF), the fault callback of the read that saw the fault moves the
+ * valve to the backup in the map and marks the affected devices; the read
+ * itself writes nothing. Service(), run right after the poll, issues the
+ * writes. Each route is precompiled into (device, ONCH bit) pairs and every
+ * device's wanted ONCH mask is kept up to date, so a switchover is one
+ * SetChannelsOn() (one 8-bit STATUS write) per affected device: one write
+ * when both routes share a device, two otherwise. A fault on the active
+ * backup marks the valve lost and switches it off.
+ *
+ * AttachDevice() installs the map as the device's FaultCallback; use
+ * SetFaultCallback() here to still receive every fault. Switchover latency
+ * (fault event opened → last ONCH write done in Service()) and counts are
+ * kept in FailoverStats.
+ *
+ * @code
+ * ValveFailover<MAX22200<MySpi>> valves;
+ * valves.AttachDevice(0, dev_a);
+ * valves.AttachDevice(1, dev_b);
+ * valves.AddValve(ValveRoute(0, 2, 1, 2));  // valve 0: A CH2, backup B CH2
+ * valves.AddValve(ValveRoute(0, 5, 0, 6));  // valve 1: A CH5, backup A CH6
+ * valves.SetValves(0x3);
+ * // fault task: dev_a.ReadFaultRegister(faults); then switch over as needed:
+ * valves.Service();
+ * const FailoverStats &stats = valves.GetStats();
+ * @endcode
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include "max22200_fault_filter.hpp"
+#include "max22200_types.hpp"
+#include <cstdint>
+
+namespace max22200 {
+
+/**
+ * @brief Primary and backup channel of one logical valve
+ */
+struct ValveRoute {
+  uint8_t primary_device;   ///< Index given to ValveFailover::AttachDevice()
+  uint8_t primary_channel;  ///< 0-7
+  uint8_t backup_device;
+  uint8_t backup_channel;
+  uint8_t fault_types;      ///< FaultTypeBit()s that fail a side (OCP..DPM only)
+
+  /// OCP, HHF, OLF (FaultTypeBit())
+  static constexpr uint8_t DEFAULT_FAULT_TYPES = (1u << 0) | (1u << 1) | (1u << 2);
+
+  ValveRoute()
+      : primary_device(0), primary_channel(0), backup_device(0), backup_channel(0),
+        fault_types(DEFAULT_FAULT_TYPES) {}
+  ValveRoute(uint8_t p_dev, uint8_t p_ch, uint8_t b_dev, uint8_t b_ch,
+             uint8_t types = DEFAULT_FAULT_TYPES)
+      : primary_device(p_dev), primary_channel(p_ch), backup_device(b_dev), backup_channel(b_ch),
+        fault_types(types) {}
+};
+
+/**
+ * @brief Side a valve is driven on
+ */
+enum class ValveSide : uint8_t {
+  PRIMARY = 0,
+  BACKUP  = 1,
+  LOST    = 2  ///< Both sides faulted; held off until Restore()
+};
+
+/**
+ * @brief Counters kept by ValveFailover
+ */
+struct FailoverStats {
+  uint32_t failovers;        ///< Valves moved to their backup
+  uint32_t lost;             ///< Valves whose backup faulted too
+  uint32_t switch_writes;    ///< ONCH writes issued by switchovers
+  uint32_t write_errors;     ///< Switchover writes that failed
+  uint32_t last_latency_us;  ///< Fault event opened → last switchover write done (Service())
+  uint32_t max_latency_us;
+
+  FailoverStats()
+      : failovers(0), lost(0), switch_writes(0), write_errors(0), last_latency_us(0),
+        max_latency_us(0) {}
+};
+
+/// Fault forwarded by ValveFailover with the device it came from
+using ValveFaultCallback = void (*)(uint8_t device, uint8_t channel, FaultType fault_type,
+                                    void *user_data);
+
+/**
+ * @class ValveFailover
+ * @brief Logical valves with primary / backup channels and single-write switchover
+ *
+ * @tparam Driver      MAX22200<SpiType>
+ * @tparam MAX_DEVICES Devices that can be attached (1 to 8)
+ * @tparam MAX_VALVES  Logical valves (at most 32)
+ */
+template <typename Driver, uint8_t MAX_DEVICES = 4, uint8_t MAX_VALVES = 16>
+class ValveFailover {
+  static_assert(MAX_DEVICES >= 1 && MAX_DEVICES <= 8, "device set is 8-bit");
+  static_assert(MAX_VALVES <= 32, "valve masks are 32-bit");
+
+public:
+  ValveFailover()
+      : drivers_{}, slots_{}, routes_{}, count_(0), primary_at_{}, backup_at_{}, owned_{},
+        want_{}, on_(0), backup_(0), lost_(0), pending_(0), pending_us_(0), stats_(),
+        callback_(nullptr), callback_user_data_(nullptr) {
+    for (uint8_t d = 0; d < MAX_DEVICES; ++d) {
+      slots_[d].map = this;
+      slots_[d].device = d;
+    }
+  }
+
+  // The attached drivers call back into this object
+  ValveFailover(const ValveFailover &) = delete;
+  ValveFailover &operator=(const ValveFailover &) = delete;
+
+  /**
+   * @brief Attach @p driver as device @p device and take its FaultCallback
+   * @return false if @p device is out of range
+   */
+  bool AttachDevice(uint8_t device, Driver &driver) {
+    if (device >= MAX_DEVICES) return false;
+    drivers_[device] = &driver;
+    driver.SetFaultCallback(&ValveFailover::onFault, &slots_[device]);
+    return true;
+  }
+
+  /**
+   * @brief Add a valve (index = number of valves added before it)
+   * @return false if full, a device is not attached, a channel is out of
+   *         range, the two routes are the same channel, or a channel already
+   *         belongs to another valve
+   */
+  bool AddValve(const ValveRoute &route) {
+    if (count_ >= MAX_VALVES || !routeValid(route)) return false;
+    const uint8_t v = count_++;
+    const uint32_t vbit = 1u << v;
+    routes_[v] = route;
+    primary_at_[route.primary_device][route.primary_channel] = vbit;
+    backup_at_[route.backup_device][route.backup_channel] = vbit;
+    owned_[route.primary_device] |= bit(route.primary_channel);
+    owned_[route.backup_device] |= bit(route.backup_channel);
+    return true;
+  }
+
+  /**
+   * @brief Switch valves on (bit N = valve N) and the rest off
+   *
+   * Each device whose owned channels change gets one SetChannelsOn(); its
+   * channels not owned by the map keep their current state.
+   */
+  DriverStatus SetValves(uint32_t mask) {
+    on_ = mask & validMask();
+    for (uint8_t d = 0; d < MAX_DEVICES; ++d) want_[d] = 0;
+    for (uint32_t m = on_ & ~lost_; m != 0; m &= m - 1) {
+      const uint8_t v = static_cast<uint8_t>(lowestBit(m));
+      want_[activeDevice(v)] |= activeBit(v);
+    }
+    return write(allDevices(), nullptr);
+  }
+
+  /** @brief Switch one valve without touching the others */
+  DriverStatus SetValve(uint8_t valve, bool on) {
+    if (valve >= count_) return DriverStatus::INVALID_PARAMETER;
+    return SetValves(on ? (on_ | (1u << valve)) : (on_ & ~(1u << valve)));
+  }
+
+  /**
+   * @brief Move @p valve back to its primary (after repair; also clears LOST)
+   */
+  DriverStatus Restore(uint8_t valve) {
+    if (valve >= count_) return DriverStatus::INVALID_PARAMETER;
+    const uint32_t vbit = 1u << valve;
+    backup_ &= ~vbit;
+    lost_ &= ~vbit;
+    return SetValves(on_);
+  }
+
+  /**
+   * @brief Record a fault seen on (@p device, @p channel)
+   *
+   * Called by the attached drivers' FaultCallback, inside their reads; call
+   * it directly for faults learned another way. Valves whose active side
+   * this is fail over (primary) or are lost (backup) in the map; nothing is
+   * written until Service().
+   *
+   * @return true if devices now wait for Service()
+   */
+  bool OnFault(uint8_t device, uint8_t channel, FaultType type) {
+    if (device >= MAX_DEVICES || channel >= NUM_CHANNELS_ ||
+        static_cast<uint8_t>(type) > static_cast<uint8_t>(FaultType::DPM)) {
+      return false;  // Device-level faults have no route
+    }
+    const uint8_t type_bit = FaultTypeBit(type);
+    const uint32_t to_backup = primary_at_[device][channel] & ~backup_ & ~lost_;
+    const uint32_t to_lost = backup_at_[device][channel] & backup_ & ~lost_;
+    const uint32_t hit = to_backup | to_lost;
+    if (hit == 0 || (routes_[lowestBit(hit)].fault_types & type_bit) == 0) {
+      return false;
+    }
+    // One valve per channel: hit has a single bit
+    const uint8_t v = static_cast<uint8_t>(lowestBit(hit));
+    const ValveRoute &r = routes_[v];
+    uint8_t dirty = devBit(device);
+    want_[device] &= static_cast<uint8_t>(~bit(channel));
+    if (to_backup != 0) {
+      backup_ |= hit;
+      stats_.failovers++;
+      if ((on_ & hit) != 0) {
+        want_[r.backup_device] |= bit(r.backup_channel);
+        dirty |= devBit(r.backup_device);
+      }
+    } else {
+      lost_ |= hit;
+      stats_.lost++;
+    }
+    uint32_t opened_us = drivers_[device]->GetTimeUs();
+    FaultEvent event;
+    const uint8_t key = FaultEventFilter::KeyOf(channel, type);
+    if (drivers_[device]->GetFaultFilter().GetEvent(key, event)) {
+      opened_us = event.first_us;
+    }
+    // Latency counts from the oldest event waiting for Service()
+    if (pending_ == 0 || static_cast<int32_t>(opened_us - pending_us_) < 0) {
+      pending_us_ = opened_us;
+    }
+    pending_ |= dirty;
+    return true;
+  }
+
+  /**
+   * @brief Write the switchovers recorded by OnFault()
+   *
+   * Call right after each poll of an attached device (and after its
+   * ServiceReactions()); with nothing pending it costs one test. One
+   * SetChannelsOn() per affected device.
+   *
+   * @return Status of the last failed write, or OK
+   */
+  DriverStatus Service() {
+    if (pending_ == 0) return DriverStatus::OK;
+    const uint8_t devices = pending_;
+    pending_ = 0;
+    return write(devices, &pending_us_);
+  }
+
+  /** @brief Devices with a switchover waiting for Service() */
+  uint8_t GetPendingDevices() const { return pending_; }
+
+  ValveSide GetSide(uint8_t valve) const {
+    const uint32_t vbit = valve < 32 ? 1u << valve : 0;
+    return (lost_ & vbit) != 0     ? ValveSide::LOST
+           : (backup_ & vbit) != 0 ? ValveSide::BACKUP
+                                   : ValveSide::PRIMARY;
+  }
+
+  /** @brief Valves on their backup (bit N = valve N) */
+  uint32_t GetFailedOver() const { return backup_ & ~lost_; }
+  /** @brief Valves with both sides faulted */
+  uint32_t GetLost() const { return lost_; }
+  /** @brief Valves commanded on (SetValves()) */
+  uint32_t GetValves() const { return on_; }
+  uint8_t Size() const { return count_; }
+
+  /** @brief Every fault from the attached devices, with the device index */
+  void SetFaultCallback(ValveFaultCallback callback, void *user_data) {
+    callback_ = callback;
+    callback_user_data_ = user_data;
+  }
+
+  const FailoverStats &GetStats() const { return stats_; }
+  void ResetStats() { stats_ = FailoverStats(); }
+
+private:
+  struct Slot {
+    ValveFailover *map;
+    uint8_t device;
+  };
+
+  static constexpr uint8_t bit(uint8_t ch) { return static_cast<uint8_t>(1u << ch); }
+  static constexpr uint8_t devBit(uint8_t d) { return static_cast<uint8_t>(1u << d); }
+  static constexpr uint8_t allDevices() { return static_cast<uint8_t>((1u << MAX_DEVICES) - 1u); }
+  uint32_t validMask() const { return count_ >= 32 ? 0xFFFFFFFFu : (1u << count_) - 1u; }
+
+  uint8_t activeDevice(uint8_t v) const {
+    return (backup_ >> v) & 1u ? routes_[v].backup_device : routes_[v].primary_device;
+  }
+  uint8_t activeBit(uint8_t v) const {
+    return bit((backup_ >> v) & 1u ? routes_[v].backup_channel : routes_[v].primary_channel);
+  }
+
+  bool routeValid(const ValveRoute &r) const {
+    if (r.primary_device >= MAX_DEVICES || r.backup_device >= MAX_DEVICES ||
+        drivers_[r.primary_device] == nullptr || drivers_[r.backup_device] == nullptr ||
+        r.primary_channel >= NUM_CHANNELS_ || r.backup_channel >= NUM_CHANNELS_ ||
+        (r.fault_types & 0x0Fu) == 0) {
+      return false;
+    }
+    if (r.primary_device == r.backup_device && r.primary_channel == r.backup_channel) {
+      return false;
+    }
+    return (owned_[r.primary_device] & bit(r.primary_channel)) == 0 &&
+           (owned_[r.backup_device] & bit(r.backup_channel)) == 0;
+  }
+
+  /// One SetChannelsOn() per device in @p devices whose ONCH differs from the wanted mask
+  DriverStatus write(uint8_t devices, const uint32_t *opened_us) {
+    DriverStatus result = DriverStatus::OK;
+    uint8_t last = MAX_DEVICES;
+    for (uint8_t d = 0; d < MAX_DEVICES; ++d) {
+      if ((devices & devBit(d)) == 0 || owned_[d] == 0) continue;
+      Driver &drv = *drivers_[d];
+      const uint8_t current = drv.GetChannelsOnMask();
+      const uint8_t next = static_cast<uint8_t>((current & ~owned_[d]) | want_[d]);
+      if (next == current) continue;
+      const DriverStatus s = drv.SetChannelsOn(next);
+      last = d;
+      if (opened_us != nullptr) {
+        stats_.switch_writes++;
+        if (s != DriverStatus::OK) stats_.write_errors++;
+      }
+      if (s != DriverStatus::OK) result = s;
+    }
+    if (opened_us != nullptr && last < MAX_DEVICES) {
+      stats_.last_latency_us = drivers_[last]->GetTimeUs() - *opened_us;
+      if (stats_.last_latency_us > stats_.max_latency_us) {
+        stats_.max_latency_us = stats_.last_latency_us;
+      }
+    }
+    return result;
+  }
+
+  static void onFault(uint8_t channel, FaultType type, void *user_data) {
+    const Slot *slot = static_cast<const Slot *>(user_data);
+    ValveFailover *map = slot->map;
+    map->OnFault(slot->device, channel, type);
+    if (map->callback_ != nullptr) {
+      map->callback_(slot->device, channel, type, map->callback_user_data_);
+    }
+  }
+
+  Driver *drivers_[MAX_DEVICES];
+  Slot slots_[MAX_DEVICES];
+  ValveRoute routes_[MAX_VALVES];
+  uint8_t count_;
+  uint32_t primary_at_[MAX_DEVICES][NUM_CHANNELS_];  ///< Valve bit whose primary is (device, ch)
+  uint32_t backup_at_[MAX_DEVICES][NUM_CHANNELS_];   ///< Valve bit whose backup is (device, ch)
+  uint8_t owned_[MAX_DEVICES];                       ///< ONCH bits owned by the map
+  uint8_t want_[MAX_DEVICES];                        ///< Wanted ONCH of the owned bits
+  uint32_t on_;      ///< Valves commanded on
+  uint32_t backup_;  ///< Valves on their backup
+  uint32_t lost_;    ///< Valves with both sides faulted
+  uint8_t pending_;      ///< Devices with a switchover waiting for Service()
+  uint32_t pending_us_;  ///< Oldest fault event opened among them
+  FailoverStats stats_;
+  ValveFaultCallback callback_;
+  void *callback_user_data_;
+};
+
+} // namespace max22200
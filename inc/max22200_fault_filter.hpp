@@ -0,0 +1,195 @@
+/**
+ * @file max22200_fault_filter.hpp
+ * @brief De-duplication of repeated MAX22200 fault observations into events
+ *
+ * A chattering OLF or DPM condition, or a poller faster than the fault
+ * clears, returns the same FAULT bits on read after read. FaultEventFilter
+ * turns those observations into events keyed on (channel, FaultType):
+ *
+ *   - The first observation of a key opens an event (reported once).
+ *   - Further observations within `window_us` of the previous one are merged
+ *     into it: count is incremented and last_us moves forward.
+ *   - A key not observed for `window_us` closes its event; the closed event
+ *     (count, first_us, last_us) is handed to the caller.
+ *
+ * State is a 64-bit open-event bitmap plus a timestamp pair and a 16-bit
+ * count per key (35 keys: OCP/HHF/OLF/DPM × 8 channels, then OVT, UVM and
+ * COMER for the device). With no fault and no open event an observation is
+ * one compare; a steady chattering fault costs a few bit operations and two
+ * stores per set bit.
+ *
+ * The driver owns one (see MAX22200::SetFaultFilterWindowUs()) and reports
+ * opened events through the fault callback, closed ones through the fault
+ * event callback. It can also be used on its own, e.g. over logged snapshots.
+ *
+ * @code
+ * FaultEventFilter filter(200000);  // merge repeats less than 200 ms apart
+ * uint64_t opened = filter.Observe(now_us, FaultEventFilter::KeyBits(snap.faults) |
+ *                                              FaultEventFilter::KeyBits(snap.status));
+ * filter.Expire(now_us, [](const FaultEvent &e) { log(e.channel, e.type, e.count); });
+ * @endcode
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include "max22200_types.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace max22200 {
+
+/**
+ * @brief One de-duplicated fault event
+ */
+struct FaultEvent {
+  uint8_t channel;    ///< 0-7, or FaultEventFilter::DEVICE_CHANNEL for OVT/UVM/COMER
+  FaultType type;     ///< Fault type
+  uint16_t count;     ///< Observations merged (saturates at 65535)
+  uint32_t first_us;  ///< Time of the first observation
+  uint32_t last_us;   ///< Time of the latest observation
+
+  FaultEvent() : channel(0), type(FaultType::OCP), count(0), first_us(0), last_us(0) {}
+};
+
+/**
+ * @brief Callback for a closed (merged) fault event
+ */
+using FaultEventCallback = void (*)(const FaultEvent &event, void *user_data);
+
+/**
+ * @brief Bounded (channel, FaultType) event filter over fixed bitmaps
+ */
+class FaultEventFilter {
+public:
+  static constexpr uint8_t NUM_KEYS = 4 * NUM_CHANNELS_ + 3;  ///< 32 channel + 3 device keys
+  static constexpr uint8_t DEVICE_CHANNEL = 0xFF;   ///< FaultEvent::channel of OVT/UVM/COMER
+  static constexpr uint32_t DEFAULT_WINDOW_US = 100000;
+
+  explicit FaultEventFilter(uint32_t window_us = DEFAULT_WINDOW_US)
+      : window_us_(window_us), open_(0), first_us_{}, last_us_{}, count_{} {}
+
+  // ── Keys ───────────────────────────────────────────────────────────────
+
+  /**
+   * @brief Key of (channel, type): type × 8 + channel for OCP..DPM, 32.. for OVT, UVM, COMER
+   */
+  static uint8_t KeyOf(uint8_t channel, FaultType type) {
+    const uint8_t t = static_cast<uint8_t>(type);
+    return t < 4 ? static_cast<uint8_t>(t * NUM_CHANNELS_ + (channel & 0x07u))
+                 : static_cast<uint8_t>(4 * NUM_CHANNELS_ + (t - 4));
+  }
+
+  /** @brief Per-channel fault keys set in a FAULT register */
+  static uint64_t KeyBits(const FaultStatus &faults) {
+    return static_cast<uint64_t>(faults.overcurrent_channel_mask) |
+           (static_cast<uint64_t>(faults.hit_not_reached_channel_mask) << 8) |
+           (static_cast<uint64_t>(faults.open_load_fault_channel_mask) << 16) |
+           (static_cast<uint64_t>(faults.plunger_movement_fault_channel_mask) << 24);
+  }
+
+  /** @brief Device fault keys (OVT, UVM, COMER) set in STATUS */
+  static uint64_t KeyBits(const StatusConfig &status) {
+    return (status.overtemperature ? 1ull << KeyOf(0, FaultType::OVT) : 0) |
+           (status.undervoltage ? 1ull << KeyOf(0, FaultType::UVM) : 0) |
+           (status.communication_error ? 1ull << KeyOf(0, FaultType::COMER) : 0);
+  }
+
+  // ── Filtering ──────────────────────────────────────────────────────────
+
+  /**
+   * @brief Record that the keys in @p active were seen at @p now_us
+   *
+   * Call Expire() first so that a repeat after a quiet window opens a new
+   * event instead of extending the old one (the driver does both).
+   *
+   * @return Keys that opened a new event (report these)
+   */
+  uint64_t Observe(uint32_t now_us, uint64_t active) {
+    if (active == 0) return 0;
+    const uint64_t opened = active & ~open_;
+    open_ |= active;
+    for (uint64_t bits = active; bits != 0; bits &= bits - 1) {
+      const uint8_t key = lowestBit(bits);
+      if ((opened >> key) & 1u) {
+        first_us_[key] = now_us;
+        count_[key] = 1;
+      } else if (count_[key] != 0xFFFFu) {
+        count_[key]++;
+      }
+      last_us_[key] = now_us;
+    }
+    return opened;
+  }
+
+  /**
+   * @brief Close events not observed for the window; fn(const FaultEvent&) for each
+   *
+   * @return Events closed
+   */
+  template <typename F>
+  size_t Expire(uint32_t now_us, F &&fn) {
+    size_t n = 0;
+    for (uint64_t bits = open_; bits != 0; bits &= bits - 1) {
+      const uint8_t key = lowestBit(bits);
+      if (now_us - last_us_[key] >= window_us_) {
+        open_ &= ~(1ull << key);
+        fn(event(key));
+        n++;
+      }
+    }
+    return n;
+  }
+
+  /**
+   * @brief Open event of @p key, if any
+   */
+  bool GetEvent(uint8_t key, FaultEvent &out) const {
+    if (key >= NUM_KEYS || ((open_ >> key) & 1u) == 0) return false;
+    out = event(key);
+    return true;
+  }
+
+  /**
+   * @brief Call fn(const FaultEvent&) for every open event
+   */
+  template <typename F>
+  size_t ForEachOpen(F &&fn) const {
+    size_t n = 0;
+    for (uint64_t bits = open_; bits != 0; bits &= bits - 1) {
+      fn(event(lowestBit(bits)));
+      n++;
+    }
+    return n;
+  }
+
+  /** @brief Drop all open events without reporting them */
+  void Reset() { open_ = 0; }
+
+  void SetWindowUs(uint32_t window_us) { window_us_ = window_us; }
+  uint32_t GetWindowUs() const { return window_us_; }
+  uint64_t GetOpenMask() const { return open_; }
+
+private:
+  FaultEvent event(uint8_t key) const {
+    FaultEvent e;
+    if (key < 4 * NUM_CHANNELS_) {
+      e.channel = static_cast<uint8_t>(key % NUM_CHANNELS_);
+      e.type = static_cast<FaultType>(key / NUM_CHANNELS_);
+    } else {
+      e.channel = DEVICE_CHANNEL;
+      e.type = static_cast<FaultType>(4 + key - 4 * NUM_CHANNELS_);
+    }
+    e.count = count_[key];
+    e.first_us = first_us_[key];
+    e.last_us = last_us_[key];
+    return e;
+  }
+
+  uint32_t window_us_;
+  uint64_t open_;                  ///< Keys with an open event
+  uint32_t first_us_[NUM_KEYS];
+  uint32_t last_us_[NUM_KEYS];
+  uint16_t count_[NUM_KEYS];
+};
+
+} // namespace max22200
@@ -0,0 +1,510 @@
+/**
+ * @file max22200_history.hpp
+ * @brief Bounded, compressed on-device history of MAX22200 state for post-mortem dumps
+ *
+ * TelemetryEncoder streams every poll. TelemetryHistory instead keeps the
+ * last few minutes to hours of state in a fixed RAM budget, so that after a
+ * fault the application can dump what led up to it without having streamed
+ * anything. Each sample holds STATUS (with ONCH), FAULT, the command-phase
+ * fault byte and the eight CFG_CHx words (setpoints, from the driver's CFG
+ * shadow, so recording costs no SPI traffic).
+ *
+ * These words rarely change, so samples are compressed in two steps:
+ *
+ * - **Run-length**: consecutive samples with identical state are one record
+ *   (first / last timestamp and sample count). The open run stays in RAM and
+ *   is written when the state changes.
+ * - **XOR delta**: a record stores only the fields that differ from the
+ *   previous record, as LEB128 varints of (value XOR previous). STATUS is
+ *   rotated left by 8 bits first so a change of ONCH alone costs one byte.
+ *
+ * ## Record format
+ *
+ * ```
+ * header  (1 byte)  bit0 STATUS, bit1 FAULT, bit2 fault byte, bit3 setpoints,
+ *                   bit7 keyframe, bits 6:4 reserved (0)
+ * dt      (varint)  keyframe: absolute first timestamp; otherwise µs from the
+ *                   previous record's last sample (mod 2^32)
+ * repeats (varint)  samples after the first with the same state
+ * span    (varint)  last - first timestamp (only if repeats > 0)
+ * STATUS  (varint)  rotl(STATUS, 8), XOR the previous one unless keyframe
+ * FAULT   (varint)  FAULT, XOR previous unless keyframe
+ * fault byte (varint)
+ * setpoints         channel mask byte (keyframe: 0xFF), then one varint per
+ *                   set bit: CFG_CHx, XOR previous unless keyframe
+ * ```
+ *
+ * Timestamps are the caller's 32-bit µs clock and are stored as differences,
+ * so the clock may wrap; a single run or gap must stay under ~71 minutes.
+ *
+ * Storage is `Blocks` blocks of `BlockBytes`. Every block starts with a
+ * keyframe, so when the ring is full the oldest block is dropped whole and
+ * the rest stays decodable. Dump() copies the blocks oldest first, then the
+ * open run, into one stream that HistoryDecoder (target or host) reads back.
+ *
+ * @code
+ * TelemetryHistory<> history;  // 16 x 256 B
+ * for (;;) {
+ *   Snapshot snap;
+ *   if (driver.ReadSnapshot(snap) == DriverStatus::OK) {
+ *     history.Record(snap, driver);
+ *     if (snap.hasFault()) {
+ *       uint8_t buf[history.MAX_DUMP_BYTES];
+ *       size_t n = history.Dump(buf, sizeof(buf));  // store or send for post-mortem
+ *     }
+ *   }
+ * }
+ * @endcode
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include "max22200_registers.hpp"
+#include "max22200_telemetry.hpp"
+#include "max22200_types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace max22200 {
+
+// ============================================================================
+// Sample and record
+// ============================================================================
+
+/**
+ * @brief One history sample (raw register values)
+ */
+struct HistorySample {
+  uint32_t timestamp_us;                ///< Sample time in µs (caller's clock)
+  uint32_t status;                      ///< STATUS register, including ONCH and fault flags
+  uint32_t fault;                       ///< FAULT register
+  uint32_t setpoints[NUM_CHANNELS_];    ///< CFG_CHx register per channel
+  uint8_t  fault_byte;                  ///< Command-phase fault byte
+
+  HistorySample() : timestamp_us(0), status(0), fault(0), setpoints(), fault_byte(0) {}
+
+  /**
+   * @brief Build a sample from a Snapshot (setpoints left at 0)
+   */
+  static HistorySample fromSnapshot(const Snapshot &snap) {
+    HistorySample s;
+    s.timestamp_us = snap.timestamp_us;
+    s.status = snap.status_raw;
+    s.fault = snap.faults.toRegister();
+    s.fault_byte = snap.fault_byte;
+    return s;
+  }
+
+  /**
+   * @brief true if every field except the timestamp matches
+   */
+  bool sameState(const HistorySample &other) const {
+    return status == other.status && fault == other.fault && fault_byte == other.fault_byte &&
+           std::memcmp(setpoints, other.setpoints, sizeof(setpoints)) == 0;
+  }
+};
+
+/**
+ * @brief A run of samples with identical state
+ */
+struct HistoryRecord {
+  HistorySample sample;  ///< State; sample.timestamp_us is the first sample's time
+  uint32_t last_us;      ///< Time of the last sample in the run
+  uint32_t samples;      ///< Samples in the run (>= 1, saturating)
+
+  HistoryRecord() : sample(), last_us(0), samples(0) {}
+};
+
+/**
+ * @brief History record header bits
+ */
+namespace HistoryFrame {
+constexpr uint8_t STATUS_BIT     = 0x01; ///< STATUS present
+constexpr uint8_t FAULT_BIT      = 0x02; ///< FAULT present
+constexpr uint8_t FAULT_BYTE_BIT = 0x04; ///< Command-phase fault byte present
+constexpr uint8_t SETPOINTS_BIT  = 0x08; ///< Channel mask + CFG_CHx words present
+constexpr uint8_t FIELDS_MASK    = 0x0F; ///< All field bits
+constexpr uint8_t KEYFRAME_BIT   = 0x80; ///< All fields present, absolute values
+
+/// Header, dt, repeats, span, STATUS, FAULT, fault byte, mask and 8 setpoints at full length
+constexpr size_t MAX_RECORD_BYTES =
+    1 + TELEMETRY_MAX_VARINT32_BYTES * 5 + 2 + 1 + TELEMETRY_MAX_VARINT32_BYTES * NUM_CHANNELS_;
+
+constexpr uint32_t rotl8(uint32_t v) { return (v << 8) | (v >> 24); }
+constexpr uint32_t rotr8(uint32_t v) { return (v >> 8) | (v << 24); }
+} // namespace HistoryFrame
+
+/**
+ * @brief Encode @p rec, as a delta against @p prev or as a keyframe if @p prev is null
+ *
+ * @param out At least HistoryFrame::MAX_RECORD_BYTES
+ * @return Bytes written
+ */
+inline size_t EncodeHistoryRecord(const HistoryRecord &rec, const HistoryRecord *prev,
+                                  uint8_t *out) {
+  const HistorySample &s = rec.sample;
+  const bool key = (prev == nullptr);
+  uint8_t header = HistoryFrame::KEYFRAME_BIT | HistoryFrame::FIELDS_MASK;
+  uint8_t setpoint_mask = 0xFF;
+  if (!key) {
+    const HistorySample &p = prev->sample;
+    header = 0;
+    setpoint_mask = 0;
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+      if (s.setpoints[ch] != p.setpoints[ch]) setpoint_mask |= static_cast<uint8_t>(1u << ch);
+    }
+    if (s.status != p.status) header |= HistoryFrame::STATUS_BIT;
+    if (s.fault != p.fault) header |= HistoryFrame::FAULT_BIT;
+    if (s.fault_byte != p.fault_byte) header |= HistoryFrame::FAULT_BYTE_BIT;
+    if (setpoint_mask != 0) header |= HistoryFrame::SETPOINTS_BIT;
+  }
+  const HistorySample zero;
+  const HistorySample &base = key ? zero : prev->sample;
+
+  size_t n = 0;
+  out[n++] = header;
+  n += EncodeVarint32(key ? s.timestamp_us : s.timestamp_us - prev->last_us, out + n);
+  const uint32_t repeats = rec.samples > 0 ? rec.samples - 1 : 0;
+  n += EncodeVarint32(repeats, out + n);
+  if (repeats > 0) n += EncodeVarint32(rec.last_us - s.timestamp_us, out + n);
+  if (header & HistoryFrame::STATUS_BIT) {
+    n += EncodeVarint32(HistoryFrame::rotl8(s.status) ^ HistoryFrame::rotl8(base.status), out + n);
+  }
+  if (header & HistoryFrame::FAULT_BIT) n += EncodeVarint32(s.fault ^ base.fault, out + n);
+  if (header & HistoryFrame::FAULT_BYTE_BIT) {
+    n += EncodeVarint32(static_cast<uint32_t>(s.fault_byte ^ base.fault_byte), out + n);
+  }
+  if (header & HistoryFrame::SETPOINTS_BIT) {
+    out[n++] = setpoint_mask;
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+      if (setpoint_mask & (1u << ch)) {
+        n += EncodeVarint32(s.setpoints[ch] ^ base.setpoints[ch], out + n);
+      }
+    }
+  }
+  return n;
+}
+
+// ============================================================================
+// Decoder
+// ============================================================================
+
+/**
+ * @brief Decoder for TelemetryHistory::Dump() streams (or raw blocks)
+ *
+ * Records before the first keyframe cannot be reconstructed; Decode() returns
+ * their length with @p valid = false.
+ */
+class HistoryDecoder {
+public:
+  HistoryDecoder() : prev_(), synced_(false) {}
+
+  /**
+   * @brief Decode one record from @p in
+   *
+   * @return Bytes consumed, or 0 if the record is truncated or malformed
+   *         (the decoder then needs a keyframe)
+   */
+  size_t Decode(const uint8_t *in, size_t len, HistoryRecord &rec, bool &valid) {
+    valid = false;
+    if (in == nullptr || len == 0) return 0;
+    const uint8_t header = in[0];
+    const bool key = (header & HistoryFrame::KEYFRAME_BIT) != 0;
+    if ((header & ~(HistoryFrame::KEYFRAME_BIT | HistoryFrame::FIELDS_MASK)) != 0 ||
+        (key && (header & HistoryFrame::FIELDS_MASK) != HistoryFrame::FIELDS_MASK)) {
+      synced_ = false;
+      return 0;
+    }
+
+    size_t n = 1;
+    bool ok = true;
+    auto next = [&](uint32_t &v) {
+      const size_t used = ok ? DecodeVarint32(in + n, len - n, v) : 0;
+      ok = used != 0;
+      n += used;
+    };
+    uint32_t dt = 0, repeats = 0, span = 0, status = 0, fault = 0, fault_byte = 0;
+    uint32_t setpoints[NUM_CHANNELS_] = {};
+    uint8_t setpoint_mask = 0;
+    next(dt);
+    next(repeats);
+    if (repeats > 0) next(span);
+    if (header & HistoryFrame::STATUS_BIT) next(status);
+    if (header & HistoryFrame::FAULT_BIT) next(fault);
+    if (header & HistoryFrame::FAULT_BYTE_BIT) next(fault_byte);
+    if (ok && (header & HistoryFrame::SETPOINTS_BIT)) {
+      if (n >= len) {
+        ok = false;
+      } else {
+        setpoint_mask = in[n++];
+        for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+          if (setpoint_mask & (1u << ch)) next(setpoints[ch]);
+        }
+      }
+    }
+    if (!ok || (key && setpoint_mask != 0xFF)) {
+      synced_ = false;
+      return 0;
+    }
+    if (!key && !synced_) return n;  // Well-formed delta, but no keyframe seen yet
+
+    HistorySample &s = prev_.sample;
+    if (key) {
+      s = HistorySample();
+      s.timestamp_us = dt;
+    } else {
+      s.timestamp_us = prev_.last_us + dt;
+    }
+    s.status = HistoryFrame::rotr8(HistoryFrame::rotl8(s.status) ^ status);
+    s.fault ^= fault;
+    s.fault_byte = static_cast<uint8_t>(s.fault_byte ^ fault_byte);
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) s.setpoints[ch] ^= setpoints[ch];
+    prev_.samples = repeats == UINT32_MAX ? UINT32_MAX : repeats + 1;
+    prev_.last_us = s.timestamp_us + span;
+    synced_ = true;
+    rec = prev_;
+    valid = true;
+    return n;
+  }
+
+  /**
+   * @brief Decode a whole stream, calling fn(const HistoryRecord&) per record
+   *
+   * @return Records delivered; stops at the first malformed record
+   */
+  template <typename F>
+  static size_t DecodeAll(const uint8_t *in, size_t len, F &&fn) {
+    HistoryDecoder dec;
+    size_t pos = 0, count = 0;
+    while (pos < len) {
+      HistoryRecord rec;
+      bool valid = false;
+      const size_t used = dec.Decode(in + pos, len - pos, rec, valid);
+      if (used == 0) break;
+      pos += used;
+      if (valid) {
+        fn(rec);
+        count++;
+      }
+    }
+    return count;
+  }
+
+private:
+  HistoryRecord prev_;
+  bool synced_;
+};
+
+// ============================================================================
+// History ring
+// ============================================================================
+
+/**
+ * @brief Fixed-size compressed history ring
+ *
+ * @tparam BlockBytes Bytes per block (each block starts with a keyframe)
+ * @tparam Blocks     Number of blocks; memory is about BlockBytes x Blocks
+ *
+ * No I/O and no clock: samples carry the caller's timestamps. Not
+ * thread-safe; record and dump from the same task (or hold a lock).
+ */
+template <size_t BlockBytes = 256, size_t Blocks = 16>
+class TelemetryHistory {
+  static_assert(BlockBytes >= 2 * HistoryFrame::MAX_RECORD_BYTES && BlockBytes <= 0xFFFF,
+                "BlockBytes must hold at least two full records");
+  static_assert(Blocks >= 2, "TelemetryHistory needs at least two blocks");
+
+public:
+  /// Dump() output never exceeds this
+  static constexpr size_t MAX_DUMP_BYTES = BlockBytes * Blocks + HistoryFrame::MAX_RECORD_BYTES;
+
+  TelemetryHistory() { Reset(); }
+
+  /**
+   * @brief Add one sample
+   */
+  void Record(const HistorySample &sample) {
+    if (open_.samples > 0 && sample.sameState(open_.sample)) {
+      open_.last_us = sample.timestamp_us;
+      if (open_.samples != UINT32_MAX) open_.samples++;
+      return;
+    }
+    if (open_.samples > 0) commit(open_);
+    open_.sample = sample;
+    open_.last_us = sample.timestamp_us;
+    open_.samples = 1;
+  }
+
+  /**
+   * @brief Add a snapshot, with setpoints from the driver's CFG shadow (no SPI traffic)
+   *
+   * Channels whose CFG register has not been read or written since
+   * Initialize() record 0.
+   */
+  template <typename Driver>
+  void Record(const Snapshot &snap, const Driver &driver) {
+    HistorySample s = HistorySample::fromSnapshot(snap);
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+      uint32_t raw = 0;
+      if (driver.GetCachedChannelRegister(ch, raw) == DriverStatus::OK) s.setpoints[ch] = raw;
+    }
+    Record(s);
+  }
+
+  /**
+   * @brief Copy the history into @p out, oldest first, for HistoryDecoder
+   *
+   * If @p cap is smaller than GetDumpBytes(), the oldest blocks are left out.
+   *
+   * @return Bytes written (0 if @p cap cannot hold even the open run)
+   */
+  size_t Dump(uint8_t *out, size_t cap) const {
+    if (out == nullptr) return 0;
+    uint8_t tail[HistoryFrame::MAX_RECORD_BYTES];
+    size_t tail_len = 0;
+    size_t first = 0;  // oldest block index (age order) included
+    size_t body = usedBytes(0);
+    if (open_.samples > 0) tail_len = EncodeHistoryRecord(open_, have_last_ ? &last_ : nullptr, tail);
+    while (first < count_ && body + tail_len > cap) {
+      body -= used_[slot(first)];
+      first++;
+    }
+    if (first == count_ && open_.samples > 0) {
+      tail_len = EncodeHistoryRecord(open_, nullptr, tail);  // no block left to delta against
+    }
+    if (body + tail_len > cap) return 0;
+
+    size_t n = 0;
+    for (size_t i = first; i < count_; ++i) {
+      std::memcpy(out + n, blocks_[slot(i)], used_[slot(i)]);
+      n += used_[slot(i)];
+    }
+    std::memcpy(out + n, tail, tail_len);
+    return n + tail_len;
+  }
+
+  /**
+   * @brief Call fn(const HistoryRecord&) for every record, oldest first (open run last)
+   *
+   * @return Records visited
+   */
+  template <typename F>
+  size_t ForEach(F &&fn) const {
+    HistoryDecoder dec;
+    size_t count = 0;
+    for (size_t i = 0; i < count_; ++i) {
+      const uint8_t *b = blocks_[slot(i)];
+      const size_t len = used_[slot(i)];
+      for (size_t pos = 0; pos < len;) {
+        HistoryRecord rec;
+        bool valid = false;
+        const size_t used = dec.Decode(b + pos, len - pos, rec, valid);
+        if (used == 0) break;
+        pos += used;
+        if (valid) {
+          fn(rec);
+          count++;
+        }
+      }
+    }
+    if (open_.samples > 0) {
+      fn(open_);
+      count++;
+    }
+    return count;
+  }
+
+  /**
+   * @brief Drop all history
+   */
+  void Reset() {
+    head_ = 0;
+    count_ = 0;
+    have_last_ = false;
+    open_ = HistoryRecord();
+    last_ = HistoryRecord();
+    for (size_t i = 0; i < Blocks; ++i) {
+      used_[i] = 0;
+      block_start_us_[i] = 0;
+    }
+  }
+
+  /**
+   * @brief Time covered, from the oldest kept sample to the newest (µs)
+   *
+   * Summed block by block, so it may exceed the 32-bit µs clock range.
+   */
+  uint64_t GetSpanUs() const {
+    if (open_.samples == 0) return 0;
+    uint32_t t = count_ > 0 ? block_start_us_[slot(0)] : open_.sample.timestamp_us;
+    uint64_t span = 0;
+    for (size_t i = 1; i < count_; ++i) {
+      span += block_start_us_[slot(i)] - t;
+      t = block_start_us_[slot(i)];
+    }
+    return span + (open_.last_us - t);
+  }
+
+  /**
+   * @brief Bytes a full Dump() produces right now
+   */
+  size_t GetDumpBytes() const {
+    uint8_t tail[HistoryFrame::MAX_RECORD_BYTES];
+    const size_t tail_len =
+        open_.samples > 0 ? EncodeHistoryRecord(open_, have_last_ ? &last_ : nullptr, tail) : 0;
+    return usedBytes(0) + tail_len;
+  }
+
+  /**
+   * @brief Number of blocks holding records
+   */
+  size_t GetBlockCount() const { return count_; }
+
+private:
+  /// Storage index of the block @p age positions after the oldest
+  size_t slot(size_t age) const { return (head_ + Blocks - count_ + age) % Blocks; }
+
+  size_t usedBytes(size_t from_age) const {
+    size_t n = 0;
+    for (size_t i = from_age; i < count_; ++i) n += used_[slot(i)];
+    return n;
+  }
+
+  /// Append a finished run; starts a new block (keyframe) when the current one is full
+  void commit(const HistoryRecord &rec) {
+    uint8_t buf[HistoryFrame::MAX_RECORD_BYTES];
+    size_t len = 0;
+    if (count_ > 0 && have_last_) {
+      len = EncodeHistoryRecord(rec, &last_, buf);
+      const size_t cur = slot(count_ - 1);
+      if (used_[cur] + len <= BlockBytes) {
+        std::memcpy(blocks_[cur] + used_[cur], buf, len);
+        used_[cur] = static_cast<uint16_t>(used_[cur] + len);
+        last_ = rec;
+        return;
+      }
+    }
+    // New block: reuse the oldest when the ring is full
+    const size_t b = head_;
+    head_ = (head_ + 1) % Blocks;
+    if (count_ < Blocks) count_++;
+    len = EncodeHistoryRecord(rec, nullptr, buf);
+    std::memcpy(blocks_[b], buf, len);
+    used_[b] = static_cast<uint16_t>(len);
+    block_start_us_[b] = rec.sample.timestamp_us;
+    last_ = rec;
+    have_last_ = true;
+  }
+
+  uint8_t blocks_[Blocks][BlockBytes];
+  uint16_t used_[Blocks];
+  uint32_t block_start_us_[Blocks];
+  size_t head_;   ///< Next block to open
+  size_t count_;  ///< Blocks in use
+  HistoryRecord open_;  ///< Current run (samples == 0: none)
+  HistoryRecord last_;  ///< Last committed record (delta base)
+  bool have_last_;
+};
+
+} // namespace max22200
@@ -0,0 +1,455 @@
+/**
+ * @file max22200_metrics.hpp
+ * @brief Time-windowed, mergeable MAX22200 driver metrics
+ *
+ * DriverStatistics is a single cumulative counter set. A MetricsWindow holds
+ * the counts for one span of time instead:
+ *
+ * | Field             | Source                                             |
+ * |-------------------|----------------------------------------------------|
+ * | operations/errors | DriverStatistics total/failed deltas               |
+ * | frames            | Command Register frames (GetFaultByteSequence())   |
+ * | channel_faults    | FAULT flags seen, per FaultType (OCP..DPM), channel |
+ * | device_faults     | STATUS OVT / UVM / COMER flags seen                |
+ * | on_time_ms        | Per-channel time with ONCH set                     |
+ * | latency_hist      | RecordLatencyUs() samples, log2 µs buckets         |
+ *
+ * DriverMetrics keeps a ring of per-minute windows and a ring of per-hour
+ * windows (each hour is the merge of its minutes).
+ *
+ * Every field is a plain sum, so Merge() is element-wise addition (saturating)
+ * and is associative and commutative: a gateway can merge windows from
+ * thousands of devices, or roll minutes into hours, in any order. Serialize()
+ * writes a presence bitmap followed by LEB128 varints of the non-zero fields,
+ * so a quiet window costs about a dozen bytes.
+ *
+ * Like PollScheduler, DriverMetrics does no I/O and keeps no clock: the caller
+ * passes a µs time (wrap at 2^32 is handled as long as Update() is called at
+ * least every 71 minutes). Window start times are ms since the first Update()
+ * and wrap after 49.7 days; a gateway normally stamps windows on receipt.
+ *
+ * @code
+ * DriverMetrics<> metrics;  // 60 minutes + 24 hours, ~22 KB
+ * for (;;) {
+ *   const uint32_t t0 = static_cast<uint32_t>(esp_timer_get_time());
+ *   driver.ReadSnapshot(snap);
+ *   metrics.RecordLatencyUs(static_cast<uint32_t>(esp_timer_get_time()) - t0);
+ *   metrics.RecordSnapshot(snap);
+ *   if (metrics.Update(t0, driver)) {
+ *     uint8_t buf[MetricsWindow::MAX_SERIALIZED_BYTES];
+ *     size_t n = metrics.Minute(0)->Serialize(buf, sizeof(buf));  // send upstream
+ *   }
+ * }
+ * @endcode
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include "max22200_registers.hpp"
+#include "max22200_types.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace max22200 {
+
+/// Per-channel FAULT types counted by MetricsWindow (FaultType::OCP..DPM)
+constexpr uint8_t METRICS_CHANNEL_FAULT_TYPES = 4;
+/// STATUS-level fault types counted by MetricsWindow (FaultType::OVT..COMER)
+constexpr uint8_t METRICS_DEVICE_FAULT_TYPES = 3;
+/// Latency buckets: bucket 0 is < 2 µs, bucket b is [2^b, 2^(b+1)) µs, last is open-ended
+constexpr uint8_t METRICS_LATENCY_BUCKETS = 16;
+
+/**
+ * @brief Counts for one span of time (one device, or merged across devices)
+ */
+struct MetricsWindow {
+  uint32_t start_ms;    ///< Window start (ms since the first DriverMetrics::Update())
+  uint32_t span_ms;     ///< Time covered (0 = empty window)
+  uint32_t operations;  ///< Driver operations (DriverStatistics::total_transfers)
+  uint32_t errors;      ///< Failed driver operations
+  uint32_t frames;      ///< Command Register frames (one per register access)
+  uint32_t channel_faults[METRICS_CHANNEL_FAULT_TYPES][NUM_CHANNELS_];  ///< [FaultType][channel]
+  uint32_t device_faults[METRICS_DEVICE_FAULT_TYPES];  ///< [FaultType - OVT]
+  uint32_t on_time_ms[NUM_CHANNELS_];                  ///< Per-channel ONCH time
+  uint32_t latency_hist[METRICS_LATENCY_BUCKETS];      ///< Latency samples per log2 µs bucket
+
+  /// Number of uint32 fields visited by Serialize()
+  static constexpr size_t FIELD_COUNT = 5 + METRICS_CHANNEL_FAULT_TYPES * NUM_CHANNELS_ +
+                                        METRICS_DEVICE_FAULT_TYPES + NUM_CHANNELS_ +
+                                        METRICS_LATENCY_BUCKETS;
+  /// Format version byte written first by Serialize()
+  static constexpr uint8_t FORMAT_VERSION = 1;
+  /// Worst-case Serialize() size: version, presence bitmap, 5-byte varints
+  static constexpr size_t MAX_SERIALIZED_BYTES = 1 + (FIELD_COUNT + 7) / 8 + FIELD_COUNT * 5;
+
+  MetricsWindow()
+      : start_ms(0), span_ms(0), operations(0), errors(0), frames(0), channel_faults{},
+        device_faults{}, on_time_ms{}, latency_hist{} {}
+
+  bool isEmpty() const { return span_ms == 0; }
+
+  /**
+   * @brief Count of one fault type (FaultType::OCP..COMER); channel ignored for STATUS types
+   */
+  uint32_t faultCount(FaultType type, uint8_t channel) const {
+    const uint8_t t = static_cast<uint8_t>(type);
+    if (t < METRICS_CHANNEL_FAULT_TYPES) {
+      return channel < NUM_CHANNELS_ ? channel_faults[t][channel] : 0;
+    }
+    return t - METRICS_CHANNEL_FAULT_TYPES < METRICS_DEVICE_FAULT_TYPES
+               ? device_faults[t - METRICS_CHANNEL_FAULT_TYPES]
+               : 0;
+  }
+
+  /**
+   * @brief Total faults of all types on one channel
+   */
+  uint32_t channelFaultCount(uint8_t channel) const {
+    uint32_t n = 0;
+    for (uint8_t t = 0; t < METRICS_CHANNEL_FAULT_TYPES; ++t) {
+      n = addSat(n, faultCount(static_cast<FaultType>(t), channel));
+    }
+    return n;
+  }
+
+  /**
+   * @brief Latency below which @p percent of the samples fall (upper bucket bound, µs)
+   *
+   * Returns 0 with no samples and UINT32_MAX if the percentile lands in the
+   * open-ended last bucket.
+   */
+  uint32_t latencyPercentileUs(uint8_t percent) const {
+    uint64_t total = 0;
+    for (uint32_t v : latency_hist) total += v;
+    if (total == 0) return 0;
+    const uint64_t target = (total * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (uint8_t b = 0; b < METRICS_LATENCY_BUCKETS; ++b) {
+      seen += latency_hist[b];
+      if (seen >= target) {
+        return b + 1u < METRICS_LATENCY_BUCKETS ? (2u << b) : UINT32_MAX;
+      }
+    }
+    return UINT32_MAX;
+  }
+
+  /**
+   * @brief Histogram bucket of a latency sample
+   */
+  static uint8_t latencyBucket(uint32_t us) {
+    uint8_t b = 0;
+    while (us >= 2u && b + 1u < METRICS_LATENCY_BUCKETS) {
+      us >>= 1;
+      b++;
+    }
+    return b;
+  }
+
+  /**
+   * @brief Add @p other into this window
+   *
+   * Counters add (saturating at UINT32_MAX); the time span becomes the union
+   * of both spans. Merging an empty window is a no-op.
+   */
+  void Merge(const MetricsWindow &other) {
+    if (other.isEmpty()) return;
+    if (isEmpty()) {
+      *this = other;
+      return;
+    }
+    const uint32_t end = maxEnd(*this, other);
+    start_ms = start_ms < other.start_ms ? start_ms : other.start_ms;
+    span_ms = end - start_ms;
+    operations = addSat(operations, other.operations);
+    errors = addSat(errors, other.errors);
+    frames = addSat(frames, other.frames);
+    for (uint8_t t = 0; t < METRICS_CHANNEL_FAULT_TYPES; ++t) {
+      for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+        channel_faults[t][ch] = addSat(channel_faults[t][ch], other.channel_faults[t][ch]);
+      }
+    }
+    for (uint8_t t = 0; t < METRICS_DEVICE_FAULT_TYPES; ++t) {
+      device_faults[t] = addSat(device_faults[t], other.device_faults[t]);
+    }
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+      on_time_ms[ch] = addSat(on_time_ms[ch], other.on_time_ms[ch]);
+    }
+    for (uint8_t b = 0; b < METRICS_LATENCY_BUCKETS; ++b) {
+      latency_hist[b] = addSat(latency_hist[b], other.latency_hist[b]);
+    }
+  }
+
+  /**
+   * @brief Write the window to @p buf
+   *
+   * Layout: FORMAT_VERSION, presence bitmap (bit i = field i non-zero, LSB
+   * first), then one unsigned LEB128 varint per non-zero field in field order
+   * (start_ms, span_ms, operations, errors, frames, channel_faults row-major,
+   * device_faults, on_time_ms, latency_hist).
+   *
+   * @return Bytes written, or 0 if @p capacity is too small
+   */
+  size_t Serialize(uint8_t *buf, size_t capacity) const {
+    const size_t bitmap_bytes = (FIELD_COUNT + 7) / 8;
+    if (capacity < 1 + bitmap_bytes) return 0;
+    buf[0] = FORMAT_VERSION;
+    uint8_t *bitmap = buf + 1;
+    for (size_t i = 0; i < bitmap_bytes; ++i) bitmap[i] = 0;
+    size_t pos = 1 + bitmap_bytes;
+    size_t index = 0;
+    bool ok = true;
+    visitFields(*this, [&](uint32_t v) {
+      if (v != 0 && ok) {
+        bitmap[index / 8] |= static_cast<uint8_t>(1u << (index % 8));
+        do {
+          if (pos >= capacity) {
+            ok = false;
+            return;
+          }
+          const uint8_t low = static_cast<uint8_t>(v & 0x7Fu);
+          v >>= 7;
+          buf[pos++] = static_cast<uint8_t>(v != 0 ? (low | 0x80u) : low);
+        } while (v != 0);
+      }
+      index++;
+    });
+    return ok ? pos : 0;
+  }
+
+  /**
+   * @brief Read a window written by Serialize()
+   *
+   * @return Bytes consumed, or 0 if the data is truncated, malformed or of
+   *         another format version (@p out is then unspecified)
+   */
+  size_t Deserialize(const uint8_t *buf, size_t len) {
+    const size_t bitmap_bytes = (FIELD_COUNT + 7) / 8;
+    if (len < 1 + bitmap_bytes || buf[0] != FORMAT_VERSION) return 0;
+    const uint8_t *bitmap = buf + 1;
+    size_t pos = 1 + bitmap_bytes;
+    size_t index = 0;
+    bool ok = true;
+    visitFields(*this, [&](uint32_t &v) {
+      v = 0;
+      if (ok && (bitmap[index / 8] & (1u << (index % 8))) != 0) {
+        for (uint8_t shift = 0;; shift = static_cast<uint8_t>(shift + 7)) {
+          if (pos >= len || shift > 28) {
+            ok = false;
+            return;
+          }
+          const uint8_t byte = buf[pos++];
+          v |= static_cast<uint32_t>(byte & 0x7Fu) << shift;
+          if ((byte & 0x80u) == 0) break;
+        }
+      }
+      index++;
+    });
+    return ok ? pos : 0;
+  }
+
+private:
+  static uint32_t addSat(uint32_t a, uint32_t b) {
+    const uint32_t s = a + b;
+    return s < a ? UINT32_MAX : s;
+  }
+
+  static uint32_t maxEnd(const MetricsWindow &a, const MetricsWindow &b) {
+    const uint32_t ea = a.start_ms + a.span_ms;
+    const uint32_t eb = b.start_ms + b.span_ms;
+    return ea > eb ? ea : eb;
+  }
+
+  /// Visit every uint32 field in serialization order
+  template <typename Window, typename F>
+  static void visitFields(Window &w, F &&f) {
+    f(w.start_ms);
+    f(w.span_ms);
+    f(w.operations);
+    f(w.errors);
+    f(w.frames);
+    for (auto &row : w.channel_faults) {
+      for (auto &v : row) f(v);
+    }
+    for (auto &v : w.device_faults) f(v);
+    for (auto &v : w.on_time_ms) f(v);
+    for (auto &v : w.latency_hist) f(v);
+  }
+};
+
+/**
+ * @class DriverMetrics
+ * @brief Per-minute and per-hour MetricsWindow rings fed from a MAX22200 driver
+ *
+ * @tparam MinuteSlots Completed minutes kept (Minute(0..MinuteSlots-1))
+ * @tparam HourSlots   Completed hours kept (Hour(0..HourSlots-1))
+ */
+template <size_t MinuteSlots = 60, size_t HourSlots = 24>
+class DriverMetrics {
+public:
+  static constexpr uint32_t MINUTE_MS = 60000;
+  static constexpr uint32_t HOUR_MS = 3600000;
+
+  DriverMetrics()
+      : minute_(), hour_(), minutes_{}, hours_{}, minute_count_(0), hour_count_(0),
+        minute_head_(0), hour_head_(0), minute_in_hour_(0), now_ms_(0), last_us_(0), rem_us_(0), last_ops_(0),
+        last_errors_(0), last_frames_(0), onch_(0), started_(false) {}
+
+  /**
+   * @brief Account driver activity up to @p now_us and roll completed windows
+   *
+   * Counter deltas since the previous Update() go into the current minute;
+   * on-time is split exactly across minute boundaries.
+   *
+   * @param now_us     Caller's µs clock
+   * @param stats      GetStatistics()
+   * @param fault_seq  GetFaultByteSequence()
+   * @param onch       GetChannelsOnMask() (applies from now on)
+   * @return true if at least one minute completed (Minute(0) is new)
+   */
+  bool Update(uint32_t now_us, const DriverStatistics &stats, uint32_t fault_seq, uint8_t onch) {
+    if (!started_) {
+      started_ = true;
+      last_us_ = now_us;
+      last_ops_ = stats.total_transfers;
+      last_errors_ = stats.failed_transfers;
+      last_frames_ = fault_seq;
+      onch_ = onch;
+      minute_.span_ms = 0;
+      return false;
+    }
+    // A ResetStatistics() in between restarts the driver counters from zero
+    const bool reset = stats.total_transfers < last_ops_ || stats.failed_transfers < last_errors_;
+    minute_.operations += stats.total_transfers - (reset ? 0 : last_ops_);
+    minute_.errors += stats.failed_transfers - (reset ? 0 : last_errors_);
+    minute_.frames += fault_seq - last_frames_;
+    last_ops_ = stats.total_transfers;
+    last_errors_ = stats.failed_transfers;
+    last_frames_ = fault_seq;
+
+    const uint32_t elapsed_us = (now_us - last_us_) + rem_us_;
+    last_us_ = now_us;
+    rem_us_ = elapsed_us % 1000u;
+    uint32_t elapsed_ms = elapsed_us / 1000u;
+
+    bool rolled = false;
+    while (elapsed_ms > 0) {
+      const uint32_t minute_end = minute_.start_ms + MINUTE_MS;
+      const uint32_t step = minute_end - now_ms_ < elapsed_ms ? minute_end - now_ms_ : elapsed_ms;
+      addOnTime(step);
+      now_ms_ += step;
+      elapsed_ms -= step;
+      minute_.span_ms = now_ms_ - minute_.start_ms;
+      if (now_ms_ == minute_end) {
+        rollMinute();
+        rolled = true;
+      }
+    }
+    onch_ = onch;
+    return rolled;
+  }
+
+  /**
+   * @brief Update() with inputs gathered from a MAX22200 driver (no SPI traffic)
+   */
+  template <typename Driver>
+  bool Update(uint32_t now_us, const Driver &driver) {
+    return Update(now_us, driver.GetStatistics(), driver.GetFaultByteSequence(),
+                  driver.GetChannelsOnMask());
+  }
+
+  /**
+   * @brief Count the fault flags reported by a STATUS / FAULT read
+   *
+   * Flags are latched by the device and cleared by the read, so each flag
+   * seen is one event.
+   */
+  void RecordFaults(const StatusConfig &status, const FaultStatus &faults) {
+    const uint8_t masks[METRICS_CHANNEL_FAULT_TYPES] = {
+        faults.overcurrent_channel_mask, faults.hit_not_reached_channel_mask,
+        faults.open_load_fault_channel_mask, faults.plunger_movement_fault_channel_mask};
+    for (uint8_t t = 0; t < METRICS_CHANNEL_FAULT_TYPES; ++t) {
+      for (uint8_t m = masks[t], ch = 0; m != 0; m = static_cast<uint8_t>(m >> 1), ++ch) {
+        if ((m & 1u) != 0) minute_.channel_faults[t][ch]++;
+      }
+    }
+    if (status.overtemperature) minute_.device_faults[0]++;
+    if (status.undervoltage) minute_.device_faults[1]++;
+    if (status.communication_error) minute_.device_faults[2]++;
+  }
+
+  /** @brief RecordFaults() for a ReadSnapshot() result */
+  void RecordSnapshot(const Snapshot &snap) { RecordFaults(snap.status, snap.faults); }
+
+  /** @brief Add one latency sample (µs) to the current minute's histogram */
+  void RecordLatencyUs(uint32_t us) { minute_.latency_hist[MetricsWindow::latencyBucket(us)]++; }
+
+  /** @brief Minute in progress */
+  const MetricsWindow &CurrentMinute() const { return minute_; }
+
+  /** @brief Hour in progress (completed minutes of this hour, merged) */
+  const MetricsWindow &CurrentHour() const { return hour_; }
+
+  /** @brief Completed minute, 0 = most recent; nullptr if not available */
+  const MetricsWindow *Minute(size_t age) const {
+    return age < minute_count_ ? &minutes_[(minute_head_ + MinuteSlots - 1 - age) % MinuteSlots]
+                               : nullptr;
+  }
+
+  /** @brief Completed hour, 0 = most recent; nullptr if not available */
+  const MetricsWindow *Hour(size_t age) const {
+    return age < hour_count_ ? &hours_[(hour_head_ + HourSlots - 1 - age) % HourSlots] : nullptr;
+  }
+
+  size_t GetMinuteCount() const { return minute_count_; }
+  size_t GetHourCount() const { return hour_count_; }
+
+  /** @brief ms accounted since the first Update() */
+  uint32_t GetElapsedMs() const { return now_ms_; }
+
+  /** @brief Forget all windows; the next Update() starts over */
+  void Reset() { *this = DriverMetrics(); }
+
+private:
+  void addOnTime(uint32_t ms) {
+    for (uint8_t m = onch_, ch = 0; m != 0; m = static_cast<uint8_t>(m >> 1), ++ch) {
+      if ((m & 1u) != 0) minute_.on_time_ms[ch] += ms;
+    }
+  }
+
+  void rollMinute() {
+    minutes_[minute_head_] = minute_;
+    minute_head_ = (minute_head_ + 1) % MinuteSlots;
+    if (minute_count_ < MinuteSlots) minute_count_++;
+    hour_.Merge(minute_);
+
+    if (++minute_in_hour_ == HOUR_MS / MINUTE_MS) {
+      minute_in_hour_ = 0;
+      hours_[hour_head_] = hour_;
+      hour_head_ = (hour_head_ + 1) % HourSlots;
+      if (hour_count_ < HourSlots) hour_count_++;
+      hour_ = MetricsWindow();
+    }
+    minute_ = MetricsWindow();
+    minute_.start_ms = now_ms_;
+  }
+
+  MetricsWindow minute_;
+  MetricsWindow hour_;
+  MetricsWindow minutes_[MinuteSlots];
+  MetricsWindow hours_[HourSlots];
+  size_t minute_count_;
+  size_t hour_count_;
+  size_t minute_head_;
+  size_t hour_head_;
+  uint32_t minute_in_hour_;
+  uint32_t now_ms_;
+  uint32_t last_us_;
+  uint32_t rem_us_;
+  uint32_t last_ops_;
+  uint32_t last_errors_;
+  uint32_t last_frames_;
+  uint8_t onch_;
+  bool started_;
+};
+
+} // namespace max22200
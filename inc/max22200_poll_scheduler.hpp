@@ -0,0 +1,256 @@
+/**
+ * @file max22200_poll_scheduler.hpp
+ * @brief Activity-driven STATUS/FAULT poll scheduling for MAX22200 telemetry
+ *
+ * A fixed-period telemetry loop spends most of its SPI traffic confirming
+ * that nothing happened. PollScheduler decides, at each wake-up of such a
+ * loop, whether a full STATUS + FAULT poll is needed:
+ *
+ * | After the poll                             | Next poll in                |
+ * |--------------------------------------------|-----------------------------|
+ * | Reported a fault                           | `fault_period_us`           |
+ * | Saw a new ONCH                             | `edge_period_us`            |
+ * | Nothing new, channels on                   | twice the last period, up   |
+ * |                                            | to `active_period_us`       |
+ * | Nothing new, all channels off              | twice the last period, up   |
+ * |                                            | to `idle_period_us`         |
+ *
+ * So the rate jumps up around switching and faults, where HIT-phase faults
+ * (HHF, DPM) and follow-on faults happen, and decays back to a heartbeat.
+ *
+ * Faults do not wait for the schedule. A poll is due immediately when:
+ *   - nFAULT becomes asserted (GPIO read, no SPI), or
+ *   - a fault byte returned by other traffic (every Command Register write
+ *     returns STATUS[7:0], see GetLastFaultByte()) shows a flag the last poll
+ *     did not see.
+ *
+ * Conversely, when other traffic has produced a fresh fault byte since the
+ * last poll, that byte equals the one the last poll saw and no flag is set,
+ * FAULT is known to be clear and ONCH is known from the host's own writes, so
+ * a due poll is skipped. `max_consecutive_skips` bounds how many real polls in
+ * a row can be replaced this way.
+ *
+ * The scheduler does no I/O and keeps no clock: the caller passes a µs time
+ * (wrap at 2^32 is handled). Check() / OnPolled() overloads taking the driver
+ * gather the inputs from it (all without SPI traffic).
+ *
+ * @code
+ * PollScheduler sched;
+ * for (;;) {
+ *   const uint32_t now = static_cast<uint32_t>(esp_timer_get_time());
+ *   if (sched.Check(now, driver) == PollAction::POLL) {
+ *     driver.ReadSnapshot(snap);
+ *     sched.OnPolled(now, driver, snap.status, snap.faults);
+ *   }
+ *   // Wake at least every 10 ms so nFAULT / traffic are noticed promptly
+ *   vTaskDelay(pdMS_TO_TICKS(std::min<uint32_t>(sched.GetDelayUs(now), 10000) / 1000));
+ * }
+ * @endcode
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include "max22200_registers.hpp"
+#include "max22200_types.hpp"
+#include <cstdint>
+
+namespace max22200 {
+
+/**
+ * @brief STATUS[7:0] bits that indicate a fault (everything except ACTIVE)
+ */
+constexpr uint8_t POLL_FAULT_FLAGS_MASK =
+    static_cast<uint8_t>(StatusReg::OVT_BIT | StatusReg::OCP_BIT | StatusReg::OLF_BIT |
+                         StatusReg::HHF_BIT | StatusReg::DPM_BIT | StatusReg::COMER_BIT |
+                         StatusReg::UVM_BIT);
+
+/**
+ * @brief Decision returned by PollScheduler::Check()
+ */
+enum class PollAction : uint8_t {
+  WAIT, ///< Not due yet
+  SKIP, ///< Due, but recent traffic proved nothing changed (rescheduled)
+  POLL  ///< Read STATUS / FAULT now, then call OnPolled()
+};
+
+/**
+ * @brief Poll periods for PollScheduler
+ */
+struct PollSchedulerConfig {
+  uint32_t edge_period_us;        ///< Period right after an ONCH change
+  uint32_t active_period_us;      ///< Ceiling while any channel is on
+  uint32_t idle_period_us;        ///< Ceiling (heartbeat) while all channels are off
+  uint32_t fault_period_us;       ///< Period right after a poll that reported a fault
+  uint8_t max_consecutive_skips;  ///< Force a real poll after this many skips
+
+  PollSchedulerConfig()
+      : edge_period_us(20000), active_period_us(200000), idle_period_us(1000000),
+        fault_period_us(20000), max_consecutive_skips(8) {}
+};
+
+/**
+ * @brief Counters kept by PollScheduler
+ */
+struct PollSchedulerStats {
+  uint32_t polls;        ///< POLL decisions
+  uint32_t skips;        ///< Due polls replaced by a fresh, clean fault byte
+  uint32_t early_polls;  ///< Polls pulled in by nFAULT or a new fault flag in traffic
+
+  PollSchedulerStats() : polls(0), skips(0), early_polls(0) {}
+};
+
+/**
+ * @class PollScheduler
+ * @brief Decides when a telemetry loop needs to read STATUS / FAULT
+ */
+class PollScheduler {
+public:
+  explicit PollScheduler(const PollSchedulerConfig &config = PollSchedulerConfig())
+      : config_(config), stats_(), next_due_us_(0), last_poll_us_(0),
+        period_us_(config.edge_period_us), polled_seq_(0), polled_byte_(0), polled_onch_(0),
+        skips_(0), polled_fault_pin_(false), started_(false) {}
+
+  /**
+   * @brief Decide whether to poll at @p now_us
+   *
+   * @param now_us      Caller's µs clock
+   * @param onch        Channels currently on (host's view, GetChannelsOnMask())
+   * @param fault_seq   GetFaultByteSequence()
+   * @param fault_byte  GetLastFaultByte()
+   * @param fault_pin   nFAULT asserted (GetFaultPinState())
+   */
+  PollAction Check(uint32_t now_us, uint8_t onch, uint32_t fault_seq, uint8_t fault_byte,
+                   bool fault_pin) {
+    if (!started_) {
+      return poll();
+    }
+    const bool fresh = fault_seq != polled_seq_;
+    const bool flags = (fault_byte & POLL_FAULT_FLAGS_MASK) != 0;
+
+    // New fault evidence: don't wait for the schedule
+    if ((fault_pin && !polled_fault_pin_) || (fresh && flags && fault_byte != polled_byte_)) {
+      stats_.early_polls++;
+      return poll();
+    }
+
+    // Channels switched since the last poll: pull the next poll in to the burst rate
+    if (onch != polled_onch_ && period_us_ > config_.edge_period_us) {
+      period_us_ = config_.edge_period_us;
+      if (isAfter(next_due_us_, last_poll_us_ + period_us_)) {
+        next_due_us_ = last_poll_us_ + period_us_;
+      }
+    }
+    if (isAfter(next_due_us_, now_us)) {
+      return PollAction::WAIT;
+    }
+
+    if (fresh && !flags && !fault_pin && fault_byte == polled_byte_ && onch == polled_onch_ &&
+        skips_ < config_.max_consecutive_skips) {
+      skips_++;
+      stats_.skips++;
+      polled_seq_ = fault_seq;
+      reschedule(now_us, onch);
+      return PollAction::SKIP;
+    }
+    return poll();
+  }
+
+  /**
+   * @brief Check() with inputs gathered from a MAX22200 driver (no SPI traffic)
+   */
+  template <typename Driver>
+  PollAction Check(uint32_t now_us, const Driver &driver) {
+    bool fault_pin = false;
+    (void)driver.GetFaultPinState(fault_pin);
+    return Check(now_us, driver.GetChannelsOnMask(), driver.GetFaultByteSequence(),
+                 driver.GetLastFaultByte(), fault_pin);
+  }
+
+  /**
+   * @brief Record the result of a POLL
+   *
+   * @param now_us      Time of the poll
+   * @param fault_seq   GetFaultByteSequence() after the poll
+   * @param fault_byte  GetLastFaultByte() after the poll
+   * @param fault_seen  true if STATUS or FAULT reported any fault
+   * @param onch        ONCH read by the poll
+   * @param fault_pin   nFAULT state after the poll
+   */
+  void OnPolled(uint32_t now_us, uint32_t fault_seq, uint8_t fault_byte, bool fault_seen,
+                uint8_t onch, bool fault_pin) {
+    started_ = true;
+    skips_ = 0;
+    polled_seq_ = fault_seq;
+    polled_byte_ = fault_byte;
+    polled_fault_pin_ = fault_pin;
+    const bool edge = onch != polled_onch_;
+    polled_onch_ = onch;
+    if (fault_seen) {
+      period_us_ = config_.fault_period_us;
+    } else if (edge) {
+      period_us_ = config_.edge_period_us;
+    } else {
+      reschedule(now_us, onch);
+      return;
+    }
+    last_poll_us_ = now_us;
+    next_due_us_ = now_us + period_us_;
+  }
+
+  /**
+   * @brief OnPolled() with the STATUS / FAULT just read through @p driver
+   */
+  template <typename Driver>
+  void OnPolled(uint32_t now_us, const Driver &driver, const StatusConfig &status,
+                const FaultStatus &faults) {
+    bool fault_pin = false;
+    (void)driver.GetFaultPinState(fault_pin);
+    OnPolled(now_us, driver.GetFaultByteSequence(), driver.GetLastFaultByte(),
+             status.hasFault() || faults.hasFault(), status.channels_on_mask, fault_pin);
+  }
+
+  /** @brief µs until the next poll is due (0 if due now) */
+  uint32_t GetDelayUs(uint32_t now_us) const {
+    return isAfter(next_due_us_, now_us) ? next_due_us_ - now_us : 0;
+  }
+
+  /** @brief Current poll period */
+  uint32_t GetPeriodUs() const { return period_us_; }
+
+  const PollSchedulerStats &GetStats() const { return stats_; }
+  const PollSchedulerConfig &GetConfig() const { return config_; }
+
+  /** @brief Forget history; the next Check() polls */
+  void Reset() { *this = PollScheduler(config_); }
+
+private:
+  /// true if @p a is strictly later than @p b on a wrapping µs clock
+  static bool isAfter(uint32_t a, uint32_t b) { return static_cast<int32_t>(a - b) > 0; }
+
+  PollAction poll() {
+    stats_.polls++;
+    return PollAction::POLL;
+  }
+
+  /// Nothing new at this poll or skip: double the period up to the ceiling
+  void reschedule(uint32_t now_us, uint8_t onch) {
+    const uint32_t ceiling = onch != 0 ? config_.active_period_us : config_.idle_period_us;
+    period_us_ = period_us_ >= ceiling / 2 ? ceiling : period_us_ * 2;
+    last_poll_us_ = now_us;
+    next_due_us_ = now_us + period_us_;
+  }
+
+  PollSchedulerConfig config_;
+  PollSchedulerStats stats_;
+  uint32_t next_due_us_;
+  uint32_t last_poll_us_;
+  uint32_t period_us_;
+  uint32_t polled_seq_;
+  uint8_t polled_byte_;
+  uint8_t polled_onch_;
+  uint8_t skips_;
+  bool polled_fault_pin_;
+  bool started_;
+};
+
+} // namespace max22200
@@ -0,0 +1,201 @@
+/**
+ * @file max22200_rules.hpp
+ * @brief Reactive ONCH rules compiled into bitmask match tables
+ *
+ * Sequential machines hand off from one valve to the next: "once CH2 has
+ * pulled in, open CH3 5 ms later", "on open load on CH5, switch to CH6".
+ * Routing each hand-off through an application task and queue costs
+ * milliseconds. A RuleTable holds such rules; the driver matches it where it
+ * detects the events and applies it in MAX22200::ServiceReactions() (see
+ * MAX22200::SetRuleTable()).
+ *
+ * A rule is a trigger plus an ONCH action:
+ *
+ * | Trigger | Fires when                                                      |
+ * |---------|-----------------------------------------------------------------|
+ * | FAULT   | a fault event opens for (channel, FaultType) (FaultEventFilter) |
+ * | ON      | the channel's ONCH bit rises                                    |
+ * | OFF     | the channel's ONCH bit falls                                    |
+ * | HOLD    | the channel goes from HIT to HOLD with no fault reported; with  |
+ * |         | DPM enabled this is the confirmed pull-in                       |
+ *
+ * The action switches on_mask on and off_mask off, immediately or after
+ * delay_us. Add() compiles each rule into per-key rule bitmasks, so matching
+ * an event is one table lookup per set key, and a table without rules for
+ * the event's keys is rejected with one mask test. ON / OFF edges produced by
+ * immediate actions are matched again in the same pass, so an immediate chain
+ * (A switches CH3 on, "ON CH3" switches CH1 off) costs one ONCH write.
+ *
+ * @code
+ * RuleTable rules;
+ * rules.Add(ReactionRule::OnHold(2, ReactionRule::Bit(3), 0, 5000));       // CH2 pulled in: CH3 on in 5 ms
+ * rules.Add(ReactionRule::OnFault(5, FaultType::OLF, ReactionRule::Bit(6),
+ *                                 ReactionRule::Bit(5)));                 // OLF CH5: switch to CH6
+ * driver.SetRuleTable(&rules);
+ * // after each poll, and at least every driver.GetReactionDelayUs():
+ * driver.ServiceReactions();
+ * @endcode
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include "max22200_fault_filter.hpp"
+#include "max22200_types.hpp"
+#include <cstdint>
+
+namespace max22200 {
+
+/**
+ * @brief Event that fires a ReactionRule
+ */
+enum class RuleTrigger : uint8_t {
+  FAULT = 0, ///< Fault event opened on (channel, fault_type)
+  ON    = 1, ///< ONCH bit of channel rose
+  OFF   = 2, ///< ONCH bit of channel fell
+  HOLD  = 3  ///< Channel entered HOLD_PHASE from HIT_PHASE without a fault
+};
+
+/**
+ * @brief One rule: trigger → ONCH action
+ */
+struct ReactionRule {
+  RuleTrigger trigger;
+  uint8_t channel;       ///< 0-7; FAULT on OVT/UVM/COMER: ignored
+  FaultType fault_type;  ///< FAULT only
+  uint8_t on_mask;       ///< Channels switched on
+  uint8_t off_mask;      ///< Channels switched off
+  uint32_t delay_us;     ///< 0 = in the same ONCH write as the event's reaction
+
+  ReactionRule()
+      : trigger(RuleTrigger::ON), channel(0), fault_type(FaultType::OCP), on_mask(0),
+        off_mask(0), delay_us(0) {}
+  ReactionRule(RuleTrigger t, uint8_t ch, FaultType ft, uint8_t on, uint8_t off,
+               uint32_t delay)
+      : trigger(t), channel(ch), fault_type(ft), on_mask(on), off_mask(off), delay_us(delay) {}
+
+  static ReactionRule OnFault(uint8_t ch, FaultType type, uint8_t on, uint8_t off,
+                              uint32_t delay_us = 0) {
+    return ReactionRule(RuleTrigger::FAULT, ch, type, on, off, delay_us);
+  }
+  static ReactionRule OnOn(uint8_t ch, uint8_t on, uint8_t off, uint32_t delay_us = 0) {
+    return ReactionRule(RuleTrigger::ON, ch, FaultType::OCP, on, off, delay_us);
+  }
+  static ReactionRule OnOff(uint8_t ch, uint8_t on, uint8_t off, uint32_t delay_us = 0) {
+    return ReactionRule(RuleTrigger::OFF, ch, FaultType::OCP, on, off, delay_us);
+  }
+  static ReactionRule OnHold(uint8_t ch, uint8_t on, uint8_t off, uint32_t delay_us = 0) {
+    return ReactionRule(RuleTrigger::HOLD, ch, FaultType::OCP, on, off, delay_us);
+  }
+
+  /** @brief ONCH bit of channel @p ch */
+  static constexpr uint8_t Bit(uint8_t ch) { return static_cast<uint8_t>(1u << (ch & 0x07u)); }
+
+  bool isValid() const {
+    return static_cast<uint8_t>(trigger) <= static_cast<uint8_t>(RuleTrigger::HOLD) &&
+           (channel < NUM_CHANNELS_ ||
+            (trigger == RuleTrigger::FAULT && static_cast<uint8_t>(fault_type) >= 4)) &&
+           static_cast<uint8_t>(fault_type) <= static_cast<uint8_t>(FaultType::COMER) &&
+           (on_mask & off_mask) == 0 && (on_mask | off_mask) != 0;
+  }
+};
+
+/**
+ * @brief Fixed-size rule table with precomputed match masks
+ */
+class RuleTable {
+public:
+  static constexpr uint8_t MAX_RULES = 16;
+
+  RuleTable()
+      : rules_{}, count_(0), immediate_(0), on_fault_{}, on_rise_{}, on_fall_{}, on_hold_{},
+        fault_keys_(0), rise_mask_(0), fall_mask_(0), hold_mask_(0) {}
+
+  /**
+   * @brief Compile @p rule into the table
+   *
+   * @return false if the table is full or the rule is invalid
+   */
+  bool Add(const ReactionRule &rule) {
+    if (count_ >= MAX_RULES || !rule.isValid()) return false;
+    const uint8_t r = count_++;
+    const uint16_t bit = static_cast<uint16_t>(1u << r);
+    rules_[r] = rule;
+    if (rule.delay_us == 0) immediate_ |= bit;
+    const uint8_t ch_bit = ReactionRule::Bit(rule.channel);
+    switch (rule.trigger) {
+      case RuleTrigger::FAULT: {
+        const uint8_t key = FaultEventFilter::KeyOf(rule.channel, rule.fault_type);
+        on_fault_[key] |= bit;
+        fault_keys_ |= 1ull << key;
+        break;
+      }
+      case RuleTrigger::ON:
+        on_rise_[rule.channel] |= bit;
+        rise_mask_ |= ch_bit;
+        break;
+      case RuleTrigger::OFF:
+        on_fall_[rule.channel] |= bit;
+        fall_mask_ |= ch_bit;
+        break;
+      case RuleTrigger::HOLD:
+        on_hold_[rule.channel] |= bit;
+        hold_mask_ |= ch_bit;
+        break;
+    }
+    return true;
+  }
+
+  /** @brief Remove all rules */
+  void Clear() { *this = RuleTable(); }
+
+  /**
+   * @brief Rules fired by a set of events (bit N = rule N)
+   *
+   * @param fault_keys FaultEventFilter keys of opened fault events
+   * @param rising     ONCH bits that rose
+   * @param falling    ONCH bits that fell
+   * @param hold       Channels that entered HOLD_PHASE
+   */
+  uint16_t Match(uint64_t fault_keys, uint8_t rising, uint8_t falling, uint8_t hold) const {
+    uint16_t m = 0;
+    for (uint64_t k = fault_keys & fault_keys_; k != 0; k &= k - 1) {
+      m |= on_fault_[lowestBit(k)];
+    }
+    m |= matchChannels(rising & rise_mask_, on_rise_);
+    m |= matchChannels(falling & fall_mask_, on_fall_);
+    m |= matchChannels(hold & hold_mask_, on_hold_);
+    return m;
+  }
+
+  const ReactionRule &Get(uint8_t index) const { return rules_[index < MAX_RULES ? index : 0]; }
+  uint8_t Size() const { return count_; }
+
+  /** @brief Rules with delay_us == 0 */
+  uint16_t GetImmediateMask() const { return immediate_; }
+
+  /** @brief Channels with a HOLD rule (the driver tracks their HIT expiry for ServiceReactions) */
+  uint8_t GetHoldMask() const { return hold_mask_; }
+
+private:
+  static uint16_t matchChannels(uint8_t bits, const uint16_t *table) {
+    uint16_t m = 0;
+    for (; bits != 0; bits &= static_cast<uint8_t>(bits - 1)) {
+      m |= table[lowestBit(bits)];
+    }
+    return m;
+  }
+
+  ReactionRule rules_[MAX_RULES];
+  uint8_t count_;
+  uint16_t immediate_;
+  uint16_t on_fault_[FaultEventFilter::NUM_KEYS];  ///< Rules per fault key
+  uint16_t on_rise_[NUM_CHANNELS_];
+  uint16_t on_fall_[NUM_CHANNELS_];
+  uint16_t on_hold_[NUM_CHANNELS_];
+  uint64_t fault_keys_;  ///< Fault keys with any rule
+  uint8_t rise_mask_;
+  uint8_t fall_mask_;
+  uint8_t hold_mask_;
+};
+
+} // namespace max22200
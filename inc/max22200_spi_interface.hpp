@@ -47,6 +47,7 @@
 #pragma once
 #include <cstddef>
 #include <cstdint>
+#include <type_traits>
 
 namespace max22200 {
 
@@ -201,6 +202,25 @@ public:
    */
   void DelayUs(uint32_t us) { static_cast<Derived *>(this)->DelayUs(us); }
 
+  /**
+   * @brief Free-running microsecond timestamp (from comm/CRTP implementation).
+   *
+   * Used for driver-side timing that must not cost SPI traffic, e.g. tracking
+   * when a channel's HIT phase ends. Any monotonic source works (e.g.
+   * esp_timer_get_time(), a hardware timer); only differences are used, so
+   * wrapping at 2^32 (~71.6 min) is fine.
+   *
+   * @note There is no default: without Derived::GetTimeUs() the call would
+   *       resolve back to this method and recurse, so that fails to compile.
+   *
+   * @return Current time in microseconds.
+   */
+  uint32_t GetTimeUs() {
+    static_assert(!std::is_same_v<decltype(&Derived::GetTimeUs), uint32_t (SpiInterface::*)()>,
+                  "SpiInterface implementation must define uint32_t GetTimeUs()");
+    return static_cast<Derived *>(this)->GetTimeUs();
+  }
+
   // --------------------------------------------------------------------------
   /// @name GPIO Pin Control
   ///
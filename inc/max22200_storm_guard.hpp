@@ -0,0 +1,216 @@
+/**
+ * @file max22200_storm_guard.hpp
+ * @brief nFAULT interrupt-storm protection through dynamic STATUS fault masks
+ *
+ * A shorted harness or a chattering load can raise the same fault faster than
+ * it is worth servicing: every nFAULT edge wakes the fault task, which reads
+ * STATUS / FAULT, and the flag is set again before the next control cycle.
+ * FaultStormGuard counts the interrupt-driven reads that report each fault
+ * type. When one type reaches `trip_count` within `window_us`:
+ *
+ *   - the type is masked in STATUS (M_OCP, M_OLF, ...), so it no longer
+ *     asserts nFAULT; its flags still latch and are seen by reads;
+ *   - the application polls at `poll_period_us` instead (IsPollDue());
+ *   - once polls have not seen the type for `quiet_us`, it is unmasked.
+ *
+ * Other types keep interrupting as before. The guard owns the mask bits of
+ * `guarded_types`; masks the application sets for other types are kept.
+ *
+ * State is one counter and two timestamps per type plus a 7-bit mask; the
+ * guard does no I/O and keeps no clock (the caller passes a µs time, wrap at
+ * 2^32 is handled). The overloads taking the driver write the mask change
+ * with MAX22200::SetFaultPinMask().
+ *
+ * @code
+ * FaultStormGuard guard;
+ * // nFAULT task
+ * driver.ReadSnapshot(snap);
+ * guard.OnInterrupt(now_us, driver, snap);
+ * // control loop
+ * if (guard.IsPollDue(now_us)) {
+ *   driver.ReadSnapshot(snap);
+ *   guard.OnPolled(now_us, driver, snap);
+ * }
+ * @endcode
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include "max22200_bulk_decode.hpp"
+#include "max22200_types.hpp"
+#include <cstdint>
+
+namespace max22200 {
+
+/**
+ * @brief Thresholds for FaultStormGuard
+ */
+struct StormGuardConfig {
+  uint8_t guarded_types;    ///< FaultTypeBit()s the guard may mask (it owns their mask bits)
+  uint16_t trip_count;      ///< Interrupts reporting one type within window_us that mask it
+  uint32_t window_us;       ///< Rate window
+  uint32_t poll_period_us;  ///< Poll period while any type is masked
+  uint32_t quiet_us;        ///< A masked type unseen by polls this long is unmasked
+
+  StormGuardConfig()
+      : guarded_types(0x3F),  // OCP, HHF, OLF, DPM, OVT, UVM (COMER is masked at reset)
+        trip_count(8), window_us(10000), poll_period_us(20000), quiet_us(200000) {}
+};
+
+/**
+ * @brief Counters kept by FaultStormGuard
+ */
+struct StormGuardStats {
+  uint32_t interrupts;  ///< OnInterrupt() calls
+  uint32_t trips;       ///< Types masked
+  uint32_t releases;    ///< Types unmasked
+  uint32_t polls;       ///< OnPolled() calls
+
+  StormGuardStats() : interrupts(0), trips(0), releases(0), polls(0) {}
+};
+
+/**
+ * @class FaultStormGuard
+ * @brief Masks a fault type from nFAULT while it storms, polls it instead
+ */
+class FaultStormGuard {
+public:
+  static constexpr uint8_t NUM_TYPES = 7;
+
+  explicit FaultStormGuard(const StormGuardConfig &config = StormGuardConfig())
+      : config_(config), stats_(), window_start_us_{}, last_seen_us_{}, count_{},
+        masked_(0), next_poll_us_(0) {}
+
+  /**
+   * @brief Record an interrupt-driven read that reported @p type_bits
+   *
+   * @return true if the masked set changed (write PinMask() to STATUS)
+   */
+  bool OnInterrupt(uint32_t now_us, uint8_t type_bits) {
+    stats_.interrupts++;
+    seen(now_us, type_bits & masked_);
+    uint8_t tripped = 0;
+    for (uint8_t bits = type_bits & config_.guarded_types & static_cast<uint8_t>(~masked_);
+         bits != 0; bits &= static_cast<uint8_t>(bits - 1)) {
+      const uint8_t t = lowestBit(bits);
+      if (now_us - window_start_us_[t] >= config_.window_us) {
+        window_start_us_[t] = now_us;
+        count_[t] = 0;
+      }
+      if (++count_[t] >= config_.trip_count) {
+        tripped |= static_cast<uint8_t>(1u << t);
+        last_seen_us_[t] = now_us;
+        stats_.trips++;
+      }
+    }
+    if (tripped == 0) {
+      return false;
+    }
+    if (masked_ == 0) {
+      next_poll_us_ = now_us + config_.poll_period_us;
+    }
+    masked_ |= tripped;
+    return true;
+  }
+
+  /**
+   * @brief Record a rate-limited poll that reported @p type_bits
+   *
+   * @return true if the masked set changed (write PinMask() to STATUS)
+   */
+  bool OnPolled(uint32_t now_us, uint8_t type_bits) {
+    stats_.polls++;
+    next_poll_us_ = now_us + config_.poll_period_us;
+    seen(now_us, type_bits & masked_);
+    uint8_t released = 0;
+    for (uint8_t bits = masked_; bits != 0; bits &= static_cast<uint8_t>(bits - 1)) {
+      const uint8_t t = lowestBit(bits);
+      if (now_us - last_seen_us_[t] >= config_.quiet_us) {
+        released |= static_cast<uint8_t>(1u << t);
+        count_[t] = 0;
+        window_start_us_[t] = now_us;
+        stats_.releases++;
+      }
+    }
+    masked_ &= static_cast<uint8_t>(~released);
+    return released != 0;
+  }
+
+  /** @brief A poll is due (never while no type is masked) */
+  bool IsPollDue(uint32_t now_us) const {
+    return masked_ != 0 && static_cast<int32_t>(next_poll_us_ - now_us) <= 0;
+  }
+
+  /** @brief µs until the next poll (UINT32_MAX while no type is masked) */
+  uint32_t GetDelayUs(uint32_t now_us) const {
+    if (masked_ == 0) return UINT32_MAX;
+    return static_cast<int32_t>(next_poll_us_ - now_us) > 0 ? next_poll_us_ - now_us : 0;
+  }
+
+  /** @brief FaultTypeBit()s currently masked by the guard */
+  uint8_t GetMaskedTypes() const { return masked_; }
+
+  /** @brief Pin mask to write: @p current outside the guarded types, the guard's inside */
+  uint8_t PinMask(uint8_t current) const {
+    return static_cast<uint8_t>((current & ~config_.guarded_types) | masked_);
+  }
+
+  /** @brief Fault types reported by a snapshot (STATUS flags and FAULT) */
+  static uint8_t TypeBits(const Snapshot &snap) {
+    return BulkDecodeTables::kStatusFaultTypes.v[static_cast<uint8_t>(snap.status_raw)] |
+           (snap.faults.overcurrent_channel_mask != 0 ? FaultTypeBit(FaultType::OCP) : 0) |
+           (snap.faults.hit_not_reached_channel_mask != 0 ? FaultTypeBit(FaultType::HHF) : 0) |
+           (snap.faults.open_load_fault_channel_mask != 0 ? FaultTypeBit(FaultType::OLF) : 0) |
+           (snap.faults.plunger_movement_fault_channel_mask != 0 ? FaultTypeBit(FaultType::DPM)
+                                                                  : 0);
+  }
+
+  // ── Driver helpers ─────────────────────────────────────────────────────
+
+  /**
+   * @brief OnInterrupt() with a snapshot; writes a changed mask through @p driver
+   *
+   * @return Result of MAX22200::SetFaultPinMask(), or OK if nothing changed
+   *         (on error call Apply() again)
+   */
+  template <typename Driver>
+  DriverStatus OnInterrupt(uint32_t now_us, Driver &driver, const Snapshot &snap) {
+    return OnInterrupt(now_us, TypeBits(snap)) ? Apply(driver) : DriverStatus::OK;
+  }
+
+  /** @brief OnPolled() with a snapshot; writes a changed mask through @p driver */
+  template <typename Driver>
+  DriverStatus OnPolled(uint32_t now_us, Driver &driver, const Snapshot &snap) {
+    return OnPolled(now_us, TypeBits(snap)) ? Apply(driver) : DriverStatus::OK;
+  }
+
+  /** @brief Write the guard's masks to STATUS */
+  template <typename Driver>
+  DriverStatus Apply(Driver &driver) const {
+    return driver.SetFaultPinMask(PinMask(driver.GetFaultPinMask()));
+  }
+
+  const StormGuardStats &GetStats() const { return stats_; }
+  const StormGuardConfig &GetConfig() const { return config_; }
+
+  /** @brief Forget history and unmask everything (call Apply() afterwards) */
+  void Reset() { *this = FaultStormGuard(config_); }
+
+private:
+  /// Masked types still present: push their release out
+  void seen(uint32_t now_us, uint8_t masked_bits) {
+    for (; masked_bits != 0; masked_bits &= static_cast<uint8_t>(masked_bits - 1)) {
+      last_seen_us_[lowestBit(masked_bits)] = now_us;
+    }
+  }
+
+  StormGuardConfig config_;
+  StormGuardStats stats_;
+  uint32_t window_start_us_[NUM_TYPES];
+  uint32_t last_seen_us_[NUM_TYPES];
+  uint16_t count_[NUM_TYPES];
+  uint8_t masked_;        ///< FaultTypeBit()s masked by the guard
+  uint32_t next_poll_us_;
+};
+
+} // namespace max22200
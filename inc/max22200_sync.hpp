@@ -0,0 +1,175 @@
+/**
+ * @file max22200_sync.hpp
+ * @brief Skew-minimised synchronised ONCH updates across separate MAX22200 devices
+ *
+ * Valves on different devices (separate CS lines) that must switch together
+ * see the whole of each SetChannelsOn() between them: the command frame, the
+ * data frame and the driver work around both. The Command Register is
+ * sticky, so SyncOnchGroup splits the write. Arm() latches the 8-bit STATUS
+ * write command in every device, ahead of time if possible. Update() then
+ * sends only the one-byte data frames, back to back, so the ONCH latches are
+ * one data frame apart. The commit loop does no driver bookkeeping: each
+ * device's audit entry, ONCH cache, state tracking and statistics are
+ * updated after the last frame (MAX22200::FinishChannelsOn()).
+ *
+ * Devices stay armed after an update (and after SetChannelsOn()), so a
+ * steady stream of updates costs data frames only. Any other register access
+ * on a device disarms it; Update() re-arms such devices before the first data
+ * frame, so the commit loop itself never carries a command frame.
+ *
+ * Skew (first to last data frame done) is measured with the drivers'
+ * GetTimeUs() around the frame loop and kept in SyncStats; its resolution is
+ * that of the clock.
+ *
+ * @code
+ * SyncOnchGroup<MAX22200<MySpi>> sync;
+ * sync.AttachDevice(0, dev_a);
+ * sync.AttachDevice(1, dev_b);
+ * sync.Arm();                       // idle time: command frames
+ * const uint8_t onch[2] = {0x05, 0x30};
+ * sync.Update(onch, 0x03);          // two data frames back to back
+ * uint32_t skew = sync.GetStats().last_skew_us;
+ * @endcode
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include "max22200_types.hpp"
+#include "max22200_valve_map.hpp"
+#include <cstdint>
+
+namespace max22200 {
+
+/**
+ * @brief Counters kept by SyncOnchGroup
+ */
+struct SyncStats {
+  uint32_t updates;       ///< Update() calls that committed
+  uint32_t arms;          ///< Command frames sent to arm a device
+  uint32_t failures;      ///< Arm or commit frames that failed
+  uint32_t last_skew_us;  ///< First → last data frame done, last update
+  uint32_t max_skew_us;
+
+  SyncStats() : updates(0), arms(0), failures(0), last_skew_us(0), max_skew_us(0) {}
+};
+
+/**
+ * @class SyncOnchGroup
+ * @brief Switches ONCH on several devices with back-to-back data frames
+ *
+ * @tparam Driver      MAX22200<SpiType>
+ * @tparam MAX_DEVICES Devices that can be attached (at most 8)
+ */
+template <typename Driver, uint8_t MAX_DEVICES = 8>
+class SyncOnchGroup {
+  static_assert(MAX_DEVICES >= 1 && MAX_DEVICES <= 8, "device set is 8-bit");
+
+public:
+  SyncOnchGroup() : drivers_{}, attached_(0), stats_() {}
+
+  /** @brief Attach @p driver as device @p device (false if out of range) */
+  bool AttachDevice(uint8_t device, Driver &driver) {
+    if (device >= MAX_DEVICES) return false;
+    drivers_[device] = &driver;
+    attached_ |= static_cast<uint8_t>(1u << device);
+    return true;
+  }
+
+  /**
+   * @brief Latch the ONCH write command in @p devices that are not armed
+   *
+   * @return The first failure (remaining devices are still tried), else OK
+   */
+  DriverStatus Arm(uint8_t devices = 0xFF) {
+    DriverStatus result = DriverStatus::OK;
+    for (uint8_t m = devices & attached_; m != 0; m &= static_cast<uint8_t>(m - 1)) {
+      Driver &driver = *drivers_[lowestBit(m)];
+      if (driver.IsChannelsOnArmed()) continue;
+      stats_.arms++;
+      const DriverStatus s = driver.ArmChannelsOn();
+      if (s != DriverStatus::OK) {
+        stats_.failures++;
+        if (result == DriverStatus::OK) result = s;
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief Write @p onch[d] to every device d in @p devices
+   *
+   * Arms devices that need it first; if that fails nothing is committed.
+   * The commit loop then sends one data frame per device in device order,
+   * with the ONCH values filtered beforehand; the drivers' bookkeeping runs
+   * once all frames are out.
+   *
+   * @return The first commit failure (remaining devices are still written), else OK
+   */
+  DriverStatus Update(const uint8_t *onch, uint8_t devices) {
+    devices &= attached_;
+    if (devices == 0) return DriverStatus::OK;
+    DriverStatus result = Arm(devices);
+    if (result != DriverStatus::OK) return result;
+
+    uint8_t value[MAX_DEVICES];
+    for (uint8_t m = devices; m != 0; m &= static_cast<uint8_t>(m - 1)) {
+      const uint8_t d = lowestBit(m);
+      value[d] = drivers_[d]->FilterChannelsOn(onch[d]);
+    }
+
+    // Frames only, back to back
+    DriverStatus sent[MAX_DEVICES];
+    const uint8_t first = lowestBit(devices);
+    uint8_t last = first;
+    uint32_t first_us = 0;
+    for (uint8_t m = devices; m != 0; m &= static_cast<uint8_t>(m - 1)) {
+      last = lowestBit(m);
+      sent[last] = drivers_[last]->SendChannelsOnFrame(value[last]);
+      if (last == first) first_us = drivers_[first]->GetTimeUs();
+    }
+    const uint32_t last_us = drivers_[last]->GetTimeUs();
+
+    for (uint8_t m = devices; m != 0; m &= static_cast<uint8_t>(m - 1)) {
+      const uint8_t d = lowestBit(m);
+      drivers_[d]->FinishChannelsOn(value[d], sent[d]);
+      if (sent[d] != DriverStatus::OK) {
+        stats_.failures++;
+        if (result == DriverStatus::OK) result = sent[d];
+      }
+    }
+    stats_.updates++;
+    stats_.last_skew_us = last_us - first_us;
+    if (stats_.last_skew_us > stats_.max_skew_us) stats_.max_skew_us = stats_.last_skew_us;
+    return result;
+  }
+
+  /**
+   * @brief Apply ValveMap masks (ValveMap::Compile()) as one synchronised update
+   *
+   * Devices whose ONCH would not change are left out.
+   */
+  DriverStatus Update(const DeviceOnchMasks<MAX_DEVICES> &masks) {
+    uint8_t onch[MAX_DEVICES] = {};
+    uint8_t devices = 0;
+    for (uint8_t m = masks.devices & attached_; m != 0; m &= static_cast<uint8_t>(m - 1)) {
+      const uint8_t d = lowestBit(m);
+      const uint8_t current = drivers_[d]->GetChannelsOnMask();
+      onch[d] = masks.Apply(d, current);
+      if (onch[d] != current) devices |= static_cast<uint8_t>(1u << d);
+    }
+    return Update(onch, devices);
+  }
+
+  /** @brief Attached devices (bit d = device d) */
+  uint8_t GetDevices() const { return attached_; }
+
+  const SyncStats &GetStats() const { return stats_; }
+  void ResetStats() { stats_ = SyncStats(); }
+
+private:
+  Driver *drivers_[MAX_DEVICES];
+  uint8_t attached_;
+  SyncStats stats_;
+};
+
+} // namespace max22200
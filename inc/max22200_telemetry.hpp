@@ -0,0 +1,386 @@
+/**
+ * @file max22200_telemetry.hpp
+ * @brief Compact delta-encoded binary telemetry for MAX22200 polling loops
+ *
+ * Telemetry loops that printf STATUS / FAULT at every poll spend most of
+ * their CPU time and UART bandwidth formatting values that did not change.
+ * TelemetryEncoder turns each poll into a small binary frame that carries
+ * only the fields that changed since the previous frame; TelemetryDecoder
+ * (usable on the target or on a host) expands the stream back into samples.
+ *
+ * ## Record (TelemetrySample)
+ *
+ * | Field        | Source                                          |
+ * |--------------|-------------------------------------------------|
+ * | timestamp_us | Caller's µs clock (wraps at 2^32)               |
+ * | status       | STATUS bits 23:0 (masks, FREQM, CMxy, flags)    |
+ * | onch         | STATUS bits 31:24 (ONCH)                        |
+ * | fault        | FAULT register (OCP / HHF / OLF / DPM bytes)    |
+ * | fault_byte   | Command-phase byte (GetLastFaultByte())         |
+ *
+ * ## Frame format
+ *
+ * ```
+ * header (1 byte)   bit0 STATUS, bit1 ONCH, bit2 FAULT, bit3 fault byte present,
+ *                   bits 6:4 sequence (frame count mod 8), bit7 keyframe
+ * dt     (varint)   keyframe: absolute timestamp_us; otherwise µs since the
+ *                   previous frame (mod 2^32)
+ * fields (varint)   for each present field in bit order: keyframe = value,
+ *                   otherwise value XOR previous value
+ * ```
+ *
+ * Varints are unsigned LEB128 (7 bits per byte, LSB group first, bit 7 =
+ * continuation). A keyframe carries every field and is emitted first and
+ * then every `keyframe_interval` frames, so a decoder can join a stream
+ * mid-way. The sequence field lets the decoder detect lost frames: after a
+ * gap it drops delta frames (their XOR base is gone) until the next
+ * keyframe. A loss of a multiple of 8 frames goes unnoticed. An unchanged
+ * poll costs two or three bytes (header + dt).
+ *
+ * @note The encoder is transport-agnostic: frames go into a caller buffer.
+ *       Framing on a byte stream (e.g. "TLM,<hex>" log lines as in the C21
+ *       examples, or COBS) is up to the application.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include "max22200_registers.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace max22200 {
+
+// ============================================================================
+// Varint helpers
+// ============================================================================
+
+/**
+ * @brief Maximum encoded size of a 32-bit varint
+ */
+constexpr size_t TELEMETRY_MAX_VARINT32_BYTES = 5;
+
+/**
+ * @brief Encode @p value as an unsigned LEB128 varint
+ *
+ * @param value Value to encode
+ * @param out   Output buffer (at least TELEMETRY_MAX_VARINT32_BYTES free)
+ * @return Number of bytes written (1-5)
+ */
+inline size_t EncodeVarint32(uint32_t value, uint8_t *out) {
+  size_t n = 0;
+  while (value >= 0x80u) {
+    out[n++] = static_cast<uint8_t>(value | 0x80u);
+    value >>= 7;
+  }
+  out[n++] = static_cast<uint8_t>(value);
+  return n;
+}
+
+/**
+ * @brief Decode an unsigned LEB128 varint
+ *
+ * @param in    Input bytes
+ * @param len   Bytes available
+ * @param value Output value
+ * @return Bytes consumed, or 0 if the input is truncated or longer than 5 bytes
+ */
+inline size_t DecodeVarint32(const uint8_t *in, size_t len, uint32_t &value) {
+  uint32_t v = 0;
+  for (size_t i = 0; i < len && i < TELEMETRY_MAX_VARINT32_BYTES; ++i) {
+    v |= static_cast<uint32_t>(in[i] & 0x7Fu) << (7u * i);
+    if ((in[i] & 0x80u) == 0) {
+      value = v;
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+// ============================================================================
+// Telemetry record and frame layout
+// ============================================================================
+
+/**
+ * @brief Telemetry frame header bits
+ */
+namespace TelemetryFrame {
+constexpr uint8_t STATUS_BIT     = 0x01; ///< STATUS[23:0] present
+constexpr uint8_t ONCH_BIT       = 0x02; ///< ONCH present
+constexpr uint8_t FAULT_BIT      = 0x04; ///< FAULT present
+constexpr uint8_t FAULT_BYTE_BIT = 0x08; ///< Command-phase fault byte present
+constexpr uint8_t FIELDS_MASK    = 0x0F; ///< All field bits
+constexpr uint8_t SEQ_MASK       = 0x70; ///< Frame sequence number (mod 8)
+constexpr uint8_t SEQ_SHIFT      = 4;
+constexpr uint8_t KEYFRAME_BIT   = 0x80; ///< All fields present, absolute values
+
+/// Header + dt + STATUS + ONCH + FAULT + fault byte, all at maximum varint length
+constexpr size_t MAX_FRAME_BYTES = 1 + TELEMETRY_MAX_VARINT32_BYTES * 3 + 2 + 2;
+} // namespace TelemetryFrame
+
+/**
+ * @brief One telemetry sample (raw register values)
+ */
+struct TelemetrySample {
+  uint32_t timestamp_us; ///< Sample time in µs (caller's clock)
+  uint32_t status;       ///< STATUS bits 23:0 (ONCH is carried separately)
+  uint32_t fault;        ///< FAULT register
+  uint8_t  onch;         ///< STATUS bits 31:24 (channels on)
+  uint8_t  fault_byte;   ///< Command-phase fault byte (STATUS[7:0] echo)
+
+  TelemetrySample() : timestamp_us(0), status(0), fault(0), onch(0), fault_byte(0) {}
+
+  /**
+   * @brief Build a sample from raw STATUS and FAULT register values
+   *
+   * @param t_us        Timestamp in µs
+   * @param status_raw  Full 32-bit STATUS (e.g. StatusConfig::toRegister())
+   * @param fault_raw   Full 32-bit FAULT
+   * @param last_byte   Command-phase fault byte (GetLastFaultByte())
+   */
+  static TelemetrySample fromRegisters(uint32_t t_us, uint32_t status_raw, uint32_t fault_raw,
+                                       uint8_t last_byte) {
+    TelemetrySample s;
+    s.timestamp_us = t_us;
+    s.status = status_raw & ~StatusReg::ONCH_MASK;
+    s.onch = static_cast<uint8_t>((status_raw & StatusReg::ONCH_MASK) >> StatusReg::ONCH_SHIFT);
+    s.fault = fault_raw;
+    s.fault_byte = last_byte;
+    return s;
+  }
+
+  /**
+   * @brief Full 32-bit STATUS value (ONCH merged back in)
+   */
+  uint32_t getStatusRegister() const {
+    return status | (static_cast<uint32_t>(onch) << StatusReg::ONCH_SHIFT);
+  }
+};
+
+// ============================================================================
+// Encoder
+// ============================================================================
+
+/**
+ * @brief Delta encoder: one TelemetrySample in, one frame out
+ *
+ * @code
+ * TelemetryEncoder enc;
+ * uint8_t frame[TelemetryFrame::MAX_FRAME_BYTES];
+ * Snapshot snap;
+ * driver.ReadSnapshot(snap);
+ * size_t n = enc.Encode(TelemetrySample::fromRegisters(snap.timestamp_us, snap.status_raw,
+ *                                                      snap.faults.toRegister(),
+ *                                                      snap.fault_byte),
+ *                       frame, sizeof(frame));
+ * @endcode
+ */
+class TelemetryEncoder {
+public:
+  /**
+   * @param keyframe_interval Emit a keyframe every N frames (0 = first frame only)
+   */
+  explicit TelemetryEncoder(uint16_t keyframe_interval = 64)
+      : prev_(), keyframe_interval_(keyframe_interval), since_keyframe_(0), seq_(0),
+        have_prev_(false) {}
+
+  /**
+   * @brief Encode @p sample into @p out
+   *
+   * @param sample Sample to encode
+   * @param out    Output buffer
+   * @param cap    Buffer size; TelemetryFrame::MAX_FRAME_BYTES always suffices
+   * @return Bytes written, or 0 if @p cap is too small (encoder state unchanged)
+   */
+  size_t Encode(const TelemetrySample &sample, uint8_t *out, size_t cap) {
+    if (out == nullptr || cap < TelemetryFrame::MAX_FRAME_BYTES) {
+      return 0;
+    }
+    const bool key = !have_prev_ ||
+                     (keyframe_interval_ != 0 && since_keyframe_ >= keyframe_interval_);
+    uint8_t header = 0;
+    if (key) {
+      header = TelemetryFrame::KEYFRAME_BIT | TelemetryFrame::FIELDS_MASK;
+    } else {
+      if (sample.status != prev_.status) header |= TelemetryFrame::STATUS_BIT;
+      if (sample.onch != prev_.onch) header |= TelemetryFrame::ONCH_BIT;
+      if (sample.fault != prev_.fault) header |= TelemetryFrame::FAULT_BIT;
+      if (sample.fault_byte != prev_.fault_byte) header |= TelemetryFrame::FAULT_BYTE_BIT;
+    }
+
+    header |= static_cast<uint8_t>(seq_ << TelemetryFrame::SEQ_SHIFT);
+
+    size_t n = 0;
+    out[n++] = header;
+    n += EncodeVarint32(key ? sample.timestamp_us : sample.timestamp_us - prev_.timestamp_us,
+                        out + n);
+    if (header & TelemetryFrame::STATUS_BIT) {
+      n += EncodeVarint32(key ? sample.status : sample.status ^ prev_.status, out + n);
+    }
+    if (header & TelemetryFrame::ONCH_BIT) {
+      n += EncodeVarint32(key ? sample.onch : static_cast<uint32_t>(sample.onch ^ prev_.onch),
+                          out + n);
+    }
+    if (header & TelemetryFrame::FAULT_BIT) {
+      n += EncodeVarint32(key ? sample.fault : sample.fault ^ prev_.fault, out + n);
+    }
+    if (header & TelemetryFrame::FAULT_BYTE_BIT) {
+      n += EncodeVarint32(key ? sample.fault_byte
+                              : static_cast<uint32_t>(sample.fault_byte ^ prev_.fault_byte),
+                          out + n);
+    }
+
+    prev_ = sample;
+    have_prev_ = true;
+    since_keyframe_ = key ? 1 : static_cast<uint16_t>(since_keyframe_ + 1);
+    seq_ = static_cast<uint8_t>((seq_ + 1u) & 0x07u);
+    return n;
+  }
+
+  /**
+   * @brief Force the next frame to be a keyframe (e.g. after a dropped frame)
+   */
+  void Reset() {
+    have_prev_ = false;
+    since_keyframe_ = 0;
+  }
+
+private:
+  TelemetrySample prev_;
+  uint16_t keyframe_interval_;
+  uint16_t since_keyframe_;
+  uint8_t seq_;  ///< Sequence number of the next frame
+  bool have_prev_;
+};
+
+// ============================================================================
+// Decoder
+// ============================================================================
+
+/**
+ * @brief Decoder for TelemetryEncoder frames
+ *
+ * Frames before the first keyframe cannot be reconstructed and are skipped
+ * (Decode() returns their length with @p valid = false). So are delta frames
+ * after a sequence gap, until the next keyframe; GetGaps() and
+ * GetLostFrames() count the gaps.
+ */
+class TelemetryDecoder {
+public:
+  TelemetryDecoder()
+      : prev_(), timestamp64_us_(0), gaps_(0), lost_frames_(0), next_seq_(0), synced_(false),
+        clock_synced_(false), have_seq_(false) {}
+
+  /**
+   * @brief Decode one frame from @p in
+   *
+   * @param in     Frame bytes (may be followed by further frames)
+   * @param len    Bytes available
+   * @param sample Output sample (valid only if @p valid is true)
+   * @param valid  true if @p sample holds a reconstructed record
+   * @return Bytes consumed, or 0 if the frame is truncated or malformed
+   *         (keyframe without every field); the decoder then needs a keyframe
+   */
+  size_t Decode(const uint8_t *in, size_t len, TelemetrySample &sample, bool &valid) {
+    valid = false;
+    if (in == nullptr || len == 0) {
+      return 0;
+    }
+    const uint8_t header = in[0];
+    const bool key = (header & TelemetryFrame::KEYFRAME_BIT) != 0;
+    if (key && (header & TelemetryFrame::FIELDS_MASK) != TelemetryFrame::FIELDS_MASK) {
+      lose();
+      return 0;
+    }
+
+    uint32_t v[5] = {};
+    size_t n = 1;
+    const uint8_t present[5] = {0x00, TelemetryFrame::STATUS_BIT, TelemetryFrame::ONCH_BIT,
+                                TelemetryFrame::FAULT_BIT, TelemetryFrame::FAULT_BYTE_BIT};
+    for (uint8_t i = 0; i < 5; ++i) {
+      if (i != 0 && (header & present[i]) == 0) continue;
+      const size_t used = DecodeVarint32(in + n, len - n, v[i]);
+      if (used == 0) {
+        lose();
+        return 0;
+      }
+      n += used;
+    }
+
+    const uint8_t seq = static_cast<uint8_t>((header & TelemetryFrame::SEQ_MASK) >>
+                                             TelemetryFrame::SEQ_SHIFT);
+    if (have_seq_ && seq != next_seq_) {
+      gaps_++;
+      lost_frames_ += static_cast<uint8_t>((seq - next_seq_) & 0x07u);
+      synced_ = false;  // A keyframe below resyncs at once
+    }
+    have_seq_ = true;
+    next_seq_ = static_cast<uint8_t>((seq + 1u) & 0x07u);
+
+    if (key) {
+      timestamp64_us_ = clock_synced_ ? timestamp64_us_ + (v[0] - prev_.timestamp_us) : v[0];
+      prev_.timestamp_us = v[0];
+      prev_.status = v[1];
+      prev_.onch = static_cast<uint8_t>(v[2]);
+      prev_.fault = v[3];
+      prev_.fault_byte = static_cast<uint8_t>(v[4]);
+      synced_ = true;
+      clock_synced_ = true;
+    } else if (synced_) {
+      prev_.timestamp_us += v[0];
+      timestamp64_us_ += v[0];
+      prev_.status ^= v[1];
+      prev_.onch = static_cast<uint8_t>(prev_.onch ^ v[2]);
+      prev_.fault ^= v[3];
+      prev_.fault_byte = static_cast<uint8_t>(prev_.fault_byte ^ v[4]);
+    } else {
+      return n;  // Well-formed delta frame, but no base (no keyframe yet, or a gap)
+    }
+    sample = prev_;
+    valid = true;
+    return n;
+  }
+
+  /**
+   * @brief Timestamp of the last decoded sample, unwrapped to 64 bits
+   *
+   * Starts from the first keyframe's 32-bit value and accumulates across
+   * wraps (and across sequence gaps shorter than one wrap); a resync after a
+   * malformed frame restarts it.
+   */
+  uint64_t GetTimestamp64Us() const { return timestamp64_us_; }
+
+  /**
+   * @brief True while delta frames can be applied (keyframe seen, no gap since)
+   */
+  bool IsSynced() const { return synced_; }
+
+  /**
+   * @brief Sequence gaps seen (each one drops deltas until the next keyframe)
+   */
+  uint32_t GetGaps() const { return gaps_; }
+
+  /**
+   * @brief Frames lost in those gaps (each gap counted mod 8)
+   */
+  uint32_t GetLostFrames() const { return lost_frames_; }
+
+private:
+  /** @brief Malformed input: forget the base, the clock and the sequence */
+  void lose() {
+    synced_ = false;
+    clock_synced_ = false;
+    have_seq_ = false;
+    timestamp64_us_ = 0;
+  }
+
+  TelemetrySample prev_;
+  uint64_t timestamp64_us_;
+  uint32_t gaps_;
+  uint32_t lost_frames_;
+  uint8_t next_seq_;
+  bool synced_;        ///< Delta frames can be applied
+  bool clock_synced_;  ///< timestamp64_us_ continues from prev_.timestamp_us
+  bool have_seq_;
+};
+
+} // namespace max22200
@@ -305,10 +305,178 @@ inline const char *FaultTypeToStr(FaultType ft) {
   }
 }
 
+/**
+ * @brief Bit for one fault type in a FaultType bitmap
+ */
+constexpr uint8_t FaultTypeBit(FaultType type) {
+  return static_cast<uint8_t>(1u << static_cast<uint8_t>(type));
+}
+
+/**
+ * @brief Index of the lowest set bit in a non-zero mask
+ *
+ * Shared bit scan for channel, device, key and rule masks.
+ */
+inline uint8_t lowestBit(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<uint8_t>(__builtin_ctzll(bits));
+#else
+  uint8_t bit = 0;
+  while ((bits & 1u) == 0) {
+    bits >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+/**
+ * @brief Automatic driver reaction to a fault
+ *
+ * Queued by the read that observes the fault and applied by
+ * MAX22200::ServiceReactions() (see MAX22200::SetFaultReaction()); each
+ * resolves to one ONCH or CFG_CHx write.
+ */
+enum class FaultReaction : uint8_t {
+  NONE           = 0, ///< Report only
+  CHANNEL_OFF    = 1, ///< Clear the faulted channel's ONCH bit (OCP, HHF, OLF, DPM)
+  QUARANTINE     = 2, ///< CHANNEL_OFF, and keep it off for cooldown_ms (OCP, HHF, OLF, DPM)
+  HIT_STEP_RETRY = 3, ///< Raise HIT one step, once; CHANNEL_OFF on the next HHF (HHF only)
+  SHED           = 4  ///< Clear the ONCH bits in shed_mask (any type, e.g. OVT)
+};
+
 // ============================================================================
 // Structures
 // ============================================================================
 
+/**
+ * @brief Reaction policy for one FaultType (see MAX22200::SetFaultReaction())
+ */
+struct FaultReactionPolicy {
+  FaultReaction action;
+  uint32_t cooldown_ms;  ///< QUARANTINE: time the channel is held off
+  uint8_t shed_mask;     ///< SHED: channels switched off, e.g. the lowest-priority ones
+
+  FaultReactionPolicy() : action(FaultReaction::NONE), cooldown_ms(0), shed_mask(0) {}
+  FaultReactionPolicy(FaultReaction a, uint32_t cooldown = 0, uint8_t shed = 0)
+      : action(a), cooldown_ms(cooldown), shed_mask(shed) {}
+
+  /** @brief Whether @p action applies to @p type (per-channel actions need a channel fault) */
+  bool isValidFor(FaultType type) const {
+    const bool per_channel = static_cast<uint8_t>(type) < 4;
+    switch (action) {
+      case FaultReaction::NONE:
+      case FaultReaction::SHED:
+        return static_cast<uint8_t>(type) <= static_cast<uint8_t>(FaultType::COMER);
+      case FaultReaction::CHANNEL_OFF:
+      case FaultReaction::QUARANTINE:
+        return per_channel;
+      case FaultReaction::HIT_STEP_RETRY:
+        return type == FaultType::HHF;
+      default:
+        return false;
+    }
+  }
+};
+
+/**
+ * @brief Measured current error of one channel setpoint (CDR)
+ *
+ * Models the measured current as `gain × nominal + offset_ma`, where nominal
+ * is the ideal `raw / 127 × IFS`. Identity (1, 0) means uncalibrated.
+ */
+struct CurrentCalibration {
+  float gain;       ///< Measured / nominal slope (accepted range 0.5–2.0)
+  float offset_ma;  ///< Measured current at raw 0, in mA (accepted ±MAX_OFFSET_MA)
+
+  /// Largest accepted |offset_ma|; keeps the Q8 offset far inside int32_t
+  static constexpr float MAX_OFFSET_MA = 10000.0f;
+
+  CurrentCalibration() : gain(1.0f), offset_ma(0.0f) {}
+  CurrentCalibration(float g, float offset) : gain(g), offset_ma(offset) {}
+
+  bool isIdentity() const { return gain == 1.0f && offset_ma == 0.0f; }
+  /** @brief Gain and offset in range; the comparisons also reject NaN and infinities */
+  bool isValid() const {
+    return gain >= 0.5f && gain <= 2.0f && offset_ma >= -MAX_OFFSET_MA &&
+           offset_ma <= MAX_OFFSET_MA;
+  }
+};
+
+/**
+ * @brief Calibration of one channel; HIT and HOLD may differ (e.g. chopping ripple)
+ */
+struct ChannelCalibration {
+  CurrentCalibration hit;
+  CurrentCalibration hold;
+
+  ChannelCalibration() : hit(), hold() {}
+  explicit ChannelCalibration(const CurrentCalibration &both) : hit(both), hold(both) {}
+  ChannelCalibration(const CurrentCalibration &hit_cal, const CurrentCalibration &hold_cal)
+      : hit(hit_cal), hold(hold_cal) {}
+
+  bool isIdentity() const { return hit.isIdentity() && hold.isIdentity(); }
+  bool isValid() const { return hit.isValid() && hold.isValid(); }
+};
+
+/**
+ * @brief CurrentCalibration folded with the board IFS into integer factors
+ *
+ * Computed once when calibration or IFS changes, so encoding a setpoint is
+ * integer arithmetic only. Q8 fixed point (1/256 mA). HFS=1 halves the
+ * scale, as for the ideal conversion.
+ */
+struct CurrentScale {
+  uint32_t full_ma_q8;    ///< Measured current at raw 127: gain × IFS
+  int32_t  offset_ma_q8;  ///< Measured current at raw 0: offset_ma
+
+  CurrentScale() : full_ma_q8(0), offset_ma_q8(0) {}
+
+  static CurrentScale fromCalibration(const CurrentCalibration &cal, uint32_t ifs_ma) {
+    CurrentScale s;
+    if (ifs_ma == 0 || !cal.isValid()) return s;
+    s.full_ma_q8 = static_cast<uint32_t>(cal.gain * static_cast<float>(ifs_ma) * 256.0f + 0.5f);
+    // An offset beyond full scale moves every code to 0 or 127 anyway
+    const float limit = static_cast<float>(ifs_ma);
+    const float offset = cal.offset_ma < -limit ? -limit
+                         : cal.offset_ma > limit ? limit
+                                                 : cal.offset_ma;
+    const float offset_q8 = offset * 256.0f;
+    s.offset_ma_q8 = static_cast<int32_t>(offset_q8 < 0.0f ? offset_q8 - 0.5f : offset_q8 + 0.5f);
+    return s;
+  }
+
+  /** @brief Code (0–127) whose calibrated current is nearest @p ma */
+  uint8_t maToRaw(uint32_t ma, bool half_full_scale) const {
+    const int64_t delta_q8 = (static_cast<int64_t>(ma) << 8) - offset_ma_q8;
+    if (delta_q8 <= 0 || full_ma_q8 == 0) return 0;
+    // round(127 × delta / full_eff), full_eff = full / 2 when HFS=1
+    const uint64_t num = static_cast<uint64_t>(delta_q8) * (half_full_scale ? 508u : 254u) + full_ma_q8;
+    const uint64_t raw = num / (2u * static_cast<uint64_t>(full_ma_q8));
+    return raw > 127u ? 127u : static_cast<uint8_t>(raw);
+  }
+
+  /** @brief Calibrated current of code @p raw, in mA */
+  float rawToMa(uint8_t raw, bool half_full_scale) const {
+    const float full_ma = static_cast<float>(full_ma_q8) / (half_full_scale ? 512.0f : 256.0f);
+    return static_cast<float>(raw & 0x7Fu) * full_ma / 127.0f +
+           static_cast<float>(offset_ma_q8) / 256.0f;
+  }
+};
+
+/**
+ * @brief Precomputed HIT and HOLD scales of one channel (see CurrentScale)
+ */
+struct ChannelScale {
+  CurrentScale hit;
+  CurrentScale hold;
+
+  ChannelScale() : hit(), hold() {}
+  ChannelScale(const ChannelCalibration &cal, uint32_t ifs_ma)
+      : hit(CurrentScale::fromCalibration(cal.hit, ifs_ma)),
+        hold(CurrentScale::fromCalibration(cal.hold, ifs_ma)) {}
+};
+
 /**
  * @brief Channel configuration structure
  *
@@ -435,6 +603,11 @@ struct ChannelConfig {
   float hit_duty_percent() const { return hit_setpoint; }
   float hold_duty_percent() const { return hold_setpoint; }
 
+  /** @brief CDR setpoint rounded to whole mA (negative = 0) */
+  static uint32_t setpointMa(float setpoint) {
+    return setpoint > 0.0f ? static_cast<uint32_t>(setpoint + 0.5f) : 0u;
+  }
+
   /**
    * @brief Build 32-bit register value from user units
    *
@@ -443,8 +616,10 @@ struct ChannelConfig {
    *
    * @param board_ifs_ma Board IFS in mA (required for CDR when > 0; 0 yields raw 0 in CDR).
    * @param master_clock_80khz Master clock base from STATUS FREQM (false = 100 kHz, true = 80 kHz); used for hit_time conversion.
+   * @param scale Per-channel calibration for CDR setpoints (nullptr = ideal IFS / 127 per code).
    */
-  uint32_t toRegister(uint32_t board_ifs_ma = 0, bool master_clock_80khz = false) const {
+  uint32_t toRegister(uint32_t board_ifs_ma = 0, bool master_clock_80khz = false,
+                      const ChannelScale *scale = nullptr) const {
     // Effective IFS for CDR: HFS=1 halves the scale (datasheet KFS 7.5k vs 15k)
     const uint32_t ifs_ma = (drive_mode == DriveMode::CDR && half_full_scale && board_ifs_ma >= 2u)
                                 ? (board_ifs_ma / 2u)
@@ -456,6 +631,8 @@ struct ChannelConfig {
       // CDR: hit_setpoint is in mA (relative to effective IFS for this channel)
       if (ifs_ma == 0) {
         hit_raw = 0;  // Invalid IFS
+      } else if (scale != nullptr) {
+        hit_raw = scale->hit.maToRaw(setpointMa(hit_setpoint), half_full_scale);
       } else if (hit_setpoint >= static_cast<float>(ifs_ma)) {
         hit_raw = 127;
       } else {
@@ -480,6 +657,8 @@ struct ChannelConfig {
       // CDR: hold_setpoint is in mA
       if (ifs_ma == 0) {
         hold_raw = 0;
+      } else if (scale != nullptr) {
+        hold_raw = scale->hold.maToRaw(setpointMa(hold_setpoint), half_full_scale);
       } else if (hold_setpoint >= static_cast<float>(ifs_ma)) {
         hold_raw = 127;
       } else {
@@ -526,8 +705,10 @@ struct ChannelConfig {
    * @param val 32-bit register value from CFG_CHx
    * @param board_ifs_ma Board IFS in mA (for CDR raw→mA conversion)
    * @param master_clock_80khz_param   Master clock 80 kHz base (for hit_time conversion)
+   * @param scale Per-channel calibration for CDR setpoints (nullptr = ideal IFS / 127 per code)
    */
-  void fromRegister(uint32_t val, uint32_t board_ifs_ma, bool master_clock_80khz_param) {
+  void fromRegister(uint32_t val, uint32_t board_ifs_ma, bool master_clock_80khz_param,
+                    const ChannelScale *scale = nullptr) {
     // Parse register fields
     half_full_scale = (val & CfgChReg::HFS_BIT) != 0;
     uint8_t hold_raw = static_cast<uint8_t>((val >> CfgChReg::HOLD_SHIFT) & 0x7F);
@@ -548,7 +729,10 @@ struct ChannelConfig {
       const uint32_t effective_ifs = half_full_scale && board_ifs_ma >= 2u
                                          ? (board_ifs_ma / 2u)
                                          : board_ifs_ma;
-      if (effective_ifs > 0) {
+      if (effective_ifs > 0 && scale != nullptr) {
+        hit_setpoint = scale->hit.rawToMa(hit_raw, half_full_scale);
+        hold_setpoint = scale->hold.rawToMa(hold_raw, half_full_scale);
+      } else if (effective_ifs > 0) {
         hit_setpoint = (static_cast<float>(hit_raw) / 127.0f) * static_cast<float>(effective_ifs);
         hold_setpoint = (static_cast<float>(hold_raw) / 127.0f) * static_cast<float>(effective_ifs);
       } else {
@@ -818,6 +1002,16 @@ struct FaultStatus {
     plunger_movement_fault_channel_mask = static_cast<uint8_t>((val >> FaultReg::DPM_SHIFT) & 0xFF);
   }
 
+  /**
+   * @brief Pack the four per-channel masks back into the FAULT register layout
+   */
+  uint32_t toRegister() const {
+    return (static_cast<uint32_t>(overcurrent_channel_mask) << FaultReg::OCP_SHIFT) |
+           (static_cast<uint32_t>(hit_not_reached_channel_mask) << FaultReg::HHF_SHIFT) |
+           (static_cast<uint32_t>(open_load_fault_channel_mask) << FaultReg::OLF_SHIFT) |
+           (static_cast<uint32_t>(plunger_movement_fault_channel_mask) << FaultReg::DPM_SHIFT);
+  }
+
   /**
    * @brief Check if any per-channel fault is active
    */
@@ -868,6 +1062,35 @@ struct FaultStatus {
   }
 };
 
+/**
+ * @brief STATUS and FAULT read back-to-back (see MAX22200::ReadSnapshot)
+ *
+ * fault_byte is the STATUS[7:0] returned by the FAULT command phase, i.e. after
+ * STATUS was read. A flag in it that STATUS did not report was raised between
+ * the two reads; isCoherent() checks for that.
+ */
+struct Snapshot {
+  StatusConfig status;    ///< STATUS register, decoded
+  FaultStatus faults;     ///< FAULT register (before any selective clear takes effect)
+  uint32_t status_raw;    ///< STATUS register as read (StatusConfig::toRegister() omits the flags)
+  uint32_t timestamp_us;  ///< SpiInterface::GetTimeUs() just before the STATUS read
+  uint8_t fault_byte;     ///< STATUS[7:0] from the FAULT command phase (= GetLastFaultByte())
+
+  Snapshot() : status(), faults(), status_raw(0), timestamp_us(0), fault_byte(0) {}
+
+  /**
+   * @brief Check if STATUS or FAULT reports any fault
+   */
+  bool hasFault() const { return status.hasFault() || faults.hasFault(); }
+
+  /**
+   * @brief true if no fault flag appeared between the STATUS and FAULT reads
+   */
+  bool isCoherent() const {
+    return (fault_byte & ~status_raw & StatusReg::FAULT_FLAGS_MASK) == 0u;
+  }
+};
+
 /**
  * @brief DPM (Detection of Plunger Movement) algorithm configuration
  *
@@ -969,6 +1192,24 @@ enum class ChannelState : uint8_t {
  */
 using ChannelConfigArray = std::array<ChannelConfig, NUM_CHANNELS_>;
 
+/**
+ * @brief Complete writable device configuration for Initialize(const DeviceImage&)
+ *
+ * STATUS (fault masks, FREQM, channel-pair modes), all eight CFG_CHx and
+ * CFG_DPM. status.active and status.channels_on_mask are applied last, after
+ * the rest has been written and read back.
+ */
+struct DeviceImage {
+  StatusConfig status;          ///< STATUS; ACTIVE and ONCH are applied last
+  ChannelConfigArray channels;  ///< CFG_CH0..CFG_CH7
+  DpmConfig dpm;                ///< CFG_DPM
+
+  DeviceImage() : status(), channels(), dpm() {
+    status.active = true;
+    status.communication_error_masked = true;  // Reset default, as Initialize()
+  }
+};
+
 /**
  * @brief Callback function type for fault events
  */
@@ -1084,7 +1325,7 @@ struct DriverStatistics {
   uint32_t failed_transfers;
   uint32_t fault_events;
   uint32_t state_changes;
-  uint32_t uptime_ms;
+  uint32_t uptime_ms;         ///< ms since Initialize(), advanced by GetStatistics()
 
   DriverStatistics()
       : total_transfers(0), failed_transfers(0), fault_events(0),
@@ -0,0 +1,214 @@
+/**
+ * @file max22200_valve_map.hpp
+ * @brief Logical valve addressing across MAX22200 devices with per-device ONCH masks
+ *
+ * Applications name valves, not (device, channel) pairs. Switching a group
+ * with SetChannelEnabled() per valve costs one ONCH write per valve. ValveMap
+ * holds the logical → physical table in flat arrays sized at compile time
+ * (device and ONCH bit per valve) and compiles any set of valves into one
+ * set / clear mask per device. Applying it is at most one SetChannelsOn()
+ * (one 8-bit STATUS write) per device, whatever the group size, and none for
+ * a device whose ONCH would not change. Channels not mapped to a valve keep
+ * their state.
+ *
+ * Groups used repeatedly can be defined once; their masks are compiled at
+ * DefineGroup() and SetGroup() only merges them with the current ONCH.
+ *
+ * @code
+ * ValveMap<MAX22200<MySpi>> valves;
+ * valves.AttachDevice(0, dev_a);
+ * valves.AttachDevice(1, dev_b);
+ * for (uint8_t v = 0; v < 16; ++v) valves.Map(v, v / 8, v % 8);
+ * valves.DefineGroup(0, ValveSetOf(0, 3, 9, 12));
+ * valves.SetGroup(0, true);                  // two writes: one per device
+ * valves.Switch(ValveBit(5), ValveBit(12));  // valve 5 on, valve 12 off
+ * @endcode
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+#pragma once
+#include "max22200_types.hpp"
+#include <cstdint>
+
+namespace max22200 {
+
+/// Set of logical valves (bit N = valve N)
+using ValveSet = uint64_t;
+
+/** @brief ValveSet bit of valve @p valve */
+constexpr ValveSet ValveBit(uint8_t valve) { return valve < 64 ? 1ull << valve : 0; }
+
+/** @brief ValveSet of the given valve indices */
+template <typename... Valves>
+constexpr ValveSet ValveSetOf(Valves... valves) {
+  return (ValveSet{0} | ... | ValveBit(static_cast<uint8_t>(valves)));
+}
+
+/**
+ * @brief ONCH change for each device: bits to set and bits to clear
+ */
+template <uint8_t MAX_DEVICES>
+struct DeviceOnchMasks {
+  uint8_t on[MAX_DEVICES];   ///< ONCH bits to set
+  uint8_t off[MAX_DEVICES];  ///< ONCH bits to clear
+  uint8_t devices;           ///< Devices with any bit to change (bit d = device d)
+
+  DeviceOnchMasks() : on{}, off{}, devices(0) {}
+
+  /** @brief New ONCH of device @p d from its @p current ONCH */
+  uint8_t Apply(uint8_t d, uint8_t current) const {
+    return static_cast<uint8_t>((current & ~off[d]) | on[d]);
+  }
+};
+
+/**
+ * @class ValveMap
+ * @brief Logical valve → (device, channel) table with per-device mask compilation
+ *
+ * @tparam Driver      MAX22200<SpiType>
+ * @tparam MAX_DEVICES Devices that can be attached (at most 8)
+ * @tparam MAX_VALVES  Logical valves (at most 64)
+ * @tparam MAX_GROUPS  Precompiled groups
+ */
+template <typename Driver, uint8_t MAX_DEVICES = 4, uint8_t MAX_VALVES = 32,
+          uint8_t MAX_GROUPS = 8>
+class ValveMap {
+  static_assert(MAX_DEVICES >= 1 && MAX_DEVICES <= 8, "device set is 8-bit");
+  static_assert(MAX_VALVES <= 64, "ValveSet is 64-bit");
+
+public:
+  using Masks = DeviceOnchMasks<MAX_DEVICES>;
+
+  ValveMap() : drivers_{}, device_of_{}, bit_of_{}, mapped_(0), groups_{}, group_sets_{} {}
+
+  /** @brief Attach @p driver as device @p device (false if out of range) */
+  bool AttachDevice(uint8_t device, Driver &driver) {
+    if (device >= MAX_DEVICES) return false;
+    drivers_[device] = &driver;
+    return true;
+  }
+
+  /**
+   * @brief Map logical @p valve to (@p device, @p channel)
+   *
+   * @return false if an index is out of range, the device is not attached or
+   *         another valve already uses the channel. Groups containing the
+   *         valve must be defined again.
+   */
+  bool Map(uint8_t valve, uint8_t device, uint8_t channel) {
+    if (valve >= MAX_VALVES || device >= MAX_DEVICES || channel >= NUM_CHANNELS_ ||
+        drivers_[device] == nullptr) {
+      return false;
+    }
+    const uint8_t bit = static_cast<uint8_t>(1u << channel);
+    for (ValveSet m = mapped_ & ~ValveBit(valve); m != 0; m &= m - 1) {
+      const uint8_t v = lowestBit(m);
+      if (device_of_[v] == device && bit_of_[v] == bit) return false;
+    }
+    device_of_[valve] = device;
+    bit_of_[valve] = bit;
+    mapped_ |= ValveBit(valve);
+    return true;
+  }
+
+  /** @brief Remove @p valve from the table (its channel keeps its state) */
+  void Unmap(uint8_t valve) { mapped_ &= ~ValveBit(valve); }
+
+  /** @brief Valves with a mapping */
+  ValveSet GetMapped() const { return mapped_; }
+
+  /**
+   * @brief Compile: valves in @p on switched on, valves in @p off switched off
+   *
+   * Unmapped valves are ignored; a valve in both sets ends up on.
+   */
+  Masks Compile(ValveSet on, ValveSet off) const {
+    Masks masks;
+    for (ValveSet m = off & mapped_; m != 0; m &= m - 1) {
+      const uint8_t v = lowestBit(m);
+      masks.off[device_of_[v]] |= bit_of_[v];
+      masks.devices |= static_cast<uint8_t>(1u << device_of_[v]);
+    }
+    for (ValveSet m = on & mapped_; m != 0; m &= m - 1) {
+      const uint8_t v = lowestBit(m);
+      masks.on[device_of_[v]] |= bit_of_[v];
+      masks.devices |= static_cast<uint8_t>(1u << device_of_[v]);
+    }
+    return masks;
+  }
+
+  /**
+   * @brief Write @p masks: at most one SetChannelsOn() per device
+   *
+   * Devices whose ONCH would not change are skipped. Every device is tried;
+   * the last error is returned.
+   */
+  DriverStatus Apply(const Masks &masks) {
+    DriverStatus result = DriverStatus::OK;
+    for (uint8_t devices = masks.devices; devices != 0;
+         devices &= static_cast<uint8_t>(devices - 1)) {
+      const uint8_t d = lowestBit(devices);
+      Driver &driver = *drivers_[d];
+      const uint8_t current = driver.GetChannelsOnMask();
+      const uint8_t next = masks.Apply(d, current);
+      if (next == current) continue;
+      const DriverStatus s = driver.SetChannelsOn(next);
+      if (s != DriverStatus::OK) result = s;
+    }
+    return result;
+  }
+
+  /** @brief Switch @p on valves on and @p off valves off; others unchanged */
+  DriverStatus Switch(ValveSet on, ValveSet off) { return Apply(Compile(on, off)); }
+
+  /** @brief Exactly the mapped valves in @p on are on */
+  DriverStatus Assign(ValveSet on) { return Apply(Compile(on, mapped_ & ~on)); }
+
+  /** @brief Switch one valve */
+  DriverStatus SetValve(uint8_t valve, bool on) {
+    if ((mapped_ & ValveBit(valve)) == 0) return DriverStatus::INVALID_PARAMETER;
+    return on ? Switch(ValveBit(valve), 0) : Switch(0, ValveBit(valve));
+  }
+
+  /** @brief Valve on, from the drivers' ONCH caches (no SPI) */
+  bool IsOn(uint8_t valve) const {
+    if ((mapped_ & ValveBit(valve)) == 0) return false;
+    return (drivers_[device_of_[valve]]->GetChannelsOnMask() & bit_of_[valve]) != 0;
+  }
+
+  // ── Groups ─────────────────────────────────────────────────────────────
+
+  /**
+   * @brief Precompile group @p group from @p valves
+   * @return false if @p group is out of range
+   */
+  bool DefineGroup(uint8_t group, ValveSet valves) {
+    if (group >= MAX_GROUPS) return false;
+    groups_[group] = Compile(valves, 0);
+    group_sets_[group] = valves & mapped_;
+    return true;
+  }
+
+  /** @brief Switch every valve of @p group on or off; others unchanged */
+  DriverStatus SetGroup(uint8_t group, bool on) {
+    if (group >= MAX_GROUPS) return DriverStatus::INVALID_PARAMETER;
+    if (on) return Apply(groups_[group]);
+    Masks off;
+    for (uint8_t d = 0; d < MAX_DEVICES; ++d) off.off[d] = groups_[group].on[d];
+    off.devices = groups_[group].devices;
+    return Apply(off);
+  }
+
+  /** @brief Valves of @p group (0 if undefined) */
+  ValveSet GetGroup(uint8_t group) const { return group < MAX_GROUPS ? group_sets_[group] : 0; }
+
+private:
+  Driver *drivers_[MAX_DEVICES];
+  uint8_t device_of_[MAX_VALVES];  ///< Device of each valve
+  uint8_t bit_of_[MAX_VALVES];     ///< ONCH bit of each valve
+  ValveSet mapped_;
+  Masks groups_[MAX_GROUPS];       ///< Compiled "on" masks of each group
+  ValveSet group_sets_[MAX_GROUPS];
+};
+
+} // namespace max22200
@@ -21,16 +21,40 @@ namespace max22200 {
 template <typename SpiType>
 MAX22200<SpiType>::MAX22200(SpiType &spi_interface)
     : spi_interface_(spi_interface), initialized_(false), statistics_(),
-      last_fault_byte_(0xFF), cached_status_(), board_config_(),
+      last_fault_byte_(0xFF), fault_byte_seq_(0), fault_byte_us_(0), onch_armed_(false), cached_status_(), board_config_(),
       fault_callback_(nullptr), fault_user_data_(nullptr),
-      state_callback_(nullptr), state_user_data_(nullptr) {}
+      fault_event_callback_(nullptr), fault_event_user_data_(nullptr), fault_filter_(),
+      state_callback_(nullptr), state_user_data_(nullptr), channel_state_{},
+      hit_start_us_{}, hit_time_us_{}, hit_known_mask_(0), hit_pending_mask_(0),
+      state_onch_(0), state_fault_mask_(0), cfg_shadow_{}, cfg_shadow_valid_mask_(0),
+      uptime_last_us_(0), uptime_rem_us_(0), calibration_{}, cal_scale_{}, cal_mask_(0),
+      audit_log_(nullptr), audit_tag_(0),
+      rule_table_(nullptr), rule_armed_(0), rule_due_us_{}, rules_busy_(false),
+      rule_pending_(0), rule_pending_us_(0),
+      reaction_{}, react_keys_(0), react_off_keys_(0), react_quarantine_keys_(0),
+      react_retry_mask_(0), react_shed_types_(0), hit_retried_mask_(0), quarantine_mask_(0),
+      quarantine_start_us_{}, quarantine_us_{}, react_pending_keys_(0), react_pending_us_(0),
+      status_word_(0), status_word_us_(0), fault_word_(0), fault_word_us_(0),
+      status_word_valid_(false), fault_word_valid_(false) {}
 
 template <typename SpiType>
 MAX22200<SpiType>::MAX22200(SpiType &spi_interface, const BoardConfig &board_config)
     : spi_interface_(spi_interface), initialized_(false), statistics_(),
-      last_fault_byte_(0xFF), cached_status_(), board_config_(board_config),
+      last_fault_byte_(0xFF), fault_byte_seq_(0), fault_byte_us_(0), onch_armed_(false), cached_status_(), board_config_(board_config),
       fault_callback_(nullptr), fault_user_data_(nullptr),
-      state_callback_(nullptr), state_user_data_(nullptr) {}
+      fault_event_callback_(nullptr), fault_event_user_data_(nullptr), fault_filter_(),
+      state_callback_(nullptr), state_user_data_(nullptr), channel_state_{},
+      hit_start_us_{}, hit_time_us_{}, hit_known_mask_(0), hit_pending_mask_(0),
+      state_onch_(0), state_fault_mask_(0), cfg_shadow_{}, cfg_shadow_valid_mask_(0),
+      uptime_last_us_(0), uptime_rem_us_(0), calibration_{}, cal_scale_{}, cal_mask_(0),
+      audit_log_(nullptr), audit_tag_(0),
+      rule_table_(nullptr), rule_armed_(0), rule_due_us_{}, rules_busy_(false),
+      rule_pending_(0), rule_pending_us_(0),
+      reaction_{}, react_keys_(0), react_off_keys_(0), react_quarantine_keys_(0),
+      react_retry_mask_(0), react_shed_types_(0), hit_retried_mask_(0), quarantine_mask_(0),
+      quarantine_start_us_{}, quarantine_us_{}, react_pending_keys_(0), react_pending_us_(0),
+      status_word_(0), status_word_us_(0), fault_word_(0), fault_word_us_(0),
+      status_word_valid_(false), fault_word_valid_(false) {}
 
 template <typename SpiType>
 MAX22200<SpiType>::~MAX22200() {
@@ -49,22 +73,12 @@ DriverStatus MAX22200<SpiType>::Initialize() {
     return DriverStatus::OK;
   }
 
-  // Step 0: Initialize SPI interface
-  if (!spi_interface_.Initialize()) {
+  // Steps 0-1: SPI interface, ENABLE pin HIGH, power-up delay
+  if (!powerUp()) {
     updateStatistics(false);
     return DriverStatus::INITIALIZATION_ERROR;
   }
 
-  // Configure SPI: Mode 0 (CPOL=0, CPHA=0), MSB first
-  if (!spi_interface_.Configure(MAX_SPI_FREQ_STANDALONE_, 0, true)) {
-    updateStatistics(false);
-    return DriverStatus::INITIALIZATION_ERROR;
-  }
-
-  // Step 1: ENABLE pin HIGH, power-up delay
-  spi_interface_.GpioSetActive(CtrlPin::ENABLE);
-  spi_interface_.DelayUs(500); // 0.5ms power-up delay
-
   constexpr int kMaxInitRetries = 3;
   StatusConfig status;
   DriverStatus result;
@@ -118,6 +132,8 @@ DriverStatus MAX22200<SpiType>::Initialize() {
 
     cached_status_ = status;
     initialized_ = true;
+    uptime_last_us_ = spi_interface_.GetTimeUs();
+    uptime_rem_us_ = 0;
     updateStatistics(true);
     return DriverStatus::OK;
   }
@@ -128,6 +144,141 @@ DriverStatus MAX22200<SpiType>::Initialize() {
   return DriverStatus::COMMUNICATION_ERROR;
 }
 
+template <typename SpiType>
+DriverStatus MAX22200<SpiType>::Initialize(const DeviceImage &image) {
+  if (initialized_) {
+    return DriverStatus::OK;
+  }
+
+  // Step 0: Validate and encode everything before ENABLE goes HIGH
+  static const uint8_t banks[10] = {
+      RegBank::STATUS,  RegBank::CFG_CH0, RegBank::CFG_CH1, RegBank::CFG_CH2,
+      RegBank::CFG_CH3, RegBank::CFG_CH4, RegBank::CFG_CH5, RegBank::CFG_CH6,
+      RegBank::CFG_CH7, RegBank::CFG_DPM};
+  const bool master_clock_80khz = image.status.master_clock_80khz;
+  uint32_t values[10];
+  StatusConfig config_status = image.status;
+  config_status.active = false;
+  config_status.channels_on_mask = 0x00;  // CMxy is only writable with the pair off
+  values[0] = config_status.toRegister();
+  for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+    if (!isChannelConfigWritable(image.channels[ch], master_clock_80khz)) {
+      updateStatistics(false);
+      return DriverStatus::INVALID_PARAMETER;
+    }
+    values[1 + ch] =
+        image.channels[ch].toRegister(board_config_.full_scale_current_ma, master_clock_80khz,
+                                      channelScale(ch));
+  }
+  values[9] = image.dpm.toRegister();
+
+  // Step 1: ENABLE pin HIGH, power-up delay
+  if (!powerUp()) {
+    updateStatistics(false);
+    return DriverStatus::INITIALIZATION_ERROR;
+  }
+
+  constexpr int kMaxInitRetries = 3;
+  DriverStatus result;
+  for (int attempt = 0; attempt < kMaxInitRetries; ++attempt) {
+    // Step 2: Write burst — STATUS (ACTIVE=0, ONCH=0), CFG_CH0..7, CFG_DPM
+    result = writeRegs32(banks, values, 10);
+    if (result != DriverStatus::OK) {
+      spi_interface_.GpioSetInactive(CtrlPin::ENABLE);
+      updateStatistics(false);
+      return result;
+    }
+
+    // Step 3: Verify burst — the STATUS read also clears UVM
+    uint32_t readback[10];
+    result = readRegs32(banks, readback, 10);
+    if (result != DriverStatus::OK) {
+      spi_interface_.GpioSetInactive(CtrlPin::ENABLE);
+      updateStatistics(false);
+      return result;
+    }
+    if (GetLastFaultByte() == StatusReg::FAULT_BYTE_COMER) {
+      continue; // Communication error — retry per datasheet Figure 6
+    }
+    bool match = (readback[0] & ~StatusReg::FAULT_FLAGS_MASK) == values[0];
+    for (uint8_t i = 1; i < 10 && match; ++i) {
+      match = readback[i] == values[i];
+    }
+    if (!match) {
+      continue; // A frame was corrupted — write the image again
+    }
+
+    // Step 4: ACTIVE and ONCH last, once the configuration is known good
+    StatusConfig status;
+    status.fromRegister(readback[0]);
+    status.active = image.status.active;
+    status.channels_on_mask = image.status.channels_on_mask;
+    result = WriteStatus(status);
+    if (result != DriverStatus::OK) {
+      spi_interface_.GpioSetInactive(CtrlPin::ENABLE);
+      updateStatistics(false);
+      return result;
+    }
+
+    // Step 5: Verify STATUS — COMER for the write shows in the fault byte and in
+    // STATUS[7:0] (the fault byte is 0x05, not 0x04, once ACTIVE is set)
+    uint32_t final_status;
+    result = readReg32(RegBank::STATUS, final_status);
+    if (result != DriverStatus::OK) {
+      spi_interface_.GpioSetInactive(CtrlPin::ENABLE);
+      updateStatistics(false);
+      return result;
+    }
+    if (GetLastFaultByte() == StatusReg::FAULT_BYTE_COMER ||
+        (final_status & StatusReg::COMER_BIT) != 0 ||
+        (final_status & ~StatusReg::FAULT_FLAGS_MASK) !=
+            (status.toRegister() & ~StatusReg::FAULT_FLAGS_MASK)) {
+      continue; // The next burst writes ACTIVE=0, ONCH=0 first
+    }
+
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+      ChannelConfig applied;
+      applied.fromRegister(values[1 + ch], board_config_.full_scale_current_ma,
+                           master_clock_80khz, channelScale(ch));
+      trackHitTime(ch, applied);
+    }
+    initialized_ = true;
+    uptime_last_us_ = spi_interface_.GetTimeUs();
+    uptime_rem_us_ = 0;
+    updateStatistics(true);
+    return DriverStatus::OK;
+  }
+
+  // COMER or readback mismatch persisted after all retries
+  spi_interface_.GpioSetInactive(CtrlPin::ENABLE);
+  updateStatistics(false);
+  return DriverStatus::COMMUNICATION_ERROR;
+}
+
+template <typename SpiType>
+bool MAX22200<SpiType>::powerUp() {
+  resetChannelStates();
+  cfg_shadow_valid_mask_ = 0;
+  dropReadCache();
+  fault_filter_.Reset();
+  hit_retried_mask_ = 0;
+  quarantine_mask_ = 0;
+  react_pending_keys_ = 0;
+  rule_armed_ = 0;
+  rule_pending_ = 0;
+
+  // Initialize SPI interface, Mode 0 (CPOL=0, CPHA=0), MSB first
+  if (!spi_interface_.Initialize() ||
+      !spi_interface_.Configure(MAX_SPI_FREQ_STANDALONE_, 0, true)) {
+    return false;
+  }
+
+  // ENABLE pin HIGH, power-up delay
+  spi_interface_.GpioSetActive(CtrlPin::ENABLE);
+  spi_interface_.DelayUs(500); // 0.5ms power-up delay (tEN)
+  return true;
+}
+
 template <typename SpiType>
 DriverStatus MAX22200<SpiType>::Deinitialize() {
   if (!initialized_) {
@@ -144,6 +295,7 @@ DriverStatus MAX22200<SpiType>::Deinitialize() {
 
   // ENABLE pin LOW
   spi_interface_.GpioSetInactive(CtrlPin::ENABLE);
+  dropReadCache();
 
   initialized_ = false;
   updateStatistics(true);
@@ -166,20 +318,62 @@ DriverStatus MAX22200<SpiType>::ReadStatus(StatusConfig &status) const {
   if (result == DriverStatus::OK) {
     status.fromRegister(raw);
     cached_status_ = status;  // Keep cache in sync for FREQM, ONCH, duty limits, etc.
+    trackOnch(status.channels_on_mask);
+    queueRules(reportFaults(FaultEventFilter::KeyBits(status)), 0, 0, 0);
   }
   return result;
 }
 
+template <typename SpiType>
+DriverStatus MAX22200<SpiType>::ReadStatus(StatusConfig &status, uint32_t max_age_us) const {
+  if (status_word_valid_ && max_age_us != 0 &&
+      spi_interface_.GetTimeUs() - status_word_us_ < max_age_us) {
+    status.fromRegister(status_word_);
+    return DriverStatus::OK;
+  }
+  return ReadStatus(status);
+}
+
 template <typename SpiType>
 DriverStatus MAX22200<SpiType>::WriteStatus(const StatusConfig &status) {
-  uint32_t raw = status.toRegister();
+  StatusConfig applied = status;
+  applied.channels_on_mask &= static_cast<uint8_t>(~blockedChannels());
+  uint32_t raw = applied.toRegister();
   DriverStatus result = writeReg32(RegBank::STATUS, raw);
   if (result == DriverStatus::OK) {
-    cached_status_ = status;  // Keep cache in sync so FREQM, ONCH, etc. are correct for calculations
+    cached_status_ = applied;  // Keep cache in sync so FREQM, ONCH, etc. are correct for calculations
+    trackOnch(applied.channels_on_mask);
   }
   return result;
 }
 
+template <typename SpiType>
+DriverStatus MAX22200<SpiType>::SetFaultPinMask(uint8_t type_bits) {
+  StatusConfig status = cached_status_;
+  status.overcurrent_masked = (type_bits & FaultTypeBit(FaultType::OCP)) != 0;
+  status.hit_not_reached_masked = (type_bits & FaultTypeBit(FaultType::HHF)) != 0;
+  status.open_load_fault_masked = (type_bits & FaultTypeBit(FaultType::OLF)) != 0;
+  status.plunger_movement_fault_masked = (type_bits & FaultTypeBit(FaultType::DPM)) != 0;
+  status.overtemperature_masked = (type_bits & FaultTypeBit(FaultType::OVT)) != 0;
+  status.undervoltage_masked = (type_bits & FaultTypeBit(FaultType::UVM)) != 0;
+  status.communication_error_masked = (type_bits & FaultTypeBit(FaultType::COMER)) != 0;
+  DriverStatus result = WriteStatus(status);
+  updateStatistics(result == DriverStatus::OK);
+  return result;
+}
+
+template <typename SpiType>
+uint8_t MAX22200<SpiType>::GetFaultPinMask() const {
+  const StatusConfig &s = cached_status_;
+  return static_cast<uint8_t>((s.overcurrent_masked ? FaultTypeBit(FaultType::OCP) : 0) |
+                              (s.hit_not_reached_masked ? FaultTypeBit(FaultType::HHF) : 0) |
+                              (s.open_load_fault_masked ? FaultTypeBit(FaultType::OLF) : 0) |
+                              (s.plunger_movement_fault_masked ? FaultTypeBit(FaultType::DPM) : 0) |
+                              (s.overtemperature_masked ? FaultTypeBit(FaultType::OVT) : 0) |
+                              (s.undervoltage_masked ? FaultTypeBit(FaultType::UVM) : 0) |
+                              (s.communication_error_masked ? FaultTypeBit(FaultType::COMER) : 0));
+}
+
 // ============================================================================
 // Channel Configuration
 // ============================================================================
@@ -192,25 +386,38 @@ DriverStatus MAX22200<SpiType>::ConfigureChannel(uint8_t channel,
     return DriverStatus::INVALID_PARAMETER;
   }
 
-  // CDR requires board IFS (from SetBoardConfig); IFS is set by RREF, not per channel
-  if (config.drive_mode == DriveMode::CDR && board_config_.full_scale_current_ma == 0) {
-    updateStatistics(false);
-    return DriverStatus::INVALID_PARAMETER;  // Call SetBoardConfig with RREF first
-  }
-
-  // Datasheet: SRC mode only for fCHOP < 50 kHz
-  if (config.slew_rate_control_enabled &&
-      getChopFreqKhz(cached_status_.master_clock_80khz, config.chop_freq) >= 50) {
+  if (!isChannelConfigWritable(config, cached_status_.master_clock_80khz)) {
     updateStatistics(false);
     return DriverStatus::INVALID_PARAMETER;
   }
 
-  uint32_t reg_val = config.toRegister(board_config_.full_scale_current_ma, cached_status_.master_clock_80khz);
+  uint32_t reg_val = config.toRegister(board_config_.full_scale_current_ma,
+                                       cached_status_.master_clock_80khz, channelScale(channel));
   DriverStatus result = writeReg32(getChannelCfgBank(channel), reg_val);
+  if (result == DriverStatus::OK) {
+    // HIT time as the device will apply it (quantised / clamped)
+    ChannelConfig applied;
+    applied.fromRegister(reg_val, board_config_.full_scale_current_ma,
+                         cached_status_.master_clock_80khz, channelScale(channel));
+    trackHitTime(channel, applied);
+    hit_retried_mask_ &= static_cast<uint8_t>(~(1u << channel));
+  }
   updateStatistics(result == DriverStatus::OK);
   return result;
 }
 
+template <typename SpiType>
+bool MAX22200<SpiType>::isChannelConfigWritable(const ChannelConfig &config,
+                                                bool master_clock_80khz) const {
+  // CDR requires board IFS (from SetBoardConfig); IFS is set by RREF, not per channel
+  if (config.drive_mode == DriveMode::CDR && board_config_.full_scale_current_ma == 0) {
+    return false;  // Call SetBoardConfig with RREF first
+  }
+  // Datasheet: SRC mode only for fCHOP < 50 kHz
+  return !config.slew_rate_control_enabled ||
+         getChopFreqKhz(master_clock_80khz, config.chop_freq) < 50;
+}
+
 template <typename SpiType>
 DriverStatus MAX22200<SpiType>::GetChannelConfig(uint8_t channel,
                                                   ChannelConfig &config) const {
@@ -223,7 +430,9 @@ DriverStatus MAX22200<SpiType>::GetChannelConfig(uint8_t channel,
   DriverStatus result = readReg32(getChannelCfgBank(channel), raw);
   if (result == DriverStatus::OK) {
     // Pass context (IFS and FREQM) for proper conversion to user units
-    config.fromRegister(raw, board_config_.full_scale_current_ma, cached_status_.master_clock_80khz);
+    config.fromRegister(raw, board_config_.full_scale_current_ma,
+                        cached_status_.master_clock_80khz, channelScale(channel));
+    trackHitTime(channel, config);
   }
   updateStatistics(result == DriverStatus::OK);
   return result;
@@ -245,14 +454,30 @@ DriverStatus MAX22200<SpiType>::ConfigureAllChannels(
 template <typename SpiType>
 DriverStatus MAX22200<SpiType>::GetAllChannelConfigs(
     ChannelConfigArray &configs) const {
-  DriverStatus status = DriverStatus::OK;
-  for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
-    DriverStatus result = GetChannelConfig(ch, configs[ch]);
-    if (result != DriverStatus::OK) {
-      status = result;
+  static const uint8_t banks[NUM_CHANNELS_] = {
+      RegBank::CFG_CH0, RegBank::CFG_CH1, RegBank::CFG_CH2, RegBank::CFG_CH3,
+      RegBank::CFG_CH4, RegBank::CFG_CH5, RegBank::CFG_CH6, RegBank::CFG_CH7};
+  uint32_t raw[NUM_CHANNELS_];
+  DriverStatus result = readRegs32(banks, raw, NUM_CHANNELS_);
+  if (result == DriverStatus::OK) {
+    const uint32_t ifs_ma = board_config_.full_scale_current_ma;
+    const bool master_clock_80khz = cached_status_.master_clock_80khz;
+    for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+      configs[ch].fromRegister(raw[ch], ifs_ma, master_clock_80khz, channelScale(ch));
+      trackHitTime(ch, configs[ch]);
     }
   }
-  return status;
+  updateStatistics(result == DriverStatus::OK);
+  return result;
+}
+
+template <typename SpiType>
+DriverStatus MAX22200<SpiType>::GetCachedChannelRegister(uint8_t channel, uint32_t &raw) const {
+  if (!IsValidChannel(channel) || (cfg_shadow_valid_mask_ & (1u << channel)) == 0) {
+    return DriverStatus::INVALID_PARAMETER;
+  }
+  raw = cfg_shadow_[channel];
+  return DriverStatus::OK;
 }
 
 // ============================================================================
@@ -301,12 +526,80 @@ DriverStatus MAX22200<SpiType>::SetAllChannelsEnabled(bool enable) {
 
 template <typename SpiType>
 DriverStatus MAX22200<SpiType>::SetChannelsOn(uint8_t channel_mask) {
+  channel_mask &= static_cast<uint8_t>(~blockedChannels());
   cached_status_.channels_on_mask = channel_mask;
   DriverStatus result = writeReg8(RegBank::STATUS, channel_mask);
+  if (result == DriverStatus::OK) {
+    trackOnch(channel_mask);
+  }
   updateStatistics(result == DriverStatus::OK);
   return result;
 }
 
+template <typename SpiType>
+DriverStatus MAX22200<SpiType>::ArmChannelsOn() {
+  const uint32_t audit_slot =
+      auditWrite(RegBank::STATUS, 0, AuditEntry::WRITE8 | AuditEntry::COMMAND);
+  const DriverStatus result = writeCommandRegister(RegBank::STATUS, true, true);
+  if (result != DriverStatus::OK && audit_log_ != nullptr) {
+    audit_log_->MarkFailed(audit_slot);
+  }
+  updateStatistics(result == DriverStatus::OK);
+  return result;
+}
+
+template <typename SpiType>
+DriverStatus MAX22200<SpiType>::CommitChannelsOn(uint8_t channel_mask) {
+  if (!onch_armed_) {
+    updateStatistics(false);
+    return DriverStatus::INVALID_PARAMETER;
+  }
+  channel_mask = FilterChannelsOn(channel_mask);
+  const uint32_t audit_slot = auditWrite(RegBank::STATUS, channel_mask, AuditEntry::WRITE8);
+  const DriverStatus result = SendChannelsOnFrame(channel_mask);
+  if (result != DriverStatus::OK && audit_log_ != nullptr) {
+    audit_log_->MarkFailed(audit_slot);
+  }
+  completeChannelsOn(channel_mask, result);
+  return result;
+}
+
+template <typename SpiType>
+uint8_t MAX22200<SpiType>::FilterChannelsOn(uint8_t channel_mask) const {
+  return static_cast<uint8_t>(channel_mask & ~blockedChannels());
+}
+
+template <typename SpiType>
+DriverStatus MAX22200<SpiType>::SendChannelsOnFrame(uint8_t channel_mask) {
+  if (!onch_armed_) {
+    return DriverStatus::INVALID_PARAMETER;
+  }
+  const DriverStatus result = writeData8(channel_mask);
+  if (result != DriverStatus::OK) {
+    onch_armed_ = false;  // Frame boundary unknown; re-send the command
+  }
+  return result;
+}
+
+template <typename SpiType>
+void MAX22200<SpiType>::FinishChannelsOn(uint8_t channel_mask, DriverStatus frame_result) {
+  if (frame_result != DriverStatus::INVALID_PARAMETER) {
+    const uint8_t failed = frame_result == DriverStatus::OK ? 0 : AuditEntry::FAILED;
+    auditWrite(RegBank::STATUS, channel_mask, AuditEntry::WRITE8 | failed);
+  }
+  completeChannelsOn(channel_mask, frame_result);
+}
+
+template <typename SpiType>
+void MAX22200<SpiType>::completeChannelsOn(uint8_t channel_mask, DriverStatus result) {
+  if (result == DriverStatus::OK) {
+    cached_status_.channels_on_mask = channel_mask;
+    shadowRegister(RegBank::STATUS, static_cast<uint32_t>(channel_mask) << 24, true, true);
+    trackOnch(channel_mask);
+  }
+  updateStatistics(result == DriverStatus::OK);
+}
+
 template <typename SpiType>
 DriverStatus MAX22200<SpiType>::SetFullBridgeState(uint8_t pair_index,
                                                   FullBridgeState state) {
@@ -348,11 +641,23 @@ DriverStatus MAX22200<SpiType>::ReadFaultRegister(FaultStatus &faults) const {
   DriverStatus result = readReg32(RegBank::FAULT, raw);
   if (result == DriverStatus::OK) {
     faults.fromRegister(raw);
+    trackFaults(faults);
   }
   updateStatistics(result == DriverStatus::OK);
   return result;
 }
 
+template <typename SpiType>
+DriverStatus MAX22200<SpiType>::ReadFaultRegister(FaultStatus &faults,
+                                                   uint32_t max_age_us) const {
+  if (fault_word_valid_ && max_age_us != 0 &&
+      spi_interface_.GetTimeUs() - fault_word_us_ < max_age_us) {
+    faults.fromRegister(fault_word_);
+    return DriverStatus::OK;
+  }
+  return ReadFaultRegister(faults);
+}
+
 template <typename SpiType>
 DriverStatus MAX22200<SpiType>::ClearAllFaults() {
   FaultStatus f;
@@ -384,7 +689,29 @@ DriverStatus MAX22200<SpiType>::ReadFaultRegisterSelectiveClear(
   uint32_t raw;
   result = readData32WithTx(tx, raw);
   if (result == DriverStatus::OK) {
+    shadowRegister(RegBank::FAULT, raw, false, false);
     faults.fromRegister(raw);
+    trackFaults(faults);
+  }
+  updateStatistics(result == DriverStatus::OK);
+  return result;
+}
+
+template <typename SpiType>
+DriverStatus MAX22200<SpiType>::ReadSnapshot(Snapshot &snap, uint8_t clear_mask) const {
+  static const uint8_t banks[2] = {RegBank::STATUS, RegBank::FAULT};
+  const uint8_t tx[2][4] = {{0, 0, 0, 0}, {clear_mask, clear_mask, clear_mask, clear_mask}};
+  uint32_t raw[2];
+  snap.timestamp_us = spi_interface_.GetTimeUs();
+  DriverStatus result = readRegs32(banks, raw, 2, tx);
+  if (result == DriverStatus::OK) {
+    snap.status_raw = raw[0];
+    snap.status.fromRegister(raw[0]);
+    snap.faults.fromRegister(raw[1]);
+    snap.fault_byte = last_fault_byte_;
+    cached_status_ = snap.status;
+    trackOnch(snap.status.channels_on_mask);
+    trackFaults(snap.faults, FaultEventFilter::KeyBits(snap.status));
   }
   updateStatistics(result == DriverStatus::OK);
   return result;
@@ -406,6 +733,161 @@ DriverStatus MAX22200<SpiType>::ClearFaultFlags() {
   return result;
 }
 
+// ============================================================================
+// Fault Reactions
+// ============================================================================
+
+template <typename SpiType>
+DriverStatus MAX22200<SpiType>::SetFaultReaction(FaultType type,
+                                                 const FaultReactionPolicy &policy) {
+  if (!policy.isValidFor(type)) {
+    return DriverStatus::INVALID_PARAMETER;
+  }
+  const uint8_t t = static_cast<uint8_t>(type);
+  reaction_[t] = policy;
+
+  // Precompute the key masks the fault path tests
+  react_keys_ = 0;
+  react_off_keys_ = 0;
+  react_quarantine_keys_ = 0;
+  react_retry_mask_ = 0;
+  react_shed_types_ = 0;
+  for (uint8_t i = 0; i <= static_cast<uint8_t>(FaultType::COMER); ++i) {
+    const FaultType ft = static_cast<FaultType>(i);
+    const uint64_t type_keys = (i < 4) ? (0xFFull << FaultEventFilter::KeyOf(0, ft))
+                                       : (1ull << FaultEventFilter::KeyOf(0, ft));
+    switch (reaction_[i].action) {
+      case FaultReaction::QUARANTINE:
+        react_quarantine_keys_ |= static_cast<uint32_t>(type_keys);
+        react_off_keys_ |= static_cast<uint32_t>(type_keys);
+        break;
+      case FaultReaction::CHANNEL_OFF:
+        react_off_keys_ |= static_cast<uint32_t>(type_keys);
+        break;
+      case FaultReaction::HIT_STEP_RETRY:
+        react_retry_mask_ = 0xFF;
+        break;
+      case FaultReaction::SHED:
+        react_shed_types_ |= static_cast<uint8_t>(1u << i);
+        break;
+      default:
+        continue;
+    }
+    react_keys_ |= type_keys;
+  }
+  return DriverStatus::OK;
+}
+
+template <typename SpiType>
+FaultReactionPolicy MAX22200<SpiType>::GetFaultReaction(FaultType type) const {
+  const uint8_t t = static_cast<uint8_t>(type);
+  return t <= static_cast<uint8_t>(FaultType::COMER) ? reaction_[t] : FaultReactionPolicy();
+}
+
+template <typename SpiType>
+void MAX22200<SpiType>::ClearFaultReactions() {
+  for (uint8_t i = 0; i <= static_cast<uint8_t>(FaultType::COMER); ++i) {
+    reaction_[i] = FaultReactionPolicy();
+  }
+  react_keys_ = 0;
+  react_off_keys_ = 0;
+  react_quarantine_keys_ = 0;
+  react_retry_mask_ = 0;
+  react_shed_types_ = 0;
+  hit_retried_mask_ = 0;
+  quarantine_mask_ = 0;
+  react_pending_keys_ = 0;
+}
+
+template <typename SpiType>
+uint8_t MAX22200<SpiType>::GetQuarantinedChannels() const {
+  return quarantine_mask_ != 0 ? activeQuarantine() : 0;
+}
+
+template <typename SpiType>
+void MAX22200<SpiType>::ReleaseQuarantine(uint8_t channel_mask) {
+  quarantine_mask_ &= static_cast<uint8_t>(~channel_mask);
+}
+
+template <typename SpiType>
+DriverStatus MAX22200<SpiType>::ServiceReactions() {
+  const RuleTable *table = initialized_ ? rule_table_ : nullptr;
+  const bool hold_watch = table != nullptr && (hit_pending_mask_ & table->GetHoldMask()) != 0;
+  if ((react_pending_keys_ | rule_pending_ | rule_armed_) == 0 && !hold_watch) {
+    return DriverStatus::OK;
+  }
+  uint8_t off = 0;
+  if (react_pending_keys_ != 0) {
+    const uint64_t keys = react_pending_keys_;
+    react_pending_keys_ = 0;
+    off = react(keys, react_pending_us_);
+  }
+  const uint8_t onch = cached_status_.channels_on_mask;
+  uint8_t next = static_cast<uint8_t>(onch & ~off);
+  const uint16_t queued = rule_pending_;
+  rule_pending_ = 0;
+  if (table != nullptr) {
+    const uint32_t now = spi_interface_.GetTimeUs();
+    const uint16_t immediate = table->GetImmediateMask();
+    // Queued delayed actions count from the call that matched them
+    armRules(static_cast<uint16_t>(queued & ~immediate), rule_pending_us_);
+    uint16_t due = 0;
+    for (uint16_t armed = rule_armed_; armed != 0; armed &= static_cast<uint16_t>(armed - 1)) {
+      const uint8_t r = lowestBit(armed);
+      if (static_cast<int32_t>(now - rule_due_us_[r]) >= 0) {
+        due |= static_cast<uint16_t>(1u << r);
+      }
+    }
+    rule_armed_ &= static_cast<uint16_t>(~due);
+    const uint8_t hold = hold_watch ? updateChannelStates(expireHitPhases(now)) : 0;
+    const uint16_t matched = static_cast<uint16_t>(
+        (queued & immediate) | table->Match(0, 0, static_cast<uint8_t>(onch & off), hold));
+    next = applyRules(next, matched, due, now);
+  }
+  if (next == onch) {
+    return DriverStatus::OK;
+  }
+
+  // Reaction offs and rule results: one ONCH write
+  rules_busy_ = true;  // Edges of this write were matched above
+  const DriverStatus result = writeReg8(RegBank::STATUS, next);
+  if (result == DriverStatus::OK) {
+    cached_status_.channels_on_mask = next;
+    trackOnch(next);
+  }
+  rules_busy_ = false;
+  updateStatistics(result == DriverStatus::OK);
+  return result;
+}
+
+template <typename SpiType>
+uint32_t MAX22200<SpiType>::GetReactionDelayUs() const {
+  if ((react_pending_keys_ | rule_pending_) != 0) {
+    return 0;
+  }
+  if (rule_table_ == nullptr) {
+    return UINT32_MAX;
+  }
+  const uint32_t now = spi_interface_.GetTimeUs();
+  uint32_t delay = UINT32_MAX;
+  for (uint16_t armed = rule_armed_; armed != 0; armed &= static_cast<uint16_t>(armed - 1)) {
+    const uint32_t due_us = rule_due_us_[lowestBit(armed)];
+    const int32_t left = static_cast<int32_t>(due_us - now);
+    delay = left <= 0 ? 0
+                      : (static_cast<uint32_t>(left) < delay ? static_cast<uint32_t>(left) : delay);
+  }
+  // HOLD rules: the end of the HIT phase of channels being watched
+  for (uint8_t pending = hit_pending_mask_ & rule_table_->GetHoldMask(); pending != 0;
+       pending &= static_cast<uint8_t>(pending - 1)) {
+    const uint8_t ch = lowestBit(pending);
+    if (hit_time_us_[ch] == UINT32_MAX) continue;  // Continuous HIT never ends
+    const int32_t left = static_cast<int32_t>(hit_start_us_[ch] + hit_time_us_[ch] - now);
+    delay = left <= 0 ? 0
+                      : (static_cast<uint32_t>(left) < delay ? static_cast<uint32_t>(left) : delay);
+  }
+  return delay;
+}
+
 template <typename SpiType>
 DriverStatus MAX22200<SpiType>::ReadDpmConfig(DpmConfig &config) const {
   uint32_t raw;
@@ -492,6 +974,7 @@ DriverStatus MAX22200<SpiType>::SetDeviceEnable(bool enable) {
     spi_interface_.GpioSetActive(CtrlPin::ENABLE);
   } else {
     spi_interface_.GpioSetInactive(CtrlPin::ENABLE);
+    dropReadCache();
   }
   updateStatistics(true);
   return DriverStatus::OK;
@@ -538,18 +1021,38 @@ uint8_t MAX22200<SpiType>::GetLastFaultByte() const {
   return last_fault_byte_;
 }
 
+template <typename SpiType>
+uint32_t MAX22200<SpiType>::GetFaultByteSequence() const {
+  return fault_byte_seq_;
+}
+
+template <typename SpiType>
+uint8_t MAX22200<SpiType>::GetChannelsOnMask() const {
+  return cached_status_.channels_on_mask;
+}
+
 // ============================================================================
 // Statistics
 // ============================================================================
 
 template <typename SpiType>
 DriverStatistics MAX22200<SpiType>::GetStatistics() const {
+  if (initialized_) {
+    // Accumulate elapsed time lazily; only the last 32-bit µs delta is kept
+    const uint32_t now_us = spi_interface_.GetTimeUs();
+    const uint32_t elapsed_us = (now_us - uptime_last_us_) + uptime_rem_us_;
+    uptime_last_us_ = now_us;
+    uptime_rem_us_ = elapsed_us % 1000u;
+    statistics_.uptime_ms += elapsed_us / 1000u;
+  }
   return statistics_;
 }
 
 template <typename SpiType>
 void MAX22200<SpiType>::ResetStatistics() {
   statistics_ = DriverStatistics{};
+  uptime_last_us_ = spi_interface_.GetTimeUs();
+  uptime_rem_us_ = 0;
 }
 
 // ============================================================================
@@ -563,6 +1066,13 @@ void MAX22200<SpiType>::SetFaultCallback(FaultCallback callback,
   fault_user_data_ = user_data;
 }
 
+template <typename SpiType>
+void MAX22200<SpiType>::SetFaultEventCallback(FaultEventCallback callback,
+                                              void *user_data) {
+  fault_event_callback_ = callback;
+  fault_event_user_data_ = user_data;
+}
+
 template <typename SpiType>
 void MAX22200<SpiType>::SetStateChangeCallback(StateChangeCallback callback,
                                                void *user_data) {
@@ -570,6 +1080,349 @@ void MAX22200<SpiType>::SetStateChangeCallback(StateChangeCallback callback,
   state_user_data_ = user_data;
 }
 
+// ============================================================================
+// Reactive Rules
+// ============================================================================
+
+template <typename SpiType>
+void MAX22200<SpiType>::SetRuleTable(const RuleTable *table) {
+  rule_table_ = table;
+  rule_armed_ = 0;
+  rule_pending_ = 0;
+}
+
+// ============================================================================
+// Register Write Audit
+// ============================================================================
+
+template <typename SpiType>
+void MAX22200<SpiType>::SetAuditLog(AuditLog *log) {
+  audit_log_ = log;
+}
+
+template <typename SpiType>
+void MAX22200<SpiType>::SetAuditTag(uint16_t tag) {
+  audit_tag_ = tag;
+}
+
+// ============================================================================
+// Channel State Tracking
+// ============================================================================
+
+template <typename SpiType>
+DriverStatus MAX22200<SpiType>::GetChannelState(uint8_t channel,
+                                                ChannelState &state) const {
+  if (!IsValidChannel(channel)) {
+    return DriverStatus::INVALID_PARAMETER;
+  }
+  UpdateChannelStates();
+  state = channel_state_[channel];
+  return DriverStatus::OK;
+}
+
+template <typename SpiType>
+void MAX22200<SpiType>::UpdateChannelStates() const {
+  if (hit_pending_mask_ == 0) {
+    return;
+  }
+  updateChannelStates(expireHitPhases(spi_interface_.GetTimeUs()));
+}
+
+template <typename SpiType>
+void MAX22200<SpiType>::trackOnch(uint8_t onch) const {
+  const uint8_t changed = state_onch_ ^ onch;
+  if (changed == 0 && hit_pending_mask_ == 0) {
+    return;
+  }
+  const uint32_t now_us = spi_interface_.GetTimeUs();
+  uint8_t candidates = expireHitPhases(now_us);
+  const uint8_t rising = changed & onch;
+  for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+    const uint8_t bit = static_cast<uint8_t>(1u << ch);
+    if ((rising & bit) != 0) {
+      hit_start_us_[ch] = now_us;
+      if ((hit_known_mask_ & bit) != 0 && hit_time_us_[ch] != 0) {
+        hit_pending_mask_ |= bit;
+      }
+    }
+  }
+  hit_pending_mask_ &= onch;
+  state_onch_ = onch;
+  const uint8_t hold = updateChannelStates(candidates | changed);
+  if (rule_table_ != nullptr) {
+    queueRules(0, rising, static_cast<uint8_t>(changed & ~onch), hold);
+  }
+}
+
+template <typename SpiType>
+void MAX22200<SpiType>::trackFaults(const FaultStatus &faults, uint64_t device_keys) const {
+  const uint8_t mask = faults.channelsWithAnyFault();
+  const uint8_t changed = state_fault_mask_ ^ mask;
+  const uint8_t expired =
+      hit_pending_mask_ != 0 ? expireHitPhases(spi_interface_.GetTimeUs()) : 0;
+  state_fault_mask_ = mask;
+  const uint8_t hold = updateChannelStates(expired | changed);
+  const uint64_t opened = reportFaults(FaultEventFilter::KeyBits(faults) | device_keys);
+  if (rule_table_ != nullptr) {
+    queueRules(opened, 0, 0, hold);
+  }
+}
+
+template <typename SpiType>
+uint64_t MAX22200<SpiType>::reportFaults(uint64_t keys) const {
+  // Steady state without faults: nothing observed, nothing open to expire
+  if ((keys | fault_filter_.GetOpenMask()) == 0 || !initialized_) {
+    return 0;
+  }
+  const uint32_t now = spi_interface_.GetTimeUs();
+  if ((keys & react_keys_) != 0) {
+    // Queued for ServiceReactions(); a read never writes
+    if (react_pending_keys_ == 0) react_pending_us_ = now;
+    react_pending_keys_ |= keys & react_keys_;
+  }
+  fault_filter_.Expire(now, [this](const FaultEvent &event) {
+    if (fault_event_callback_ != nullptr) {
+      fault_event_callback_(event, fault_event_user_data_);
+    }
+  });
+  const uint64_t opened = fault_filter_.Observe(now, keys);
+  for (uint64_t pending = opened; pending != 0; pending &= pending - 1) {
+    statistics_.fault_events++;
+    if (fault_callback_ != nullptr) {
+      FaultEvent event;
+      fault_filter_.GetEvent(lowestBit(pending), event);
+      fault_callback_(event.channel, event.type, fault_user_data_);
+    }
+  }
+  return opened;
+}
+
+template <typename SpiType>
+uint8_t MAX22200<SpiType>::reactionOffMask(uint64_t keys) const {
+  const uint32_t off_keys = static_cast<uint32_t>(keys) & react_off_keys_;
+  uint8_t off = static_cast<uint8_t>(off_keys | (off_keys >> 8) | (off_keys >> 16) | (off_keys >> 24));
+
+  // SHED: precomputed channel set per type
+  for (uint8_t types = react_shed_types_, t = 0; types != 0; types >>= 1, ++t) {
+    if ((types & 1u) == 0) continue;
+    const FaultType ft = static_cast<FaultType>(t);
+    const uint64_t type_keys = (t < 4) ? (0xFFull << FaultEventFilter::KeyOf(0, ft))
+                                       : (1ull << FaultEventFilter::KeyOf(0, ft));
+    if ((keys & type_keys) != 0) {
+      off |= reaction_[t].shed_mask;
+    }
+  }
+
+  // HIT_STEP_RETRY gives up (switches off) after one retry, at full scale or without shadow
+  const uint8_t hhf = static_cast<uint8_t>(keys >> 8) & react_retry_mask_;
+  for (uint8_t pending = hhf; pending != 0; pending &= static_cast<uint8_t>(pending - 1)) {
+    const uint8_t ch = lowestBit(pending);
+    const uint8_t bit = static_cast<uint8_t>(1u << ch);
+    if ((hit_retried_mask_ & bit) != 0 || (cfg_shadow_valid_mask_ & bit) == 0 ||
+        (cfg_shadow_[ch] & CfgChReg::HIT_MASK) == CfgChReg::HIT_MASK) {
+      off |= bit;
+    }
+  }
+  return off;
+}
+
+template <typename SpiType>
+uint8_t MAX22200<SpiType>::react(uint64_t keys, uint32_t seen_us) {
+  const uint32_t ch_keys = static_cast<uint32_t>(keys);
+  uint8_t off = reactionOffMask(keys);
+
+  // QUARANTINE: hold the channel off for the cooldown of the type that tripped it
+  for (uint32_t q = ch_keys & react_quarantine_keys_; q != 0; q &= q - 1) {
+    const uint8_t key = lowestBit(q);
+    const uint8_t ch = key % NUM_CHANNELS_;
+    quarantine_mask_ |= static_cast<uint8_t>(1u << ch);
+    quarantine_start_us_[ch] = seen_us;
+    quarantine_us_[ch] = reaction_[key / NUM_CHANNELS_].cooldown_ms * 1000u;
+  }
+
+  // HIT_STEP_RETRY: one CFG_CHx write per channel, first HHF only
+  const uint8_t hhf = static_cast<uint8_t>(static_cast<uint8_t>(ch_keys >> 8) & react_retry_mask_ &
+                                           static_cast<uint8_t>(~off));
+  for (uint8_t pending = hhf; pending != 0; pending &= static_cast<uint8_t>(pending - 1)) {
+    const uint8_t ch = lowestBit(pending);
+    const uint8_t bit = static_cast<uint8_t>(1u << ch);
+    hit_retried_mask_ |= bit;
+    if (writeReg32(getChannelCfgBank(ch), cfg_shadow_[ch] + (1u << CfgChReg::HIT_SHIFT)) !=
+        DriverStatus::OK) {
+      off |= bit;
+    }
+  }
+  return off;
+}
+
+template <typename SpiType>
+uint8_t MAX22200<SpiType>::activeQuarantine() const {
+  const uint32_t now = spi_interface_.GetTimeUs();
+  uint8_t active = 0;
+  for (uint8_t pending = quarantine_mask_; pending != 0;
+       pending &= static_cast<uint8_t>(pending - 1)) {
+    const uint8_t ch = lowestBit(pending);
+    if (now - quarantine_start_us_[ch] < quarantine_us_[ch]) {
+      active |= static_cast<uint8_t>(1u << ch);
+    }
+  }
+  return active;
+}
+
+template <typename SpiType>
+uint8_t MAX22200<SpiType>::blockedChannels() const {
+  if ((quarantine_mask_ | react_pending_keys_) == 0) {
+    return 0;
+  }
+  return static_cast<uint8_t>((quarantine_mask_ != 0 ? activeQuarantine() : 0) |
+                              reactionOffMask(react_pending_keys_ & react_keys_));
+}
+
+template <typename SpiType>
+void MAX22200<SpiType>::queueRules(uint64_t fault_keys, uint8_t rising, uint8_t falling,
+                                   uint8_t hold) const {
+  // rules_busy_: ServiceReactions() matched the edges of its own write already
+  if (rule_table_ == nullptr || rules_busy_ || !initialized_) {
+    return;
+  }
+  const uint16_t matched = rule_table_->Match(fault_keys, rising, falling, hold);
+  if (matched == 0) {
+    return;
+  }
+  if (rule_pending_ == 0) {
+    rule_pending_us_ = spi_interface_.GetTimeUs();
+  }
+  rule_pending_ |= matched;
+}
+
+template <typename SpiType>
+void MAX22200<SpiType>::armRules(uint16_t rules, uint32_t from_us) {
+  for (; rules != 0; rules &= static_cast<uint16_t>(rules - 1)) {
+    const uint8_t r = lowestBit(rules);
+    rule_due_us_[r] = from_us + rule_table_->Get(r).delay_us;
+    rule_armed_ |= static_cast<uint16_t>(1u << r);
+  }
+}
+
+template <typename SpiType>
+uint8_t MAX22200<SpiType>::applyRules(uint8_t onch, uint16_t matched, uint16_t due,
+                                      uint32_t now_us) {
+  const RuleTable *table = rule_table_;
+  const uint16_t immediate = table->GetImmediateMask();
+  uint8_t next = onch;
+  uint16_t apply = due;
+  uint16_t seen = 0;
+  // Each rule fires at most once per pass, so chains end within MAX_RULES rounds
+  while ((matched | apply) != 0) {
+    matched &= static_cast<uint16_t>(~seen);
+    seen |= matched;
+    armRules(static_cast<uint16_t>(matched & ~immediate), now_us);
+    apply |= matched & immediate;
+    if (apply == 0) {
+      break;
+    }
+    const uint8_t prev = next;
+    for (; apply != 0; apply &= static_cast<uint16_t>(apply - 1)) {
+      const ReactionRule &rule = table->Get(lowestBit(apply));
+      next = static_cast<uint8_t>((next & ~rule.off_mask) | rule.on_mask);
+    }
+    next &= static_cast<uint8_t>(~blockedChannels());
+    matched = table->Match(0, static_cast<uint8_t>(next & ~prev),
+                           static_cast<uint8_t>(prev & ~next), 0);
+  }
+  return next;
+}
+
+template <typename SpiType>
+void MAX22200<SpiType>::trackHitTime(uint8_t channel,
+                                     const ChannelConfig &config) const {
+  if (config.isContinuousHit()) {
+    hit_time_us_[channel] = UINT32_MAX;
+  } else if (config.hasHitTime()) {
+    hit_time_us_[channel] = static_cast<uint32_t>(config.hit_time_ms * 1000.0f + 0.5f);
+  } else {
+    hit_time_us_[channel] = 0;
+  }
+  const uint8_t bit = static_cast<uint8_t>(1u << channel);
+  hit_known_mask_ |= bit;
+  if ((state_onch_ & bit) == 0) {
+    return;
+  }
+  // Channel already on: place it in HIT or HOLD relative to its ONCH edge
+  const uint32_t hit_us = hit_time_us_[channel];
+  if (hit_us == UINT32_MAX ||
+      (hit_us != 0 && spi_interface_.GetTimeUs() - hit_start_us_[channel] < hit_us)) {
+    hit_pending_mask_ |= bit;
+  } else {
+    hit_pending_mask_ &= static_cast<uint8_t>(~bit);
+  }
+  updateChannelStates(bit);
+}
+
+template <typename SpiType>
+uint8_t MAX22200<SpiType>::expireHitPhases(uint32_t now_us) const {
+  uint8_t expired = 0;
+  for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+    const uint8_t bit = static_cast<uint8_t>(1u << ch);
+    if ((hit_pending_mask_ & bit) != 0 && hit_time_us_[ch] != UINT32_MAX &&
+        now_us - hit_start_us_[ch] >= hit_time_us_[ch]) {
+      expired |= bit;
+    }
+  }
+  hit_pending_mask_ &= static_cast<uint8_t>(~expired);
+  return expired;
+}
+
+template <typename SpiType>
+ChannelState MAX22200<SpiType>::computeChannelState(uint8_t channel) const {
+  const uint8_t bit = static_cast<uint8_t>(1u << channel);
+  if ((state_fault_mask_ & bit) != 0) {
+    return ChannelState::FAULT;
+  }
+  if ((state_onch_ & bit) == 0) {
+    return ChannelState::DISABLED;
+  }
+  if ((hit_known_mask_ & bit) == 0) {
+    return ChannelState::ENABLED;
+  }
+  return (hit_pending_mask_ & bit) != 0 ? ChannelState::HIT_PHASE
+                                        : ChannelState::HOLD_PHASE;
+}
+
+template <typename SpiType>
+uint8_t MAX22200<SpiType>::updateChannelStates(uint8_t candidates) const {
+  uint8_t hold = 0;
+  for (uint8_t ch = 0; candidates != 0; ++ch, candidates >>= 1) {
+    if ((candidates & 1u) == 0) {
+      continue;
+    }
+    const ChannelState old_state = channel_state_[ch];
+    const ChannelState new_state = computeChannelState(ch);
+    if (new_state == old_state) {
+      continue;
+    }
+    channel_state_[ch] = new_state;
+    statistics_.state_changes++;
+    if (old_state == ChannelState::HIT_PHASE && new_state == ChannelState::HOLD_PHASE) {
+      hold |= static_cast<uint8_t>(1u << ch);
+    }
+    if (state_callback_ != nullptr) {
+      state_callback_(ch, old_state, new_state, state_user_data_);
+    }
+  }
+  return hold;
+}
+
+template <typename SpiType>
+void MAX22200<SpiType>::resetChannelStates() const {
+  for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+    channel_state_[ch] = ChannelState::DISABLED;
+  }
+  hit_pending_mask_ = 0;
+  state_onch_ = 0;
+  state_fault_mask_ = 0;
+}
+
 // ============================================================================
 // Private: Two-Phase SPI Protocol Implementation
 // ============================================================================
@@ -588,6 +1441,7 @@ DriverStatus MAX22200<SpiType>::writeCommandRegister(uint8_t bank,
                                                       bool mode8) const {
   uint8_t cmd_byte = CommandReg::build(bank, is_write, mode8);
   uint8_t rx_byte = 0xFF;
+  onch_armed_ = false;  // Latched command unknown until this one completes
 
   // CMD pin HIGH for Command Register write
   spi_interface_.GpioSetActive(CtrlPin::CMD);
@@ -603,8 +1457,13 @@ DriverStatus MAX22200<SpiType>::writeCommandRegister(uint8_t bank,
     return DriverStatus::COMMUNICATION_ERROR;
   }
 
+  onch_armed_ = bank == RegBank::STATUS && is_write && mode8;
+
   // Store the fault flags byte returned by the device
   last_fault_byte_ = rx_byte;
+  fault_byte_seq_++;
+  fault_byte_us_ = spi_interface_.GetTimeUs();
+  observeFaultByte(rx_byte);
 
   return DriverStatus::OK;
 }
@@ -710,9 +1569,15 @@ DriverStatus MAX22200<SpiType>::readData8(uint8_t &value) const {
 template <typename SpiType>
 DriverStatus MAX22200<SpiType>::writeReg32(uint8_t bank,
                                             uint32_t value) const {
+  const uint32_t audit_slot = auditWrite(bank, value, 0);
   DriverStatus result = writeCommandRegister(bank, true, false);
-  if (result != DriverStatus::OK) return result;
-  return writeData32(value);
+  if (result == DriverStatus::OK) result = writeData32(value);
+  if (result == DriverStatus::OK) {
+    shadowRegister(bank, value, false, true);
+  } else if (audit_log_ != nullptr) {
+    audit_log_->MarkFailed(audit_slot);
+  }
+  return result;
 }
 
 template <typename SpiType>
@@ -720,21 +1585,137 @@ DriverStatus MAX22200<SpiType>::readReg32(uint8_t bank,
                                            uint32_t &value) const {
   DriverStatus result = writeCommandRegister(bank, false, false);
   if (result != DriverStatus::OK) return result;
-  return readData32(value);
+  result = readData32(value);
+  if (result == DriverStatus::OK) shadowRegister(bank, value, false, false);
+  return result;
+}
+
+template <typename SpiType>
+DriverStatus MAX22200<SpiType>::readRegs32(const uint8_t *banks, uint32_t *values,
+                                            uint8_t count, const uint8_t (*tx)[4]) const {
+  static const uint8_t zeros[4] = {0, 0, 0, 0};
+  for (uint8_t i = 0; i < count; ++i) {
+    DriverStatus result = writeCommandRegister(banks[i], false, false);
+    if (result != DriverStatus::OK) return result;
+    result = readData32WithTx(tx ? tx[i] : zeros, values[i]);
+    if (result != DriverStatus::OK) return result;
+    shadowRegister(banks[i], values[i], false, false);
+  }
+  return DriverStatus::OK;
+}
+
+template <typename SpiType>
+DriverStatus MAX22200<SpiType>::writeRegs32(const uint8_t *banks, const uint32_t *values,
+                                             uint8_t count) const {
+  for (uint8_t i = 0; i < count; ++i) {
+    DriverStatus result = writeReg32(banks[i], values[i]);
+    if (result != DriverStatus::OK) return result;
+  }
+  return DriverStatus::OK;
 }
 
 template <typename SpiType>
 DriverStatus MAX22200<SpiType>::writeReg8(uint8_t bank, uint8_t value) const {
+  const uint32_t audit_slot = auditWrite(bank, value, AuditEntry::WRITE8);
   DriverStatus result = writeCommandRegister(bank, true, true);
-  if (result != DriverStatus::OK) return result;
-  return writeData8(value);
+  if (result == DriverStatus::OK) result = writeData8(value);
+  if (result == DriverStatus::OK) {
+    shadowRegister(bank, static_cast<uint32_t>(value) << 24, true, true);
+  } else {
+    onch_armed_ = false;
+    if (audit_log_ != nullptr) audit_log_->MarkFailed(audit_slot);
+  }
+  return result;
 }
 
 template <typename SpiType>
 DriverStatus MAX22200<SpiType>::readReg8(uint8_t bank, uint8_t &value) const {
   DriverStatus result = writeCommandRegister(bank, false, true);
   if (result != DriverStatus::OK) return result;
-  return readData8(value);
+  result = readData8(value);
+  if (result == DriverStatus::OK) shadowRegister(bank, static_cast<uint32_t>(value) << 24, true, false);
+  return result;
+}
+
+template <typename SpiType>
+void MAX22200<SpiType>::shadowRegister(uint8_t bank, uint32_t value, bool mode8,
+                                       bool is_write) const {
+  if (bank == RegBank::STATUS) {
+    if (!mode8) {
+      // Written words carry no flags; the command phase just returned them
+      status_word_ = is_write ? (value & ~StatusReg::FAULT_FLAGS_MASK) |
+                                    (last_fault_byte_ & StatusReg::FAULT_FLAGS_MASK)
+                              : value;
+      status_word_us_ = fault_byte_us_;
+      status_word_valid_ = true;
+    } else if (status_word_valid_) {
+      status_word_ = (status_word_ & ~StatusReg::ONCH_MASK) | value;
+      status_word_us_ = fault_byte_us_;
+    }
+    return;
+  }
+  if (bank == RegBank::FAULT) {
+    if (!mode8 && !is_write) {
+      fault_word_ = value;
+      fault_word_us_ = fault_byte_us_;
+      fault_word_valid_ = true;
+    }
+    return;
+  }
+  if (bank < RegBank::CFG_CH0 || bank > RegBank::CFG_CH7) {
+    return;
+  }
+  const uint8_t ch = static_cast<uint8_t>(bank - RegBank::CFG_CH0);
+  const uint8_t bit = static_cast<uint8_t>(1u << ch);
+  if (!mode8) {
+    cfg_shadow_[ch] = value;
+    cfg_shadow_valid_mask_ |= bit;
+  } else if ((cfg_shadow_valid_mask_ & bit) != 0) {
+    // 8-bit access only covers bits 31:24 (HFS + HOLD)
+    cfg_shadow_[ch] = (cfg_shadow_[ch] & 0x00FFFFFFu) | value;
+  }
+}
+
+template <typename SpiType>
+void MAX22200<SpiType>::observeFaultByte(uint8_t fault_byte) const {
+  if ((fault_byte & StatusReg::UVM_BIT) != 0) {
+    // Possible power-on reset: the writable bits are no longer known
+    status_word_valid_ = false;
+  } else if (status_word_valid_) {
+    status_word_ = (status_word_ & ~0xFFu) | fault_byte;
+    status_word_us_ = fault_byte_us_;
+  }
+
+  // STATUS OCP/HHF/OLF/DPM are set while any FAULT bit of that type is set
+  const uint8_t flags = fault_byte & (StatusReg::OCP_BIT | StatusReg::HHF_BIT |
+                                      StatusReg::OLF_BIT | StatusReg::DPM_BIT);
+  if (flags == 0) {
+    fault_word_ = 0;
+    fault_word_us_ = fault_byte_us_;
+    fault_word_valid_ = true;
+  } else if (fault_word_valid_) {
+    uint8_t cached = 0;
+    if ((fault_word_ & FaultReg::OCP_MASK) != 0) cached |= StatusReg::OCP_BIT;
+    if ((fault_word_ & FaultReg::HHF_MASK) != 0) cached |= StatusReg::HHF_BIT;
+    if ((fault_word_ & FaultReg::OLF_MASK) != 0) cached |= StatusReg::OLF_BIT;
+    if ((fault_word_ & FaultReg::DPM_MASK) != 0) cached |= StatusReg::DPM_BIT;
+    if ((flags & ~cached) != 0) fault_word_valid_ = false;
+  }
+}
+
+template <typename SpiType>
+void MAX22200<SpiType>::dropReadCache() const {
+  status_word_valid_ = false;
+  fault_word_valid_ = false;
+  onch_armed_ = false;
+}
+
+template <typename SpiType>
+uint32_t MAX22200<SpiType>::auditWrite(uint8_t bank, uint32_t value, uint8_t flags) const {
+  if (audit_log_ == nullptr) {
+    return AuditLog::NO_SLOT;
+  }
+  return audit_log_->Append(bank, value, spi_interface_.GetTimeUs(), audit_tag_, flags);
 }
 
 // ============================================================================
@@ -744,6 +1725,9 @@ DriverStatus MAX22200<SpiType>::readReg8(uint8_t bank, uint8_t &value) const {
 template <typename SpiType>
 void MAX22200<SpiType>::SetBoardConfig(const BoardConfig &config) {
   board_config_ = config;
+  for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+    cal_scale_[ch] = ChannelScale(calibration_[ch], board_config_.full_scale_current_ma);
+  }
 }
 
 template <typename SpiType>
@@ -751,6 +1735,39 @@ BoardConfig MAX22200<SpiType>::GetBoardConfig() const {
   return board_config_;
 }
 
+template <typename SpiType>
+DriverStatus MAX22200<SpiType>::SetChannelCalibration(uint8_t channel,
+                                                       const ChannelCalibration &cal) {
+  if (!IsValidChannel(channel) || !cal.isValid()) {
+    return DriverStatus::INVALID_PARAMETER;
+  }
+  const uint8_t bit = static_cast<uint8_t>(1u << channel);
+  calibration_[channel] = cal;
+  cal_scale_[channel] = ChannelScale(cal, board_config_.full_scale_current_ma);
+  cal_mask_ = cal.isIdentity() ? static_cast<uint8_t>(cal_mask_ & ~bit)
+                               : static_cast<uint8_t>(cal_mask_ | bit);
+  return DriverStatus::OK;
+}
+
+template <typename SpiType>
+DriverStatus MAX22200<SpiType>::GetChannelCalibration(uint8_t channel,
+                                                       ChannelCalibration &cal) const {
+  if (!IsValidChannel(channel)) {
+    return DriverStatus::INVALID_PARAMETER;
+  }
+  cal = calibration_[channel];
+  return DriverStatus::OK;
+}
+
+template <typename SpiType>
+void MAX22200<SpiType>::ClearChannelCalibration() {
+  for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+    calibration_[ch] = ChannelCalibration();
+    cal_scale_[ch] = ChannelScale();
+  }
+  cal_mask_ = 0;
+}
+
 // ============================================================================
 // Convenience APIs: Current in Real Units (CDR Mode)
 // ============================================================================
@@ -0,0 +1,541 @@
+/**
+ * @file max22200_log_analyze.cpp
+ * @brief Fast host analytics for MAX22200 telemetry logs.
+ *
+ * @details
+ *   Memory-maps one or more logs and accepts two row formats, mixed freely
+ *   with other log lines (which are skipped):
+ *
+ *     - poll_csv rows from c21_dpm_tuning_test (anything may precede `CSV,`):
+ *         CSV,cycle,phase,t_us,fault_dpm_byte,status_byte,dpm_fired,ocp,hhf,olf
+ *     - rows written by max22200_telemetry_decode:
+ *         t_us,status,onch,ocp,hhf,olf,dpm,fault_byte,...
+ *
+ *   Each file is split into one line-aligned chunk per thread. Threads find
+ *   field and line boundaries 16 bytes at a time (SSE2 compare + movemask;
+ *   scalar elsewhere), parse the numbers and decode STATUS / FAULT with the
+ *   library's StatusConfig / FaultStatus fromRegister() codecs. Order-free
+ *   totals are summed per chunk; telemetry rows are kept in order for the
+ *   one pass that needs the previous sample (duty, on-periods, DPM timing).
+ *
+ *   Report:
+ *     - per-channel fault rates by type (per 1000 samples, per cycle / hour)
+ *     - STATUS flag counts (OVT, UVM, COMER); zero for poll_csv rows, whose
+ *       status_byte (StatusConfig::toRegister()) carries no read-only flags
+ *     - DPM first-fire time after ENERGISE (poll_csv) or after ONCH rising
+ *       (telemetry): count, min / p50 / p90 / p99 / max
+ *     - per-channel duty, on-period count and length (telemetry)
+ *
+ * @par Usage
+ *   max22200_log_analyze [--threads N] [--channel N] FILE...
+ *
+ *   --channel is the channel the poll_csv ocp/hhf/olf/dpm_fired columns refer
+ *   to (cfg::kChannel of the firmware, default 0).
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "max22200_types.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// CSV SCANNER
+//==============================================================================
+
+static constexpr int kMaxFields = 16;
+
+/// Field boundaries of one line ([begin[i], end[i]) for field i)
+struct Row {
+  const char *begin[kMaxFields];
+  const char *end[kMaxFields];
+  int count;
+};
+
+/**
+ * @brief Call on_row(row) for every line in [p, end)
+ *
+ * Commas and newlines are located 16 bytes at a time; only their positions
+ * are visited. Fields beyond kMaxFields are merged into the last one.
+ */
+template <typename F>
+static void scan_csv(const char *p, const char *end, F &&on_row) {
+  Row row;
+  row.count = 0;
+  const char *field = p;
+  auto close_field = [&](const char *q) {
+    if (row.count < kMaxFields) {
+      row.begin[row.count] = field;
+      row.end[row.count] = q;
+      row.count++;
+    } else {
+      row.end[kMaxFields - 1] = q;
+    }
+    field = q + 1;
+  };
+  auto close_line = [&](const char *q) {
+    if (q > field && q[-1] == '\r') --q;
+    close_field(q);
+    on_row(row);
+    row.count = 0;
+  };
+
+  const char *q = p;
+#if defined(__SSE2__)
+  const __m128i comma = _mm_set1_epi8(',');
+  const __m128i newline = _mm_set1_epi8('\n');
+  for (; q + 16 <= end; q += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(q));
+    unsigned mask = static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, newline))));
+    while (mask != 0) {
+      const int i = __builtin_ctz(mask);
+      mask &= mask - 1;
+      if (q[i] == ',') {
+        close_field(q + i);
+      } else {
+        close_line(q + i);
+        field = q + i + 1;
+      }
+    }
+  }
+#endif
+  for (; q < end; ++q) {
+    if (*q == ',') {
+      close_field(q);
+    } else if (*q == '\n') {
+      close_line(q);
+      field = q + 1;
+    }
+  }
+  if (field < end) close_line(end);
+}
+
+/// Decimal or 0x-prefixed hex; false if the field is empty or not a number
+static bool parse_u64(const char *b, const char *e, uint64_t &out) {
+  while (b < e && *b == ' ') ++b;
+  if (b == e) return false;
+  uint64_t v = 0;
+  if (e - b > 2 && b[0] == '0' && (b[1] == 'x' || b[1] == 'X')) {
+    for (b += 2; b < e; ++b) {
+      const char c = *b;
+      const int d = (c >= '0' && c <= '9') ? c - '0'
+                  : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                  : (c >= 'A' && c <= 'F') ? c - 'A' + 10
+                                           : -1;
+      if (d < 0) return false;
+      v = (v << 4) | static_cast<uint64_t>(d);
+    }
+  } else {
+    for (; b < e; ++b) {
+      if (*b < '0' || *b > '9') return false;
+      v = v * 10 + static_cast<uint64_t>(*b - '0');
+    }
+  }
+  out = v;
+  return true;
+}
+
+static bool ends_with(const char *b, const char *e, const char *suffix) {
+  const size_t n = std::strlen(suffix);
+  return static_cast<size_t>(e - b) >= n && std::memcmp(e - n, suffix, n) == 0;
+}
+
+//==============================================================================
+// PER-CHUNK RESULTS
+//==============================================================================
+
+static constexpr int kFaultTypes = 4;  ///< OCP, HHF, OLF, DPM (FaultType order)
+static const char *const kFaultNames[kFaultTypes] = {"OCP", "HHF", "OLF", "DPM"};
+
+struct CycleInfo {
+  uint32_t first_dpm_us = UINT32_MAX;  ///< First ENERGISE sample with dpm_fired
+  uint8_t fault_types = 0;             ///< Bit per FaultType seen in the cycle
+};
+
+/// A telemetry row kept for the ordered pass
+struct TlmRow {
+  uint64_t t_us;
+  uint32_t fault;
+  uint8_t onch;
+};
+
+struct Partial {
+  uint64_t lines = 0;
+  uint64_t skipped = 0;
+  // STATUS flags (decoded with StatusConfig::fromRegister)
+  uint64_t ovt = 0, uvm = 0, comer = 0;
+  // poll_csv
+  uint64_t poll_rows = 0;
+  uint64_t poll_energise = 0;
+  uint64_t poll_fault[kFaultTypes] = {};  ///< Samples flagged on --channel
+  uint64_t poll_dpm_mask[NUM_CHANNELS_] = {};  ///< fault_dpm_byte bits, all channels
+  std::unordered_map<uint32_t, CycleInfo> cycles;
+  // telemetry
+  uint64_t tlm_fault[kFaultTypes][NUM_CHANNELS_] = {};  ///< Samples flagged
+  std::vector<TlmRow> tlm;
+
+  void countStatus(uint32_t status_raw) {
+    StatusConfig st;
+    st.fromRegister(status_raw);
+    ovt += st.overtemperature;
+    uvm += st.undervoltage;
+    comer += st.communication_error;
+  }
+};
+
+static void add_fault_masks(uint64_t (&counts)[kFaultTypes][NUM_CHANNELS_], const FaultStatus &f) {
+  const uint8_t masks[kFaultTypes] = {f.overcurrent_channel_mask, f.hit_not_reached_channel_mask,
+                                      f.open_load_fault_channel_mask,
+                                      f.plunger_movement_fault_channel_mask};
+  for (int t = 0; t < kFaultTypes; ++t) {
+    for (uint8_t m = masks[t], ch = 0; m != 0; m = static_cast<uint8_t>(m >> 1), ++ch) {
+      counts[t][ch] += m & 1u;
+    }
+  }
+}
+
+static void analyze_chunk(const char *b, const char *e, uint8_t channel, Partial &out) {
+  uint32_t last_cycle = UINT32_MAX;
+  CycleInfo *cyc_ptr = nullptr;  // rows of one cycle are contiguous: skip the hash lookup
+  scan_csv(b, e, [&](const Row &r) {
+    out.lines++;
+    uint64_t v[10];
+    if (r.count >= 10 && ends_with(r.begin[0], r.end[0], "CSV")) {
+      // CSV,cycle,phase,t_us,fault_dpm_byte,status_byte,dpm_fired,ocp,hhf,olf
+      if (!parse_u64(r.begin[1], r.end[1], v[1]) || !parse_u64(r.begin[3], r.end[3], v[3])) {
+        out.skipped++;
+        return;
+      }
+      for (int i = 4; i < 10; ++i) {
+        if (!parse_u64(r.begin[i], r.end[i], v[i])) {
+          out.skipped++;
+          return;
+        }
+      }
+      out.poll_rows++;
+      const bool energise = (r.end[2] - r.begin[2]) == 8 && std::memcmp(r.begin[2], "ENERGISE", 8) == 0;
+      out.poll_energise += energise;
+      // Rebuild the FAULT word: DPM byte for all channels, ocp/hhf/olf for --channel
+      const uint32_t ch_bit = 1u << channel;
+      const uint32_t fault_raw = ((v[7] ? ch_bit : 0u) << FaultReg::OCP_SHIFT) |
+                                 ((v[8] ? ch_bit : 0u) << FaultReg::HHF_SHIFT) |
+                                 ((v[9] ? ch_bit : 0u) << FaultReg::OLF_SHIFT) |
+                                 ((static_cast<uint32_t>(v[4]) & 0xFFu) << FaultReg::DPM_SHIFT);
+      FaultStatus f;
+      f.fromRegister(fault_raw);
+      out.countStatus(static_cast<uint32_t>(v[5]) & 0xFFu);
+      const bool flagged[kFaultTypes] = {f.hasOvercurrentOnChannel(channel),
+                                         f.hasHitNotReachedOnChannel(channel),
+                                         f.hasOpenLoadFaultOnChannel(channel), v[6] != 0};
+      if (cyc_ptr == nullptr || v[1] != last_cycle) {
+        last_cycle = static_cast<uint32_t>(v[1]);
+        cyc_ptr = &out.cycles[last_cycle];
+      }
+      CycleInfo &cyc = *cyc_ptr;
+      for (int t = 0; t < kFaultTypes; ++t) {
+        out.poll_fault[t] += flagged[t];
+        if (flagged[t]) cyc.fault_types |= static_cast<uint8_t>(1u << t);
+      }
+      for (uint8_t ch = 0; ch < NUM_CHANNELS_; ++ch) {
+        out.poll_dpm_mask[ch] += f.hasPlungerMovementFaultOnChannel(ch);
+      }
+      if (energise && v[6] != 0 && v[3] < cyc.first_dpm_us) {
+        cyc.first_dpm_us = static_cast<uint32_t>(v[3]);
+      }
+      return;
+    }
+    // t_us,status,onch,ocp,hhf,olf,dpm,fault_byte,...
+    if (r.count >= 8) {
+      for (int i = 0; i < 7; ++i) {
+        if (!parse_u64(r.begin[i], r.end[i], v[i])) {
+          out.skipped++;  // also the header line
+          return;
+        }
+      }
+      const uint32_t onch = static_cast<uint32_t>(v[2]) & 0xFFu;
+      out.countStatus((static_cast<uint32_t>(v[1]) & ~StatusReg::ONCH_MASK) |
+                      (onch << StatusReg::ONCH_SHIFT));
+      const uint32_t fault_raw = ((static_cast<uint32_t>(v[3]) & 0xFFu) << FaultReg::OCP_SHIFT) |
+                                 ((static_cast<uint32_t>(v[4]) & 0xFFu) << FaultReg::HHF_SHIFT) |
+                                 ((static_cast<uint32_t>(v[5]) & 0xFFu) << FaultReg::OLF_SHIFT) |
+                                 ((static_cast<uint32_t>(v[6]) & 0xFFu) << FaultReg::DPM_SHIFT);
+      FaultStatus f;
+      f.fromRegister(fault_raw);
+      add_fault_masks(out.tlm_fault, f);
+      out.tlm.push_back({v[0], fault_raw, static_cast<uint8_t>(onch)});
+      return;
+    }
+    out.skipped++;
+  });
+}
+
+//==============================================================================
+// ORDERED TELEMETRY PASS
+//==============================================================================
+
+struct ChannelTiming {
+  uint64_t on_us = 0;
+  uint64_t periods = 0;
+  uint64_t period_min_us = UINT64_MAX;
+  uint64_t period_max_us = 0;
+  std::vector<uint64_t> dpm_after_on_us;
+};
+
+struct TlmState {
+  bool have_prev = false;
+  uint64_t prev_t = 0;
+  uint8_t prev_onch = 0;
+  uint64_t rise_t[NUM_CHANNELS_] = {};
+  uint8_t waiting_dpm = 0;  ///< Channels on whose first DPM has not been seen
+  uint64_t first_t = 0;
+  uint64_t span_us = 0;
+};
+
+static void telemetry_pass(const std::vector<TlmRow> &rows, TlmState &s,
+                           ChannelTiming (&ch)[NUM_CHANNELS_]) {
+  for (const TlmRow &r : rows) {
+    if (!s.have_prev) {
+      s.have_prev = true;
+      s.first_t = r.t_us;
+      s.prev_t = r.t_us;
+      s.prev_onch = r.onch;
+      for (uint8_t c = 0; c < NUM_CHANNELS_; ++c) s.rise_t[c] = r.t_us;
+      s.waiting_dpm = r.onch;
+      continue;
+    }
+    const uint64_t dt = r.t_us >= s.prev_t ? r.t_us - s.prev_t : 0;
+    const uint8_t rise = static_cast<uint8_t>(r.onch & ~s.prev_onch);
+    const uint8_t fall = static_cast<uint8_t>(s.prev_onch & ~r.onch);
+    const uint8_t dpm = static_cast<uint8_t>((r.fault >> FaultReg::DPM_SHIFT) & 0xFFu);
+    for (uint8_t c = 0; c < NUM_CHANNELS_; ++c) {
+      const uint8_t bit = static_cast<uint8_t>(1u << c);
+      if (s.prev_onch & bit) ch[c].on_us += dt;
+      if (fall & bit) {
+        const uint64_t len = r.t_us - s.rise_t[c];
+        ch[c].periods++;
+        ch[c].period_min_us = std::min(ch[c].period_min_us, len);
+        ch[c].period_max_us = std::max(ch[c].period_max_us, len);
+        s.waiting_dpm &= static_cast<uint8_t>(~bit);
+      }
+      if (rise & bit) {
+        s.rise_t[c] = r.t_us;
+        s.waiting_dpm |= bit;
+      } else if ((s.waiting_dpm & dpm & bit) != 0) {
+        ch[c].dpm_after_on_us.push_back(r.t_us - s.rise_t[c]);
+        s.waiting_dpm &= static_cast<uint8_t>(~bit);
+      }
+    }
+    s.prev_t = r.t_us;
+    s.prev_onch = r.onch;
+    s.span_us = r.t_us - s.first_t;
+  }
+}
+
+//==============================================================================
+// REPORT HELPERS
+//==============================================================================
+
+static void print_distribution(const char *label, std::vector<uint64_t> v) {
+  if (v.empty()) {
+    std::printf("  %-30s none\n", label);
+    return;
+  }
+  std::sort(v.begin(), v.end());
+  auto pct = [&](double p) { return v[static_cast<size_t>(p * (v.size() - 1))] / 1e3; };
+  std::printf("  %-30s n=%zu  min %.2f  p50 %.2f  p90 %.2f  p99 %.2f  max %.2f ms\n", label,
+              v.size(), v.front() / 1e3, pct(0.5), pct(0.9), pct(0.99), v.back() / 1e3);
+}
+
+struct MappedFile {
+  const char *data = nullptr;
+  size_t size = 0;
+  int fd = -1;
+
+  bool open(const char *path) {
+    fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0) return false;
+    size = static_cast<size_t>(st.st_size);
+    if (size == 0) return true;
+    void *p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) return false;
+    ::madvise(p, size, MADV_SEQUENTIAL);
+    data = static_cast<const char *>(p);
+    return true;
+  }
+  ~MappedFile() {
+    if (data != nullptr) ::munmap(const_cast<char *>(data), size);
+    if (fd >= 0) ::close(fd);
+  }
+};
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+int main(int argc, char **argv) {
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  unsigned channel = 0;
+  std::vector<const char *> inputs;
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    if (std::strcmp(a, "--threads") == 0 && has_value) {
+      threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(a, "--channel") == 0 && has_value) {
+      channel = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (a[0] != '-') {
+      inputs.push_back(a);
+    } else {
+      inputs.clear();
+      break;
+    }
+  }
+  if (inputs.empty() || threads == 0 || channel >= NUM_CHANNELS_) {
+    std::fprintf(stderr, "usage: %s [--threads N] [--channel N] FILE...\n", argv[0]);
+    return 2;
+  }
+
+  const auto t0 = std::chrono::steady_clock::now();
+  Partial total;
+  std::unordered_map<uint64_t, CycleInfo> cycles;  ///< (file << 32 | cycle)
+  ChannelTiming timing[NUM_CHANNELS_];
+  uint64_t tlm_rows = 0, tlm_span_us = 0, bytes = 0;
+
+  for (size_t fi = 0; fi < inputs.size(); ++fi) {
+    MappedFile file;
+    if (!file.open(inputs[fi])) {
+      std::fprintf(stderr, "cannot map %s\n", inputs[fi]);
+      return 1;
+    }
+    bytes += file.size;
+    if (file.size == 0) continue;
+
+    // Line-aligned chunks, one per thread
+    std::vector<const char *> cuts{file.data};
+    const char *end = file.data + file.size;
+    for (unsigned t = 1; t < threads; ++t) {
+      const char *c = file.data + file.size * t / threads;
+      c = std::max(c, cuts.back());
+      const void *nl = std::memchr(c, '\n', static_cast<size_t>(end - c));
+      cuts.push_back(nl ? static_cast<const char *>(nl) + 1 : end);
+    }
+    cuts.push_back(end);
+
+    std::vector<Partial> parts(cuts.size() - 1);
+    std::vector<std::thread> pool;
+    for (size_t k = 0; k + 1 < cuts.size(); ++k) {
+      pool.emplace_back(analyze_chunk, cuts[k], cuts[k + 1], static_cast<uint8_t>(channel),
+                        std::ref(parts[k]));
+    }
+    for (std::thread &th : pool) th.join();
+
+    TlmState state;
+    for (Partial &p : parts) {
+      total.lines += p.lines;
+      total.skipped += p.skipped;
+      total.ovt += p.ovt;
+      total.uvm += p.uvm;
+      total.comer += p.comer;
+      total.poll_rows += p.poll_rows;
+      total.poll_energise += p.poll_energise;
+      for (int t = 0; t < kFaultTypes; ++t) {
+        total.poll_fault[t] += p.poll_fault[t];
+        for (uint8_t c = 0; c < NUM_CHANNELS_; ++c) total.tlm_fault[t][c] += p.tlm_fault[t][c];
+      }
+      for (uint8_t c = 0; c < NUM_CHANNELS_; ++c) total.poll_dpm_mask[c] += p.poll_dpm_mask[c];
+      for (const auto &kv : p.cycles) {
+        CycleInfo &dst = cycles[(static_cast<uint64_t>(fi) << 32) | kv.first];
+        dst.first_dpm_us = std::min(dst.first_dpm_us, kv.second.first_dpm_us);
+        dst.fault_types |= kv.second.fault_types;
+      }
+      telemetry_pass(p.tlm, state, timing);
+      tlm_rows += p.tlm.size();
+      std::vector<TlmRow>().swap(p.tlm);
+    }
+    tlm_span_us += state.span_us;
+  }
+  const double secs =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  std::printf("MAX22200 log analysis: %zu file(s), %.1f MB, %" PRIu64 " lines in %.3f s "
+              "(%.2f GB/s, %u threads)\n",
+              inputs.size(), bytes / 1e6, total.lines, secs, secs > 0 ? bytes / secs / 1e9 : 0.0,
+              threads);
+  std::printf("  poll_csv rows %" PRIu64 ", telemetry rows %" PRIu64 ", other lines %" PRIu64 "\n",
+              total.poll_rows, tlm_rows, total.skipped);
+  std::printf("  STATUS flags: OVT %" PRIu64 "  UVM %" PRIu64 "  COMER %" PRIu64 " samples\n",
+              total.ovt, total.uvm, total.comer);
+
+  if (total.poll_rows > 0) {
+    std::vector<uint64_t> first_dpm;
+    uint64_t cycles_with[kFaultTypes] = {};
+    for (const auto &kv : cycles) {
+      if (kv.second.first_dpm_us != UINT32_MAX) first_dpm.push_back(kv.second.first_dpm_us);
+      for (int t = 0; t < kFaultTypes; ++t) cycles_with[t] += (kv.second.fault_types >> t) & 1u;
+    }
+    std::printf("\npoll_csv (CH%u): %zu cycles, %" PRIu64 " samples (%" PRIu64 " ENERGISE)\n",
+                channel, cycles.size(), total.poll_rows, total.poll_energise);
+    std::printf("  %-6s %12s %14s %12s %12s\n", "fault", "samples", "per 1k samples", "cycles",
+                "% cycles");
+    for (int t = 0; t < kFaultTypes; ++t) {
+      std::printf("  %-6s %12" PRIu64 " %14.3f %12" PRIu64 " %11.2f%%\n", kFaultNames[t],
+                  total.poll_fault[t], 1000.0 * total.poll_fault[t] / total.poll_rows,
+                  cycles_with[t], cycles.empty() ? 0.0 : 100.0 * cycles_with[t] / cycles.size());
+    }
+    std::printf("  DPM samples by channel (fault_dpm_byte):");
+    for (uint8_t c = 0; c < NUM_CHANNELS_; ++c) std::printf(" %" PRIu64, total.poll_dpm_mask[c]);
+    std::printf("\n");
+    print_distribution("DPM first fire after ENERGISE", first_dpm);
+  }
+
+  if (tlm_rows > 0) {
+    const double hours = tlm_span_us / 3.6e9;
+    std::printf("\ntelemetry: %" PRIu64 " samples over %.1f s\n", tlm_rows, tlm_span_us / 1e6);
+    std::printf("  %-3s %7s %8s %10s %10s %10s   %s\n", "ch", "duty", "periods", "mean ms",
+                "min ms", "max ms", "faults/h OCP HHF OLF DPM");
+    for (uint8_t c = 0; c < NUM_CHANNELS_; ++c) {
+      const ChannelTiming &ct = timing[c];
+      uint64_t faults = 0;
+      for (int t = 0; t < kFaultTypes; ++t) faults += total.tlm_fault[t][c];
+      if (ct.on_us == 0 && ct.periods == 0 && faults == 0) continue;
+      std::printf("  %-3u %6.2f%% %8" PRIu64 " %10.2f %10.2f %10.2f  ", c,
+                  tlm_span_us ? 100.0 * ct.on_us / tlm_span_us : 0.0, ct.periods,
+                  ct.periods ? ct.on_us / 1e3 / ct.periods : 0.0,
+                  ct.periods ? ct.period_min_us / 1e3 : 0.0, ct.period_max_us / 1e3);
+      for (int t = 0; t < kFaultTypes; ++t) {
+        std::printf(" %8.2f", hours > 0 ? total.tlm_fault[t][c] / hours : 0.0);
+      }
+      std::printf("\n");
+    }
+    for (uint8_t c = 0; c < NUM_CHANNELS_; ++c) {
+      if (timing[c].dpm_after_on_us.empty()) continue;
+      char label[40];
+      std::snprintf(label, sizeof(label), "CH%u DPM after ONCH rise", c);
+      print_distribution(label, timing[c].dpm_after_on_us);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,232 @@
+/**
+ * @file max22200_telemetry_decode.cpp
+ * @brief Host decoder for MAX22200 binary telemetry (max22200_telemetry.hpp).
+ *
+ * @details
+ *   Reads either a captured serial log in which the target printed each
+ *   frame as a `TLM,<hex>` line (anything before `TLM,` on the line, such as
+ *   a log prefix, is ignored; other lines are skipped), or a raw binary file
+ *   of concatenated frames, and expands every frame back into a sample.
+ *
+ *   Output is CSV (one row per sample, default to stdout) or a column
+ *   directory: one little-endian binary array per field plus a schema.txt,
+ *   ready for numpy.fromfile / pandas / Arrow without parsing text.
+ *
+ *   CSV columns:
+ *     t_us,status,onch,ocp,hhf,olf,dpm,fault_byte,active,comer,uvm,ovt
+ *   (status and masks in hex, t_us unwrapped to 64 bits).
+ *
+ *   Lost frames are detected from the header sequence number. Each gap is
+ *   reported on stderr; delta frames after it are dropped until the next
+ *   keyframe, so no row is built on the wrong base.
+ *
+ * @par Usage
+ *   max22200_telemetry_decode [--bin] [--csv FILE] [--columns DIR] [INPUT]
+ *
+ *   INPUT defaults to stdin.
+ *
+ * @copyright Copyright (c) 2024-2025 HardFOC. All rights reserved.
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "max22200_telemetry.hpp"
+
+using namespace max22200;
+
+//==============================================================================
+// COLUMN STORE
+//==============================================================================
+
+struct Columns {
+  std::vector<uint64_t> t_us;
+  std::vector<uint32_t> status;
+  std::vector<uint8_t> onch;
+  std::vector<uint32_t> fault;
+  std::vector<uint8_t> fault_byte;
+
+  void add(uint64_t t, const TelemetrySample &s) {
+    t_us.push_back(t);
+    status.push_back(s.status);
+    onch.push_back(s.onch);
+    fault.push_back(s.fault);
+    fault_byte.push_back(s.fault_byte);
+  }
+};
+
+template <typename T>
+static bool write_column(const std::string &dir, const char *name, const std::vector<T> &v) {
+  const std::string path = dir + "/" + name;
+  std::FILE *f = std::fopen(path.c_str(), "wb");
+  if (f == nullptr) return false;
+  // Host byte order is little-endian on every platform this tool targets
+  const size_t written = v.empty() ? 0 : std::fwrite(v.data(), sizeof(T), v.size(), f);
+  return std::fclose(f) == 0 && written == v.size();
+}
+
+static bool write_columns(const std::string &dir, const Columns &c) {
+  const std::string schema_path = dir + "/schema.txt";
+  std::FILE *schema = std::fopen(schema_path.c_str(), "w");
+  if (schema == nullptr) return false;
+  std::fprintf(schema,
+               "rows %zu\n"
+               "t_us.u64 uint64 little-endian  sample time (us, unwrapped)\n"
+               "status.u32 uint32 little-endian  STATUS bits 23:0\n"
+               "onch.u8 uint8  STATUS bits 31:24 (channels on)\n"
+               "fault.u32 uint32 little-endian  FAULT register (OCP<<24|HHF<<16|OLF<<8|DPM)\n"
+               "fault_byte.u8 uint8  command-phase fault byte\n",
+               c.t_us.size());
+  const bool ok = std::fclose(schema) == 0;
+  return ok && write_column(dir, "t_us.u64", c.t_us) && write_column(dir, "status.u32", c.status) &&
+         write_column(dir, "onch.u8", c.onch) && write_column(dir, "fault.u32", c.fault) &&
+         write_column(dir, "fault_byte.u8", c.fault_byte);
+}
+
+static void write_csv_row(std::FILE *out, uint64_t t, const TelemetrySample &s) {
+  const uint32_t st = s.status;
+  std::fprintf(out,
+               "%" PRIu64 ",0x%06" PRIX32 ",0x%02X,0x%02X,0x%02X,0x%02X,0x%02X,0x%02X,%d,%d,%d,%d\n",
+               t, st, s.onch, static_cast<unsigned>((s.fault >> FaultReg::OCP_SHIFT) & 0xFFu),
+               static_cast<unsigned>((s.fault >> FaultReg::HHF_SHIFT) & 0xFFu),
+               static_cast<unsigned>((s.fault >> FaultReg::OLF_SHIFT) & 0xFFu),
+               static_cast<unsigned>((s.fault >> FaultReg::DPM_SHIFT) & 0xFFu), s.fault_byte,
+               (st & StatusReg::ACTIVE_BIT) != 0, (st & StatusReg::COMER_BIT) != 0,
+               (st & StatusReg::UVM_BIT) != 0, (st & StatusReg::OVT_BIT) != 0);
+}
+
+//==============================================================================
+// INPUT
+//==============================================================================
+
+static int hex_nibble(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+/// Collect frames: one per TLM line (log) or the whole file (bin)
+static bool read_frames(std::FILE *in, bool binary, std::vector<std::vector<uint8_t>> &frames) {
+  if (binary) {
+    std::vector<uint8_t> all;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), in)) > 0) all.insert(all.end(), buf, buf + n);
+    frames.push_back(std::move(all));
+    return true;
+  }
+  char line[1024];
+  while (std::fgets(line, sizeof(line), in) != nullptr) {
+    const char *p = std::strstr(line, "TLM,");
+    if (p == nullptr) continue;
+    p += 4;
+    std::vector<uint8_t> frame;
+    while (hex_nibble(p[0]) >= 0 && hex_nibble(p[1]) >= 0) {
+      frame.push_back(static_cast<uint8_t>((hex_nibble(p[0]) << 4) | hex_nibble(p[1])));
+      p += 2;
+    }
+    if (!frame.empty()) frames.push_back(std::move(frame));
+  }
+  return true;
+}
+
+//==============================================================================
+// MAIN
+//==============================================================================
+
+int main(int argc, char **argv) {
+  bool binary = false;
+  const char *csv_path = nullptr;
+  const char *columns_dir = nullptr;
+  const char *input = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const bool has_value = (i + 1 < argc);
+    if (std::strcmp(a, "--bin") == 0) {
+      binary = true;
+    } else if (std::strcmp(a, "--csv") == 0 && has_value) {
+      csv_path = argv[++i];
+    } else if (std::strcmp(a, "--columns") == 0 && has_value) {
+      columns_dir = argv[++i];
+    } else if (a[0] != '-' && input == nullptr) {
+      input = a;
+    } else {
+      std::fprintf(stderr, "usage: %s [--bin] [--csv FILE] [--columns DIR] [INPUT]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  std::FILE *in = input ? std::fopen(input, binary ? "rb" : "r") : stdin;
+  if (in == nullptr) {
+    std::fprintf(stderr, "cannot open %s\n", input);
+    return 1;
+  }
+  std::vector<std::vector<uint8_t>> frames;
+  read_frames(in, binary, frames);
+  if (in != stdin) std::fclose(in);
+
+  std::FILE *csv = nullptr;
+  if (csv_path != nullptr || columns_dir == nullptr) {
+    csv = csv_path ? std::fopen(csv_path, "w") : stdout;
+    if (csv == nullptr) {
+      std::fprintf(stderr, "cannot write %s\n", csv_path);
+      return 1;
+    }
+    std::fprintf(csv, "t_us,status,onch,ocp,hhf,olf,dpm,fault_byte,active,comer,uvm,ovt\n");
+  }
+
+  TelemetryDecoder dec;
+  Columns cols;
+  uint64_t decoded = 0, skipped = 0, dropped = 0, errors = 0, bytes = 0;
+  uint64_t frame_index = 0;
+  uint32_t gaps = 0, lost_before = 0;
+  bool seen_keyframe = false;
+  for (const std::vector<uint8_t> &buf : frames) {
+    size_t off = 0;
+    while (off < buf.size()) {
+      TelemetrySample s;
+      bool valid = false;
+      const size_t used = dec.Decode(buf.data() + off, buf.size() - off, s, valid);
+      if (used == 0) {
+        errors++;
+        break;  // Rest of this buffer is unusable; the next keyframe resyncs
+      }
+      off += used;
+      bytes += used;
+      frame_index++;
+      const uint32_t lost = dec.GetLostFrames();
+      if (dec.GetGaps() != gaps) {
+        std::fprintf(stderr, "gap before frame %" PRIu64 ": %" PRIu32 " frame(s) lost (mod 8)\n",
+                     frame_index, lost - lost_before);
+        gaps = dec.GetGaps();
+      }
+      lost_before = lost;
+      if (!valid) {
+        (seen_keyframe ? dropped : skipped)++;
+        continue;
+      }
+      seen_keyframe = true;
+      decoded++;
+      if (csv != nullptr) write_csv_row(csv, dec.GetTimestamp64Us(), s);
+      if (columns_dir != nullptr) cols.add(dec.GetTimestamp64Us(), s);
+    }
+  }
+  if (csv != nullptr && csv != stdout) std::fclose(csv);
+  if (columns_dir != nullptr && !write_columns(columns_dir, cols)) {
+    std::fprintf(stderr, "cannot write columns to %s\n", columns_dir);
+    return 1;
+  }
+
+  std::fprintf(stderr,
+               "%" PRIu64 " samples from %" PRIu64 " bytes (%.2f B/sample), %" PRIu64
+               " skipped before first keyframe, %" PRIu64 " malformed, %" PRIu32
+               " gaps (%" PRIu32 " frames lost, %" PRIu64 " dropped until keyframe)\n",
+               decoded, bytes, decoded ? static_cast<double>(bytes) / decoded : 0.0, skipped,
+               errors, dec.GetGaps(), dec.GetLostFrames(), dropped);
+  return errors == 0 ? 0 : 1;
+}